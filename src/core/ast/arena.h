@@ -0,0 +1,104 @@
+// src/core/ast/arena.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace initlang {
+namespace ast {
+
+// Tableau de taille fixe alloué dans une AstArena (non possédant).
+template <typename T>
+class ArenaArray {
+private:
+    T* items = nullptr;
+    uint32_t count = 0;
+
+public:
+    ArenaArray() = default;
+    ArenaArray(T* data, uint32_t size) : items(data), count(size) {}
+
+    T* begin() const { return items; }
+    T* end() const { return items + count; }
+    T* data() const { return items; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](size_t i) const { return items[i]; }
+
+    // Raccourcit le tableau sur place (les éléments retirés restent dans l'arène)
+    void truncate(size_t new_size) { count = static_cast<uint32_t>(std::min<size_t>(new_size, count)); }
+};
+
+// Allocateur par incrément de pointeur pour un parse complet. Les nœuds et
+// leurs chaînes sont posés dans de grands blocs ; détruire l'arène rend tous
+// les blocs d'un coup. Les destructeurs des objets ne sont JAMAIS appelés :
+// n'y placer que des types sans ressource possédée.
+class AstArena {
+private:
+    static constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    size_t next_block_size = MIN_BLOCK_SIZE;
+    size_t reserved = 0;
+    size_t node_count = 0;
+
+    void* allocate_slow(size_t size, size_t align) {
+        size_t block_size = std::max(next_block_size, size + align);
+        blocks.emplace_back(new char[block_size]);
+        cursor = blocks.back().get();
+        limit = cursor + block_size;
+        reserved += block_size;
+        next_block_size = std::min(next_block_size * 2, MAX_BLOCK_SIZE);
+        return allocate(size, align);
+    }
+
+public:
+    AstArena() = default;
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t)(align - 1);
+        if (cursor == nullptr || p + size > reinterpret_cast<uintptr_t>(limit)) {
+            return allocate_slow(size, align);
+        }
+        cursor = reinterpret_cast<char*>(p + size);
+        return reinterpret_cast<void*>(p);
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        ++node_count;
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    ArenaArray<T> copy_array(const T* items, size_t count) {
+        if (count == 0) return {};
+        T* dst = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        std::uninitialized_copy(items, items + count, dst);
+        return ArenaArray<T>(dst, static_cast<uint32_t>(count));
+    }
+
+    std::string_view copy_string(std::string_view text) {
+        if (text.empty()) return {};
+        char* dst = static_cast<char*>(allocate(text.size(), 1));
+        std::memcpy(dst, text.data(), text.size());
+        return std::string_view(dst, text.size());
+    }
+
+    size_t nodes() const { return node_count; }
+    size_t bytes_reserved() const { return reserved; }
+};
+
+} // namespace ast
+} // namespace initlang
@@ -1,119 +1,248 @@
 // src/core/ast/ast.h
 #pragma once
 #include "../lexer/tokens.h"
+#include "../common/interner.h"
+#include "arena.h"
+#include <cstdint>
 #include <memory>
 #include <vector>
-#include <string>
+#include <string_view>
 
 namespace initlang {
 namespace ast {
 
+// Tous les nœuds vivent dans une AstArena : les enfants sont des pointeurs
+// bruts, les listes des ArenaArray et les noms des common::Symbol (SymbolId
+// plus vue sur le texte stocké dans l'Interner du Program). Aucun membre ne
+// possède de ressource, de sorte que l'arène libère l'arbre entier d'un coup
+// sans appeler les destructeurs.
+
 // Forward declarations
 class BlockStatement;
 class Expression;
 
+// Étiquette de type, commune à l'arbre et à la forme plate (flat_ast.h) :
+// les passes aiguillent par switch au lieu de dynamic_cast.
+enum class NodeKind : uint8_t {
+    NumberLiteral,
+    StringLiteral,
+    Identifier,
+    BinaryExpression,
+    CallExpression,
+    SpawnExpression,
+    AwaitExpression,
+    ExpressionStatement,
+    VariableDeclaration,
+    BlockStatement,
+    FunctionDeclaration,
+    ReturnStatement,
+    Program
+};
+
+// Position dans le source (base 1 ; 0 = inconnue), reprise du token qui
+// ouvre le nœud : opérateur pour une expression binaire, '(' pour un appel,
+// mot-clé pour une déclaration.
+struct SourceLocation {
+    int line = 0;
+    int column = 0;
+};
+
+// Liaison d'un nom, posée par le résolveur (compiler/resolver.h) avant la
+// génération de code : aucun nom n'est plus cherché à l'exécution, sauf les
+// globales.
+enum class Binding : uint8_t {
+    Unresolved,
+    Global,   // table des globales, par nom
+    Local,    // slot de la fenêtre de pile de la fonction courante
+    Upvalue   // variable capturée d'une fonction englobante
+};
+
+struct Resolution {
+    Binding binding = Binding::Unresolved;
+    uint16_t index = 0; // slot (Local) ou rang dans FunctionDeclaration::upvalues (Upvalue)
+};
+
+// Capture d'une fonction : slot local de la fonction immédiatement
+// englobante (is_local) ou capture de celle-ci
+struct UpvalueRef {
+    uint16_t index;
+    bool is_local;
+};
+
 class ASTNode {
 public:
+    const NodeKind kind;
+    SourceLocation location;
+
+    explicit ASTNode(NodeKind k) : kind(k) {}
     virtual ~ASTNode() = default;
 };
 
+// Conversion vérifiée par l'étiquette (chaque classe expose KIND)
+template <typename T>
+T* node_cast(ASTNode* node) {
+    return node && node->kind == T::KIND ? static_cast<T*>(node) : nullptr;
+}
+
+template <typename T>
+const T* node_cast(const ASTNode* node) {
+    return node && node->kind == T::KIND ? static_cast<const T*>(node) : nullptr;
+}
+
 // Expressions
-class Expression : public ASTNode {};
+class Expression : public ASTNode {
+protected:
+    using ASTNode::ASTNode;
+};
 
 class NumberLiteral : public Expression {
 public:
+    static constexpr NodeKind KIND = NodeKind::NumberLiteral;
+
     double value;
-    NumberLiteral(double val) : value(val) {}
+    NumberLiteral(double val) : Expression(KIND), value(val) {}
 };
 
 class StringLiteral : public Expression {
 public:
-    std::string value;
-    StringLiteral(const std::string& val) : value(val) {}
+    static constexpr NodeKind KIND = NodeKind::StringLiteral;
+
+    common::Symbol value;
+    StringLiteral(common::Symbol val) : Expression(KIND), value(val) {}
 };
 
 class Identifier : public Expression {
 public:
-    std::string name;
-    Identifier(const std::string& n) : name(n) {}
+    static constexpr NodeKind KIND = NodeKind::Identifier;
+
+    common::Symbol name;
+    Resolution resolved;
+
+    Identifier(common::Symbol n) : Expression(KIND), name(n) {}
 };
 
 class BinaryExpression : public Expression {
 public:
+    static constexpr NodeKind KIND = NodeKind::BinaryExpression;
+
     lexer::TokenType op;
-    std::unique_ptr<Expression> left;
-    std::unique_ptr<Expression> right;
-    
-    BinaryExpression(lexer::TokenType operation, 
-                    std::unique_ptr<Expression> l, 
-                    std::unique_ptr<Expression> r)
-        : op(operation), left(std::move(l)), right(std::move(r)) {}
+    Expression* left;
+    Expression* right;
+
+    BinaryExpression(lexer::TokenType operation, Expression* l, Expression* r)
+        : Expression(KIND), op(operation), left(l), right(r) {}
 };
 
 class CallExpression : public Expression {
 public:
-    std::unique_ptr<Expression> callee;
-    std::vector<std::unique_ptr<Expression>> arguments;
-    
-    CallExpression(std::unique_ptr<Expression> c, 
-                  std::vector<std::unique_ptr<Expression>> args)
-        : callee(std::move(c)), arguments(std::move(args)) {}
+    static constexpr NodeKind KIND = NodeKind::CallExpression;
+
+    Expression* callee;
+    ArenaArray<Expression*> arguments;
+
+    CallExpression(Expression* c, ArenaArray<Expression*> args)
+        : Expression(KIND), callee(c), arguments(args) {}
+};
+
+// `spawn f(x)` : l'appel s'exécute dans une tâche, l'expression vaut la tâche
+class SpawnExpression : public Expression {
+public:
+    static constexpr NodeKind KIND = NodeKind::SpawnExpression;
+
+    CallExpression* call;
+
+    SpawnExpression(CallExpression* c) : Expression(KIND), call(c) {}
+};
+
+// `await t` : résultat de la tâche t (toute autre valeur passe telle quelle)
+class AwaitExpression : public Expression {
+public:
+    static constexpr NodeKind KIND = NodeKind::AwaitExpression;
+
+    Expression* value;
+
+    AwaitExpression(Expression* v) : Expression(KIND), value(v) {}
 };
 
 // Statements
-class Statement : public ASTNode {};
+class Statement : public ASTNode {
+protected:
+    using ASTNode::ASTNode;
+};
 
 class ExpressionStatement : public Statement {
 public:
-    std::unique_ptr<Expression> expression;
-    ExpressionStatement(std::unique_ptr<Expression> expr) 
-        : expression(std::move(expr)) {}
+    static constexpr NodeKind KIND = NodeKind::ExpressionStatement;
+
+    Expression* expression;
+    ExpressionStatement(Expression* expr) : Statement(KIND), expression(expr) {}
 };
 
 class VariableDeclaration : public Statement {
 public:
-    std::string name;
-    std::unique_ptr<Expression> value;
+    static constexpr NodeKind KIND = NodeKind::VariableDeclaration;
+
+    common::Symbol name;
+    Expression* value;
     bool is_const;
-    
-    VariableDeclaration(const std::string& n, std::unique_ptr<Expression> v, bool ic = false)
-        : name(n), value(std::move(v)), is_const(ic) {}
+    Resolution resolved; // Local (slot) ou Global
+
+    VariableDeclaration(common::Symbol n, Expression* v, bool ic = false)
+        : Statement(KIND), name(n), value(v), is_const(ic) {}
 };
 
 // Déclaration complète de BlockStatement AVANT FunctionDeclaration
 class BlockStatement : public Statement {
 public:
-    std::vector<std::unique_ptr<Statement>> statements;
-    
-    BlockStatement() = default;
-    BlockStatement(std::vector<std::unique_ptr<Statement>> stmts)
-        : statements(std::move(stmts)) {}
+    static constexpr NodeKind KIND = NodeKind::BlockStatement;
+
+    ArenaArray<Statement*> statements;
+    uint16_t local_count = 0; // locales déclarées directement dans le bloc
+
+    BlockStatement() : Statement(KIND) {}
+    BlockStatement(ArenaArray<Statement*> stmts) : Statement(KIND), statements(stmts) {}
 };
 
 class FunctionDeclaration : public Statement {
 public:
-    std::string name;
-    std::vector<std::string> parameters;
-    std::unique_ptr<BlockStatement> body;
-    
-    FunctionDeclaration(const std::string& n, 
-                       std::vector<std::string> params,
-                       std::unique_ptr<BlockStatement> b)
-        : name(n), parameters(std::move(params)), body(std::move(b)) {}
+    static constexpr NodeKind KIND = NodeKind::FunctionDeclaration;
+
+    common::Symbol name;
+    ArenaArray<common::Symbol> parameters;
+    BlockStatement* body;
+    Resolution resolved;              // liaison du nom, comme VariableDeclaration
+    ArenaArray<UpvalueRef> upvalues;  // captures, dans l'ordre des Resolution::index
+    uint16_t slot_count = 0;          // slots de pile utilisés au plus (appelé compris)
+    bool is_async;                    // `async fi` : le corps peut contenir `await`
+
+    FunctionDeclaration(common::Symbol n, ArenaArray<common::Symbol> params, BlockStatement* b, bool ia = false)
+        : Statement(KIND), name(n), parameters(params), body(b), is_async(ia) {}
 };
 
 class ReturnStatement : public Statement {
 public:
-    std::unique_ptr<Expression> value;
-    
-    ReturnStatement(std::unique_ptr<Expression> val = nullptr) 
-        : value(std::move(val)) {}
+    static constexpr NodeKind KIND = NodeKind::ReturnStatement;
+
+    Expression* value;
+
+    ReturnStatement(Expression* val = nullptr) : Statement(KIND), value(val) {}
 };
 
-// Programme
+// Programme : possède l'arène de ses nœuds, sauf si l'appelant en a fourni
+// une (Parser::parse_program(AstArena&)), auquel cas elle doit lui survivre.
+// L'Interner est partagé avec le Parser et le compilateur ; il garde en vie
+// le texte des symboles.
 class Program : public ASTNode {
 public:
-    std::vector<std::unique_ptr<Statement>> statements;
+    static constexpr NodeKind KIND = NodeKind::Program;
+
+    Program() : ASTNode(KIND) {}
+
+    std::vector<Statement*> statements;
+    std::unique_ptr<AstArena> owned_arena;
+    AstArena* arena = nullptr;
+    std::shared_ptr<common::Interner> symbols;
+    uint16_t slot_count = 0; // slots du script (locales de blocs), posé par le résolveur
 };
 
 } // namespace ast
@@ -0,0 +1,369 @@
+// src/core/ast/flat_ast.h
+#pragma once
+#include "ast.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace initlang {
+namespace ast {
+
+// Forme plate de l'AST, en structure de tableaux : un nœud est un indice
+// 32 bits dans des tableaux typés. Pensée pour les parcours de très gros
+// programmes (100k+ instructions) : pas de pointeurs, pas de vtable, les
+// nœuds d'un même parcours sont contigus en mémoire.
+using NodeId = uint32_t;
+inline constexpr NodeId NO_NODE = std::numeric_limits<NodeId>::max();
+
+// Tranche d'indices dans FlatAst::extra (enfants d'un appel, d'un bloc...)
+struct NodeRange {
+    const uint32_t* items = nullptr;
+    uint32_t count = 0;
+
+    const uint32_t* begin() const { return items; }
+    const uint32_t* end() const { return items + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint32_t operator[](size_t i) const { return items[i]; }
+};
+
+class FlatAst {
+public:
+    static constexpr uint32_t ASYNC_FUNCTION = 0x80000000u;
+
+    // Un enregistrement par nœud. Sens des opérandes selon le type :
+    //   NumberLiteral        a = indice dans numbers
+    //   StringLiteral        a = SymbolId
+    //   Identifier           a = SymbolId
+    //   BinaryExpression     a = gauche, b = droite, c = opérateur (TokenType)
+    //   CallExpression       a = appelé, b/c = tranche d'arguments dans extra
+    //   SpawnExpression      a = appel (CallExpression)
+    //   AwaitExpression      a = valeur attendue
+    //   ExpressionStatement  a = expression
+    //   VariableDeclaration  a = SymbolId du nom, b = valeur, c = is_const
+    //   BlockStatement       b/c = tranche d'instructions dans extra
+    //   FunctionDeclaration  a = SymbolId du nom, b = début dans extra (corps
+    //                        puis SymbolId des paramètres), c = nombre de
+    //                        paramètres, plus ASYNC_FUNCTION pour `async fi`
+    //   ReturnStatement      a = valeur ou NO_NODE
+    std::vector<NodeKind> kinds;
+    std::vector<uint32_t> a;
+    std::vector<uint32_t> b;
+    std::vector<uint32_t> c;
+    std::vector<int> lines;    // position de chaque nœud (SourceLocation)
+    std::vector<int> columns;
+
+    std::vector<uint32_t> extra;          // listes d'enfants
+    std::vector<double> numbers;          // littéraux numériques
+    std::vector<NodeId> statements;       // instructions de premier niveau
+
+    // Texte des identifiants et des chaînes
+    std::shared_ptr<common::Interner> symbols = std::make_shared<common::Interner>();
+
+    size_t size() const { return kinds.size(); }
+    NodeKind kind(NodeId id) const { return kinds[id]; }
+
+    NodeRange range(uint32_t begin, uint32_t count) const {
+        return NodeRange{extra.data() + begin, count};
+    }
+
+    SourceLocation location(NodeId id) const { return SourceLocation{lines[id], columns[id]}; }
+
+    NodeId add(NodeKind kind, SourceLocation at, uint32_t x = 0, uint32_t y = 0, uint32_t z = 0) {
+        if (kinds.size() >= NO_NODE) {
+            throw std::length_error("FlatAst: too many nodes");
+        }
+        kinds.push_back(kind);
+        a.push_back(x);
+        b.push_back(y);
+        c.push_back(z);
+        lines.push_back(at.line);
+        columns.push_back(at.column);
+        return static_cast<NodeId>(kinds.size() - 1);
+    }
+
+    // Vues typées sur un nœud
+    struct Number { double value; };
+    struct String { common::Symbol value; };
+    struct Ident { common::Symbol name; };
+    struct Binary { lexer::TokenType op; NodeId left; NodeId right; };
+    struct Call { NodeId callee; NodeRange arguments; };
+    struct Spawn { NodeId call; };
+    struct Await { NodeId value; };
+    struct ExprStmt { NodeId expression; };
+    struct VarDecl { common::Symbol name; NodeId value; bool is_const; };
+    struct Block { NodeRange statements; };
+    struct Function { common::Symbol name; NodeRange parameters; NodeId body; bool is_async; }; // paramètres = SymbolId
+    struct Return { NodeId value; };
+
+    Number number(NodeId id) const { return {numbers[a[id]]}; }
+    common::Symbol symbol(uint32_t id) const { return symbols->symbol(common::SymbolId(id)); }
+
+    String string_literal(NodeId id) const { return {symbol(a[id])}; }
+    Ident identifier(NodeId id) const { return {symbol(a[id])}; }
+    Binary binary(NodeId id) const { return {static_cast<lexer::TokenType>(c[id]), a[id], b[id]}; }
+    Call call(NodeId id) const { return {a[id], range(b[id], c[id])}; }
+    Spawn spawn(NodeId id) const { return {a[id]}; }
+    Await await_expression(NodeId id) const { return {a[id]}; }
+    ExprStmt expression_statement(NodeId id) const { return {a[id]}; }
+    VarDecl variable(NodeId id) const { return {symbol(a[id]), b[id], c[id] != 0}; }
+    Block block(NodeId id) const { return {range(b[id], c[id])}; }
+    Function function(NodeId id) const {
+        return {symbol(a[id]), range(b[id] + 1, c[id] & ~ASYNC_FUNCTION), extra[b[id]], (c[id] & ASYNC_FUNCTION) != 0};
+    }
+    Return return_statement(NodeId id) const { return {a[id]}; }
+};
+
+// Aiguillage par type : appelle visitor(id, vue) avec la vue typée du nœud.
+template <typename Visitor>
+decltype(auto) visit(const FlatAst& tree, NodeId id, Visitor&& visitor) {
+    switch (tree.kind(id)) {
+        case NodeKind::NumberLiteral:       return visitor(id, tree.number(id));
+        case NodeKind::StringLiteral:       return visitor(id, tree.string_literal(id));
+        case NodeKind::Identifier:          return visitor(id, tree.identifier(id));
+        case NodeKind::BinaryExpression:    return visitor(id, tree.binary(id));
+        case NodeKind::CallExpression:      return visitor(id, tree.call(id));
+        case NodeKind::SpawnExpression:     return visitor(id, tree.spawn(id));
+        case NodeKind::AwaitExpression:     return visitor(id, tree.await_expression(id));
+        case NodeKind::ExpressionStatement: return visitor(id, tree.expression_statement(id));
+        case NodeKind::VariableDeclaration: return visitor(id, tree.variable(id));
+        case NodeKind::BlockStatement:      return visitor(id, tree.block(id));
+        case NodeKind::FunctionDeclaration: return visitor(id, tree.function(id));
+        case NodeKind::ReturnStatement:     return visitor(id, tree.return_statement(id));
+        case NodeKind::Program:             break;
+    }
+    throw std::logic_error("FlatAst: invalid node kind");
+}
+
+// Appelle fn(enfant) pour chaque enfant direct, dans l'ordre du source.
+template <typename Fn>
+void for_each_child(const FlatAst& tree, NodeId id, Fn&& fn) {
+    switch (tree.kind(id)) {
+        case NodeKind::BinaryExpression:
+            fn(tree.a[id]);
+            fn(tree.b[id]);
+            break;
+        case NodeKind::CallExpression:
+            fn(tree.a[id]);
+            for (NodeId arg : tree.range(tree.b[id], tree.c[id])) fn(arg);
+            break;
+        case NodeKind::SpawnExpression:
+        case NodeKind::AwaitExpression:
+        case NodeKind::ExpressionStatement:
+            fn(tree.a[id]);
+            break;
+        case NodeKind::VariableDeclaration:
+            fn(tree.b[id]);
+            break;
+        case NodeKind::BlockStatement:
+            for (NodeId stmt : tree.range(tree.b[id], tree.c[id])) fn(stmt);
+            break;
+        case NodeKind::FunctionDeclaration:
+            fn(tree.extra[tree.b[id]]);
+            break;
+        case NodeKind::ReturnStatement:
+            if (tree.a[id] != NO_NODE) fn(tree.a[id]);
+            break;
+        default:
+            break;
+    }
+}
+
+// Parcours préfixe itératif (pas de récursion sur les arbres profonds).
+template <typename Fn>
+void walk(const FlatAst& tree, Fn&& fn) {
+    std::vector<NodeId> stack(tree.statements.rbegin(), tree.statements.rend());
+    std::vector<NodeId> children;
+    while (!stack.empty()) {
+        NodeId id = stack.back();
+        stack.pop_back();
+        fn(id);
+
+        children.clear();
+        for_each_child(tree, id, [&children](NodeId child) { children.push_back(child); });
+        stack.insert(stack.end(), children.rbegin(), children.rend());
+    }
+}
+
+// Constructeur de FlatAst utilisé par le Parser (parser::BasicParser) et par
+// le convertisseur depuis l'arbre. Les listes sont empilées puis scellées
+// dans `extra` : les enfants d'un nœud y restent contigus.
+class FlatBuilder {
+public:
+    using Expr = NodeId;
+    using Stmt = NodeId;
+    using Block = NodeId;
+
+    static constexpr NodeId null() { return NO_NODE; }
+
+    explicit FlatBuilder(FlatAst& target) : tree(target) {}
+
+    Expr number(SourceLocation at, double value) {
+        tree.numbers.push_back(value);
+        return tree.add(NodeKind::NumberLiteral, at, static_cast<uint32_t>(tree.numbers.size() - 1));
+    }
+
+    Expr string_literal(SourceLocation at, common::Symbol value) {
+        return tree.add(NodeKind::StringLiteral, at, value.id.value);
+    }
+
+    Expr identifier(SourceLocation at, common::Symbol value) {
+        return tree.add(NodeKind::Identifier, at, value.id.value);
+    }
+
+    Expr binary(SourceLocation at, lexer::TokenType op, Expr left, Expr right) {
+        return tree.add(NodeKind::BinaryExpression, at, left, right, static_cast<uint32_t>(op));
+    }
+
+    size_t mark_expressions() const { return pending.size(); }
+    void push_expression(Expr e) { pending.push_back(e); }
+
+    Expr call(SourceLocation at, Expr callee, size_t mark) {
+        auto [begin, count] = seal(mark);
+        return tree.add(NodeKind::CallExpression, at, callee, begin, count);
+    }
+
+    bool is_call(Expr e) const { return e != NO_NODE && tree.kind(e) == NodeKind::CallExpression; }
+    Expr spawn_expression(SourceLocation at, Expr call) { return tree.add(NodeKind::SpawnExpression, at, call); }
+    Expr await_expression(SourceLocation at, Expr value) { return tree.add(NodeKind::AwaitExpression, at, value); }
+
+    Stmt expression_statement(SourceLocation at, Expr e) { return tree.add(NodeKind::ExpressionStatement, at, e); }
+
+    // Le nom est le dernier empilé depuis `names_mark`
+    Stmt variable(SourceLocation at, size_t names_mark, Expr value, bool is_const = false) {
+        uint32_t n = pending_names[names_mark];
+        pending_names.resize(names_mark);
+        return tree.add(NodeKind::VariableDeclaration, at, n, value, is_const ? 1 : 0);
+    }
+
+    size_t mark_statements() const { return pending.size(); }
+    void push_statement(Stmt s) { pending.push_back(s); }
+
+    Block block(SourceLocation at, size_t mark) {
+        auto [begin, count] = seal(mark);
+        return tree.add(NodeKind::BlockStatement, at, 0, begin, count);
+    }
+
+    size_t mark_names() const { return pending_names.size(); }
+    void push_name(common::Symbol n) { pending_names.push_back(n.id.value); }
+
+    // Pile de noms depuis `names_mark` : nom de la fonction puis paramètres
+    Stmt function(SourceLocation at, size_t names_mark, Block body, bool is_async = false) {
+        uint32_t n = pending_names[names_mark];
+        uint32_t begin = static_cast<uint32_t>(tree.extra.size());
+        tree.extra.push_back(body);
+        tree.extra.insert(tree.extra.end(), pending_names.begin() + names_mark + 1, pending_names.end());
+        uint32_t count = static_cast<uint32_t>(pending_names.size() - names_mark - 1);
+        pending_names.resize(names_mark);
+        return tree.add(NodeKind::FunctionDeclaration, at, n, begin, count | (is_async ? FlatAst::ASYNC_FUNCTION : 0));
+    }
+
+    Stmt return_statement(SourceLocation at, Expr value) { return tree.add(NodeKind::ReturnStatement, at, value); }
+
+    void add_to_program(Stmt s) { tree.statements.push_back(s); }
+
+    FlatAst& result() { return tree; }
+
+private:
+    FlatAst& tree;
+    std::vector<uint32_t> pending;
+    std::vector<uint32_t> pending_names;
+
+    std::pair<uint32_t, uint32_t> seal(size_t mark) {
+        uint32_t begin = static_cast<uint32_t>(tree.extra.size());
+        tree.extra.insert(tree.extra.end(), pending.begin() + mark, pending.end());
+        uint32_t count = static_cast<uint32_t>(pending.size() - mark);
+        pending.resize(mark);
+        return {begin, count};
+    }
+};
+
+namespace detail {
+
+inline NodeId flatten_node(FlatBuilder& out, const ASTNode* node) {
+    if (!node) return NO_NODE;
+
+    SourceLocation at = node->location;
+    switch (node->kind) {
+        case NodeKind::NumberLiteral:
+            return out.number(at, static_cast<const NumberLiteral*>(node)->value);
+        case NodeKind::StringLiteral:
+            return out.string_literal(at, static_cast<const StringLiteral*>(node)->value);
+        case NodeKind::Identifier:
+            return out.identifier(at, static_cast<const Identifier*>(node)->name);
+        case NodeKind::BinaryExpression: {
+            auto* bin = static_cast<const BinaryExpression*>(node);
+            NodeId left = flatten_node(out, bin->left);
+            NodeId right = flatten_node(out, bin->right);
+            return out.binary(at, bin->op, left, right);
+        }
+        case NodeKind::CallExpression: {
+            auto* call = static_cast<const CallExpression*>(node);
+            NodeId callee = flatten_node(out, call->callee);
+            // Les arguments sont aplatis avant d'être empilés : les listes
+            // imbriquées se referment avant celle-ci
+            std::vector<NodeId> args;
+            args.reserve(call->arguments.size());
+            for (const Expression* arg : call->arguments) args.push_back(flatten_node(out, arg));
+            size_t mark = out.mark_expressions();
+            for (NodeId arg : args) out.push_expression(arg);
+            return out.call(at, callee, mark);
+        }
+        case NodeKind::SpawnExpression:
+            return out.spawn_expression(at, flatten_node(out, static_cast<const SpawnExpression*>(node)->call));
+        case NodeKind::AwaitExpression:
+            return out.await_expression(at, flatten_node(out, static_cast<const AwaitExpression*>(node)->value));
+        case NodeKind::ExpressionStatement:
+            return out.expression_statement(
+                at, flatten_node(out, static_cast<const ExpressionStatement*>(node)->expression));
+        case NodeKind::VariableDeclaration: {
+            auto* decl = static_cast<const VariableDeclaration*>(node);
+            NodeId value = flatten_node(out, decl->value);
+            size_t mark = out.mark_names();
+            out.push_name(decl->name);
+            return out.variable(at, mark, value, decl->is_const);
+        }
+        case NodeKind::BlockStatement: {
+            auto* block = static_cast<const BlockStatement*>(node);
+            std::vector<NodeId> stmts;
+            stmts.reserve(block->statements.size());
+            for (const Statement* stmt : block->statements) stmts.push_back(flatten_node(out, stmt));
+            size_t mark = out.mark_statements();
+            for (NodeId stmt : stmts) out.push_statement(stmt);
+            return out.block(at, mark);
+        }
+        case NodeKind::FunctionDeclaration: {
+            auto* fn = static_cast<const FunctionDeclaration*>(node);
+            NodeId body = flatten_node(out, fn->body);
+            size_t mark = out.mark_names();
+            out.push_name(fn->name);
+            for (common::Symbol param : fn->parameters) out.push_name(param);
+            return out.function(at, mark, body, fn->is_async);
+        }
+        case NodeKind::ReturnStatement:
+            return out.return_statement(at, flatten_node(out, static_cast<const ReturnStatement*>(node)->value));
+        case NodeKind::Program:
+            break;
+    }
+    throw std::logic_error("flatten: unexpected node kind");
+}
+
+} // namespace detail
+
+// Conversion de compatibilité : arbre à pointeurs -> forme plate. Les deux
+// formes partagent l'Interner du programme, donc les mêmes SymbolId.
+inline FlatAst flatten(const Program& program) {
+    FlatAst tree;
+    if (program.symbols) tree.symbols = program.symbols;
+    FlatBuilder out(tree);
+    for (const Statement* stmt : program.statements) {
+        out.add_to_program(detail::flatten_node(out, stmt));
+    }
+    return tree;
+}
+
+} // namespace ast
+} // namespace initlang
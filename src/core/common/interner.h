@@ -0,0 +1,161 @@
+// src/core/common/interner.h
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace initlang {
+namespace common {
+
+// Identifiant stable d'une chaîne internée (identifiant ou littéral).
+// Deux SymbolId d'un même Interner sont égaux ssi les chaînes le sont.
+struct SymbolId {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t value = INVALID;
+
+    constexpr SymbolId() = default;
+    constexpr explicit SymbolId(uint32_t v) : value(v) {}
+
+    constexpr bool valid() const { return value != INVALID; }
+    constexpr bool operator==(SymbolId other) const { return value == other.value; }
+    constexpr bool operator!=(SymbolId other) const { return value != other.value; }
+    constexpr bool operator<(SymbolId other) const { return value < other.value; }
+};
+
+struct SymbolIdHash {
+    size_t operator()(SymbolId id) const { return id.value; }
+};
+
+// Symbole tel que porté par l'AST : l'identifiant pour les comparaisons, et
+// le texte (vue sur le stockage de l'Interner) pour les messages.
+struct Symbol {
+    SymbolId id;
+    std::string_view text;
+
+    bool operator==(const Symbol& other) const { return id == other.id; }
+    bool operator!=(const Symbol& other) const { return id != other.id; }
+};
+
+// Table d'internement : chaque chaîne distincte reçoit un SymbolId dense
+// (0, 1, 2...) et un hachage 64 bits calculé une seule fois.
+//
+// Les textes sont copiés dans des blocs qui ne bougent jamais : les vues
+// rendues restent valides pendant toute la vie de l'Interner. Une fois la
+// compilation terminée, freeze() interdit toute insertion ; les méthodes
+// const ne modifient rien et peuvent alors être appelées depuis plusieurs
+// threads sans synchronisation.
+class Interner {
+private:
+    struct Entry {
+        std::string_view text;
+        uint64_t hash;
+    };
+
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> slots; // id + 1, 0 = vide ; adressage ouvert linéaire
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    size_t remaining = 0;
+    bool is_frozen = false;
+
+    std::string_view store(std::string_view text) {
+        if (text.empty()) return std::string_view("", 0);
+        if (text.size() > remaining) {
+            size_t size = std::max(BLOCK_SIZE, text.size());
+            blocks.emplace_back(new char[size]);
+            cursor = blocks.back().get();
+            remaining = size;
+        }
+        std::memcpy(cursor, text.data(), text.size());
+        std::string_view stored(cursor, text.size());
+        cursor += text.size();
+        remaining -= text.size();
+        return stored;
+    }
+
+    size_t probe(std::string_view text, uint64_t h) const {
+        size_t mask = slots.size() - 1;
+        for (size_t i = static_cast<size_t>(h) & mask;; i = (i + 1) & mask) {
+            uint32_t slot = slots[i];
+            if (slot == 0) return i;
+            const Entry& e = entries[slot - 1];
+            if (e.hash == h && e.text == text) return i;
+        }
+    }
+
+    void grow() {
+        std::vector<uint32_t> old = std::move(slots);
+        slots.assign(old.empty() ? 1024 : old.size() * 2, 0);
+        size_t mask = slots.size() - 1;
+        for (uint32_t slot : old) {
+            if (slot == 0) continue;
+            size_t i = static_cast<size_t>(entries[slot - 1].hash) & mask;
+            while (slots[i] != 0) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+
+public:
+    Interner() { grow(); }
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    // FNV-1a 64 bits
+    static uint64_t hash_text(std::string_view text) {
+        uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : text) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    SymbolId intern(std::string_view text) {
+        uint64_t h = hash_text(text);
+        size_t i = probe(text, h);
+        if (slots[i] != 0) return SymbolId(slots[i] - 1);
+
+        if (is_frozen) {
+            throw std::logic_error("Interner is frozen: cannot intern '" + std::string(text) + "'");
+        }
+        if (entries.size() >= SymbolId::INVALID - 1) {
+            throw std::length_error("Interner: too many symbols");
+        }
+
+        entries.push_back(Entry{store(text), h});
+        slots[i] = static_cast<uint32_t>(entries.size());
+        // Facteur de charge <= 1/2
+        if (entries.size() * 2 > slots.size()) grow();
+        return SymbolId(static_cast<uint32_t>(entries.size() - 1));
+    }
+
+    Symbol symbol(std::string_view text) {
+        SymbolId id = intern(text);
+        return Symbol{id, entries[id.value].text};
+    }
+
+    // Recherche sans insertion : SymbolId invalide si absent
+    SymbolId find(std::string_view text) const {
+        uint32_t slot = slots[probe(text, hash_text(text))];
+        return slot ? SymbolId(slot - 1) : SymbolId();
+    }
+
+    std::string_view name(SymbolId id) const { return entries[id.value].text; }
+    uint64_t hash(SymbolId id) const { return entries[id.value].hash; }
+    Symbol symbol(SymbolId id) const { return Symbol{id, entries[id.value].text}; }
+    size_t size() const { return entries.size(); }
+
+    void freeze() { is_frozen = true; }
+    bool frozen() const { return is_frozen; }
+};
+
+} // namespace common
+} // namespace initlang
@@ -1,5 +1,51 @@
 // src/core/compiler/bytecode.h
-enum class OpCode {
+#pragma once
+#include "../runtime/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace initlang {
+namespace runtime { class Shape; }
+namespace compiler {
+
+using runtime::Value;
+
+// Les opérandes suivent l'opcode, en petit-boutiste. Les indices de
+// constantes et de globales (Heap::global_id) tiennent sur un octet ;
+// au-delà de 255, la variante _LONG prend un opérande de 3 octets.
+//
+// Effets sur la pile :
+//   OP_JUMP_IF_FALSE          dépile la condition
+//   OP_CALL n                 appelé + n arguments -> résultat
+//   OP_TAIL_CALL n            appelé + n arguments, à la place de la trame
+//                             courante (`return f(...)`)
+//   OP_BUILD_LIST n           n valeurs -> liste
+//   OP_BUILD_STRUCT n         n paires (nom, valeur) -> structure
+//   OP_GET_FIELD k            structure -> valeur du champ constants[k]
+//   OP_SET_FIELD k            structure, valeur -> valeur, rangée dans le
+//                             champ constants[k] (qui doit exister)
+//   OP_INIT_GER/OP_INIT_LOG n n arguments -> résultat
+//   OP_SPAWN n                appelé + n arguments -> tâche (l'appel s'exécute
+//                             dans la tâche)
+//   OP_AWAIT                  tâche -> son résultat ; toute autre valeur
+//                             reste en place
+//
+// Les superinstructions ne sont produites que par compiler/peephole.h :
+//   OP_ADD_CONSTANT k         OP_CONSTANT k + OP_ADD
+//   OP_SUBTRACT_CONSTANT k    OP_CONSTANT k + OP_SUBTRACT
+//   OP_JUMP_IF_NOT_LESS d     OP_LESS + OP_JUMP_IF_FALSE d
+//   OP_SET_LOCAL_POP s        OP_SET_LOCAL s + OP_POP
+//   OP_RETURN_LOCAL s         OP_GET_LOCAL s + OP_RETURN
+//
+// Les formes spécialisées ne sont écrites que par la VM (quickening), à la
+// place d'un opcode générique dont les opérandes ont toujours été du même
+// type ; elles reprennent sa forme générique si le type change :
+//   OP_ADD_NUM_NUM, OP_ADD_STR_STR          OP_ADD
+//   OP_SUBTRACT_NUM ... OP_DIVIDE_NUM       OP_SUBTRACT ... OP_DIVIDE
+//   OP_GREATER_NUM, OP_LESS_NUM             OP_GREATER, OP_LESS
+enum class OpCode : uint8_t {
     // Constantes
     OP_CONSTANT, OP_NULL, OP_TRUE, OP_FALSE,
     
@@ -12,21 +58,411 @@ enum class OpCode {
     OP_NEGATE, OP_NOT,
     
     // Comparaisons
-    OP_EQUAL, OP_NOT_EQUAL, OP_GREATER, OP_LESS,
+    OP_EQUAL, OP_NOT_EQUAL, OP_GREATER, OP_LESS, OP_GREATER_EQUAL, OP_LESS_EQUAL,
     
     // Contrôle
     OP_JUMP, OP_JUMP_IF_FALSE, OP_LOOP,
-    OP_CALL, OP_RETURN,
+    OP_CALL, OP_TAIL_CALL, OP_RETURN,
     
     // Structures
-    OP_BUILD_LIST, OP_BUILD_STRUCT,
+    OP_BUILD_LIST, OP_BUILD_STRUCT, OP_GET_FIELD, OP_SET_FIELD,
     
     // Spécial INITLANG
-    OP_INIT_GER, OP_INIT_LOG
+    OP_INIT_GER, OP_INIT_LOG,
+
+    // Tâches
+    OP_SPAWN, OP_AWAIT,
+
+    // Pile
+    OP_POP,
+
+    // Opérande de 3 octets (indice >= 256)
+    OP_CONSTANT_LONG, OP_DEFINE_GLOBAL_LONG, OP_GET_GLOBAL_LONG, OP_SET_GLOBAL_LONG,
+
+    // Superinstructions
+    OP_ADD_CONSTANT, OP_SUBTRACT_CONSTANT, OP_JUMP_IF_NOT_LESS, OP_SET_LOCAL_POP, OP_RETURN_LOCAL,
+
+    // Formes spécialisées (quickening)
+    OP_ADD_NUM_NUM, OP_ADD_STR_STR, OP_SUBTRACT_NUM, OP_MULTIPLY_NUM, OP_DIVIDE_NUM,
+    OP_GREATER_NUM, OP_LESS_NUM,
+
+    OP_COUNT_ // doit rester le dernier
+};
+
+inline constexpr size_t OPCODE_COUNT = static_cast<size_t>(OpCode::OP_COUNT_);
+
+// Hauteur maximale de la pile d'une fonction, comptée depuis le slot 0
+// (appelé, paramètres, locales et temporaires). Le compilateur et le
+// chargeur de cache refusent le code qui la dépasse ; la VM réserve cette
+// fenêtre à chaque appel.
+inline constexpr size_t MAX_FRAME_SLOTS = 256;
+
+// Forme des opérandes d'un opcode
+enum class OperandFormat : uint8_t {
+    NONE,   // pas d'opérande
+    BYTE,   // indice de constante/nom, slot local, nombre d'arguments
+    LONG,   // indice sur 3 octets
+    JUMP,   // déplacement sur 2 octets (avant pour JUMP*, arrière pour LOOP)
+};
+
+inline constexpr OperandFormat operand_format(OpCode op) {
+    switch (op) {
+        case OpCode::OP_CONSTANT:
+        case OpCode::OP_DEFINE_GLOBAL:
+        case OpCode::OP_GET_GLOBAL:
+        case OpCode::OP_SET_GLOBAL:
+        case OpCode::OP_GET_LOCAL:
+        case OpCode::OP_SET_LOCAL:
+        case OpCode::OP_CALL:
+        case OpCode::OP_TAIL_CALL:
+        case OpCode::OP_BUILD_LIST:
+        case OpCode::OP_BUILD_STRUCT:
+        case OpCode::OP_GET_FIELD:
+        case OpCode::OP_SET_FIELD:
+        case OpCode::OP_INIT_GER:
+        case OpCode::OP_INIT_LOG:
+        case OpCode::OP_SPAWN:
+        case OpCode::OP_ADD_CONSTANT:
+        case OpCode::OP_SUBTRACT_CONSTANT:
+        case OpCode::OP_SET_LOCAL_POP:
+        case OpCode::OP_RETURN_LOCAL:
+            return OperandFormat::BYTE;
+        case OpCode::OP_CONSTANT_LONG:
+        case OpCode::OP_DEFINE_GLOBAL_LONG:
+        case OpCode::OP_GET_GLOBAL_LONG:
+        case OpCode::OP_SET_GLOBAL_LONG:
+            return OperandFormat::LONG;
+        case OpCode::OP_JUMP:
+        case OpCode::OP_JUMP_IF_FALSE:
+        case OpCode::OP_LOOP:
+        case OpCode::OP_JUMP_IF_NOT_LESS:
+            return OperandFormat::JUMP;
+        default:
+            return OperandFormat::NONE;
+    }
+}
+
+// Forme générique d'un opcode spécialisé par la VM (lui-même sinon)
+inline constexpr OpCode generic_opcode(OpCode op) {
+    switch (op) {
+        case OpCode::OP_ADD_NUM_NUM:
+        case OpCode::OP_ADD_STR_STR:   return OpCode::OP_ADD;
+        case OpCode::OP_SUBTRACT_NUM:  return OpCode::OP_SUBTRACT;
+        case OpCode::OP_MULTIPLY_NUM:  return OpCode::OP_MULTIPLY;
+        case OpCode::OP_DIVIDE_NUM:    return OpCode::OP_DIVIDE;
+        case OpCode::OP_GREATER_NUM:   return OpCode::OP_GREATER;
+        case OpCode::OP_LESS_NUM:      return OpCode::OP_LESS;
+        default:                       return op;
+    }
+}
+
+// Valeurs dépilées puis empilées par une instruction ; `n` est son
+// opérande d'un octet (nombre d'arguments, d'éléments ou de paires)
+struct StackEffect {
+    size_t pops;
+    size_t pushes;
+};
+
+inline constexpr StackEffect stack_effect(OpCode op, size_t n) {
+    switch (op) {
+        case OpCode::OP_CONSTANT:
+        case OpCode::OP_CONSTANT_LONG:
+        case OpCode::OP_NULL:
+        case OpCode::OP_TRUE:
+        case OpCode::OP_FALSE:
+        case OpCode::OP_GET_GLOBAL:
+        case OpCode::OP_GET_GLOBAL_LONG:
+        case OpCode::OP_GET_LOCAL:
+            return {0, 1};
+        case OpCode::OP_DEFINE_GLOBAL:
+        case OpCode::OP_DEFINE_GLOBAL_LONG:
+        case OpCode::OP_JUMP_IF_FALSE:
+        case OpCode::OP_RETURN:
+        case OpCode::OP_POP:
+        case OpCode::OP_SET_LOCAL_POP:
+            return {1, 0};
+        case OpCode::OP_SET_GLOBAL:
+        case OpCode::OP_SET_GLOBAL_LONG:
+        case OpCode::OP_SET_LOCAL:
+        case OpCode::OP_NEGATE:
+        case OpCode::OP_NOT:
+        case OpCode::OP_GET_FIELD:
+        case OpCode::OP_AWAIT:
+        case OpCode::OP_ADD_CONSTANT:
+        case OpCode::OP_SUBTRACT_CONSTANT:
+            return {1, 1};
+        case OpCode::OP_ADD:
+        case OpCode::OP_SUBTRACT:
+        case OpCode::OP_MULTIPLY:
+        case OpCode::OP_DIVIDE:
+        case OpCode::OP_EQUAL:
+        case OpCode::OP_NOT_EQUAL:
+        case OpCode::OP_GREATER:
+        case OpCode::OP_LESS:
+        case OpCode::OP_GREATER_EQUAL:
+        case OpCode::OP_LESS_EQUAL:
+        case OpCode::OP_SET_FIELD:
+        case OpCode::OP_ADD_NUM_NUM:
+        case OpCode::OP_ADD_STR_STR:
+        case OpCode::OP_SUBTRACT_NUM:
+        case OpCode::OP_MULTIPLY_NUM:
+        case OpCode::OP_DIVIDE_NUM:
+        case OpCode::OP_GREATER_NUM:
+        case OpCode::OP_LESS_NUM:
+            return {2, 1};
+        case OpCode::OP_JUMP_IF_NOT_LESS:
+            return {2, 0};
+        case OpCode::OP_JUMP:
+        case OpCode::OP_LOOP:
+        case OpCode::OP_RETURN_LOCAL:
+            return {0, 0};
+        case OpCode::OP_CALL:
+        case OpCode::OP_SPAWN:
+            return {n + 1, 1};
+        case OpCode::OP_TAIL_CALL:
+            return {n + 1, 0};
+        case OpCode::OP_BUILD_LIST:
+        case OpCode::OP_INIT_GER:
+        case OpCode::OP_INIT_LOG:
+            return {n, 1};
+        case OpCode::OP_BUILD_STRUCT:
+            return {2 * n, 1};
+        case OpCode::OP_COUNT_:
+            break;
+    }
+    return {0, 0};
+}
+
+// Taille totale d'une instruction (opcode compris)
+inline constexpr size_t instruction_size(OpCode op) {
+    switch (operand_format(op)) {
+        case OperandFormat::BYTE: return 2;
+        case OperandFormat::LONG: return 4;
+        case OperandFormat::JUMP: return 3;
+        default:                  return 1;
+    }
+}
+
+// Octets de code d'un Chunk : possédés (compilation) ou empruntés à une
+// zone externe, typiquement la projection mmap d'un cache .initc, que
+// `owner` maintient en vie. Un buffer emprunté est copié à la première
+// écriture.
+class CodeBuffer {
+public:
+    CodeBuffer() = default;
+
+    void borrow(const uint8_t* bytes, size_t count, std::shared_ptr<const void> keep_alive) {
+        owned.clear();
+        borrowed = bytes;
+        borrowed_size = count;
+        owner = std::move(keep_alive);
+    }
+
+    bool is_borrowed() const { return borrowed != nullptr; }
+
+    const uint8_t* data() const { return borrowed ? borrowed : owned.data(); }
+    size_t size() const { return borrowed ? borrowed_size : owned.size(); }
+    bool empty() const { return size() == 0; }
+
+    uint8_t operator[](size_t i) const { return data()[i]; }
+    uint8_t& operator[](size_t i) { return own()[i]; }
+
+    void push_back(uint8_t byte) { own().push_back(byte); }
+    // Recopie un buffer emprunté : son adresse ne change plus ensuite
+    void make_owned() { own(); }
+
+private:
+    std::vector<uint8_t> owned;
+    const uint8_t* borrowed = nullptr;
+    size_t borrowed_size = 0;
+    std::shared_ptr<const void> owner;
+
+    std::vector<uint8_t>& own() {
+        if (borrowed) {
+            owned.assign(borrowed, borrowed + borrowed_size);
+            borrowed = nullptr;
+            borrowed_size = 0;
+            owner.reset();
+        }
+        return owned;
+    }
+};
+
+// Position source d'une instruction (base 1 ; 0 = inconnue)
+struct LinePosition {
+    int line = 0;
+    int column = 0;
+};
+
+// Table des positions d'un Chunk, indexée par offset de code. Chaque
+// changement de position ouvre une « séquence » encodée en deltas varint :
+//   varint(delta d'offset)  zigzag-varint(delta de ligne)  varint(colonne)
+// soit typiquement 3 octets par séquence. Un point de reprise toutes les
+// CHECKPOINT_INTERVAL séquences permet une recherche dichotomique, suivie
+// d'un décodage linéaire borné. La recherche n'a lieu que sur le chemin
+// d'erreur (traces, désassembleur).
+class LineTable {
+public:
+    static constexpr size_t CHECKPOINT_INTERVAL = 32;
+
+    // Position des octets à partir de `offset` (offsets croissants)
+    void add(size_t offset, int line, int column) {
+        if (runs > 0 && line == last.line && column == last.column) return;
+
+        if (runs % CHECKPOINT_INTERVAL == 0) {
+            checkpoints.push_back(Checkpoint{static_cast<uint32_t>(offset), static_cast<uint32_t>(data.size()),
+                                             LinePosition{line, column}});
+        }
+        write_varint(offset - last_offset);
+        write_varint(zigzag(static_cast<int64_t>(line) - last.line));
+        write_varint(static_cast<uint32_t>(column));
+
+        last_offset = offset;
+        last = LinePosition{line, column};
+        ++runs;
+    }
+
+    LinePosition lookup(size_t offset) const {
+        if (checkpoints.empty() || offset < checkpoints.front().offset) return LinePosition{};
+
+        // Dernier point de reprise <= offset
+        size_t lo = 0, hi = checkpoints.size();
+        while (hi - lo > 1) {
+            size_t mid = (lo + hi) / 2;
+            if (checkpoints[mid].offset <= offset) lo = mid; else hi = mid;
+        }
+
+        const Checkpoint& cp = checkpoints[lo];
+        size_t pos = cp.data_pos;
+        size_t run_offset = cp.offset;
+        LinePosition current = cp.position;
+        read_run(pos); // séquence du point de reprise, déjà connue
+
+        for (size_t i = 1; i < CHECKPOINT_INTERVAL && pos < data.size(); ++i) {
+            size_t next = pos;
+            uint64_t delta = read_varint(next);
+            if (run_offset + delta > offset) break;
+            run_offset += delta;
+            current.line += static_cast<int>(unzigzag(read_varint(next)));
+            current.column = static_cast<int>(read_varint(next));
+            pos = next;
+        }
+        return current;
+    }
+
+    size_t size() const { return runs; }
+
+    // Forme sérialisée : le flux des séquences seul, les points de reprise
+    // se reconstruisent au décodage
+    const std::vector<uint8_t>& encoded() const { return data; }
+
+    // Reprend un flux encoded() ; seuls les points de reprise sont recalculés
+    static LineTable decode(const uint8_t* bytes, size_t count) {
+        LineTable table;
+        table.data.assign(bytes, bytes + count);
+
+        size_t pos = 0, offset = 0;
+        LinePosition current;
+        while (pos < count) {
+            size_t start = pos;
+            offset += table.read_varint(pos);
+            current.line += static_cast<int>(unzigzag(table.read_varint(pos)));
+            current.column = static_cast<int>(table.read_varint(pos));
+            if (table.runs % CHECKPOINT_INTERVAL == 0) {
+                table.checkpoints.push_back(Checkpoint{static_cast<uint32_t>(offset), static_cast<uint32_t>(start), current});
+            }
+            ++table.runs;
+        }
+        table.last_offset = offset;
+        table.last = current;
+        return table;
+    }
+
+    size_t memory_bytes() const { return data.size() + checkpoints.size() * sizeof(Checkpoint); }
+
+private:
+    struct Checkpoint {
+        uint32_t offset;
+        uint32_t data_pos;
+        LinePosition position;
+    };
+
+    std::vector<uint8_t> data;
+    std::vector<Checkpoint> checkpoints;
+    size_t runs = 0;
+    size_t last_offset = 0;
+    LinePosition last;
+
+    static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+    void write_varint(uint64_t v) {
+        while (v >= 0x80) {
+            data.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(v));
+    }
+
+    uint64_t read_varint(size_t& pos) const {
+        uint64_t v = 0;
+        for (int shift = 0; pos < data.size(); shift += 7) {
+            uint8_t byte = data[pos++];
+            v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        return v;
+    }
+
+    void read_run(size_t& pos) const {
+        read_varint(pos);
+        read_varint(pos);
+        read_varint(pos);
+    }
+};
+
+// Cache en ligne d'une instruction de structure : dernière forme vue
+// (monomorphe) et indice du champ dans cette forme (OP_GET_FIELD,
+// OP_SET_FIELD) ; pour OP_BUILD_STRUCT, forme produite
+struct FieldCache {
+    const runtime::Shape* shape = nullptr;
+    uint32_t index = 0;
 };
 
 struct Chunk {
-    std::vector<uint8_t> code;
+    CodeBuffer code;
     std::vector<Value> constants;
-    std::vector<int> lines;
+    LineTable lines;
+    // Hauteur de pile maximale (au plus MAX_FRAME_SLOTS), posée par le
+    // compilateur ou le chargeur de cache ; 0 pour un Chunk écrit à la main
+    uint32_t max_stack = 0;
+    // Compteurs de quickening et caches en ligne par offset, alloués et
+    // tenus par la VM ; ni compilés ni mis en cache
+    std::vector<uint8_t> warmup;
+    std::vector<FieldCache> field_caches;
+
+    void write(uint8_t byte, int line, int column = 0) {
+        lines.add(code.size(), line, column);
+        code.push_back(byte);
+    }
+
+    void write(OpCode op, int line, int column = 0) { write(static_cast<uint8_t>(op), line, column); }
+
+    LinePosition position(size_t offset) const { return lines.lookup(offset); }
+
+    size_t add_constant(Value value) {
+        constants.push_back(value);
+        return constants.size() - 1;
+    }
+
+    uint32_t read_long(size_t offset) const {
+        return code[offset] | (code[offset + 1] << 8) | (static_cast<uint32_t>(code[offset + 2]) << 16);
+    }
+
+    uint16_t read_short(size_t offset) const {
+        return static_cast<uint16_t>(code[offset] | (code[offset + 1] << 8));
+    }
 };
+
+} // namespace compiler
+} // namespace initlang
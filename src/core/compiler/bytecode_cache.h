@@ -0,0 +1,578 @@
+// src/core/compiler/bytecode_cache.h
+#pragma once
+#include "bytecode.h"
+#include "disassembler.h"
+#include "../common/interner.h"
+#include "../lexer/source.h"
+#include "../runtime/object.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace initlang {
+namespace compiler {
+
+// Cache de bytecode compilé (.initc). Un fichier contient le script et
+// toutes ses fonctions imbriquées :
+//
+//   CacheHeader                         64 octets
+//   chaînes     : u32 longueur, octets  (noms et constantes chaînes)
+//   globales    : u32 nombre, u32 chaîne par identifiant de globale
+//   fonctions   : 5 x u32 (nom, arité, tailles), code, constantes, lignes
+//
+// Entiers en petit-boutiste. Le chargement projette le fichier (mmap) :
+// le code est emprunté tel quel par les Chunk (CodeBuffer::borrow), seules
+// les constantes sont reconstruites, les chaînes passant par Heap::intern.
+// Les opérandes de globales sont les Heap::global_id du Heap d'origine :
+// au chargement, la table des globales les relie au Heap courant. Dans un
+// Heap neuf la correspondance est l'identité et le code reste emprunté ;
+// sinon les fonctions concernées sont recopiées et corrigées. Tables des
+// lignes et constantes sont copiées : elles sont petites et les Value
+// contiennent des pointeurs.
+//
+// Le fichier est invalidé par un changement de source (empreinte et
+// taille), de format, ou du jeu d'opcodes (nombre, noms et formes
+// d'opérandes). La charge utile est protégée par une somme de contrôle et le
+// bytecode est revérifié avant d'être confié à la VM : opérandes, sauts,
+// hauteur de pile (au plus MAX_FRAME_SLOTS) et slots locaux.
+//
+// Constante : u8 étiquette, puis f64 (nombre), u32 (chaîne, fonction) ou
+// rien (null, booléens). Tout NaN est écrit sous la forme CANONICAL_NAN ;
+// un autre NaN au chargement est une corruption : en NaN-boxing, ses bits
+// pourraient désigner null, un booléen ou un pointeur d'objet.
+
+inline constexpr char CACHE_MAGIC[8] = {'I', 'N', 'I', 'T', 'C', '\r', '\n', '\x1a'};
+inline constexpr uint32_t CACHE_FORMAT_VERSION = 3;
+inline constexpr uint32_t CACHE_ENDIAN_TAG = 0x01020304;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t endian_tag;
+    uint64_t opcode_signature;
+    uint64_t source_hash;
+    uint64_t source_size;
+    uint32_t string_count;
+    uint32_t function_count;
+    uint64_t payload_size;
+    uint64_t payload_checksum;
+};
+static_assert(sizeof(CacheHeader) == 64, "CacheHeader layout must stay stable");
+
+// Empreinte du jeu d'opcodes : toute modification de l'enum OpCode change
+// la valeur et invalide les caches existants
+inline uint64_t opcode_signature() {
+    std::string description = std::to_string(OPCODE_COUNT);
+    for (size_t i = 0; i < OPCODE_COUNT; ++i) {
+        OpCode op = static_cast<OpCode>(i);
+        description += ' ';
+        description += opcode_name(op);
+        description += static_cast<char>('0' + static_cast<int>(operand_format(op)));
+    }
+    return common::Interner::hash_text(description);
+}
+
+// Empreinte de contenu, mot par mot sur quatre voies indépendantes :
+// FNV-1a (octet par octet) coûterait à lui seul un tiers du chargement
+inline uint64_t content_hash(const void* bytes, size_t size) {
+    constexpr uint64_t PRIME = 0x9E3779B97F4A7C15ull;
+    const auto* p = static_cast<const uint8_t*>(bytes);
+    uint64_t lanes[4] = {size, PRIME, ~size, PRIME * 3};
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, p + i + 8 * lane, sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * PRIME;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+    uint64_t h = lanes[0] ^ (lanes[1] * 3) ^ (lanes[2] * 5) ^ (lanes[3] * 7);
+    for (; i < size; ++i) h = (h ^ p[i]) * PRIME;
+    h ^= h >> 32;
+    h *= PRIME;
+    return h ^ (h >> 29);
+}
+
+// Clé du cache : la source et les options de compilation qui changent le
+// bytecode produit (niveau d'optimisation -O)
+inline uint64_t source_hash(std::string_view source, uint32_t options = 0) {
+    uint64_t h = content_hash(source.data(), source.size());
+    return options == 0 ? h : h ^ content_hash(&options, sizeof(options));
+}
+
+namespace cache_detail {
+
+enum class ConstantTag : uint8_t {
+    Null,
+    False,
+    True,
+    Number,
+    String,
+    Function
+};
+
+inline constexpr uint32_t NO_NAME = 0xFFFFFFFF;
+inline constexpr size_t FUNCTION_RECORD_SIZE = 5 * sizeof(uint32_t);
+inline constexpr size_t MIN_CONSTANT_SIZE = 1;
+inline constexpr uint64_t CANONICAL_NAN = 0x7ff8000000000000ull;
+
+class Writer {
+public:
+    std::string out;
+
+    void u8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+    void u32(uint32_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+    void u64(uint64_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+    void bytes(const void* p, size_t n) { out.append(static_cast<const char*>(p), n); }
+};
+
+// Lecture bornée : tout dépassement est une corruption
+class Reader {
+public:
+    Reader(const uint8_t* d, size_t n) : data(d), size(n) {}
+
+    const uint8_t* take(size_t n) {
+        if (n > size - pos) corrupt("truncated file");
+        const uint8_t* p = data + pos;
+        pos += n;
+        return p;
+    }
+
+    uint8_t u8() { return *take(1); }
+    uint32_t u32() { uint32_t v; std::memcpy(&v, take(sizeof(v)), sizeof(v)); return v; }
+    uint64_t u64() { uint64_t v; std::memcpy(&v, take(sizeof(v)), sizeof(v)); return v; }
+
+    bool done() const { return pos == size; }
+
+    [[noreturn]] static void corrupt(const std::string& what) {
+        throw std::runtime_error("Cache error: " + what);
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+};
+
+inline uint32_t read_index(const uint8_t* code, size_t offset, OpCode op) {
+    return operand_format(op) == OperandFormat::LONG
+        ? code[offset + 1] | (code[offset + 2] << 8) | (static_cast<uint32_t>(code[offset + 3]) << 16)
+        : code[offset + 1];
+}
+
+// Cible d'un saut (offset suivant le saut, plus ou moins le déplacement)
+inline size_t jump_target(const uint8_t* code, size_t offset, OpCode op) {
+    uint16_t jump = static_cast<uint16_t>(code[offset + 1] | (code[offset + 2] << 8));
+    size_t next = offset + instruction_size(op);
+    return op == OpCode::OP_LOOP ? next - jump : next + jump;
+}
+
+// Instruction après laquelle l'exécution ne passe pas à la suivante
+inline bool ends_flow(OpCode op) {
+    return op == OpCode::OP_RETURN || op == OpCode::OP_RETURN_LOCAL || op == OpCode::OP_TAIL_CALL ||
+           op == OpCode::OP_JUMP || op == OpCode::OP_LOOP;
+}
+
+inline bool has_local_operand(OpCode op) {
+    return op == OpCode::OP_GET_LOCAL || op == OpCode::OP_SET_LOCAL || op == OpCode::OP_SET_LOCAL_POP ||
+           op == OpCode::OP_RETURN_LOCAL;
+}
+
+// Numérotation préfixe des fonctions (le script vaut 0, une fonction
+// imbriquée a toujours un numéro supérieur à celui qui la référence) et
+// table des chaînes dédupliquée
+struct Layout {
+    std::vector<const runtime::ObjFunction*> functions;
+    std::unordered_map<const runtime::ObjFunction*, uint32_t> function_ids;
+    std::vector<const runtime::ObjString*> strings;
+    std::unordered_map<const runtime::ObjString*, uint32_t> string_ids;
+    uint32_t global_limit = 0; // 1 + plus grand identifiant de globale utilisé
+
+    uint32_t string_id(const runtime::ObjString* s) {
+        auto [it, inserted] = string_ids.emplace(s, static_cast<uint32_t>(strings.size()));
+        if (inserted) strings.push_back(s);
+        return it->second;
+    }
+
+    void visit(const runtime::ObjFunction* function) {
+        function_ids.emplace(function, static_cast<uint32_t>(functions.size()));
+        functions.push_back(function);
+        if (function->name) string_id(function->name);
+
+        const Chunk& chunk = function->chunk;
+        for (size_t offset = 0; offset < chunk.code.size(); offset += instruction_size(OpCode(chunk.code[offset]))) {
+            OpCode op = static_cast<OpCode>(chunk.code[offset]);
+            if (has_global_operand(op)) global_limit = std::max(global_limit, read_index(chunk.code.data(), offset, op) + 1);
+        }
+
+        for (Value constant : function->chunk.constants) {
+            if (runtime::is_string(constant)) {
+                string_id(runtime::as_string(constant));
+            } else if (runtime::is_function(constant)) {
+                if (function_ids.count(runtime::as_function(constant))) {
+                    throw std::logic_error("bytecode cache: function graph is not a tree");
+                }
+                visit(runtime::as_function(constant));
+            }
+        }
+    }
+};
+
+// Contrôle du bytecode chargé : la VM ne revérifie rien à l'exécution.
+// `entry_depth` est la hauteur de la fenêtre à l'entrée (appelé et
+// arguments). Renvoie la hauteur de pile maximale (Chunk::max_stack).
+inline size_t verify_code(const uint8_t* code, size_t size, const std::vector<Value>& constants, size_t globals,
+                        size_t entry_depth) {
+    if (size == 0) Reader::corrupt("empty function");
+
+    // Premier passage : débuts d'instruction et sauts ; cibles vérifiées
+    // ensuite, un saut avant pouvant viser une instruction pas encore lue
+    std::vector<bool> starts(size, false);
+    std::vector<size_t> targets;
+    size_t offset = 0;
+    OpCode last = OpCode::OP_RETURN;
+    while (offset < size) {
+        if (code[offset] >= OPCODE_COUNT) Reader::corrupt("unknown opcode");
+        last = static_cast<OpCode>(code[offset]);
+        size_t length = instruction_size(last);
+        if (length > size - offset) Reader::corrupt("truncated instruction");
+        starts[offset] = true;
+
+        if (has_constant_operand(last)) {
+            size_t index = read_index(code, offset, last);
+            if (index >= constants.size()) Reader::corrupt("constant index out of range");
+            if ((last == OpCode::OP_GET_FIELD || last == OpCode::OP_SET_FIELD) && !runtime::is_string(constants[index])) {
+                Reader::corrupt("field name is not a string");
+            }
+        } else if (has_global_operand(last)) {
+            if (read_index(code, offset, last) >= globals) Reader::corrupt("global index out of range");
+        } else if (operand_format(last) == OperandFormat::JUMP) {
+            uint16_t jump = static_cast<uint16_t>(code[offset + 1] | (code[offset + 2] << 8));
+            size_t next = offset + length;
+            if (last == OpCode::OP_LOOP ? jump > next : jump >= size - next) Reader::corrupt("jump out of range");
+            targets.push_back(jump_target(code, offset, last));
+        }
+        offset += length;
+    }
+    for (size_t target : targets) {
+        if (!starts[target]) Reader::corrupt("jump into the middle of an instruction");
+    }
+    // Le code ne doit pas pouvoir se poursuivre au-delà de la fin
+    if (!ends_flow(last)) Reader::corrupt("code runs past the end of the function");
+
+    // Second passage, sur les chemins d'exécution : hauteur de pile de
+    // chaque instruction atteignable, la même quel que soit le chemin. Une
+    // instruction ne dépile que ce qui a été empilé dans la trame et ne lit
+    // ou n'écrit que des slots déjà empilés : la VM ne voit jamais une case
+    // non initialisée de la pile, et la hauteur reste dans la fenêtre que
+    // la VM garantit à une trame (MAX_FRAME_SLOTS).
+    constexpr size_t UNVISITED = SIZE_MAX;
+    size_t peak = entry_depth;
+    std::vector<size_t> depths(size, UNVISITED);
+    std::vector<size_t> pending{0};
+    depths[0] = entry_depth;
+    auto reach = [&](size_t target, size_t depth) {
+        if (depths[target] == UNVISITED) {
+            depths[target] = depth;
+            pending.push_back(target);
+        } else if (depths[target] != depth) {
+            Reader::corrupt("inconsistent stack depth");
+        }
+    };
+    while (!pending.empty()) {
+        offset = pending.back();
+        pending.pop_back();
+        OpCode op = static_cast<OpCode>(code[offset]);
+        size_t depth = depths[offset];
+
+        StackEffect effect = stack_effect(op, operand_format(op) == OperandFormat::BYTE ? code[offset + 1] : 0);
+        if (effect.pops > depth) Reader::corrupt("stack underflow");
+        depth = depth - effect.pops + effect.pushes;
+        if (depth > MAX_FRAME_SLOTS) Reader::corrupt("stack too deep");
+        peak = std::max(peak, depth);
+        // OP_SET_LOCAL_POP écrit après avoir dépilé
+        if (has_local_operand(op) && code[offset + 1] >= (op == OpCode::OP_SET_LOCAL_POP ? depth : depths[offset])) {
+            Reader::corrupt("local slot out of range");
+        }
+
+        if (operand_format(op) == OperandFormat::JUMP) reach(jump_target(code, offset, op), depth);
+        if (!ends_flow(op)) reach(offset + instruction_size(op), depth);
+    }
+    return peak;
+}
+
+// Réécrit les opérandes de globales selon `link` (le code est alors
+// recopié). false si un nouvel identifiant ne tient plus dans un opérande
+// d'un octet : le cache ne peut pas servir dans ce Heap.
+inline bool relink(Chunk& chunk, const std::vector<uint32_t>& link) {
+    const Chunk& view = chunk; // lecture sans déclencher la copie
+    for (size_t offset = 0; offset < view.code.size(); offset += instruction_size(OpCode(view.code[offset]))) {
+        OpCode op = static_cast<OpCode>(view.code[offset]);
+        if (!has_global_operand(op)) continue;
+
+        uint32_t id = link[read_index(view.code.data(), offset, op)];
+        if (id == read_index(view.code.data(), offset, op)) continue;
+        if (operand_format(op) == OperandFormat::BYTE) {
+            if (id > 0xFF) return false;
+            chunk.code[offset + 1] = static_cast<uint8_t>(id);
+        } else {
+            chunk.code[offset + 1] = static_cast<uint8_t>(id & 0xFF);
+            chunk.code[offset + 2] = static_cast<uint8_t>((id >> 8) & 0xFF);
+            chunk.code[offset + 3] = static_cast<uint8_t>((id >> 16) & 0xFF);
+        }
+    }
+    return true;
+}
+
+} // namespace cache_detail
+
+// Image .initc du script et de ses fonctions ; `heap` fournit les noms des
+// globales
+inline std::string serialize_cache(const runtime::Heap& heap, const runtime::ObjFunction& script,
+                                   std::string_view source, uint32_t options = 0) {
+    using namespace cache_detail;
+
+    Layout layout;
+    layout.visit(&script);
+    std::vector<uint32_t> global_names;
+    for (uint32_t id = 0; id < layout.global_limit; ++id) {
+        global_names.push_back(layout.string_id(heap.global_name(id)));
+    }
+
+    Writer w;
+    for (const runtime::ObjString* s : layout.strings) {
+        w.u32(s->length);
+        w.bytes(s->chars(), s->length);
+    }
+    w.u32(static_cast<uint32_t>(global_names.size()));
+    for (uint32_t name : global_names) w.u32(name);
+
+    for (const runtime::ObjFunction* function : layout.functions) {
+        const Chunk& chunk = function->chunk;
+        const std::vector<uint8_t>& lines = chunk.lines.encoded();
+        w.u32(function->name ? layout.string_ids.at(function->name) : NO_NAME);
+        w.u32(static_cast<uint32_t>(function->arity));
+        w.u32(static_cast<uint32_t>(chunk.code.size()));
+        w.u32(static_cast<uint32_t>(chunk.constants.size()));
+        w.u32(static_cast<uint32_t>(lines.size()));
+
+        w.bytes(chunk.code.data(), chunk.code.size());
+        for (Value constant : chunk.constants) {
+            switch (constant.type()) {
+                case runtime::ValueType::Null:
+                    w.u8(static_cast<uint8_t>(ConstantTag::Null));
+                    break;
+                case runtime::ValueType::Bool:
+                    w.u8(static_cast<uint8_t>(constant.as_bool() ? ConstantTag::True : ConstantTag::False));
+                    break;
+                case runtime::ValueType::Number: {
+                    double number = constant.as_number();
+                    uint64_t bits;
+                    std::memcpy(&bits, &number, sizeof(bits));
+                    if (number != number) bits = CANONICAL_NAN;
+                    w.u8(static_cast<uint8_t>(ConstantTag::Number));
+                    w.u64(bits);
+                    break;
+                }
+                case runtime::ValueType::Object:
+                    if (runtime::is_string(constant)) {
+                        w.u8(static_cast<uint8_t>(ConstantTag::String));
+                        w.u32(layout.string_ids.at(runtime::as_string(constant)));
+                    } else if (runtime::is_function(constant)) {
+                        w.u8(static_cast<uint8_t>(ConstantTag::Function));
+                        w.u32(layout.function_ids.at(runtime::as_function(constant)));
+                    } else {
+                        throw std::logic_error("bytecode cache: unsupported constant type");
+                    }
+                    break;
+            }
+        }
+        w.bytes(lines.data(), lines.size());
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.format_version = CACHE_FORMAT_VERSION;
+    header.endian_tag = CACHE_ENDIAN_TAG;
+    header.opcode_signature = opcode_signature();
+    header.source_hash = source_hash(source, options);
+    header.source_size = source.size();
+    header.string_count = static_cast<uint32_t>(layout.strings.size());
+    header.function_count = static_cast<uint32_t>(layout.functions.size());
+    header.payload_size = w.out.size();
+    header.payload_checksum = content_hash(w.out.data(), w.out.size());
+
+    std::string image(reinterpret_cast<const char*>(&header), sizeof(header));
+    image += w.out;
+    return image;
+}
+
+// Charge une image .initc. Renvoie nullptr si elle ne correspond pas à
+// `source` et `options`, ou à ce binaire (cache périmé) ; lève
+// std::runtime_error si elle est corrompue. Le code des fonctions reste
+// dans `data`, que `owner` doit maintenir en vie.
+inline runtime::ObjFunction* load_cache(runtime::Heap& heap, const uint8_t* data, size_t size,
+                                        std::string_view source, std::shared_ptr<const void> owner,
+                                        uint32_t options = 0) {
+    using namespace cache_detail;
+
+    CacheHeader header;
+    if (size < sizeof(header)) Reader::corrupt("truncated header");
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0) Reader::corrupt("bad magic");
+
+    if (header.format_version != CACHE_FORMAT_VERSION || header.endian_tag != CACHE_ENDIAN_TAG ||
+        header.opcode_signature != opcode_signature() || header.source_size != source.size() ||
+        header.source_hash != source_hash(source, options)) {
+        return nullptr;
+    }
+
+    const uint8_t* payload = data + sizeof(header);
+    if (header.payload_size != size - sizeof(header)) Reader::corrupt("payload size mismatch");
+    if (content_hash(payload, header.payload_size) != header.payload_checksum) Reader::corrupt("checksum mismatch");
+
+    if (header.function_count == 0 || header.function_count > header.payload_size / FUNCTION_RECORD_SIZE ||
+        header.string_count > header.payload_size / sizeof(uint32_t)) {
+        Reader::corrupt("bad section counts");
+    }
+    Reader r(payload, header.payload_size);
+
+    std::vector<runtime::ObjString*> strings;
+    strings.reserve(header.string_count);
+    heap.reserve_strings(header.string_count);
+    for (uint32_t i = 0; i < header.string_count; ++i) {
+        uint32_t length = r.u32();
+        strings.push_back(heap.intern(std::string_view(reinterpret_cast<const char*>(r.take(length)), length)));
+    }
+
+    // Édition de liens des globales : identifiant du fichier -> du Heap
+    uint32_t global_count = r.u32();
+    if (global_count > header.payload_size / sizeof(uint32_t)) Reader::corrupt("bad global count");
+    std::vector<uint32_t> link(global_count);
+    bool identity = true;
+    for (uint32_t i = 0; i < global_count; ++i) {
+        uint32_t name = r.u32();
+        if (name >= strings.size()) Reader::corrupt("global name out of range");
+        link[i] = heap.global_id(strings[name]);
+        identity = identity && link[i] == i;
+    }
+
+    std::vector<runtime::ObjFunction*> functions(header.function_count);
+    for (auto& function : functions) function = heap.new_function();
+
+    for (uint32_t id = 0; id < header.function_count; ++id) {
+        runtime::ObjFunction* function = functions[id];
+        uint32_t name = r.u32();
+        uint32_t arity = r.u32();
+        uint32_t code_size = r.u32();
+        uint32_t constant_count = r.u32();
+        uint32_t line_bytes = r.u32();
+
+        if (name != NO_NAME) {
+            if (name >= strings.size()) Reader::corrupt("function name out of range");
+            function->name = strings[name];
+        }
+        if (arity > 255) Reader::corrupt("bad arity");
+        function->arity = static_cast<int>(arity);
+
+        const uint8_t* code = r.take(code_size);
+
+        Chunk& chunk = function->chunk;
+        if (constant_count > header.payload_size / MIN_CONSTANT_SIZE) Reader::corrupt("bad constant count");
+        chunk.constants.reserve(constant_count);
+        for (uint32_t i = 0; i < constant_count; ++i) {
+            switch (static_cast<ConstantTag>(r.u8())) {
+                case ConstantTag::Null:  chunk.constants.push_back(Value::null()); break;
+                case ConstantTag::False: chunk.constants.push_back(Value::boolean(false)); break;
+                case ConstantTag::True:  chunk.constants.push_back(Value::boolean(true)); break;
+                case ConstantTag::Number: {
+                    uint64_t bits = r.u64();
+                    double number;
+                    std::memcpy(&number, &bits, sizeof(number));
+                    if (number != number && bits != CANONICAL_NAN) Reader::corrupt("bad number constant");
+                    chunk.constants.push_back(Value::number(number));
+                    break;
+                }
+                case ConstantTag::String: {
+                    uint32_t index = r.u32();
+                    if (index >= strings.size()) Reader::corrupt("string constant out of range");
+                    chunk.constants.push_back(Value::object(strings[index]));
+                    break;
+                }
+                case ConstantTag::Function: {
+                    // Numérotation préfixe : ni cycle ni partage possible
+                    uint32_t index = r.u32();
+                    if (index <= id || index >= functions.size()) Reader::corrupt("function constant out of range");
+                    chunk.constants.push_back(Value::object(functions[index]));
+                    break;
+                }
+                default:
+                    Reader::corrupt("unknown constant tag");
+            }
+        }
+
+        chunk.lines = LineTable::decode(r.take(line_bytes), line_bytes);
+
+        chunk.max_stack = static_cast<uint32_t>(verify_code(code, code_size, chunk.constants, link.size(), arity + 1));
+        chunk.code.borrow(code, code_size, owner);
+        if (!identity && !relink(chunk, link)) return nullptr;
+    }
+    if (!r.done()) Reader::corrupt("trailing bytes");
+
+    return functions[0];
+}
+
+// Chemin du cache associé à un script : « x.init » -> « x.initc »,
+// sinon suffixe « .initc »
+inline std::string cache_path_for(const std::string& script_path) {
+    std::string_view ext = ".init";
+    bool has_ext = script_path.size() >= ext.size() &&
+                   script_path.compare(script_path.size() - ext.size(), ext.size(), ext) == 0;
+    return has_ext ? script_path + "c" : script_path + ".initc";
+}
+
+// Charge `path` par projection mémoire. nullptr si le fichier n'existe pas
+// ou est périmé ; lève std::runtime_error s'il est corrompu.
+inline runtime::ObjFunction* load_cache_file(runtime::Heap& heap, const std::string& path, std::string_view source,
+                                             uint32_t options = 0) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return nullptr;
+
+    auto mapping = std::make_shared<lexer::SourceBuffer>(lexer::SourceBuffer::map_file(path));
+    return load_cache(heap, reinterpret_cast<const uint8_t*>(mapping->data()), mapping->size(), source,
+                      std::shared_ptr<const void>(mapping, mapping->data()), options);
+}
+
+// Écriture atomique (fichier temporaire puis rename) : un lecteur
+// concurrent voit l'ancien cache ou le nouveau, jamais un fichier partiel
+inline void write_cache_file(const std::string& path, const runtime::Heap& heap, const runtime::ObjFunction& script,
+                             std::string_view source, uint32_t options = 0) {
+    std::string image = serialize_cache(heap, script, source, options);
+    std::string temp = path + ".tmp" + std::to_string(::getpid());
+
+    std::FILE* out = std::fopen(temp.c_str(), "wb");
+    if (!out) {
+        throw std::runtime_error("Cannot write '" + temp + "': " + std::strerror(errno));
+    }
+    bool ok = std::fwrite(image.data(), 1, image.size(), out) == image.size();
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        int err = errno;
+        std::remove(temp.c_str());
+        throw std::runtime_error("Cannot write '" + path + "': " + std::strerror(err));
+    }
+}
+
+} // namespace compiler
+} // namespace initlang
@@ -0,0 +1,402 @@
+// src/core/compiler/compiler.h
+#pragma once
+#include "bytecode.h"
+#include "resolver.h"
+#include "../ast/ast.h"
+#include "../runtime/object.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace initlang {
+namespace compiler {
+
+// Compilateur AST -> bytecode. Chaque FunctionDeclaration devient une
+// ObjFunction avec son propre Chunk ; le script de premier niveau est
+// lui-même une fonction sans nom ni paramètre.
+//
+// Les portées sont calculées par le Resolver, lancé en tête de compile() :
+// au premier niveau, `let` et `fi` définissent des globales, désignées
+// par leur identifiant dense Heap::global_id (OP_DEFINE_GLOBAL) ;
+// ailleurs, des locales dont le slot est fixé à la compilation
+// (OP_GET_LOCAL/OP_SET_LOCAL). Le slot 0 d'une fonction est réservé à
+// l'appelé, les paramètres occupent les slots 1..n.
+//
+// La hauteur de pile de chaque fonction est suivie à l'émission (le code
+// produit ne contient pas de saut) : son maximum est rangé dans
+// Chunk::max_stack, et une fonction qui dépasserait MAX_FRAME_SLOTS
+// (appels ou init.ger imbriqués) est une erreur de compilation.
+class Compiler {
+public:
+    // Limites de l'encodage
+    static constexpr size_t MAX_ARGUMENTS = 255;
+    static constexpr size_t MAX_CONSTANTS = 1u << 24;
+    static constexpr size_t MAX_GLOBALS = 1u << 24;
+
+    explicit Compiler(runtime::Heap& h) : heap(h) {}
+
+    // Renvoie la fonction du script. Ses objets (chaînes, fonctions
+    // imbriquées) appartiennent au Heap.
+    runtime::ObjFunction* compile(ast::Program& program) {
+        Resolver(program).resolve();
+        global_ids.clear(); // SymbolId propres à l'Interner du programme
+
+        // find() et non intern() : l'Interner peut être gelé
+        init_ger = program.symbols->find("init.ger");
+        init_log = program.symbols->find("init.log");
+
+        FunctionState script(heap.new_function(), nullptr);
+        current = &script;
+
+        for (const ast::Statement* stmt : program.statements) {
+            compile_statement(stmt);
+        }
+        emit(OpCode::OP_NULL);
+        emit(OpCode::OP_RETURN);
+
+        current = nullptr;
+        return script.function;
+    }
+
+    // Octets de bytecode émis depuis la construction (toutes fonctions)
+    size_t bytes_emitted() const { return emitted; }
+
+private:
+    struct FunctionState {
+        runtime::ObjFunction* function;
+        FunctionState* enclosing;
+
+        // Constantes déjà posées dans le Chunk : une entrée par symbole ou
+        // par nombre (clé = motif binaire du double)
+        std::unordered_map<common::SymbolId, uint32_t, common::SymbolIdHash> symbol_constants;
+        std::unordered_map<uint64_t, uint32_t> number_constants;
+
+        // Hauteur de pile courante : appelé et paramètres à l'entrée
+        size_t height;
+
+        FunctionState(runtime::ObjFunction* f, FunctionState* e)
+            : function(f), enclosing(e), height(static_cast<size_t>(f->arity) + 1) {
+            f->chunk.max_stack = static_cast<uint32_t>(height);
+        }
+    };
+
+    runtime::Heap& heap;
+    FunctionState* current = nullptr;
+    // Identifiants de globales (Heap::global_id) déjà attribués, par symbole
+    std::unordered_map<common::SymbolId, uint32_t, common::SymbolIdHash> global_ids;
+    common::SymbolId init_ger;
+    common::SymbolId init_log;
+    ast::SourceLocation position; // nœud en cours, attribué aux octets émis
+    size_t emitted = 0;
+
+    [[noreturn]] void error(const std::string& message) {
+        std::string where;
+        if (position.line > 0) {
+            where = "[line " + std::to_string(position.line) + ":" + std::to_string(position.column) + "] ";
+        }
+        throw std::runtime_error("Compile error: " + where + message);
+    }
+
+    Chunk& chunk() { return current->function->chunk; }
+
+    void emit(uint8_t byte) {
+        chunk().write(byte, position.line, position.column);
+        ++emitted;
+    }
+
+    void emit(OpCode op) {
+        emit(static_cast<uint8_t>(op));
+        track_height(op, 0);
+    }
+
+    void emit(OpCode op, uint8_t operand) {
+        emit(static_cast<uint8_t>(op));
+        emit(operand);
+        track_height(op, operand);
+    }
+
+    void track_height(OpCode op, size_t operand) {
+        StackEffect effect = stack_effect(op, operand);
+        current->height = current->height - effect.pops + effect.pushes;
+        if (current->height > chunk().max_stack) {
+            if (current->height > MAX_FRAME_SLOTS) error("expression too deep");
+            chunk().max_stack = static_cast<uint32_t>(current->height);
+        }
+    }
+
+    // Opérande d'un octet si possible, sinon variante _LONG sur 3 octets
+    void emit_indexed(OpCode short_op, OpCode long_op, uint32_t index) {
+        if (index < 256) {
+            emit(short_op, static_cast<uint8_t>(index));
+            return;
+        }
+        emit(long_op);
+        emit(static_cast<uint8_t>(index & 0xFF));
+        emit(static_cast<uint8_t>((index >> 8) & 0xFF));
+        emit(static_cast<uint8_t>((index >> 16) & 0xFF));
+    }
+
+    uint32_t make_constant(Value value) {
+        if (chunk().constants.size() >= MAX_CONSTANTS) {
+            error("too many constants in one chunk");
+        }
+        return static_cast<uint32_t>(chunk().add_constant(value));
+    }
+
+    // Chaîne constante, dédupliquée par SymbolId
+    uint32_t symbol_constant(common::Symbol symbol) {
+        auto it = current->symbol_constants.find(symbol.id);
+        if (it != current->symbol_constants.end()) return it->second;
+
+        uint32_t index = make_constant(Value::object(heap.intern(symbol.text)));
+        current->symbol_constants.emplace(symbol.id, index);
+        return index;
+    }
+
+    uint32_t number_constant(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        auto it = current->number_constants.find(bits);
+        if (it != current->number_constants.end()) return it->second;
+
+        uint32_t index = make_constant(Value::number(value));
+        current->number_constants.emplace(bits, index);
+        return index;
+    }
+
+    uint32_t global_id(common::Symbol name) {
+        auto it = global_ids.find(name.id);
+        if (it != global_ids.end()) return it->second;
+
+        uint32_t id = heap.global_id(heap.intern(name.text));
+        if (id >= MAX_GLOBALS) error("too many global variables");
+        global_ids.emplace(name.id, id);
+        return id;
+    }
+
+    void emit_constant(uint32_t index) {
+        emit_indexed(OpCode::OP_CONSTANT, OpCode::OP_CONSTANT_LONG, index);
+    }
+
+    // Position courante le temps de compiler un nœud ; un nœud sans
+    // position (AST construit à la main) garde celle de son parent.
+    class PositionScope {
+    public:
+        PositionScope(Compiler& c, const ast::ASTNode* node) : compiler(c), saved(c.position) {
+            if (node->location.line > 0) c.position = node->location;
+        }
+        ~PositionScope() { compiler.position = saved; }
+
+    private:
+        Compiler& compiler;
+        ast::SourceLocation saved;
+    };
+
+    // ----- Instructions -----
+
+    void compile_statement(const ast::Statement* stmt) {
+        PositionScope at(*this, stmt);
+        switch (stmt->kind) {
+            case ast::NodeKind::ExpressionStatement:
+                compile_expression(static_cast<const ast::ExpressionStatement*>(stmt)->expression);
+                emit(OpCode::OP_POP);
+                break;
+            case ast::NodeKind::VariableDeclaration:
+                compile_variable(static_cast<const ast::VariableDeclaration*>(stmt));
+                break;
+            case ast::NodeKind::FunctionDeclaration:
+                compile_function_declaration(static_cast<const ast::FunctionDeclaration*>(stmt));
+                break;
+            case ast::NodeKind::BlockStatement: {
+                auto* block = static_cast<const ast::BlockStatement*>(stmt);
+                for (const ast::Statement* inner : block->statements) compile_statement(inner);
+                // Les locales du bloc occupent le haut de la pile
+                for (uint16_t i = 0; i < block->local_count; ++i) emit(OpCode::OP_POP);
+                break;
+            }
+            case ast::NodeKind::ReturnStatement:
+                compile_return(static_cast<const ast::ReturnStatement*>(stmt));
+                break;
+            default:
+                error("unexpected statement node");
+        }
+    }
+
+    void compile_variable(const ast::VariableDeclaration* decl) {
+        // Valeur d'abord : `let x ==> x` lit le x englobant
+        if (decl->value) {
+            compile_expression(decl->value);
+        } else {
+            emit(OpCode::OP_NULL);
+        }
+
+        // Locale : la valeur reste dans son slot
+        if (decl->resolved.binding == ast::Binding::Global) {
+            emit_indexed(OpCode::OP_DEFINE_GLOBAL, OpCode::OP_DEFINE_GLOBAL_LONG, global_id(decl->name));
+        }
+    }
+
+    void compile_function_declaration(const ast::FunctionDeclaration* decl) {
+        runtime::ObjFunction* function = compile_function(decl);
+        emit_constant(make_constant(Value::object(function)));
+
+        if (decl->resolved.binding == ast::Binding::Global) {
+            emit_indexed(OpCode::OP_DEFINE_GLOBAL, OpCode::OP_DEFINE_GLOBAL_LONG, global_id(decl->name));
+        }
+    }
+
+    runtime::ObjFunction* compile_function(const ast::FunctionDeclaration* decl) {
+        if (decl->parameters.size() > MAX_ARGUMENTS) {
+            error("function '" + std::string(decl->name.text) + "' has too many parameters");
+        }
+
+        runtime::ObjFunction* function = heap.new_function();
+        function->name = heap.intern(decl->name.text);
+        function->arity = static_cast<int>(decl->parameters.size());
+        FunctionState state(function, current);
+        current = &state;
+
+        if (decl->body) {
+            for (const ast::Statement* stmt : decl->body->statements) compile_statement(stmt);
+        }
+        emit(OpCode::OP_NULL);
+        emit(OpCode::OP_RETURN);
+
+        // Pas de POP des locales : OP_RETURN abandonne toute la fenêtre de pile
+        current = state.enclosing;
+        return state.function;
+    }
+
+    void compile_return(const ast::ReturnStatement* ret) {
+        if (current->enclosing == nullptr) {
+            error("'return' outside of a function");
+        }
+        // `return f(...)` : appel terminal, la trame est réutilisée
+        auto* call = ret->value ? ast::node_cast<ast::CallExpression>(ret->value) : nullptr;
+        if (call && !is_builtin_call(call)) {
+            PositionScope at(*this, call);
+            compile_call(call, OpCode::OP_TAIL_CALL);
+            return;
+        }
+
+        if (ret->value) {
+            compile_expression(ret->value);
+        } else {
+            emit(OpCode::OP_NULL);
+        }
+        emit(OpCode::OP_RETURN);
+    }
+
+    // ----- Expressions -----
+
+    void compile_expression(const ast::Expression* expr) {
+        PositionScope at(*this, expr);
+        switch (expr->kind) {
+            case ast::NodeKind::NumberLiteral:
+                emit_constant(number_constant(static_cast<const ast::NumberLiteral*>(expr)->value));
+                break;
+            case ast::NodeKind::StringLiteral:
+                emit_constant(symbol_constant(static_cast<const ast::StringLiteral*>(expr)->value));
+                break;
+            case ast::NodeKind::Identifier:
+                compile_identifier(static_cast<const ast::Identifier*>(expr));
+                break;
+            case ast::NodeKind::BinaryExpression:
+                compile_binary(static_cast<const ast::BinaryExpression*>(expr));
+                break;
+            case ast::NodeKind::CallExpression:
+                compile_call(static_cast<const ast::CallExpression*>(expr));
+                break;
+            case ast::NodeKind::SpawnExpression:
+                compile_spawn(static_cast<const ast::SpawnExpression*>(expr));
+                break;
+            case ast::NodeKind::AwaitExpression:
+                compile_expression(static_cast<const ast::AwaitExpression*>(expr)->value);
+                emit(OpCode::OP_AWAIT);
+                break;
+            default:
+                error("unexpected expression node");
+        }
+    }
+
+    bool is_builtin(common::SymbolId id) const {
+        return id.valid() && (id == init_ger || id == init_log);
+    }
+
+    void compile_identifier(const ast::Identifier* ident) {
+        switch (ident->resolved.binding) {
+            case ast::Binding::Local:
+                emit(OpCode::OP_GET_LOCAL, static_cast<uint8_t>(ident->resolved.index));
+                break;
+            case ast::Binding::Upvalue:
+                error("cannot capture local '" + std::string(ident->name.text) + "' of an enclosing function");
+            case ast::Binding::Global:
+                if (is_builtin(ident->name.id)) {
+                    error("'" + std::string(ident->name.text) + "' must be called");
+                }
+                emit_indexed(OpCode::OP_GET_GLOBAL, OpCode::OP_GET_GLOBAL_LONG, global_id(ident->name));
+                break;
+            case ast::Binding::Unresolved:
+                error("unresolved identifier '" + std::string(ident->name.text) + "'");
+        }
+    }
+
+    void compile_binary(const ast::BinaryExpression* bin) {
+        compile_expression(bin->left);
+        compile_expression(bin->right);
+
+        switch (bin->op) {
+            case lexer::TokenType::PLUS:  emit(OpCode::OP_ADD); break;
+            case lexer::TokenType::MINUS: emit(OpCode::OP_SUBTRACT); break;
+            case lexer::TokenType::STAR:  emit(OpCode::OP_MULTIPLY); break;
+            case lexer::TokenType::SLASH: emit(OpCode::OP_DIVIDE); break;
+            case lexer::TokenType::EQ:    emit(OpCode::OP_EQUAL); break;
+            case lexer::TokenType::NEQ:   emit(OpCode::OP_NOT_EQUAL); break;
+            case lexer::TokenType::LT:    emit(OpCode::OP_LESS); break;
+            case lexer::TokenType::GT:    emit(OpCode::OP_GREATER); break;
+            case lexer::TokenType::LTE:   emit(OpCode::OP_LESS_EQUAL); break;
+            case lexer::TokenType::GTE:   emit(OpCode::OP_GREATER_EQUAL); break;
+            default:
+                error("unsupported binary operator");
+        }
+    }
+
+    bool is_builtin_call(const ast::CallExpression* call) const {
+        auto* callee = ast::node_cast<ast::Identifier>(call->callee);
+        return callee && is_builtin(callee->name.id);
+    }
+
+    void compile_call(const ast::CallExpression* call, OpCode op = OpCode::OP_CALL) {
+        if (call->arguments.size() > MAX_ARGUMENTS) {
+            error("too many arguments in call");
+        }
+        uint8_t argc = static_cast<uint8_t>(call->arguments.size());
+
+        // init.ger(...) / init.log(...) : opcodes dédiés, sans appelé sur la pile
+        auto* callee = ast::node_cast<ast::Identifier>(call->callee);
+        if (is_builtin_call(call)) {
+            for (const ast::Expression* arg : call->arguments) compile_expression(arg);
+            emit(callee->name.id == init_ger ? OpCode::OP_INIT_GER : OpCode::OP_INIT_LOG, argc);
+            return;
+        }
+
+        compile_expression(call->callee);
+        for (const ast::Expression* arg : call->arguments) compile_expression(arg);
+        emit(op, argc);
+    }
+
+    // Appelé et arguments évalués ici, l'appel lui-même dans la tâche
+    void compile_spawn(const ast::SpawnExpression* spawn) {
+        if (is_builtin_call(spawn->call)) {
+            auto* callee = static_cast<const ast::Identifier*>(spawn->call->callee);
+            error("'" + std::string(callee->name.text) + "' cannot be spawned");
+        }
+        PositionScope at(*this, spawn->call);
+        compile_call(spawn->call, OpCode::OP_SPAWN);
+    }
+};
+
+} // namespace compiler
+} // namespace initlang
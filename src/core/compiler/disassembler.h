@@ -0,0 +1,189 @@
+// src/core/compiler/disassembler.h
+#pragma once
+#include "bytecode.h"
+#include "../runtime/object.h"
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace initlang {
+namespace compiler {
+
+inline const char* opcode_name(OpCode op) {
+    switch (op) {
+        case OpCode::OP_CONSTANT:           return "OP_CONSTANT";
+        case OpCode::OP_NULL:               return "OP_NULL";
+        case OpCode::OP_TRUE:               return "OP_TRUE";
+        case OpCode::OP_FALSE:              return "OP_FALSE";
+        case OpCode::OP_DEFINE_GLOBAL:      return "OP_DEFINE_GLOBAL";
+        case OpCode::OP_GET_GLOBAL:         return "OP_GET_GLOBAL";
+        case OpCode::OP_SET_GLOBAL:         return "OP_SET_GLOBAL";
+        case OpCode::OP_GET_LOCAL:          return "OP_GET_LOCAL";
+        case OpCode::OP_SET_LOCAL:          return "OP_SET_LOCAL";
+        case OpCode::OP_ADD:                return "OP_ADD";
+        case OpCode::OP_SUBTRACT:           return "OP_SUBTRACT";
+        case OpCode::OP_MULTIPLY:           return "OP_MULTIPLY";
+        case OpCode::OP_DIVIDE:             return "OP_DIVIDE";
+        case OpCode::OP_NEGATE:             return "OP_NEGATE";
+        case OpCode::OP_NOT:                return "OP_NOT";
+        case OpCode::OP_EQUAL:              return "OP_EQUAL";
+        case OpCode::OP_NOT_EQUAL:          return "OP_NOT_EQUAL";
+        case OpCode::OP_GREATER:            return "OP_GREATER";
+        case OpCode::OP_LESS:               return "OP_LESS";
+        case OpCode::OP_GREATER_EQUAL:      return "OP_GREATER_EQUAL";
+        case OpCode::OP_LESS_EQUAL:         return "OP_LESS_EQUAL";
+        case OpCode::OP_JUMP:               return "OP_JUMP";
+        case OpCode::OP_JUMP_IF_FALSE:      return "OP_JUMP_IF_FALSE";
+        case OpCode::OP_LOOP:               return "OP_LOOP";
+        case OpCode::OP_CALL:               return "OP_CALL";
+        case OpCode::OP_TAIL_CALL:          return "OP_TAIL_CALL";
+        case OpCode::OP_RETURN:             return "OP_RETURN";
+        case OpCode::OP_BUILD_LIST:         return "OP_BUILD_LIST";
+        case OpCode::OP_BUILD_STRUCT:       return "OP_BUILD_STRUCT";
+        case OpCode::OP_GET_FIELD:          return "OP_GET_FIELD";
+        case OpCode::OP_SET_FIELD:          return "OP_SET_FIELD";
+        case OpCode::OP_INIT_GER:           return "OP_INIT_GER";
+        case OpCode::OP_INIT_LOG:           return "OP_INIT_LOG";
+        case OpCode::OP_SPAWN:              return "OP_SPAWN";
+        case OpCode::OP_AWAIT:              return "OP_AWAIT";
+        case OpCode::OP_POP:                return "OP_POP";
+        case OpCode::OP_CONSTANT_LONG:      return "OP_CONSTANT_LONG";
+        case OpCode::OP_DEFINE_GLOBAL_LONG: return "OP_DEFINE_GLOBAL_LONG";
+        case OpCode::OP_GET_GLOBAL_LONG:    return "OP_GET_GLOBAL_LONG";
+        case OpCode::OP_SET_GLOBAL_LONG:    return "OP_SET_GLOBAL_LONG";
+        case OpCode::OP_ADD_CONSTANT:       return "OP_ADD_CONSTANT";
+        case OpCode::OP_SUBTRACT_CONSTANT:  return "OP_SUBTRACT_CONSTANT";
+        case OpCode::OP_JUMP_IF_NOT_LESS:   return "OP_JUMP_IF_NOT_LESS";
+        case OpCode::OP_SET_LOCAL_POP:      return "OP_SET_LOCAL_POP";
+        case OpCode::OP_RETURN_LOCAL:       return "OP_RETURN_LOCAL";
+        case OpCode::OP_ADD_NUM_NUM:        return "OP_ADD_NUM_NUM";
+        case OpCode::OP_ADD_STR_STR:        return "OP_ADD_STR_STR";
+        case OpCode::OP_SUBTRACT_NUM:       return "OP_SUBTRACT_NUM";
+        case OpCode::OP_MULTIPLY_NUM:       return "OP_MULTIPLY_NUM";
+        case OpCode::OP_DIVIDE_NUM:         return "OP_DIVIDE_NUM";
+        case OpCode::OP_GREATER_NUM:        return "OP_GREATER_NUM";
+        case OpCode::OP_LESS_NUM:           return "OP_LESS_NUM";
+        case OpCode::OP_COUNT_:             break;
+    }
+    return "OP_UNKNOWN";
+}
+
+// Opcodes dont l'opérande désigne une entrée de Chunk::constants
+inline bool has_constant_operand(OpCode op) {
+    return op == OpCode::OP_CONSTANT || op == OpCode::OP_CONSTANT_LONG || op == OpCode::OP_ADD_CONSTANT ||
+           op == OpCode::OP_SUBTRACT_CONSTANT || op == OpCode::OP_GET_FIELD || op == OpCode::OP_SET_FIELD;
+}
+
+// Opcodes dont l'opérande est un identifiant de globale (Heap::global_id)
+inline bool has_global_operand(OpCode op) {
+    switch (op) {
+        case OpCode::OP_DEFINE_GLOBAL:
+        case OpCode::OP_GET_GLOBAL:
+        case OpCode::OP_SET_GLOBAL:
+        case OpCode::OP_DEFINE_GLOBAL_LONG:
+        case OpCode::OP_GET_GLOBAL_LONG:
+        case OpCode::OP_SET_GLOBAL_LONG:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Ajoute à `out` une ligne décrivant l'instruction à `offset` et renvoie
+// l'offset de la suivante. Format :
+//   0004    3 OP_CONSTANT          1 '42'
+// Les noms des globales ne sont affichés que si `heap` est fourni.
+inline size_t disassemble_instruction(const Chunk& chunk, size_t offset, std::string& out,
+                                      const runtime::Heap* heap = nullptr) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%04zu ", offset);
+    out += buffer;
+
+    // Les opérandes héritent de la position de leur opcode : l'octet
+    // précédent donne celle de l'instruction précédente.
+    int line = chunk.position(offset).line;
+    if (offset > 0 && line == chunk.position(offset - 1).line) {
+        out += "   | ";
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%4d ", line);
+        out += buffer;
+    }
+
+    uint8_t byte = chunk.code[offset];
+    if (byte >= OPCODE_COUNT) {
+        std::snprintf(buffer, sizeof(buffer), "<unknown opcode %u>\n", byte);
+        out += buffer;
+        return offset + 1;
+    }
+
+    OpCode op = static_cast<OpCode>(byte);
+    size_t size = instruction_size(op);
+    if (offset + size > chunk.code.size()) {
+        out += std::string(opcode_name(op)) + " <truncated>\n";
+        return chunk.code.size();
+    }
+
+    if (operand_format(op) == OperandFormat::NONE) {
+        out += std::string(opcode_name(op)) + "\n";
+        return offset + size;
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "%-22s", opcode_name(op));
+    out += buffer;
+
+    uint32_t operand = 0;
+    switch (operand_format(op)) {
+        case OperandFormat::NONE:
+            break;
+        case OperandFormat::BYTE:
+            operand = chunk.code[offset + 1];
+            break;
+        case OperandFormat::LONG:
+            operand = chunk.read_long(offset + 1);
+            break;
+        case OperandFormat::JUMP: {
+            uint16_t jump = chunk.read_short(offset + 1);
+            long target = op == OpCode::OP_LOOP ? static_cast<long>(offset + size) - jump
+                                                : static_cast<long>(offset + size) + jump;
+            std::snprintf(buffer, sizeof(buffer), "%4u -> %ld\n", jump, target);
+            out += buffer;
+            return offset + size;
+        }
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "%4u", operand);
+    out += buffer;
+    if (has_constant_operand(op)) {
+        out += operand < chunk.constants.size()
+            ? " '" + runtime::to_string(chunk.constants[operand]) + "'"
+            : " <bad constant>";
+    } else if (has_global_operand(op) && heap) {
+        out += operand < heap->global_count() ? " '" + std::string(heap->global_name(operand)->view()) + "'"
+                                              : " <bad global>";
+    }
+    out += "\n";
+    return offset + size;
+}
+
+inline std::string disassemble(const Chunk& chunk, std::string_view name, const runtime::Heap* heap = nullptr) {
+    std::string out = "== " + std::string(name) + " ==\n";
+    for (size_t offset = 0; offset < chunk.code.size();) {
+        offset = disassemble_instruction(chunk, offset, out, heap);
+    }
+    return out;
+}
+
+// Désassemble une fonction puis, récursivement, les fonctions de ses constantes
+inline std::string disassemble(const runtime::ObjFunction& function, const runtime::Heap* heap = nullptr) {
+    std::string out = disassemble(function.chunk,
+                                  function.name ? function.name->view() : std::string_view("<script>"), heap);
+    for (Value constant : function.chunk.constants) {
+        if (runtime::is_function(constant)) {
+            out += disassemble(*runtime::as_function(constant), heap);
+        }
+    }
+    return out;
+}
+
+} // namespace compiler
+} // namespace initlang
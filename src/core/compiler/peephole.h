@@ -0,0 +1,315 @@
+// src/core/compiler/peephole.h
+#pragma once
+#include "bytecode.h"
+#include "../runtime/object.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace initlang {
+namespace compiler {
+
+struct PeepholeStats {
+    size_t bytes_before = 0;
+    size_t bytes_after = 0;
+    size_t threaded_jumps = 0;      // sauts redirigés vers la fin de leur chaîne
+    size_t dead_instructions = 0;   // inaccessibles, ou sauts vers l'instruction suivante
+    size_t fused = 0;               // superinstructions formées
+
+    PeepholeStats& operator+=(const PeepholeStats& other) {
+        bytes_before += other.bytes_before;
+        bytes_after += other.bytes_after;
+        threaded_jumps += other.threaded_jumps;
+        dead_instructions += other.dead_instructions;
+        fused += other.fused;
+        return *this;
+    }
+};
+
+// Passe sur le bytecode d'un Chunk, après la compilation :
+//  1. threading : un saut vers un OP_JUMP/OP_LOOP vise directement la fin
+//     de la chaîne ; un saut inconditionnel vers OP_RETURN devient OP_RETURN.
+//     Un OP_JUMP_IF_FALSE ne suit la chaîne que vers l'avant (pas de saut
+//     conditionnel arrière) ;
+//  2. code mort : instructions inaccessibles depuis l'entrée (typiquement
+//     le `OP_NULL OP_RETURN` final après un `return`), sauts vers
+//     l'instruction suivante ;
+//  3. superinstructions : paires adjacentes fusionnées, sauf si la seconde
+//     est une cible de saut.
+//
+// Les paires fusionnées sont les plus fréquentes à l'exécution sur le
+// corpus de bench_vm (`bench_vm --profile`, part moyenne des paires) :
+//   OP_LESS + OP_JUMP_IF_FALSE     7.6 %  -> OP_JUMP_IF_NOT_LESS
+//   OP_CONSTANT + OP_ADD           5.8 %  -> OP_ADD_CONSTANT
+//   OP_SET_LOCAL + OP_POP          5.8 %  -> OP_SET_LOCAL_POP
+//   OP_GET_LOCAL + OP_RETURN       2.2 %  -> OP_RETURN_LOCAL
+//   OP_CONSTANT + OP_SUBTRACT      1.8 %  -> OP_SUBTRACT_CONSTANT
+// Les paires plus fréquentes qui n'y figurent pas chevauchent celles-ci
+// (OP_GET_LOCAL + OP_CONSTANT, OP_CONSTANT + OP_LESS), terminent une
+// boucle (OP_POP + OP_LOOP, déjà un saut) ou portent un identifiant de
+// globale que le cache doit pouvoir relier.
+//
+// La table des lignes est reconstruite : chaque instruction garde la
+// position de sa première instruction d'origine, et le dernier octet d'une
+// superinstruction celle de la composante qui peut échouer, puisque la VM
+// localise une erreur par l'octet qui précède ip. Si un saut redirigé ne
+// tient plus sur 16 bits, le Chunk est laissé tel quel.
+class PeepholeOptimizer {
+public:
+    explicit PeepholeOptimizer(Chunk& c) : chunk(c) {}
+
+    PeepholeStats run() {
+        stats = PeepholeStats{};
+        stats.bytes_before = stats.bytes_after = chunk.code.size();
+        if (!decode()) return stats;
+
+        thread_jumps();
+        remove_dead();
+        fuse();
+
+        Chunk out;
+        if (!encode(out)) return PeepholeStats{chunk.code.size(), chunk.code.size(), 0, 0, 0};
+        out.constants = std::move(chunk.constants);
+        stats.bytes_after = out.code.size();
+        chunk = std::move(out);
+        return stats;
+    }
+
+private:
+    static constexpr size_t NO_TARGET = SIZE_MAX;
+
+    struct Instruction {
+        OpCode op;
+        uint32_t operand;     // opérande BYTE/LONG
+        size_t target;        // indice de l'instruction visée (sauts)
+        LinePosition position;
+        LinePosition fault;   // position du dernier octet
+    };
+
+    Chunk& chunk;
+    std::vector<Instruction> code;
+    PeepholeStats stats;
+
+    static bool is_jump(OpCode op) { return operand_format(op) == OperandFormat::JUMP; }
+
+    static bool is_unconditional(OpCode op) { return op == OpCode::OP_JUMP || op == OpCode::OP_LOOP; }
+
+    static bool falls_through(OpCode op) {
+        return !is_unconditional(op) && op != OpCode::OP_RETURN && op != OpCode::OP_RETURN_LOCAL &&
+               op != OpCode::OP_TAIL_CALL;
+    }
+
+    bool decode() {
+        const Chunk& view = chunk; // lecture sans copier un code emprunté
+        size_t size = view.code.size();
+        std::vector<size_t> index_at(size + 1, NO_TARGET);
+        std::vector<size_t> target_offsets;
+
+        for (size_t offset = 0; offset < size;) {
+            if (view.code[offset] >= OPCODE_COUNT) return false;
+            OpCode op = static_cast<OpCode>(view.code[offset]);
+            size_t length = instruction_size(op);
+            if (length > size - offset) return false;
+
+            Instruction ins{op, 0, NO_TARGET, view.position(offset), view.position(offset + length - 1)};
+            switch (operand_format(op)) {
+                case OperandFormat::BYTE:
+                    ins.operand = view.code[offset + 1];
+                    break;
+                case OperandFormat::LONG:
+                    ins.operand = view.read_long(offset + 1);
+                    break;
+                case OperandFormat::JUMP: {
+                    size_t next = offset + length;
+                    uint16_t jump = view.read_short(offset + 1);
+                    if (op == OpCode::OP_LOOP && jump > next) return false;
+                    target_offsets.push_back(op == OpCode::OP_LOOP ? next - jump : next + jump);
+                    break;
+                }
+                case OperandFormat::NONE:
+                    break;
+            }
+            index_at[offset] = code.size();
+            code.push_back(ins);
+            offset += length;
+        }
+
+        size_t jumps = 0;
+        for (Instruction& ins : code) {
+            if (!is_jump(ins.op)) continue;
+            size_t offset = target_offsets[jumps++];
+            if (offset >= size || index_at[offset] == NO_TARGET) return false;
+            ins.target = index_at[offset];
+        }
+        return !code.empty();
+    }
+
+    void thread_jumps() {
+        for (size_t i = 0; i < code.size(); ++i) {
+            Instruction& ins = code[i];
+            if (!is_jump(ins.op)) continue;
+
+            size_t target = ins.target;
+            for (size_t steps = 0; steps < code.size() && is_unconditional(code[target].op); ++steps) {
+                size_t next = code[target].target;
+                if (next == i || (!is_unconditional(ins.op) && next <= i)) break;
+                target = next;
+            }
+            if (target != ins.target) {
+                ins.target = target;
+                ++stats.threaded_jumps;
+            }
+            if (is_unconditional(ins.op) && code[target].op == OpCode::OP_RETURN) {
+                ins.op = OpCode::OP_RETURN;
+                ins.target = NO_TARGET;
+                ++stats.threaded_jumps;
+            }
+        }
+    }
+
+    void remove_dead() {
+        std::vector<bool> live(code.size(), false);
+        std::vector<size_t> work{0};
+        while (!work.empty()) {
+            size_t i = work.back();
+            work.pop_back();
+            if (i >= code.size() || live[i]) continue;
+            live[i] = true;
+            if (is_jump(code[i].op)) work.push_back(code[i].target);
+            if (falls_through(code[i].op)) work.push_back(i + 1);
+        }
+
+        // Saut vers l'instruction vivante suivante : inutile
+        for (size_t i = 0; i < code.size(); ++i) {
+            if (!live[i] || code[i].op != OpCode::OP_JUMP) continue;
+            size_t next = i + 1;
+            while (next < code.size() && !live[next]) ++next;
+            if (code[i].target == next) live[i] = false;
+        }
+
+        compact(live);
+    }
+
+    // Retire les instructions non gardées ; un saut vers une instruction
+    // retirée vise la première gardée qui la suit
+    void compact(const std::vector<bool>& keep) {
+        std::vector<size_t> remap(code.size() + 1, 0);
+        size_t kept = 0;
+        for (size_t i = 0; i < code.size(); ++i) {
+            remap[i] = kept;
+            if (keep[i]) ++kept;
+        }
+        remap[code.size()] = kept;
+
+        std::vector<Instruction> out;
+        out.reserve(kept);
+        for (size_t i = 0; i < code.size(); ++i) {
+            if (!keep[i]) {
+                ++stats.dead_instructions;
+                continue;
+            }
+            Instruction ins = code[i];
+            if (is_jump(ins.op)) ins.target = remap[ins.target];
+            out.push_back(ins);
+        }
+        code.swap(out);
+    }
+
+    // Superinstruction de la paire (a, b), ou OP_COUNT_. `fault_second`
+    // indique que l'erreur éventuelle vient de b.
+    static OpCode fused(OpCode a, OpCode b, bool& fault_second) {
+        fault_second = true;
+        if (a == OpCode::OP_CONSTANT && b == OpCode::OP_ADD) return OpCode::OP_ADD_CONSTANT;
+        if (a == OpCode::OP_CONSTANT && b == OpCode::OP_SUBTRACT) return OpCode::OP_SUBTRACT_CONSTANT;
+        fault_second = false;
+        if (a == OpCode::OP_LESS && b == OpCode::OP_JUMP_IF_FALSE) return OpCode::OP_JUMP_IF_NOT_LESS;
+        if (a == OpCode::OP_SET_LOCAL && b == OpCode::OP_POP) return OpCode::OP_SET_LOCAL_POP;
+        if (a == OpCode::OP_GET_LOCAL && b == OpCode::OP_RETURN) return OpCode::OP_RETURN_LOCAL;
+        return OpCode::OP_COUNT_;
+    }
+
+    void fuse() {
+        std::vector<bool> is_target(code.size(), false);
+        for (const Instruction& ins : code) {
+            if (is_jump(ins.op)) is_target[ins.target] = true;
+        }
+
+        std::vector<bool> keep(code.size(), true);
+        for (size_t i = 0; i + 1 < code.size(); ++i) {
+            if (is_target[i + 1]) continue;
+            Instruction& a = code[i];
+            const Instruction& b = code[i + 1];
+            bool fault_second = false;
+            OpCode op = fused(generic_opcode(a.op), generic_opcode(b.op), fault_second);
+            if (op == OpCode::OP_COUNT_) continue;
+
+            if (is_jump(b.op)) a.target = b.target;
+            a.op = op;
+            if (fault_second) a.fault = b.fault;
+            keep[i + 1] = false;
+            ++stats.fused;
+            ++i;
+        }
+
+        size_t dead = stats.dead_instructions;
+        compact(keep);
+        stats.dead_instructions = dead;
+    }
+
+    bool encode(Chunk& out) const {
+        std::vector<size_t> offsets(code.size() + 1, 0);
+        for (size_t i = 0; i < code.size(); ++i) offsets[i + 1] = offsets[i] + instruction_size(code[i].op);
+
+        for (size_t i = 0; i < code.size(); ++i) {
+            const Instruction& ins = code[i];
+            OpCode op = ins.op;
+            size_t next = offsets[i + 1];
+            size_t distance = 0;
+            if (is_jump(op)) {
+                size_t target = offsets[ins.target];
+                if (is_unconditional(op)) op = target < next ? OpCode::OP_LOOP : OpCode::OP_JUMP;
+                else if (target < next) return false;
+                distance = target < next ? next - target : target - next;
+                if (distance > 0xFFFF) return false;
+            }
+
+            size_t length = instruction_size(op);
+            uint8_t bytes[4] = {static_cast<uint8_t>(op), 0, 0, 0};
+            switch (operand_format(op)) {
+                case OperandFormat::BYTE:
+                    bytes[1] = static_cast<uint8_t>(ins.operand);
+                    break;
+                case OperandFormat::LONG:
+                    bytes[1] = static_cast<uint8_t>(ins.operand & 0xFF);
+                    bytes[2] = static_cast<uint8_t>((ins.operand >> 8) & 0xFF);
+                    bytes[3] = static_cast<uint8_t>((ins.operand >> 16) & 0xFF);
+                    break;
+                case OperandFormat::JUMP:
+                    bytes[1] = static_cast<uint8_t>(distance & 0xFF);
+                    bytes[2] = static_cast<uint8_t>(distance >> 8);
+                    break;
+                case OperandFormat::NONE:
+                    break;
+            }
+            for (size_t b = 0; b < length; ++b) {
+                const LinePosition& at = b + 1 == length ? ins.fault : ins.position;
+                out.write(bytes[b], at.line, at.column);
+            }
+        }
+        return true;
+    }
+};
+
+inline PeepholeStats optimize_chunk(Chunk& chunk) { return PeepholeOptimizer(chunk).run(); }
+
+// Optimise une fonction et, récursivement, celles de ses constantes
+inline PeepholeStats optimize_bytecode(runtime::ObjFunction& function) {
+    PeepholeStats total = optimize_chunk(function.chunk);
+    for (Value constant : function.chunk.constants) {
+        if (runtime::is_function(constant)) total += optimize_bytecode(*runtime::as_function(constant));
+    }
+    return total;
+}
+
+} // namespace compiler
+} // namespace initlang
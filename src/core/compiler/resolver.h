@@ -0,0 +1,257 @@
+// src/core/compiler/resolver.h
+#pragma once
+#include "../ast/ast.h"
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace initlang {
+namespace compiler {
+
+// Passe de résolution des noms, avant la génération de code. Elle parcourt
+// le Program et annote l'AST (ast::Resolution) :
+//  - chaque paramètre et chaque `let`/`fi` de bloc reçoit un slot fixe de
+//    la fenêtre de pile de sa fonction (slot 0 : l'appelé) ;
+//  - au premier niveau, `let` et `fi` sont des globales ;
+//  - un identifiant est Local, Upvalue (local d'une fonction englobante,
+//    capture ajoutée à FunctionDeclaration::upvalues de chaque fonction
+//    traversée, comme dans clox) ou Global.
+// `await` n'est admis que dans une `async fi` ou au premier niveau.
+// Le compilateur n'a plus qu'à lire les annotations. La passe est
+// idempotente. Elle relève aussi les noms de globales (global_names()),
+// que le compilateur de projet numérote avant de compiler.
+class Resolver {
+public:
+    static constexpr size_t MAX_LOCALS = 256;
+    static constexpr size_t MAX_UPVALUES = 256;
+
+    explicit Resolver(ast::Program& p) : program(p) {}
+
+    void resolve() {
+        if (!program.symbols) {
+            throw std::runtime_error("Compile error: program has no symbol table");
+        }
+        init_ger = program.symbols->find("init.ger");
+        init_log = program.symbols->find("init.log");
+
+        globals.clear();
+        seen_globals.clear();
+        FunctionScope script(nullptr);
+        current = &script;
+        for (ast::Statement* stmt : program.statements) resolve_statement(stmt);
+        program.slot_count = script.max_slots;
+        current = nullptr;
+    }
+
+    // Noms liés à des globales (déclarées ou lues), par première occurrence
+    const std::vector<common::Symbol>& global_names() const { return globals; }
+
+private:
+    struct Local {
+        common::SymbolId name;
+        int depth;
+    };
+
+    struct FunctionScope {
+        FunctionScope* enclosing;
+        std::vector<Local> locals;
+        std::vector<ast::UpvalueRef> upvalues;
+        int depth = 0;
+        uint16_t max_slots = 1;
+        bool is_async = true; // le script peut attendre
+
+        explicit FunctionScope(FunctionScope* e) : enclosing(e) {
+            locals.push_back(Local{common::SymbolId(), 0}); // slot 0 : l'appelé
+        }
+    };
+
+    ast::Program& program;
+    FunctionScope* current = nullptr;
+    common::SymbolId init_ger;
+    common::SymbolId init_log;
+    std::vector<common::Symbol> globals;
+    std::unordered_set<common::SymbolId, common::SymbolIdHash> seen_globals;
+
+    [[noreturn]] static void error(const ast::ASTNode* node, const std::string& message) {
+        std::string where;
+        if (node->location.line > 0) {
+            where = "[line " + std::to_string(node->location.line) + ":" + std::to_string(node->location.column) + "] ";
+        }
+        throw std::runtime_error("Compile error: " + where + message);
+    }
+
+    // Slot du nouveau local, ou Global au premier niveau
+    ast::Resolution declare(const ast::ASTNode* node, common::Symbol name) {
+        if (current->enclosing == nullptr && current->depth == 0) {
+            note_global(name);
+            return ast::Resolution{ast::Binding::Global, 0};
+        }
+
+        auto& locals = current->locals;
+        for (auto it = locals.rbegin(); it != locals.rend() && it->depth == current->depth; ++it) {
+            if (it->name == name.id) {
+                error(node, "'" + std::string(name.text) + "' is already declared in this scope");
+            }
+        }
+        if (locals.size() >= MAX_LOCALS) {
+            error(node, "too many local variables in function");
+        }
+        locals.push_back(Local{name.id, current->depth});
+        if (locals.size() > current->max_slots) current->max_slots = static_cast<uint16_t>(locals.size());
+        return ast::Resolution{ast::Binding::Local, static_cast<uint16_t>(locals.size() - 1)};
+    }
+
+    void note_global(common::Symbol name) {
+        if (seen_globals.insert(name.id).second) globals.push_back(name);
+    }
+
+    static int find_local(const FunctionScope& scope, common::SymbolId name) {
+        for (size_t i = scope.locals.size(); i-- > 1;) {
+            if (scope.locals[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    static int add_upvalue(const ast::ASTNode* node, FunctionScope& scope, uint16_t index, bool is_local) {
+        for (size_t i = 0; i < scope.upvalues.size(); ++i) {
+            if (scope.upvalues[i].index == index && scope.upvalues[i].is_local == is_local) return static_cast<int>(i);
+        }
+        if (scope.upvalues.size() >= MAX_UPVALUES) {
+            error(node, "too many captured variables in function");
+        }
+        scope.upvalues.push_back(ast::UpvalueRef{index, is_local});
+        return static_cast<int>(scope.upvalues.size() - 1);
+    }
+
+    static int find_upvalue(const ast::ASTNode* node, FunctionScope& scope, common::SymbolId name) {
+        if (!scope.enclosing) return -1;
+
+        int slot = find_local(*scope.enclosing, name);
+        if (slot >= 0) return add_upvalue(node, scope, static_cast<uint16_t>(slot), true);
+
+        int outer = find_upvalue(node, *scope.enclosing, name);
+        if (outer >= 0) return add_upvalue(node, scope, static_cast<uint16_t>(outer), false);
+        return -1;
+    }
+
+    // ----- Instructions -----
+
+    void resolve_statement(ast::Statement* stmt) {
+        switch (stmt->kind) {
+            case ast::NodeKind::ExpressionStatement:
+                resolve_expression(static_cast<ast::ExpressionStatement*>(stmt)->expression);
+                break;
+            case ast::NodeKind::VariableDeclaration: {
+                auto* decl = static_cast<ast::VariableDeclaration*>(stmt);
+                // Valeur d'abord : `let x ==> x` lit le x englobant
+                if (decl->value) resolve_expression(decl->value);
+                decl->resolved = declare(decl, decl->name);
+                break;
+            }
+            case ast::NodeKind::FunctionDeclaration:
+                resolve_function(static_cast<ast::FunctionDeclaration*>(stmt));
+                break;
+            case ast::NodeKind::BlockStatement:
+                resolve_block(static_cast<ast::BlockStatement*>(stmt));
+                break;
+            case ast::NodeKind::ReturnStatement: {
+                auto* ret = static_cast<ast::ReturnStatement*>(stmt);
+                if (ret->value) resolve_expression(ret->value);
+                break;
+            }
+            default:
+                error(stmt, "unexpected statement node");
+        }
+    }
+
+    void resolve_block(ast::BlockStatement* block) {
+        ++current->depth;
+        size_t before = current->locals.size();
+        for (ast::Statement* inner : block->statements) resolve_statement(inner);
+        block->local_count = static_cast<uint16_t>(current->locals.size() - before);
+        current->locals.resize(before);
+        --current->depth;
+    }
+
+    void resolve_function(ast::FunctionDeclaration* decl) {
+        // Déclarée avant son corps, pour les appels récursifs
+        decl->resolved = declare(decl, decl->name);
+
+        FunctionScope scope(current);
+        current = &scope;
+        scope.is_async = decl->is_async;
+        ++scope.depth;
+        for (common::Symbol param : decl->parameters) declare(decl, param);
+
+        // Le corps partage la portée des paramètres
+        if (decl->body) {
+            size_t before = scope.locals.size();
+            for (ast::Statement* stmt : decl->body->statements) resolve_statement(stmt);
+            decl->body->local_count = static_cast<uint16_t>(scope.locals.size() - before);
+        }
+
+        decl->slot_count = scope.max_slots;
+        decl->upvalues = program.arena->copy_array(scope.upvalues.data(), scope.upvalues.size());
+        current = scope.enclosing;
+    }
+
+    // ----- Expressions -----
+
+    void resolve_expression(ast::Expression* expr) {
+        switch (expr->kind) {
+            case ast::NodeKind::NumberLiteral:
+            case ast::NodeKind::StringLiteral:
+                break;
+            case ast::NodeKind::Identifier:
+                resolve_identifier(static_cast<ast::Identifier*>(expr));
+                break;
+            case ast::NodeKind::BinaryExpression: {
+                auto* bin = static_cast<ast::BinaryExpression*>(expr);
+                resolve_expression(bin->left);
+                resolve_expression(bin->right);
+                break;
+            }
+            case ast::NodeKind::CallExpression: {
+                auto* call = static_cast<ast::CallExpression*>(expr);
+                resolve_expression(call->callee);
+                for (ast::Expression* arg : call->arguments) resolve_expression(arg);
+                break;
+            }
+            case ast::NodeKind::SpawnExpression:
+                resolve_expression(static_cast<ast::SpawnExpression*>(expr)->call);
+                break;
+            case ast::NodeKind::AwaitExpression:
+                if (!current->is_async) error(expr, "'await' outside of an async function");
+                resolve_expression(static_cast<ast::AwaitExpression*>(expr)->value);
+                break;
+            default:
+                error(expr, "unexpected expression node");
+        }
+    }
+
+    void resolve_identifier(ast::Identifier* ident) {
+        common::SymbolId id = ident->name.id;
+        if (id.valid() && (id == init_ger || id == init_log)) {
+            ident->resolved = ast::Resolution{ast::Binding::Global, 0};
+            return;
+        }
+
+        int slot = find_local(*current, id);
+        if (slot >= 0) {
+            ident->resolved = ast::Resolution{ast::Binding::Local, static_cast<uint16_t>(slot)};
+            return;
+        }
+
+        int upvalue = find_upvalue(ident, *current, id);
+        if (upvalue >= 0) {
+            ident->resolved = ast::Resolution{ast::Binding::Upvalue, static_cast<uint16_t>(upvalue)};
+            return;
+        }
+        note_global(ident->name);
+        ident->resolved = ast::Resolution{ast::Binding::Global, 0};
+    }
+};
+
+} // namespace compiler
+} // namespace initlang
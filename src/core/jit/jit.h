@@ -0,0 +1,602 @@
+// src/core/jit/jit.h
+#pragma once
+#include "x64_assembler.h"
+#include "../compiler/bytecode.h"
+#include "../runtime/object.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// JIT de base x86-64 : disponible sur x86-64 POSIX avec le NaN-boxing (le
+// code émis manipule les Value comme des mots de 64 bits). INITLANG_NO_JIT
+// le retire de la compilation.
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__)) && !defined(INITLANG_NO_JIT) && \
+    !defined(INITLANG_TAGGED_VALUES)
+#define INITLANG_JIT 1
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define INITLANG_JIT 0
+#endif
+
+namespace initlang {
+namespace jit {
+
+using compiler::OpCode;
+using runtime::Value;
+
+// État de la VM lu par le code natif (disposition figée : le code émis lit
+// `globals` par son offset)
+struct Context {
+    void* vm;
+    Value* globals;
+};
+
+// Chemins lents fournis par la VM. Chacun renvoie 0, ou 1 après avoir
+// mis l'exception de l'erreur en attente dans la VM : une exception C++ ne
+// doit jamais traverser le code natif, qui n'a pas de tables de déroulement.
+// `ip` pointe après l'instruction, comme dans l'interpréteur.
+struct Helpers {
+    // operands[0] = operands[0] op operands[1] sur des opérandes qui ne sont
+    // pas tous deux des nombres (OP_NEGATE : operands[0] seul)
+    int (*binary)(Context* context, Value* operands, uint32_t op, const uint8_t* ip);
+    int (*undefined_global)(Context* context, uint32_t id, const uint8_t* ip);
+    // Appel complet, résultat dans window[0] (l'appelé)
+    int (*call)(Context* context, Value* window, uint32_t argc, const uint8_t* ip);
+    // init.log : affiche les arguments, résultat null dans args[0]
+    int (*log)(Context* context, Value* args, uint32_t argc);
+};
+
+// Points d'entrée. Le code natif travaille sur la pile de valeurs de la VM,
+// dans la trame que l'appelant a empilée : 0 au retour de la fonction
+// (résultat dans slots[0]), 1 sur erreur.
+using Entry = int (*)(Context* context, Value* slots);
+// Reprise au début d'une boucle depuis l'interpréteur, sommet de pile `sp`
+using LoopEntry = int (*)(Context* context, Value* slots, Value* sp, const void* head);
+
+// Code natif d'une fonction, dans sa propre zone exécutable
+class NativeFunction {
+public:
+    Entry entry = nullptr;
+    LoopEntry resume = nullptr;
+
+    NativeFunction(void* memory, size_t mapped, size_t used) : base(memory), mapped_size(mapped), used_size(used) {}
+    ~NativeFunction() {
+#if INITLANG_JIT
+        if (base) ::munmap(base, mapped_size);
+#endif
+    }
+    NativeFunction(const NativeFunction&) = delete;
+    NativeFunction& operator=(const NativeFunction&) = delete;
+
+    size_t code_size() const { return used_size; }
+
+    // Adresse native du début de boucle à l'offset `offset` du bytecode,
+    // nullptr si ce n'est pas une cible d'OP_LOOP
+    const void* loop_head(size_t offset) const {
+        auto it = std::lower_bound(loop_heads.begin(), loop_heads.end(), offset,
+                                   [](const std::pair<size_t, const void*>& head, size_t at) { return head.first < at; });
+        return it != loop_heads.end() && it->first == offset ? it->second : nullptr;
+    }
+
+private:
+    friend class Translator;
+
+    void* base;
+    size_t mapped_size;
+    size_t used_size;
+    std::vector<std::pair<size_t, const void*>> loop_heads; // triés par offset
+};
+
+// Bilan du JIT depuis la création de la VM
+struct Stats {
+    size_t compiled = 0;    // fonctions traduites
+    size_t rejected = 0;    // fonctions laissées à l'interpréteur (opcode non pris en charge)
+    size_t code_bytes = 0;  // code natif émis
+};
+
+// Opcodes traduits ; une fonction qui en contient un autre reste
+// interprétée (formes longues des grands scripts, listes, structures,
+// appels terminaux dont la pile constante n'a pas d'équivalent natif,
+// tâches)
+inline bool supported(OpCode op) {
+    switch (compiler::generic_opcode(op)) {
+        case OpCode::OP_CONSTANT_LONG:
+        case OpCode::OP_DEFINE_GLOBAL_LONG:
+        case OpCode::OP_GET_GLOBAL_LONG:
+        case OpCode::OP_SET_GLOBAL_LONG:
+        case OpCode::OP_BUILD_LIST:
+        case OpCode::OP_BUILD_STRUCT:
+        case OpCode::OP_GET_FIELD:
+        case OpCode::OP_SET_FIELD:
+        case OpCode::OP_TAIL_CALL:
+        case OpCode::OP_SPAWN:
+        case OpCode::OP_AWAIT:
+        case OpCode::OP_COUNT_:
+            return false;
+        default:
+            return true;
+    }
+}
+
+#if INITLANG_JIT
+
+// Traduction « template » : chaque opcode devient une séquence fixe qui
+// fait sur la pile de la VM ce que fait l'interpréteur, avec le cas des
+// nombres en ligne et les autres cas dans les Helpers. Registres
+// (préservés par l'ABI System V à travers les appels de helpers) :
+//   rbx = slots, r12 = sommet de pile, r13 = constantes,
+//   r14 = Context, r15 = masque QNAN (test de type des nombres).
+class Translator {
+public:
+    Translator(const runtime::ObjFunction& f, const Helpers& h)
+        : function(f), helpers(h), code(f.chunk.code.data()), size(f.chunk.code.size()) {}
+
+    // nullptr si la fonction contient un opcode non pris en charge. Le
+    // code du Chunk doit être possédé : le code natif garde son adresse
+    // pour les positions d'erreur.
+    std::shared_ptr<NativeFunction> translate() {
+        if (!scan()) return nullptr;
+
+        Assembler::Label body = as.new_label();
+        Assembler::Label entry = as.new_label();
+        Assembler::Label resume = as.new_label();
+        epilogue = as.new_label();
+        error_exit = as.new_label();
+
+        // Entrée normale : arguments en place, sommet juste après eux
+        as.bind(entry);
+        prologue();
+        as.mov(SP, RSI);
+        as.add(SP, 8 * (function.arity + 1));
+        as.jmp(body);
+
+        // Reprise de boucle : sommet et cible fournis par l'interpréteur
+        as.bind(resume);
+        prologue();
+        as.mov(SP, RDX);
+        as.jmp(RCX);
+
+        as.bind(body);
+        for (size_t offset = 0; offset < size; offset += compiler::instruction_size(static_cast<OpCode>(code[offset]))) {
+            as.bind(labels[offset]);
+            if (!emit_instruction(offset)) return nullptr;
+        }
+
+        as.bind(error_exit);
+        as.mov32(RAX, 1);
+        as.bind(epilogue);
+        as.add(RSP, 8);
+        for (Reg r : {R15, R14, R13, R12, RBX, RBP}) as.pop(r);
+        as.ret();
+        if (!as.finish()) return nullptr;
+
+        const std::vector<uint8_t>& bytes = as.code();
+        size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t mapped = (bytes.size() + page - 1) / page * page;
+        void* memory = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return nullptr;
+        std::memcpy(memory, bytes.data(), bytes.size());
+        // W^X : la zone n'est jamais à la fois inscriptible et exécutable
+        if (::mprotect(memory, mapped, PROT_READ | PROT_EXEC) != 0) {
+            ::munmap(memory, mapped);
+            return nullptr;
+        }
+
+        auto native = std::make_shared<NativeFunction>(memory, mapped, bytes.size());
+        const uint8_t* start = static_cast<const uint8_t*>(memory);
+        native->entry = reinterpret_cast<Entry>(const_cast<uint8_t*>(start + as.position(entry)));
+        native->resume = reinterpret_cast<LoopEntry>(const_cast<uint8_t*>(start + as.position(resume)));
+        for (size_t head : loop_targets) native->loop_heads.emplace_back(head, start + as.position(labels[head]));
+        return native;
+    }
+
+private:
+    static constexpr Reg SLOTS = RBX;
+    static constexpr Reg SP = R12;
+    static constexpr Reg CONSTANTS = R13;
+    static constexpr Reg CONTEXT = R14;
+    static constexpr Reg QNAN_MASK = R15;
+
+    const runtime::ObjFunction& function;
+    const Helpers& helpers;
+    const uint8_t* code;
+    size_t size;
+    Assembler as;
+    std::vector<Assembler::Label> labels;  // un label par début d'instruction
+    std::vector<size_t> loop_targets;       // triés, sans doublon
+    Assembler::Label epilogue = 0;
+    Assembler::Label error_exit = 0;
+
+    // Opcodes pris en charge, instructions entières, sauts vers des débuts
+    // d'instruction
+    bool scan() {
+        std::vector<bool> starts(size + 1, false);
+        for (size_t offset = 0; offset < size;) {
+            OpCode op = static_cast<OpCode>(code[offset]);
+            if (!supported(op)) return false;
+            starts[offset] = true;
+            offset += compiler::instruction_size(op);
+            if (offset > size) return false;
+        }
+        labels.assign(size, 0);
+        for (size_t offset = 0; offset < size; offset += compiler::instruction_size(static_cast<OpCode>(code[offset]))) {
+            labels[offset] = as.new_label();
+            OpCode op = static_cast<OpCode>(code[offset]);
+            if (compiler::operand_format(op) != compiler::OperandFormat::JUMP) continue;
+            size_t target = jump_target(offset);
+            if (target >= size || !starts[target]) return false;
+            if (op == OpCode::OP_LOOP) loop_targets.push_back(target);
+        }
+        std::sort(loop_targets.begin(), loop_targets.end());
+        loop_targets.erase(std::unique(loop_targets.begin(), loop_targets.end()), loop_targets.end());
+        return true;
+    }
+
+    size_t jump_target(size_t offset) const {
+        size_t distance = static_cast<size_t>(code[offset + 1] | (code[offset + 2] << 8));
+        size_t next = offset + 3;
+        return static_cast<OpCode>(code[offset]) == OpCode::OP_LOOP ? next - distance : next + distance;
+    }
+
+    void prologue() {
+        // 6 registres + 8 octets : pile alignée sur 16 pour les helpers
+        for (Reg r : {RBP, RBX, R12, R13, R14, R15}) as.push(r);
+        as.sub(RSP, 8);
+        as.mov(CONTEXT, RDI);
+        as.mov(SLOTS, RSI);
+        as.mov(CONSTANTS, reinterpret_cast<uint64_t>(function.chunk.constants.data()));
+        as.mov(QNAN_MASK, Value::QNAN);
+    }
+
+    // ----- Fragments -----
+
+    void push(Reg r) {
+        as.store(SP, 0, r);
+        as.add(SP, 8);
+    }
+
+    // Saute à `slow` si `r` n'est pas un nombre (détruit rdx)
+    void guard_number(Reg r, Assembler::Label slow) {
+        as.mov(RDX, r);
+        as.and_(RDX, QNAN_MASK);
+        as.cmp(RDX, QNAN_MASK);
+        as.jcc(EQUAL, slow);
+    }
+
+    void call_helper(const void* target) {
+        as.mov(RAX, reinterpret_cast<uint64_t>(target));
+        as.call(RAX);
+    }
+
+    // Appel d'un helper faillible : sortie en erreur s'il renvoie non nul
+    void call_checked(const void* target) {
+        call_helper(target);
+        as.test32(RAX, RAX);
+        as.jcc(NOT_EQUAL, error_exit);
+    }
+
+    // Booléen INITLANG à partir de al (0 ou 1) : FALSE_BITS + al
+    void boolean_from_al() {
+        as.movzx8(RAX, RAX);
+        as.mov(RCX, Value::FALSE_BITS);
+        as.add(RAX, RCX);
+    }
+
+    // operands[0] op operands[1] par le helper, operands à `disp` de sp
+    void binary_helper(OpCode op, int32_t disp, const uint8_t* ip) {
+        as.mov(RDI, CONTEXT);
+        as.lea(RSI, SP, disp);
+        as.mov32(RDX, static_cast<uint32_t>(op));
+        as.mov(RCX, reinterpret_cast<uint64_t>(ip));
+        call_checked(reinterpret_cast<const void*>(helpers.binary));
+    }
+
+    // a = rax, b = rcx, tous deux nombres : résultat dans rax
+    void number_operation(OpCode op) {
+        as.movq(XMM0, RAX);
+        as.movq(XMM1, RCX);
+        switch (op) {
+            case OpCode::OP_ADD:      as.addsd(XMM0, XMM1); break;
+            case OpCode::OP_SUBTRACT: as.subsd(XMM0, XMM1); break;
+            case OpCode::OP_MULTIPLY: as.mulsd(XMM0, XMM1); break;
+            case OpCode::OP_DIVIDE:   as.divsd(XMM0, XMM1); break;
+            case OpCode::OP_GREATER:
+                as.ucomisd(XMM0, XMM1);
+                as.setcc(ABOVE, RAX);
+                boolean_from_al();
+                return;
+            case OpCode::OP_LESS:
+                as.ucomisd(XMM1, XMM0);
+                as.setcc(ABOVE, RAX);
+                boolean_from_al();
+                return;
+            // Non ordonné : CF = 1, donc faux comme en C++
+            case OpCode::OP_GREATER_EQUAL:
+                as.ucomisd(XMM0, XMM1);
+                as.setcc(ABOVE_EQUAL, RAX);
+                boolean_from_al();
+                return;
+            case OpCode::OP_LESS_EQUAL:
+                as.ucomisd(XMM1, XMM0);
+                as.setcc(ABOVE_EQUAL, RAX);
+                boolean_from_al();
+                return;
+            case OpCode::OP_EQUAL:
+                // égal et ordonné (NaN != NaN)
+                as.ucomisd(XMM0, XMM1);
+                as.setcc(EQUAL, RAX);
+                as.setcc(NO_PARITY, RDX);
+                as.and8(RAX, RDX);
+                boolean_from_al();
+                return;
+            case OpCode::OP_NOT_EQUAL:
+                as.ucomisd(XMM0, XMM1);
+                as.setcc(NOT_EQUAL, RAX);
+                as.setcc(PARITY, RDX);
+                as.or8(RAX, RDX);
+                boolean_from_al();
+                return;
+            default:
+                return;
+        }
+        as.movq(RAX, XMM0);
+    }
+
+    // Binaire sur sp[-2], sp[-1] ; hors nombres, l'égalité compare les bits
+    // et le reste passe par le helper
+    void binary(OpCode op, const uint8_t* ip) {
+        Assembler::Label slow = as.new_label();
+        Assembler::Label done = as.new_label();
+        as.load(RAX, SP, -16);
+        as.load(RCX, SP, -8);
+        guard_number(RAX, slow);
+        guard_number(RCX, slow);
+        number_operation(op);
+        as.store(SP, -16, RAX);
+        as.jmp(done);
+
+        as.bind(slow);
+        if (op == OpCode::OP_EQUAL || op == OpCode::OP_NOT_EQUAL) {
+            as.cmp(RAX, RCX);
+            as.setcc(op == OpCode::OP_EQUAL ? EQUAL : NOT_EQUAL, RAX);
+            boolean_from_al();
+            as.store(SP, -16, RAX);
+        } else {
+            binary_helper(op, -16, ip);
+        }
+        as.bind(done);
+        as.sub(SP, 8);
+    }
+
+    // sp[-1] op constants[index] (superinstructions du peephole)
+    void binary_constant(OpCode op, uint8_t index, const uint8_t* ip) {
+        Assembler::Label slow = as.new_label();
+        Assembler::Label done = as.new_label();
+        as.load(RAX, SP, -8);
+        as.load(RCX, CONSTANTS, 8 * index);
+        guard_number(RAX, slow);
+        guard_number(RCX, slow);
+        number_operation(op);
+        as.store(SP, -8, RAX);
+        as.jmp(done);
+
+        // La constante est recopiée au-dessus du sommet (fenêtre garantie)
+        as.bind(slow);
+        as.store(SP, 0, RCX);
+        binary_helper(op, -8, ip);
+        as.bind(done);
+    }
+
+    void return_rax() {
+        as.store(SLOTS, 0, RAX);
+        as.xor32(RAX, RAX);
+        as.jmp(epilogue);
+    }
+
+    bool emit_instruction(size_t offset) {
+        OpCode op = static_cast<OpCode>(code[offset]);
+        uint8_t operand = offset + 1 < size ? code[offset + 1] : 0;
+        const uint8_t* ip = code + offset + compiler::instruction_size(op);
+
+        switch (compiler::generic_opcode(op)) {
+            case OpCode::OP_CONSTANT:
+                as.load(RAX, CONSTANTS, 8 * operand);
+                push(RAX);
+                return true;
+            case OpCode::OP_NULL:
+            case OpCode::OP_TRUE:
+            case OpCode::OP_FALSE:
+                as.mov(RAX, op == OpCode::OP_NULL   ? Value::NULL_BITS
+                          : op == OpCode::OP_TRUE ? Value::TRUE_BITS
+                                                  : Value::FALSE_BITS);
+                push(RAX);
+                return true;
+            case OpCode::OP_POP:
+                as.sub(SP, 8);
+                return true;
+
+            case OpCode::OP_GET_LOCAL:
+                as.load(RAX, SLOTS, 8 * operand);
+                push(RAX);
+                return true;
+            case OpCode::OP_SET_LOCAL:
+                as.load(RAX, SP, -8);
+                as.store(SLOTS, 8 * operand, RAX);
+                return true;
+            case OpCode::OP_SET_LOCAL_POP:
+                as.sub(SP, 8);
+                as.load(RAX, SP, 0);
+                as.store(SLOTS, 8 * operand, RAX);
+                return true;
+
+            case OpCode::OP_DEFINE_GLOBAL:
+                as.sub(SP, 8);
+                as.load(RAX, SP, 0);
+                as.load(RCX, CONTEXT, offsetof(Context, globals));
+                as.store(RCX, 8 * operand, RAX);
+                return true;
+            case OpCode::OP_GET_GLOBAL:
+            case OpCode::OP_SET_GLOBAL: {
+                Assembler::Label defined = as.new_label();
+                as.load(RCX, CONTEXT, offsetof(Context, globals));
+                as.load(RAX, RCX, 8 * operand);
+                as.mov(RDX, Value::object(nullptr).bits);
+                as.cmp(RAX, RDX);
+                as.jcc(NOT_EQUAL, defined);
+                as.mov(RDI, CONTEXT);
+                as.mov32(RSI, operand);
+                as.mov(RDX, reinterpret_cast<uint64_t>(ip));
+                call_helper(reinterpret_cast<const void*>(helpers.undefined_global));
+                as.jmp(error_exit);
+                as.bind(defined);
+                if (op == OpCode::OP_GET_GLOBAL) {
+                    push(RAX);
+                } else {
+                    as.load(RAX, SP, -8);
+                    as.store(RCX, 8 * operand, RAX);
+                }
+                return true;
+            }
+
+            case OpCode::OP_ADD:
+            case OpCode::OP_SUBTRACT:
+            case OpCode::OP_MULTIPLY:
+            case OpCode::OP_DIVIDE:
+            case OpCode::OP_GREATER:
+            case OpCode::OP_LESS:
+            case OpCode::OP_GREATER_EQUAL:
+            case OpCode::OP_LESS_EQUAL:
+            case OpCode::OP_EQUAL:
+            case OpCode::OP_NOT_EQUAL:
+                binary(compiler::generic_opcode(op), ip);
+                return true;
+            case OpCode::OP_ADD_CONSTANT:
+                binary_constant(OpCode::OP_ADD, operand, ip);
+                return true;
+            case OpCode::OP_SUBTRACT_CONSTANT:
+                binary_constant(OpCode::OP_SUBTRACT, operand, ip);
+                return true;
+
+            case OpCode::OP_NEGATE: {
+                Assembler::Label slow = as.new_label();
+                Assembler::Label done = as.new_label();
+                as.load(RAX, SP, -8);
+                guard_number(RAX, slow);
+                as.mov(RCX, Value::SIGN_BIT);
+                as.xor_(RAX, RCX);
+                as.store(SP, -8, RAX);
+                as.jmp(done);
+                as.bind(slow);
+                binary_helper(OpCode::OP_NEGATE, -8, ip);
+                as.bind(done);
+                return true;
+            }
+            case OpCode::OP_NOT:
+                as.load(RCX, SP, -8);
+                as.mov(RDX, Value::FALSE_BITS);
+                as.cmp(RCX, RDX);
+                as.setcc(EQUAL, RAX);
+                as.mov(RDX, Value::NULL_BITS);
+                as.cmp(RCX, RDX);
+                as.setcc(EQUAL, RDX);
+                as.or8(RAX, RDX);
+                boolean_from_al();
+                as.store(SP, -8, RAX);
+                return true;
+
+            case OpCode::OP_JUMP:
+            case OpCode::OP_LOOP:
+                as.jmp(labels[jump_target(offset)]);
+                return true;
+            case OpCode::OP_JUMP_IF_FALSE: {
+                Assembler::Label target = labels[jump_target(offset)];
+                as.sub(SP, 8);
+                as.load(RAX, SP, 0);
+                as.mov(RCX, Value::FALSE_BITS);
+                as.cmp(RAX, RCX);
+                as.jcc(EQUAL, target);
+                as.mov(RCX, Value::NULL_BITS);
+                as.cmp(RAX, RCX);
+                as.jcc(EQUAL, target);
+                return true;
+            }
+            case OpCode::OP_JUMP_IF_NOT_LESS: {
+                Assembler::Label slow = as.new_label();
+                Assembler::Label done = as.new_label();
+                as.load(RAX, SP, -16);
+                as.load(RCX, SP, -8);
+                guard_number(RAX, slow);
+                guard_number(RCX, slow);
+                as.sub(SP, 16);
+                as.movq(XMM0, RAX);
+                as.movq(XMM1, RCX);
+                // !(a < b), vrai aussi si non ordonné
+                as.ucomisd(XMM1, XMM0);
+                as.jcc(BELOW_EQUAL, labels[jump_target(offset)]);
+                as.jmp(done);
+                as.bind(slow);
+                binary_helper(OpCode::OP_LESS, -16, ip);
+                as.bind(done);
+                return true;
+            }
+
+            case OpCode::OP_CALL:
+                as.mov(RDI, CONTEXT);
+                as.lea(RSI, SP, -8 * (operand + 1));
+                as.mov32(RDX, operand);
+                as.mov(RCX, reinterpret_cast<uint64_t>(ip));
+                call_checked(reinterpret_cast<const void*>(helpers.call));
+                as.sub(SP, 8 * operand);
+                return true;
+            case OpCode::OP_RETURN:
+                as.load(RAX, SP, -8);
+                return_rax();
+                return true;
+            case OpCode::OP_RETURN_LOCAL:
+                as.load(RAX, SLOTS, 8 * operand);
+                return_rax();
+                return true;
+
+            case OpCode::OP_INIT_GER:
+                // Premier argument laissé en place, null sans argument
+                if (operand == 0) {
+                    as.mov(RAX, Value::NULL_BITS);
+                    push(RAX);
+                } else {
+                    as.sub(SP, 8 * (operand - 1));
+                }
+                return true;
+            case OpCode::OP_INIT_LOG:
+                as.mov(RDI, CONTEXT);
+                as.lea(RSI, SP, -8 * operand);
+                as.mov32(RDX, operand);
+                call_checked(reinterpret_cast<const void*>(helpers.log));
+                as.sub(SP, 8 * (operand - 1));
+                return true;
+
+            default:
+                return false;
+        }
+    }
+};
+
+#endif // INITLANG_JIT
+
+// Code natif de `function`, nullptr si elle doit rester interprétée
+inline std::shared_ptr<NativeFunction> compile(const runtime::ObjFunction& function, const Helpers& helpers) {
+#if INITLANG_JIT
+    return Translator(function, helpers).translate();
+#else
+    (void)function;
+    (void)helpers;
+    return nullptr;
+#endif
+}
+
+} // namespace jit
+} // namespace initlang
@@ -0,0 +1,160 @@
+// src/core/jit/x64_assembler.h
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace initlang {
+namespace jit {
+
+// Registres généraux x86-64, numérotés comme dans l'encodage
+enum Reg : uint8_t {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+// Registres SSE utilisés pour l'arithmétique flottante
+enum Xmm : uint8_t { XMM0, XMM1 };
+
+// Conditions des sauts et des SETcc (quatre bits de poids faible de 0F 8x / 0F 9x)
+enum Cond : uint8_t {
+    PARITY = 0xA,  // non ordonné après ucomisd
+    NO_PARITY = 0xB,
+    EQUAL = 0x4,
+    NOT_EQUAL = 0x5,
+    ABOVE_EQUAL = 0x3,
+    BELOW_EQUAL = 0x6,
+    ABOVE = 0x7,
+};
+
+// Émetteur x86-64 minimal : juste les instructions dont le JIT a besoin,
+// toujours sous leur forme longue (disp32, rel32) pour garder l'encodage
+// simple. Les sauts visent des labels, résolus par finish().
+class Assembler {
+public:
+    using Label = size_t;
+
+    const std::vector<uint8_t>& code() const { return bytes; }
+    size_t size() const { return bytes.size(); }
+
+    Label new_label() {
+        labels.push_back(UNBOUND);
+        return labels.size() - 1;
+    }
+    void bind(Label label) { labels[label] = bytes.size(); }
+    size_t position(Label label) const { return labels[label]; }
+
+    // Résout les déplacements ; faux si un label visé n'a jamais été posé
+    bool finish() {
+        for (const Fixup& fixup : fixups) {
+            if (labels[fixup.label] == UNBOUND) return false;
+            int32_t rel = static_cast<int32_t>(labels[fixup.label] - (fixup.at + 4));
+            std::memcpy(&bytes[fixup.at], &rel, 4);
+        }
+        fixups.clear();
+        return true;
+    }
+
+    // ----- Mouvements -----
+
+    void mov(Reg dst, Reg src) { rex_rm(true, src, dst); emit(0x89); modrm_reg(src, dst); }
+    void mov(Reg dst, uint64_t imm) {
+        emit(0x48 | (dst >> 3));
+        emit(0xB8 | (dst & 7));
+        emit64(imm);
+    }
+    void mov32(Reg dst, uint32_t imm) {
+        if (dst >= R8) emit(0x41);
+        emit(0xB8 | (dst & 7));
+        emit32(imm);
+    }
+    void load(Reg dst, Reg base, int32_t disp) { rex_rm(true, dst, base); emit(0x8B); modrm_mem(dst, base, disp); }
+    void store(Reg base, int32_t disp, Reg src) { rex_rm(true, src, base); emit(0x89); modrm_mem(src, base, disp); }
+    void lea(Reg dst, Reg base, int32_t disp) { rex_rm(true, dst, base); emit(0x8D); modrm_mem(dst, base, disp); }
+
+    // ----- Arithmétique entière -----
+
+    void add(Reg dst, int32_t imm) { alu_imm(0, dst, imm); }
+    void sub(Reg dst, int32_t imm) { alu_imm(5, dst, imm); }
+    void add(Reg dst, Reg src) { rex_rm(true, src, dst); emit(0x01); modrm_reg(src, dst); }
+    void and_(Reg dst, Reg src) { rex_rm(true, src, dst); emit(0x21); modrm_reg(src, dst); }
+    void xor_(Reg dst, Reg src) { rex_rm(true, src, dst); emit(0x31); modrm_reg(src, dst); }
+    void cmp(Reg a, Reg b) { rex_rm(true, b, a); emit(0x39); modrm_reg(b, a); }
+    void test32(Reg a, Reg b) { rex_rm(false, b, a); emit(0x85); modrm_reg(b, a); }
+    void xor32(Reg dst, Reg src) { rex_rm(false, src, dst); emit(0x31); modrm_reg(src, dst); }
+
+    // Octets de poids faible de RAX..RBX uniquement (pas de REX)
+    void setcc(Cond cond, Reg dst) { emit(0x0F); emit(0x90 | cond); emit(0xC0 | dst); }
+    void and8(Reg dst, Reg src) { emit(0x20); emit(0xC0 | (src << 3) | dst); }
+    void or8(Reg dst, Reg src) { emit(0x08); emit(0xC0 | (src << 3) | dst); }
+    void movzx8(Reg dst, Reg src) { emit(0x0F); emit(0xB6); emit(0xC0 | (dst << 3) | src); }
+
+    // ----- Flottants (SSE2) -----
+
+    void movq(Xmm dst, Reg src) { emit(0x66); rex_rm(true, static_cast<Reg>(dst), src); emit(0x0F); emit(0x6E); modrm_reg(static_cast<Reg>(dst), src); }
+    void movq(Reg dst, Xmm src) { emit(0x66); rex_rm(true, static_cast<Reg>(src), dst); emit(0x0F); emit(0x7E); modrm_reg(static_cast<Reg>(src), dst); }
+    void addsd(Xmm dst, Xmm src) { sse(0xF2, 0x58, dst, src); }
+    void subsd(Xmm dst, Xmm src) { sse(0xF2, 0x5C, dst, src); }
+    void mulsd(Xmm dst, Xmm src) { sse(0xF2, 0x59, dst, src); }
+    void divsd(Xmm dst, Xmm src) { sse(0xF2, 0x5E, dst, src); }
+    void ucomisd(Xmm a, Xmm b) { sse(0x66, 0x2E, a, b); }
+
+    // ----- Contrôle -----
+
+    void jmp(Label target) { emit(0xE9); fixup(target); }
+    void jcc(Cond cond, Label target) { emit(0x0F); emit(0x80 | cond); fixup(target); }
+    void jmp(Reg target) { if (target >= R8) emit(0x41); emit(0xFF); emit(0xE0 | (target & 7)); }
+    void call(Reg target) { if (target >= R8) emit(0x41); emit(0xFF); emit(0xD0 | (target & 7)); }
+    void push(Reg r) { if (r >= R8) emit(0x41); emit(0x50 | (r & 7)); }
+    void pop(Reg r) { if (r >= R8) emit(0x41); emit(0x58 | (r & 7)); }
+    void ret() { emit(0xC3); }
+
+private:
+    static constexpr size_t UNBOUND = ~size_t(0);
+
+    struct Fixup {
+        size_t at;     // position du rel32
+        Label label;
+    };
+
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> labels;
+    std::vector<Fixup> fixups;
+
+    void emit(uint8_t byte) { bytes.push_back(byte); }
+    void emit32(uint32_t value) { for (int i = 0; i < 4; ++i) emit(static_cast<uint8_t>(value >> (8 * i))); }
+    void emit64(uint64_t value) { for (int i = 0; i < 8; ++i) emit(static_cast<uint8_t>(value >> (8 * i))); }
+
+    void fixup(Label target) {
+        fixups.push_back(Fixup{bytes.size(), target});
+        emit32(0);
+    }
+
+    // Préfixe REX pour `reg` (champ reg du ModRM) et `rm` ; omis s'il est inutile
+    void rex_rm(bool wide, Reg reg, Reg rm) {
+        uint8_t rex = 0x40 | (wide ? 8 : 0) | ((reg >> 3) << 2) | (rm >> 3);
+        if (rex != 0x40) emit(rex);
+    }
+    void modrm_reg(Reg reg, Reg rm) { emit(0xC0 | ((reg & 7) << 3) | (rm & 7)); }
+    // [base + disp32] ; RSP/R12 comme base imposent un octet SIB
+    void modrm_mem(Reg reg, Reg base, int32_t disp) {
+        emit(0x80 | ((reg & 7) << 3) | (base & 7));
+        if ((base & 7) == RSP) emit(0x24);
+        emit32(static_cast<uint32_t>(disp));
+    }
+    void alu_imm(uint8_t ext, Reg dst, int32_t imm) {
+        rex_rm(true, RAX, dst);
+        emit(0x81);
+        emit(0xC0 | (ext << 3) | (dst & 7));
+        emit32(static_cast<uint32_t>(imm));
+    }
+    void sse(uint8_t prefix, uint8_t op, Xmm dst, Xmm src) {
+        emit(prefix);
+        emit(0x0F);
+        emit(op);
+        emit(0xC0 | (dst << 3) | src);
+    }
+};
+
+} // namespace jit
+} // namespace initlang
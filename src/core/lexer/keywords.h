@@ -0,0 +1,70 @@
+// src/core/lexer/keywords.h
+#pragma once
+#include "tokens.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace initlang {
+namespace lexer {
+
+struct Keyword {
+    std::string_view text;
+    TokenType type;
+};
+
+// Ensemble complet des mots-clés, formes spéciales INITLANG comprises
+// (verrouillé par tests/test_core.cpp).
+inline constexpr std::array<Keyword, 9> keyword_list = {{
+    {"let", TokenType::LET},
+    {"fi", TokenType::FI},
+    {"const", TokenType::CONST},
+    {"return", TokenType::RETURN},
+    {"async", TokenType::ASYNC},
+    {"spawn", TokenType::SPAWN},
+    {"await", TokenType::AWAIT},
+    {"init.ger", TokenType::INIT_GER},
+    {"init.log", TokenType::INIT_LOG},
+}};
+
+// Hachage parfait : longueur, premier et dernier caractère suffisent à
+// séparer tous les mots-clés. Un seul compare de chaîne confirme le candidat.
+inline constexpr size_t KEYWORD_TABLE_SIZE = 16;
+
+constexpr size_t keyword_hash(std::string_view text) {
+    return (text.size() + 3 * static_cast<unsigned char>(text.front()) +
+            15 * static_cast<unsigned char>(text.back())) & (KEYWORD_TABLE_SIZE - 1);
+}
+
+struct KeywordTable {
+    // Indice + 1 dans keyword_list, 0 = case vide
+    std::array<uint8_t, KEYWORD_TABLE_SIZE> slots{};
+    bool perfect = true;
+
+    constexpr KeywordTable() {
+        for (size_t i = 0; i < keyword_list.size(); ++i) {
+            size_t h = keyword_hash(keyword_list[i].text);
+            if (slots[h] != 0) perfect = false;
+            slots[h] = static_cast<uint8_t>(i + 1);
+        }
+    }
+};
+
+inline constexpr KeywordTable keyword_table{};
+static_assert(keyword_table.perfect, "keyword_hash has a collision: adjust its coefficients");
+
+// Renvoie le type du mot-clé, ou IDENTIFIER.
+constexpr TokenType lookup_keyword(std::string_view text) {
+    if (text.size() < 2 || text.size() > 8) return TokenType::IDENTIFIER;
+    uint8_t slot = keyword_table.slots[keyword_hash(text)];
+    if (slot != 0 && keyword_list[slot - 1].text == text) {
+        return keyword_list[slot - 1].type;
+    }
+    return TokenType::IDENTIFIER;
+}
+
+static_assert(lookup_keyword("init.log") == TokenType::INIT_LOG);
+static_assert(lookup_keyword("letx") == TokenType::IDENTIFIER);
+
+} // namespace lexer
+} // namespace initlang
@@ -1,181 +1,345 @@
 // src/core/lexer/lexer.h
 #pragma once
 #include "tokens.h"
+#include "source.h"
+#include "simd_scan.h"
+#include "keywords.h"
 #include <string>
+#include <string_view>
 #include <vector>
+#include <deque>
 #include <memory>
-#include <cctype>
+#include <cstring>
 #include <stdexcept>
 
 namespace initlang {
 namespace lexer {
 
+// Le Lexer possède l'unique copie du source ; les tokens produits sont des
+// vues (std::string_view) sur ce buffer. Seules les chaînes contenant des
+// séquences d'échappement sont décodées, dans une arène annexe.
+//
+// Trois modes d'entrée :
+//  - buffer complet (std::string ou SourceBuffer, éventuellement mmap) ;
+//  - flux (ChunkReader) : le source est lu par blocs de taille fixe dans une
+//    fenêtre glissante. La mémoire reste bornée (deux fenêtres d'environ
+//    un bloc plus la longueur du plus long token). En contrepartie, un token n'est
+//    garanti valide que jusqu'au retour du token suivant-le-suivant, ce qui
+//    suffit au Parser (current_token + peek_token).
 class Lexer {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
 private:
-    std::string source;
-    size_t position;
+    SourceBuffer input;
+    const char* buffer; // octets actuellement visibles (source entier ou fenêtre)
+    size_t length;
+    size_t position;    // index de current_char dans buffer
     int line;
-    int column;
+    int column;         // colonne de current_char (base 1)
     char current_char;
-    
+    const simd::ScanKernels& scan; // noyaux de balayage (AVX2/SSE2/scalaire)
+
+    // Début du token en cours. Le token rendu précédemment est « épinglé » :
+    // tant qu'il vit dans la fenêtre active, celle-ci ne doit pas bouger.
+    size_t token_start = 0;
+    bool pinned_in_window = false;
+
+    // Mode flux : deux fenêtres alternées. Au remplissage, le token en cours
+    // est recopié dans l'autre fenêtre pendant que l'ancienne garde en vie le
+    // token épinglé ; aucune vue déjà rendue n'est donc invalidée.
+    ChunkReader reader;
+    std::vector<char> window;
+    std::vector<char> retired;
+    size_t chunk_size = 0;
+    bool reader_done = true;
+
+    // Chaînes décodées (échappements). std::deque ne déplace jamais ses
+    // éléments : les vues rendues restent stables.
+    std::deque<std::string> decoded_strings;
+
+    // Interner optionnel (non possédé) : identifiants et chaînes y reçoivent
+    // leur SymbolId au moment du découpage.
+    common::Interner* symbols = nullptr;
+
+    bool streaming() const { return static_cast<bool>(reader); }
+
+    // Lit un bloc supplémentaire dans la fenêtre. Renvoie false en fin de flux.
+    bool refill() {
+        if (reader_done) return false;
+
+        size_t pending = length - token_start; // octets du token en cours
+        if (pinned_in_window) {
+            // Le token épinglé reste dans l'ancienne fenêtre, mise de côté
+            retired.swap(window);
+            if (window.size() < pending + chunk_size) {
+                window.resize(pending + chunk_size);
+            }
+            std::memcpy(window.data(), retired.data() + token_start, pending);
+            pinned_in_window = false;
+        } else {
+            // Aucune vue vivante dans la fenêtre active : compactage sur place
+            std::memmove(window.data(), window.data() + token_start, pending);
+            if (window.size() < pending + chunk_size) {
+                window.resize(pending + chunk_size);
+            }
+        }
+        position -= token_start;
+        length = pending;
+        token_start = 0;
+        buffer = window.data();
+
+        size_t n = reader(window.data() + length, window.size() - length);
+        if (n == 0) {
+            reader_done = true;
+            return false;
+        }
+        length += n;
+        return true;
+    }
+
     void advance() {
-        if (position < source.length()) {
-            current_char = source[position++];
-            column++;
+        if (current_char == '\n') {
+            line++;
+            column = 1;
         } else {
+            column++;
+        }
+        position++;
+        if (position >= length && !refill()) {
             current_char = '\0';
+            return;
         }
+        current_char = buffer[position];
     }
-    
-    void skip_whitespace() {
-        while (current_char != '\0' && std::isspace(current_char)) {
-            if (current_char == '\n') {
-                line++;
-                column = 1;
+
+    // Avance d'un coup sur toute une série d'octets de même classe, trouvée
+    // par un noyau de balayage. line/column sont recalculés à partir des
+    // sauts de ligne comptés par le noyau.
+    template <typename ScanRun>
+    void advance_run(ScanRun scan_run) {
+        for (;;) {
+            const char* begin = buffer + position;
+            simd::NewlineInfo newlines;
+            const char* stop = scan_run(begin, buffer + length, newlines);
+
+            if (newlines.count) {
+                line += static_cast<int>(newlines.count);
+                column = static_cast<int>(stop - newlines.last);
+            } else {
+                column += static_cast<int>(stop - begin);
             }
-            advance();
+            position = static_cast<size_t>(stop - buffer);
+
+            if (position < length) {
+                current_char = buffer[position];
+                return;
+            }
+            // Fin de fenêtre : la série peut continuer dans le bloc suivant
+            if (!refill()) {
+                current_char = '\0';
+                return;
+            }
+        }
+    }
+
+    void skip_whitespace() {
+        if (simd::has_class(current_char, simd::CC_SPACE)) {
+            advance_run(scan.whitespace);
+        }
+    }
+
+    char peek(size_t offset = 1) {
+        while (position + offset >= length) {
+            if (!refill()) return '\0';
         }
+        return buffer[position + offset];
+    }
+
+    std::string_view slice(size_t start) const {
+        return std::string_view(buffer + start, position - start);
     }
-    
-    char peek() {
-        if (position < source.length()) {
-            return source[position];
+
+    void start_input() {
+        current_char = '\0';
+        if (length > 0 || refill()) {
+            current_char = buffer[0];
         }
-        return '\0';
     }
-    
+
     Token read_identifier() {
         int start_line = line;
-        int start_column = column - 1;
-        std::string result;
-        
-        while (current_char != '\0' && 
-               (std::isalnum(current_char) || current_char == '_' || current_char == '.')) {
-            result += current_char;
-            advance();
-        }
-        
-        // Mots-clés spéciaux INITLANG
-        if (result == "init.ger") return Token(TokenType::INIT_GER, result, start_line, start_column);
-        if (result == "init.log") return Token(TokenType::INIT_LOG, result, start_line, start_column);
-        
-        // Mots-clés normaux
-        static const std::unordered_map<std::string, TokenType> keywords = {
-            {"let", TokenType::LET},
-            {"fi", TokenType::FI},
-            {"const", TokenType::CONST},
-            {"return", TokenType::RETURN},
-            {"async", TokenType::ASYNC},
-            {"spawn", TokenType::SPAWN},
-            {"await", TokenType::AWAIT}
-        };
-        
-        auto it = keywords.find(result);
-        if (it != keywords.end()) {
-            return Token(it->second, result, start_line, start_column);
+        int start_column = column;
+
+        advance_run(scan.identifier);
+
+        std::string_view result = slice(token_start);
+
+        // Mots-clés, formes spéciales INITLANG (init.ger/init.log) comprises
+        Token token(lookup_keyword(result), result, start_line, start_column);
+        if (symbols && token.type == TokenType::IDENTIFIER) {
+            token.symbol = symbols->intern(result);
         }
-        
-        return Token(TokenType::IDENTIFIER, result, start_line, start_column);
+        return token;
     }
-    
+
     Token read_number() {
         int start_line = line;
-        int start_column = column - 1;
-        std::string result;
-        bool has_dot = false;
-        
-        while (current_char != '\0' && 
-               (std::isdigit(current_char) || current_char == '.')) {
-            if (current_char == '.') {
-                if (has_dot) break; // Deux points = erreur
-                has_dot = true;
-            }
-            result += current_char;
+        int start_column = column;
+
+        advance_run(scan.digits);
+        if (current_char == '.') { // un seul point décimal
             advance();
+            advance_run(scan.digits);
         }
-        
-        return Token(TokenType::NUMBER, result, start_line, start_column);
+
+        return Token(TokenType::NUMBER, slice(token_start), start_line, start_column);
     }
-    
+
     Token read_string() {
         int start_line = line;
-        int start_column = column - 1;
-        std::string result;
+        int start_column = column;
         char quote = current_char;
-        
+
         advance(); // Skip opening quote
-        
-        while (current_char != '\0' && current_char != quote) {
-            if (current_char == '\\') {
+
+        auto body = [this, quote](const char* p, const char* end, simd::NewlineInfo& newlines) {
+            return scan.string_body(p, end, quote, newlines);
+        };
+
+        // Cas courant : aucun échappement, le lexème est une vue sur le source
+        advance_run(body);
+
+        std::string_view result;
+        size_t body_length = position - (token_start + 1);
+        bool has_escapes = current_char == '\\';
+
+        if (has_escapes) {
+            // En mode flux, seules les deux dernières chaînes décodées sont conservées
+            if (streaming() && decoded_strings.size() >= 2) {
+                decoded_strings.pop_front();
+            }
+            std::string& decoded = decoded_strings.emplace_back(buffer + token_start + 1, body_length);
+            while (current_char == '\\') {
                 advance(); // Skip backslash
                 switch (current_char) {
-                    case 'n': result += '\n'; break;
-                    case 't': result += '\t'; break;
-                    case 'r': result += '\r'; break;
-                    default: result += current_char; break;
+                    case 'n': decoded += '\n'; break;
+                    case 't': decoded += '\t'; break;
+                    case 'r': decoded += '\r'; break;
+                    case '\0': break;
+                    default: decoded += current_char; break;
                 }
-            } else {
-                result += current_char;
+                if (current_char == '\0') break;
+                advance();
+
+                // Segment sans échappement suivant ; offsets relatifs à
+                // token_start car un remplissage peut déplacer la fenêtre
+                size_t from = position - token_start;
+                advance_run(body);
+                decoded.append(buffer + token_start + from, position - token_start - from);
             }
-            advance();
+            result = decoded;
         }
-        
+
         if (current_char != quote) {
-            throw std::runtime_error("Unterminated string at line " + std::to_string(line));
+            throw std::runtime_error("Unterminated string at line " + std::to_string(start_line));
         }
-        
-        advance(); // Skip closing quote
-        return Token(TokenType::STRING, result, start_line, start_column);
+
+        advance(); // Skip closing quote (peut remplir la fenêtre : vue prise ensuite)
+        if (!has_escapes) {
+            result = std::string_view(buffer + token_start + 1, body_length);
+        }
+        Token token(TokenType::STRING, result, start_line, start_column);
+        if (symbols) token.symbol = symbols->intern(result);
+        return token;
     }
 
 public:
-    Lexer(const std::string& source) 
-        : source(source), position(0), line(1), column(1), current_char('\0') {
-        advance();
+    Lexer(std::string src) : Lexer(SourceBuffer(std::move(src))) {}
+
+    explicit Lexer(SourceBuffer src)
+        : input(std::move(src)), buffer(input.data()), length(input.size()),
+          position(0), line(1), column(1), current_char('\0'), scan(simd::kernels()) {
+        start_input();
+    }
+
+    // Mode flux : le source est tiré par blocs de `chunk` octets.
+    explicit Lexer(ChunkReader chunk_reader, size_t chunk = DEFAULT_CHUNK_SIZE)
+        : buffer(nullptr), length(0), position(0), line(1), column(1), current_char('\0'),
+          scan(simd::kernels()), reader(std::move(chunk_reader)), chunk_size(chunk ? chunk : DEFAULT_CHUNK_SIZE),
+          reader_done(false) {
+        window.resize(chunk_size);
+        buffer = window.data();
+        start_input();
+    }
+
+    // Tranche empruntée d'un buffer possédé ailleurs (ParallelLexer), qui
+    // commence en début de ligne `first_line` ; le buffer doit survivre aux tokens.
+    Lexer(std::string_view slice, int first_line)
+        : buffer(slice.data()), length(slice.size()), position(0), line(first_line), column(1),
+          current_char('\0'), scan(simd::kernels()) {
+        start_input();
     }
-    
+
+    // Script projeté en mémoire, sans copie.
+    static Lexer from_file(const std::string& path) {
+        return Lexer(SourceBuffer::map_file(path));
+    }
+
+    // Les tokens pointent dans le buffer : un Lexer ne se copie ni ne se déplace.
+    Lexer(const Lexer&) = delete;
+    Lexer& operator=(const Lexer&) = delete;
+
+    // Les tokens rendus ensuite portent un SymbolId de `interner`, qui doit
+    // survivre au Lexer (nullptr : pas d'internement).
+    void set_interner(common::Interner* interner) { symbols = interner; }
+    common::Interner* interner() const { return symbols; }
+
     Token next_token() {
+        // Le token rendu précédemment (futur current_token du Parser) doit survivre
+        pinned_in_window = streaming();
         skip_whitespace();
-        
+        token_start = position;
+
         if (current_char == '\0') {
             return Token(TokenType::EOF_TOKEN, "", line, column);
         }
-        
+
         // Identifiants
-        if (std::isalpha(current_char) || current_char == '_') {
+        if (simd::has_class(current_char, simd::CC_IDENT_START)) {
             return read_identifier();
         }
-        
+
         // Nombres
-        if (std::isdigit(current_char)) {
+        if (simd::has_class(current_char, simd::CC_DIGIT)) {
             return read_number();
         }
-        
+
         // Chaînes de caractères
         if (current_char == '"' || current_char == '\'') {
             return read_string();
         }
-        
+
         // Opérateurs et symboles
         int current_line = line;
         int current_column = column;
         char ch = current_char;
-        
+
         // Opérateur arrow ==>
-        if (ch == '=' && peek() == '=' && source[position + 1] == '>') {
+        if (ch == '=' && peek() == '=' && peek(2) == '>') {
             advance(); // =
             advance(); // =
             advance(); // >
             return Token(TokenType::ARROW, "==>", current_line, current_column);
         }
-        
+
         // Double arrow =>
         if (ch == '=' && peek() == '>') {
             advance(); // =
             advance(); // >
             return Token(TokenType::DOUBLE_ARROW, "=>", current_line, current_column);
         }
-        
+
         // Autres opérateurs simples
         switch (ch) {
             case '+': advance(); return Token(TokenType::PLUS, "+", current_line, current_column);
@@ -193,7 +357,7 @@ public:
             case ';': advance(); return Token(TokenType::SEMICOLON, ";", current_line, current_column);
             case ':': advance(); return Token(TokenType::COLON, ":", current_line, current_column);
             case '.': advance(); return Token(TokenType::DOT, ".", current_line, current_column);
-            case '=': 
+            case '=':
                 if (peek() == '=') {
                     advance(); advance();
                     return Token(TokenType::EQ, "==", current_line, current_column);
@@ -222,23 +386,29 @@ public:
                 advance();
                 return Token(TokenType::GT, ">", current_line, current_column);
         }
-        
+
         // Caractère inconnu
         std::string unknown(1, ch);
         advance();
-        throw std::runtime_error("Unexpected character '" + unknown + "' at line " + 
+        throw std::runtime_error("Unexpected character '" + unknown + "' at line " +
                                 std::to_string(current_line) + ":" + std::to_string(current_column));
     }
-    
+
     std::vector<Token> tokenize() {
+        if (streaming()) {
+            throw std::logic_error("tokenize() needs the whole source; use next_token() in streaming mode");
+        }
+
         std::vector<Token> tokens;
+        // Estimation grossière (~1 token pour 6 octets) pour éviter les réallocations
+        tokens.reserve(length / 6 + 1);
         Token token = next_token();
-        
+
         while (token.type != TokenType::EOF_TOKEN) {
             tokens.push_back(token);
             token = next_token();
         }
-        
+
         tokens.push_back(token); // EOF
         return tokens;
     }
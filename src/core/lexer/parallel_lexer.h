@@ -0,0 +1,201 @@
+// src/core/lexer/parallel_lexer.h
+#pragma once
+#include "lexer.h"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace initlang {
+namespace lexer {
+
+// Découpage d'un gros source sur plusieurs threads, token pour token
+// identique à Lexer::tokenize().
+//
+// Un pré-balayage séquentiel (noyau simd quotes/string_body, bien plus
+// rapide que le découpage lui-même) choisit des frontières sûres proches de
+// parts égales : juste après un '\n' situé hors de toute chaîne. Le langage
+// n'ayant pas de commentaires, aucun token ne franchit une telle frontière.
+// Le pré-balayage compte aussi les lignes : chaque segment est confié à un
+// Lexer qui démarre à la bonne ligne, en colonne 1, ce qui rend line/column
+// (et les messages d'erreur) exacts sans retouche. Les vecteurs de tokens
+// sont ensuite recollés, l'EOF de chaque segment sauf le dernier retiré.
+//
+// Un '\0' hors chaîne termine le source et une chaîne non terminée court
+// jusqu'au bout : dans les deux cas le reste du buffer forme le dernier
+// segment, traité comme par le Lexer séquentiel.
+class ParallelLexer {
+public:
+    // En dessous, un segment ne rentabilise pas son thread
+    static constexpr size_t MIN_SEGMENT_SIZE = 256 * 1024;
+
+    struct Segment {
+        size_t begin;
+        size_t end;
+        int line; // ligne du premier octet
+    };
+
+    // thread_count = 0 : std::thread::hardware_concurrency()
+    explicit ParallelLexer(SourceBuffer src, size_t thread_count = 0, size_t min_segment = MIN_SEGMENT_SIZE)
+        : input(std::move(src)), threads(thread_count ? thread_count : std::thread::hardware_concurrency()),
+          min_segment_size(min_segment ? min_segment : 1) {
+        if (threads == 0) threads = 1;
+    }
+
+    explicit ParallelLexer(std::string src, size_t thread_count = 0, size_t min_segment = MIN_SEGMENT_SIZE)
+        : ParallelLexer(SourceBuffer(std::move(src)), thread_count, min_segment) {}
+
+    // Les tokens pointent dans le buffer et dans les Lexer de segment
+    ParallelLexer(const ParallelLexer&) = delete;
+    ParallelLexer& operator=(const ParallelLexer&) = delete;
+
+    // Comme Lexer::set_interner. L'internement se fait au recollage, dans
+    // l'ordre du source : les SymbolId sont ceux du Lexer séquentiel.
+    void set_interner(common::Interner* interner) { symbols = interner; }
+
+    // Segments du dernier tokenize()
+    const std::vector<Segment>& segments() const { return parts; }
+
+    std::vector<Token> tokenize() {
+        std::string_view text(input.data(), input.size());
+        size_t wanted = std::max<size_t>(1, std::min(threads, text.size() / min_segment_size));
+        parts = split(text, wanted);
+        const size_t count = parts.size();
+
+        lexers.clear();
+        lexers.resize(count);
+        std::vector<std::vector<Token>> pieces(count);
+        std::vector<std::exception_ptr> errors(count);
+        run(count, [&](size_t i) {
+            try {
+                lexers[i] = std::make_unique<Lexer>(text.substr(parts[i].begin, parts[i].end - parts[i].begin),
+                                                    parts[i].line);
+                pieces[i] = lexers[i]->tokenize();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+        // Première erreur dans l'ordre du source : celle du Lexer séquentiel
+        for (const std::exception_ptr& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        // Le premier segment sert de base ; les suivants y sont recopiés
+        std::vector<Token> tokens = std::move(pieces[0]);
+        if (count > 1) {
+            std::vector<size_t> offsets(count + 1, 0);
+            offsets[1] = tokens.size() - 1;
+            for (size_t i = 1; i < count; ++i) {
+                offsets[i + 1] = offsets[i] + pieces[i].size() - (i + 1 < count ? 1 : 0);
+            }
+            tokens.resize(offsets[count]);
+            run(count - 1, [&](size_t j) {
+                size_t i = j + 1;
+                std::copy(pieces[i].begin(), pieces[i].begin() + (offsets[i + 1] - offsets[i]),
+                          tokens.begin() + offsets[i]);
+            });
+        }
+        if (symbols) {
+            for (Token& token : tokens) {
+                if (token.type == TokenType::IDENTIFIER || token.type == TokenType::STRING) {
+                    token.symbol = symbols->intern(token.value);
+                }
+            }
+        }
+        return tokens;
+    }
+
+    // Pré-balayage : au plus `count` segments, frontières au premier début
+    // de ligne hors chaîne à partir de chaque k * size / count.
+    static std::vector<Segment> split(std::string_view text, size_t count) {
+        const simd::ScanKernels& scan = simd::kernels();
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        const char* p = begin;
+        int line = 1;
+        char quote = 0; // guillemet ouvrant tant que p est dans une chaîne
+
+        std::vector<Segment> segments;
+        Segment current{0, 0, 1};
+        for (size_t k = 1; k < count && p < end; ++k) {
+            const char* target = begin + text.size() * k / count;
+            bool found = false;
+            while (!found && p < end) {
+                simd::NewlineInfo newlines;
+                if (quote) {
+                    p = scan.string_body(p, end, quote, newlines);
+                    line += static_cast<int>(newlines.count);
+                    if (p == end) break;
+                    if (*p == quote) {
+                        quote = 0;
+                        ++p;
+                        continue;
+                    }
+                    ++p; // '\\' : l'octet suivant est échappé
+                    if (p == end || *p == '\0') {
+                        p = end; // chaîne non terminée
+                        break;
+                    }
+                    if (*p == '\n') ++line;
+                    ++p;
+                    continue;
+                }
+
+                if (p < target) {
+                    p = scan.quotes(p, target, newlines);
+                    line += static_cast<int>(newlines.count);
+                    if (p == target) continue;
+                } else {
+                    // Cible atteinte hors chaîne : frontière à la fin de la ligne
+                    while (p < end && *p != '\n' && !simd::is_quote_stop(*p)) ++p;
+                    if (p == end) break;
+                    if (*p == '\n') {
+                        ++line;
+                        ++p;
+                        found = true;
+                        continue;
+                    }
+                }
+                // Octet d'arrêt hors chaîne
+                if (*p == '\0') {
+                    p = end; // fin du source pour le Lexer
+                } else if (*p == '\\') {
+                    ++p; // caractère invalide, signalé par le Lexer
+                } else {
+                    quote = *p++;
+                }
+            }
+            if (!found || p == end) break;
+
+            current.end = static_cast<size_t>(p - begin);
+            segments.push_back(current);
+            current = Segment{current.end, 0, line};
+        }
+        current.end = text.size();
+        segments.push_back(current);
+        return segments;
+    }
+
+private:
+    SourceBuffer input;
+    size_t threads;
+    size_t min_segment_size;
+    common::Interner* symbols = nullptr;
+    std::vector<Segment> parts;
+    std::vector<std::unique_ptr<Lexer>> lexers; // gardent les chaînes décodées
+
+    // task(i) pour chaque segment, un thread par segment (le premier sur le
+    // thread appelant)
+    template <typename Task>
+    static void run(size_t count, Task&& task) {
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < count; ++i) pool.emplace_back([&task, i]() { task(i); });
+        if (count > 0) task(0);
+        for (std::thread& thread : pool) thread.join();
+    }
+};
+
+} // namespace lexer
+} // namespace initlang
@@ -0,0 +1,339 @@
+// src/core/lexer/simd_scan.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(INITLANG_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define INITLANG_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace initlang {
+namespace lexer {
+namespace simd {
+
+// Classes de caractères du Lexer (remplace std::isspace/std::isalnum, qui
+// dépendent de la locale et coûtent un appel par octet).
+enum CharClass : uint8_t {
+    CC_SPACE       = 1 << 0,
+    CC_IDENT_START = 1 << 1, // [A-Za-z_]
+    CC_IDENT       = 1 << 2, // [A-Za-z0-9_.]
+    CC_DIGIT       = 1 << 3, // [0-9]
+};
+
+struct CharClassTable {
+    uint8_t flags[256] = {};
+
+    constexpr CharClassTable() {
+        flags[static_cast<unsigned char>(' ')] |= CC_SPACE;
+        for (int c = '\t'; c <= '\r'; ++c) flags[c] |= CC_SPACE;
+        for (int c = 'a'; c <= 'z'; ++c) flags[c] |= CC_IDENT_START | CC_IDENT;
+        for (int c = 'A'; c <= 'Z'; ++c) flags[c] |= CC_IDENT_START | CC_IDENT;
+        for (int c = '0'; c <= '9'; ++c) flags[c] |= CC_DIGIT | CC_IDENT;
+        flags[static_cast<unsigned char>('_')] |= CC_IDENT_START | CC_IDENT;
+        flags[static_cast<unsigned char>('.')] |= CC_IDENT;
+    }
+};
+
+inline constexpr CharClassTable char_classes{};
+
+inline bool has_class(char c, uint8_t cls) {
+    return (char_classes.flags[static_cast<unsigned char>(c)] & cls) != 0;
+}
+
+// Sauts de ligne rencontrés pendant un balayage : nombre et position du
+// dernier, pour recalculer exactement line/column.
+struct NewlineInfo {
+    size_t count = 0;
+    const char* last = nullptr;
+};
+
+// Chaque noyau renvoie le premier octet de [p, end) qui n'appartient plus à
+// la série (ou `end`).
+using ScanFn = const char* (*)(const char* p, const char* end, NewlineInfo& newlines);
+using StringScanFn = const char* (*)(const char* p, const char* end, char quote, NewlineInfo& newlines);
+
+struct ScanKernels {
+    const char* name;
+    ScanFn whitespace;     // espaces, compte les '\n'
+    ScanFn identifier;     // [A-Za-z0-9_.]
+    ScanFn digits;         // [0-9]
+    StringScanFn string_body; // jusqu'au guillemet ou au '\\', compte les '\n'
+    ScanFn quotes;         // hors chaîne : jusqu'à un guillemet, '\\' ou '\0', compte les '\n'
+};
+
+// --- Noyaux scalaires (repli portable et traitement des queues) ---
+
+inline const char* scalar_whitespace(const char* p, const char* end, NewlineInfo& newlines) {
+    for (; p < end && has_class(*p, CC_SPACE); ++p) {
+        if (*p == '\n') {
+            newlines.count++;
+            newlines.last = p;
+        }
+    }
+    return p;
+}
+
+inline const char* scalar_identifier(const char* p, const char* end, NewlineInfo&) {
+    while (p < end && has_class(*p, CC_IDENT)) ++p;
+    return p;
+}
+
+inline const char* scalar_digits(const char* p, const char* end, NewlineInfo&) {
+    while (p < end && has_class(*p, CC_DIGIT)) ++p;
+    return p;
+}
+
+inline const char* scalar_string_body(const char* p, const char* end, char quote, NewlineInfo& newlines) {
+    for (; p < end && *p != quote && *p != '\\'; ++p) {
+        if (*p == '\n') {
+            newlines.count++;
+            newlines.last = p;
+        }
+    }
+    return p;
+}
+
+inline bool is_quote_stop(char c) { return c == '"' || c == '\'' || c == '\\' || c == '\0'; }
+
+inline const char* scalar_quotes(const char* p, const char* end, NewlineInfo& newlines) {
+    for (; p < end && !is_quote_stop(*p); ++p) {
+        if (*p == '\n') {
+            newlines.count++;
+            newlines.last = p;
+        }
+    }
+    return p;
+}
+
+inline const ScanKernels& scalar_kernels() {
+    static const ScanKernels kernels = {
+        "scalar", scalar_whitespace, scalar_identifier, scalar_digits, scalar_string_body, scalar_quotes
+    };
+    return kernels;
+}
+
+#ifdef INITLANG_SIMD_X86
+
+// Comptabilise les '\n' situés avant la position `stop` du bloc courant.
+inline void count_newlines(uint32_t newline_mask, unsigned stop, const char* block, NewlineInfo& newlines) {
+    if (stop < 32) newline_mask &= (1u << stop) - 1;
+    if (newline_mask) {
+        newlines.count += static_cast<size_t>(__builtin_popcount(newline_mask));
+        newlines.last = block + (31 - __builtin_clz(newline_mask));
+    }
+}
+
+// --- SSE2 (toujours disponible en x86-64), 16 octets par itération ---
+
+// Octets de x dans [lo, lo + span] (comparaison non signée)
+inline __m128i sse2_in_range(__m128i x, char lo, char span) {
+    __m128i shifted = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    __m128i limit = _mm_set1_epi8(span);
+    return _mm_cmpeq_epi8(_mm_max_epu8(shifted, limit), limit);
+}
+
+inline __m128i sse2_ident_mask(__m128i x) {
+    __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+    __m128i m = _mm_or_si128(sse2_in_range(lower, 'a', 'z' - 'a'), sse2_in_range(x, '0', 9));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+    return _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('.')));
+}
+
+inline const char* sse2_whitespace(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), sse2_in_range(x, '\t', '\r' - '\t'));
+        uint32_t other = ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+        uint32_t nl = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n'))));
+        unsigned stop = other ? static_cast<unsigned>(__builtin_ctz(other)) : 16;
+        count_newlines(nl, stop, p, newlines);
+        if (other) return p + stop;
+        p += 16;
+    }
+    return scalar_whitespace(p, end, newlines);
+}
+
+inline const char* sse2_identifier(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t other = ~static_cast<uint32_t>(_mm_movemask_epi8(sse2_ident_mask(x))) & 0xFFFFu;
+        if (other) return p + __builtin_ctz(other);
+        p += 16;
+    }
+    return scalar_identifier(p, end, newlines);
+}
+
+inline const char* sse2_digits(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t other = ~static_cast<uint32_t>(_mm_movemask_epi8(sse2_in_range(x, '0', 9))) & 0xFFFFu;
+        if (other) return p + __builtin_ctz(other);
+        p += 16;
+    }
+    return scalar_digits(p, end, newlines);
+}
+
+inline const char* sse2_string_body(const char* p, const char* end, char quote, NewlineInfo& newlines) {
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(quote)),
+                                       _mm_cmpeq_epi8(x, _mm_set1_epi8('\\')));
+        uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        uint32_t nl = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n'))));
+        unsigned stop = hit ? static_cast<unsigned>(__builtin_ctz(hit)) : 16;
+        count_newlines(nl, stop, p, newlines);
+        if (hit) return p + stop;
+        p += 16;
+    }
+    return scalar_string_body(p, end, quote, newlines);
+}
+
+inline const char* sse2_quotes(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')),
+                                                    _mm_cmpeq_epi8(x, _mm_set1_epi8('\''))),
+                                       _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\\')),
+                                                    _mm_cmpeq_epi8(x, _mm_setzero_si128())));
+        uint32_t hit = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        uint32_t nl = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n'))));
+        unsigned stop = hit ? static_cast<unsigned>(__builtin_ctz(hit)) : 16;
+        count_newlines(nl, stop, p, newlines);
+        if (hit) return p + stop;
+        p += 16;
+    }
+    return scalar_quotes(p, end, newlines);
+}
+
+inline const ScanKernels& sse2_kernels() {
+    static const ScanKernels kernels = {
+        "sse2", sse2_whitespace, sse2_identifier, sse2_digits, sse2_string_body, sse2_quotes
+    };
+    return kernels;
+}
+
+// --- AVX2, 32 octets par itération (sélectionné à l'exécution) ---
+
+#define INITLANG_AVX2 __attribute__((target("avx2,popcnt")))
+
+INITLANG_AVX2 inline __m256i avx2_in_range(__m256i x, char lo, char span) {
+    __m256i shifted = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    __m256i limit = _mm256_set1_epi8(span);
+    return _mm256_cmpeq_epi8(_mm256_max_epu8(shifted, limit), limit);
+}
+
+INITLANG_AVX2 inline const char* avx2_whitespace(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                                     avx2_in_range(x, '\t', '\r' - '\t'));
+        uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        uint32_t nl = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n'))));
+        unsigned stop = other ? static_cast<unsigned>(__builtin_ctz(other)) : 32;
+        count_newlines(nl, stop, p, newlines);
+        if (other) return p + stop;
+        p += 32;
+    }
+    return sse2_whitespace(p, end, newlines);
+}
+
+INITLANG_AVX2 inline const char* avx2_identifier(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+        __m256i m = _mm256_or_si256(avx2_in_range(lower, 'a', 'z' - 'a'), avx2_in_range(x, '0', 9));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('.')));
+        uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(m));
+        if (other) return p + __builtin_ctz(other);
+        p += 32;
+    }
+    return sse2_identifier(p, end, newlines);
+}
+
+INITLANG_AVX2 inline const char* avx2_digits(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(avx2_in_range(x, '0', 9)));
+        if (other) return p + __builtin_ctz(other);
+        p += 32;
+    }
+    return sse2_digits(p, end, newlines);
+}
+
+INITLANG_AVX2 inline const char* avx2_string_body(const char* p, const char* end, char quote, NewlineInfo& newlines) {
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(quote)),
+                                          _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')));
+        uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        uint32_t nl = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n'))));
+        unsigned stop = hit ? static_cast<unsigned>(__builtin_ctz(hit)) : 32;
+        count_newlines(nl, stop, p, newlines);
+        if (hit) return p + stop;
+        p += 32;
+    }
+    return sse2_string_body(p, end, quote, newlines);
+}
+
+INITLANG_AVX2 inline const char* avx2_quotes(const char* p, const char* end, NewlineInfo& newlines) {
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')),
+                                                          _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\''))),
+                                          _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')),
+                                                          _mm256_cmpeq_epi8(x, _mm256_setzero_si256())));
+        uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        uint32_t nl = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n'))));
+        unsigned stop = hit ? static_cast<unsigned>(__builtin_ctz(hit)) : 32;
+        count_newlines(nl, stop, p, newlines);
+        if (hit) return p + stop;
+        p += 32;
+    }
+    return sse2_quotes(p, end, newlines);
+}
+
+#undef INITLANG_AVX2
+
+inline const ScanKernels& avx2_kernels() {
+    static const ScanKernels kernels = {
+        "avx2", avx2_whitespace, avx2_identifier, avx2_digits, avx2_string_body, avx2_quotes
+    };
+    return kernels;
+}
+
+inline bool cpu_has_avx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif // INITLANG_SIMD_X86
+
+// Noyaux retenus pour ce processus : AVX2 si le CPU le permet, sinon SSE2,
+// sinon scalaire. force_kernels() sert aux tests et benchmarks.
+inline const ScanKernels& best_kernels() {
+#ifdef INITLANG_SIMD_X86
+    return cpu_has_avx2() ? avx2_kernels() : sse2_kernels();
+#else
+    return scalar_kernels();
+#endif
+}
+
+inline std::atomic<const ScanKernels*>& active_kernels_slot() {
+    static std::atomic<const ScanKernels*> active{&best_kernels()};
+    return active;
+}
+
+inline const ScanKernels& kernels() {
+    return *active_kernels_slot().load(std::memory_order_relaxed);
+}
+
+inline void force_kernels(const ScanKernels& k) {
+    active_kernels_slot().store(&k, std::memory_order_relaxed);
+}
+
+} // namespace simd
+} // namespace lexer
+} // namespace initlang
@@ -0,0 +1,119 @@
+// src/core/lexer/source.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <functional>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace initlang {
+namespace lexer {
+
+// Buffer source possédé par un Lexer : soit une std::string, soit une
+// projection mémoire (mmap) d'un fichier. Dans le second cas le script n'est
+// jamais copié ; les pages sont chargées à la demande par le noyau.
+class SourceBuffer {
+private:
+    std::string owned;
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+
+    void release() {
+        if (mapping) {
+            ::munmap(mapping, mapping_size);
+            mapping = nullptr;
+            mapping_size = 0;
+        }
+    }
+
+public:
+    SourceBuffer() = default;
+    explicit SourceBuffer(std::string text) : owned(std::move(text)) {}
+
+    SourceBuffer(SourceBuffer&& other) noexcept
+        : owned(std::move(other.owned)), mapping(other.mapping), mapping_size(other.mapping_size) {
+        other.mapping = nullptr;
+        other.mapping_size = 0;
+    }
+
+    SourceBuffer& operator=(SourceBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            owned = std::move(other.owned);
+            mapping = other.mapping;
+            mapping_size = other.mapping_size;
+            other.mapping = nullptr;
+            other.mapping_size = 0;
+        }
+        return *this;
+    }
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    ~SourceBuffer() { release(); }
+
+    static SourceBuffer map_file(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open '" + path + "': " + std::strerror(errno));
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot stat '" + path + "': " + std::strerror(err));
+        }
+
+        SourceBuffer buffer;
+        if (st.st_size > 0) {
+            void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                int err = errno;
+                ::close(fd);
+                throw std::runtime_error("Cannot map '" + path + "': " + std::strerror(err));
+            }
+            ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            buffer.mapping = addr;
+            buffer.mapping_size = static_cast<size_t>(st.st_size);
+        }
+
+        ::close(fd); // la projection reste valide après fermeture
+        return buffer;
+    }
+
+    const char* data() const {
+        return mapping ? static_cast<const char*>(mapping) : owned.data();
+    }
+
+    size_t size() const {
+        return mapping ? mapping_size : owned.size();
+    }
+
+    std::string_view view() const { return std::string_view(data(), size()); }
+};
+
+// Source en flux : remplit `dst` avec au plus `capacity` octets et renvoie le
+// nombre d'octets lus (0 = fin du flux).
+using ChunkReader = std::function<size_t(char* dst, size_t capacity)>;
+
+inline ChunkReader fd_reader(int fd) {
+    return [fd](char* dst, size_t capacity) -> size_t {
+        for (;;) {
+            ssize_t n = ::read(fd, dst, capacity);
+            if (n >= 0) return static_cast<size_t>(n);
+            if (errno != EINTR) {
+                throw std::runtime_error(std::string("Read error: ") + std::strerror(errno));
+            }
+        }
+    };
+}
+
+} // namespace lexer
+} // namespace initlang
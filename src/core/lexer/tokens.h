@@ -1,13 +1,54 @@
-// src/core/lexer/tokens.h (EXTRAIT CORRIGÉ)
+// src/core/lexer/tokens.h
+#pragma once
+#include "../common/interner.h"
+#include <cstddef>
+#include <string_view>
+
+namespace initlang {
+namespace lexer {
+
+enum class TokenType {
+    // Littéraux
+    IDENTIFIER, NUMBER, STRING,
+
+    // Mots-clés
+    LET, FI, CONST, RETURN, ASYNC, SPAWN, AWAIT,
+
+    // Spécial INITLANG
+    INIT_GER, INIT_LOG,
+
+    // Opérateurs
+    PLUS, MINUS, STAR, SLASH, PERCENT,
+    ASSIGN, EQ, NEQ, LT, GT, LTE, GTE, NOT,
+    ARROW,        // ==>
+    DOUBLE_ARROW, // =>
+
+    // Délimiteurs
+    LPAREN, RPAREN, LBRACE, RBRACE, LBRACKET, RBRACKET,
+    COMMA, SEMICOLON, COLON, DOT,
+
+    EOF_TOKEN // doit rester le dernier
+};
+
+inline constexpr size_t TOKEN_TYPE_COUNT = static_cast<size_t>(TokenType::EOF_TOKEN) + 1;
+
+// Un token ne possède pas son lexème : `value` est une vue sur le buffer
+// source du Lexer (ou sur son arène de chaînes décodées pour les chaînes
+// contenant des échappements). Un token reste donc valide tant que le
+// Lexer qui l'a produit est vivant.
 struct Token {
     TokenType type;
-    std::string value;
+    std::string_view value;
     int line;
     int column;
-    
+    common::SymbolId symbol; // IDENTIFIER/STRING, si le Lexer a un Interner
+
     // Constructeur par défaut
-    Token() : type(TokenType::EOF_TOKEN), value(""), line(1), column(1) {}
-    
-    Token(TokenType t, const std::string& v, int l = 1, int c = 1) 
+    Token() : type(TokenType::EOF_TOKEN), value(), line(1), column(1) {}
+
+    Token(TokenType t, std::string_view v, int l = 1, int c = 1)
         : type(t), value(v), line(l), column(c) {}
 };
+
+} // namespace lexer
+} // namespace initlang
@@ -0,0 +1,79 @@
+// src/core/logging/log_ring.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sys/uio.h>
+
+namespace initlang {
+namespace logging {
+
+// Anneau d'octets à un producteur et un consommateur, sans verrou. Le
+// producteur n'y publie que des lignes complètes (head avancé après la
+// copie, en release), si bien que le consommateur peut écrire tel quel
+// tout ce qui est lisible : au plus deux iovec, le second quand les
+// données font le tour du tableau.
+class ByteRing {
+public:
+    // capacity arrondie à la puissance de deux supérieure
+    explicit ByteRing(size_t capacity) {
+        size_t size = 64;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        data.reset(new char[size]);
+    }
+
+    ByteRing(const ByteRing&) = delete;
+    ByteRing& operator=(const ByteRing&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    // Approximatif hors des deux threads concernés
+    size_t size() const {
+        return static_cast<size_t>(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+    }
+
+    // Producteur : false si la place manque (rien n'est écrit)
+    bool try_write(const char* bytes, size_t count) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        uint64_t t = tail.load(std::memory_order_acquire);
+        if (count > capacity() - static_cast<size_t>(h - t)) return false;
+        size_t at = static_cast<size_t>(h) & mask;
+        size_t first = count < capacity() - at ? count : capacity() - at;
+        std::memcpy(data.get() + at, bytes, first);
+        std::memcpy(data.get(), bytes + first, count - first);
+        head.store(h + count, std::memory_order_release);
+        return true;
+    }
+
+    // Consommateur : octets lisibles dans iov[0..2) ; renvoie le nombre
+    // d'iovec remplis, `count` reçoit le total à passer ensuite à consume()
+    int readable(iovec* iov, size_t& count) const {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        count = static_cast<size_t>(h - t);
+        if (count == 0) return 0;
+        size_t at = static_cast<size_t>(t) & mask;
+        size_t first = count < capacity() - at ? count : capacity() - at;
+        iov[0] = iovec{data.get() + at, first};
+        if (first == count) return 1;
+        iov[1] = iovec{data.get(), count - first};
+        return 2;
+    }
+
+    // Consommateur : libère `count` octets lus
+    void consume(size_t count) {
+        tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+private:
+    std::unique_ptr<char[]> data;
+    size_t mask = 0;
+    alignas(64) std::atomic<uint64_t> head{0}; // écrit par le producteur
+    alignas(64) std::atomic<uint64_t> tail{0}; // écrit par le consommateur
+};
+
+} // namespace logging
+} // namespace initlang
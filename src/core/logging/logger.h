@@ -0,0 +1,310 @@
+// src/core/logging/logger.h
+#pragma once
+#include "log_ring.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace initlang {
+namespace logging {
+
+// Journal asynchrone : chaque thread formate ses lignes dans son propre
+// ByteRing (aucun verrou ni appel système sur le chemin d'écriture), un
+// thread de vidage les regroupe en gros appels writev sur le descripteur.
+//
+// L'ordre des lignes est celui de chaque thread ; les lignes de threads
+// différents s'entrelacent ligne à ligne. Le vidage a lieu toutes les
+// `interval`, dès qu'un anneau est à moitié plein, sur flush() et à la
+// destruction, qui écrit tout ce qui a été publié.
+//
+// Anneau plein : Overflow::Block fait écrire le producteur lui-même (il
+// vide tous les anneaux, contre-pression sans attente active),
+// Overflow::Drop abandonne la ligne et la compte. Une ligne plus grande
+// que l'anneau est écrite directement, après ce qui la précède.
+
+enum class Level : uint8_t { Debug, Info, Warn, Error, Off };
+
+// Rendu d'une ligne, appliqué par l'appelant (vm::VM pour init.log)
+enum class Format : uint8_t {
+    Plain,    // arguments séparés par des espaces
+    KeyValue, // level=info puis clé=valeur, chaînes entre guillemets
+};
+
+enum class Overflow : uint8_t { Block, Drop };
+
+inline const char* level_name(Level level) {
+    switch (level) {
+        case Level::Debug: return "debug";
+        case Level::Info: return "info";
+        case Level::Warn: return "warn";
+        case Level::Error: return "error";
+        case Level::Off: return "off";
+    }
+    return "?";
+}
+
+inline bool parse_level(std::string_view text, Level& level) {
+    for (Level candidate : {Level::Debug, Level::Info, Level::Warn, Level::Error, Level::Off}) {
+        if (text == level_name(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Options {
+    int fd = STDOUT_FILENO;
+    Level level = Level::Info;             // seuil : les lignes en dessous sont ignorées
+    Format format = Format::Plain;
+    Overflow overflow = Overflow::Block;
+    size_t ring_bytes = 64 * 1024;         // par thread
+    std::chrono::milliseconds interval{1}; // période de vidage
+};
+
+struct Stats {
+    uint64_t records = 0; // lignes publiées
+    uint64_t dropped = 0; // Overflow::Drop
+    uint64_t blocked = 0; // Overflow::Block : vidages faits par un producteur
+    uint64_t bytes = 0;   // octets écrits
+    uint64_t writes = 0;  // appels writev
+    uint64_t errors = 0;  // échecs d'écriture (lignes perdues)
+};
+
+class Logger {
+public:
+    static constexpr int MAX_IOVECS = 256;
+
+    explicit Logger(Options o = {}) : options(o), id(next_id().fetch_add(1) + 1), flusher([this] { loop(); }) {}
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(wake_lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+        drain();
+    }
+
+    bool enabled(Level level) const { return level != Level::Off && level >= options.level; }
+    Format format() const { return options.format; }
+
+    // Tampon du thread appelant, vide : y formater une ligne ('\n' compris)
+    // puis la publier avec commit()
+    std::string& begin() {
+        Ring& ring = local();
+        ring.scratch.clear();
+        return ring.scratch;
+    }
+
+    void commit() {
+        Ring& ring = local();
+        const std::string& line = ring.scratch;
+        if (line.empty()) return;
+        if (line.size() > ring.bytes.capacity()) {
+            std::lock_guard<std::mutex> lock(write_lock);
+            drain_locked();
+            write_all(line.data(), line.size());
+            bump(ring.records);
+            return;
+        }
+        while (!ring.bytes.try_write(line.data(), line.size())) {
+            if (options.overflow == Overflow::Drop) {
+                bump(ring.dropped);
+                return;
+            }
+            bump(ring.blocked);
+            drain();
+        }
+        bump(ring.records);
+        if (ring.bytes.size() >= ring.bytes.capacity() / 2) request_flush();
+    }
+
+    void write(std::string_view line) {
+        begin().append(line);
+        commit();
+    }
+
+    // Synchrone : écrit tout ce qui a été publié avant l'appel
+    void flush() { drain(); }
+
+    Stats stats() const {
+        Stats s;
+        {
+            std::lock_guard<std::mutex> lock(registry_lock);
+            for (const auto& ring : rings) {
+                s.records += ring->records.load(std::memory_order_relaxed);
+                s.dropped += ring->dropped.load(std::memory_order_relaxed);
+                s.blocked += ring->blocked.load(std::memory_order_relaxed);
+            }
+        }
+        s.bytes = bytes_written.load(std::memory_order_relaxed);
+        s.writes = writes.load(std::memory_order_relaxed);
+        s.errors = errors.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct Ring {
+        ByteRing bytes;
+        std::thread::id owner;
+        std::string scratch; // ligne en cours de formatage
+        // Écrits par le seul propriétaire
+        std::atomic<uint64_t> records{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> blocked{0};
+
+        Ring(size_t capacity, std::thread::id thread) : bytes(capacity), owner(thread) {}
+    };
+
+    // Dernier anneau utilisé par le thread : `logger` identifie le Logger
+    // (jamais réutilisé, contrairement à une adresse)
+    struct Cache {
+        uint64_t logger = 0;
+        Ring* ring = nullptr;
+    };
+
+    Options options;
+    const uint64_t id;
+
+    mutable std::mutex registry_lock;
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    std::mutex write_lock; // un seul consommateur à la fois
+    std::vector<Ring*> snapshot;
+    std::atomic<uint64_t> bytes_written{0};
+    std::atomic<uint64_t> writes{0};
+    std::atomic<uint64_t> errors{0};
+
+    std::mutex wake_lock;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::atomic<bool> flush_requested{false};
+    std::thread flusher; // dernier membre : démarre une fois le reste construit
+
+    static std::atomic<uint64_t>& next_id() {
+        static std::atomic<uint64_t> counter{0};
+        return counter;
+    }
+
+    static Cache& cache() {
+        static thread_local Cache local;
+        return local;
+    }
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Ring& local() {
+        Cache& c = cache();
+        if (c.logger == id) return *c.ring;
+        std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(registry_lock);
+        Ring* found = nullptr;
+        for (const auto& ring : rings) {
+            if (ring->owner == self) found = ring.get();
+        }
+        if (!found) {
+            rings.push_back(std::make_unique<Ring>(options.ring_bytes, self));
+            found = rings.back().get();
+        }
+        c = Cache{id, found};
+        return *found;
+    }
+
+    void request_flush() {
+        if (flush_requested.load(std::memory_order_relaxed) || flush_requested.exchange(true)) return;
+        std::lock_guard<std::mutex> lock(wake_lock);
+        wake.notify_one();
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(wake_lock);
+        while (!stopping) {
+            wake.wait_for(lock, options.interval, [this] { return stopping || flush_requested.load(); });
+            flush_requested.store(false);
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    void drain() {
+        std::lock_guard<std::mutex> lock(write_lock);
+        drain_locked();
+    }
+
+    // Tous les anneaux en un minimum de writev (MAX_IOVECS iovec par appel)
+    void drain_locked() {
+        {
+            std::lock_guard<std::mutex> lock(registry_lock);
+            snapshot.clear();
+            for (const auto& ring : rings) snapshot.push_back(ring.get());
+        }
+        iovec iov[MAX_IOVECS];
+        std::pair<Ring*, size_t> batch[MAX_IOVECS];
+        size_t next = 0;
+        while (next < snapshot.size()) {
+            int count = 0;
+            size_t rings_read = 0;
+            for (; next < snapshot.size() && count + 2 <= MAX_IOVECS; ++next) {
+                size_t bytes = 0;
+                int parts = snapshot[next]->bytes.readable(iov + count, bytes);
+                if (parts == 0) continue;
+                count += parts;
+                batch[rings_read++] = {snapshot[next], bytes};
+            }
+            if (count == 0) break;
+            write_iov(iov, count);
+            for (size_t i = 0; i < rings_read; ++i) batch[i].first->bytes.consume(batch[i].second);
+        }
+    }
+
+    void write_all(const char* bytes, size_t count) {
+        iovec iov{const_cast<char*>(bytes), count};
+        write_iov(&iov, 1);
+    }
+
+    // Écritures partielles reprises ; sur erreur, le reste du lot est perdu
+    void write_iov(iovec* iov, int count) {
+        while (count > 0) {
+            ssize_t written = ::writev(options.fd, iov, count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                errors.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            writes.fetch_add(1, std::memory_order_relaxed);
+            bytes_written.fetch_add(static_cast<uint64_t>(written), std::memory_order_relaxed);
+            size_t left = static_cast<size_t>(written);
+            while (count > 0 && left >= iov->iov_len) {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+    }
+};
+
+} // namespace logging
+} // namespace initlang
@@ -0,0 +1,447 @@
+// src/core/optimizer/optimizer.h
+#pragma once
+#include "../ast/ast.h"
+#include "../runtime/object.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace initlang {
+namespace optimizer {
+
+// Passes de réécriture de l'AST à pointeurs, avant la compilation. Les
+// nouveaux nœuds sont alloués dans l'arène du Program ; les nœuds
+// remplacés y restent, simplement détachés de l'arbre.
+//
+// Niveaux (-O) :
+//   0  aucune passe
+//   1  fold (pliage des constantes), dce (code mort après return)
+//   2  dce, inline (petites fonctions), fold
+//
+// Toutes les passes préservent la sémantique de la VM, erreurs comprises :
+// rien n'est plié ni supprimé qui pourrait lever une erreur à l'exécution.
+
+struct PassStats {
+    const char* name;
+    size_t nodes_before;
+    size_t nodes_after;
+    size_t rewrites;   // réécritures effectuées (plis, appels remplacés, instructions coupées)
+    double seconds;
+
+    long long nodes_removed() const {
+        return static_cast<long long>(nodes_before) - static_cast<long long>(nodes_after);
+    }
+};
+
+// Nombre de nœuds atteignables depuis les instructions du programme
+inline size_t count_nodes(const ast::Expression* expr) {
+    switch (expr->kind) {
+        case ast::NodeKind::BinaryExpression: {
+            auto* bin = static_cast<const ast::BinaryExpression*>(expr);
+            return 1 + count_nodes(bin->left) + count_nodes(bin->right);
+        }
+        case ast::NodeKind::CallExpression: {
+            auto* call = static_cast<const ast::CallExpression*>(expr);
+            size_t n = 1 + count_nodes(call->callee);
+            for (const ast::Expression* arg : call->arguments) n += count_nodes(arg);
+            return n;
+        }
+        case ast::NodeKind::SpawnExpression:
+            return 1 + count_nodes(static_cast<const ast::SpawnExpression*>(expr)->call);
+        case ast::NodeKind::AwaitExpression:
+            return 1 + count_nodes(static_cast<const ast::AwaitExpression*>(expr)->value);
+        default:
+            return 1;
+    }
+}
+
+inline size_t count_nodes(const ast::Statement* stmt) {
+    switch (stmt->kind) {
+        case ast::NodeKind::ExpressionStatement:
+            return 1 + count_nodes(static_cast<const ast::ExpressionStatement*>(stmt)->expression);
+        case ast::NodeKind::VariableDeclaration: {
+            auto* decl = static_cast<const ast::VariableDeclaration*>(stmt);
+            return 1 + (decl->value ? count_nodes(decl->value) : 0);
+        }
+        case ast::NodeKind::BlockStatement: {
+            size_t n = 1;
+            for (const ast::Statement* inner : static_cast<const ast::BlockStatement*>(stmt)->statements) {
+                n += count_nodes(inner);
+            }
+            return n;
+        }
+        case ast::NodeKind::FunctionDeclaration: {
+            auto* decl = static_cast<const ast::FunctionDeclaration*>(stmt);
+            return 1 + (decl->body ? count_nodes(decl->body) : 0);
+        }
+        case ast::NodeKind::ReturnStatement: {
+            auto* ret = static_cast<const ast::ReturnStatement*>(stmt);
+            return 1 + (ret->value ? count_nodes(ret->value) : 0);
+        }
+        default:
+            return 1;
+    }
+}
+
+inline size_t count_nodes(const ast::Program& program) {
+    size_t n = 0;
+    for (const ast::Statement* stmt : program.statements) n += count_nodes(stmt);
+    return n;
+}
+
+class Optimizer {
+public:
+    static constexpr int MAX_LEVEL = 2;
+    static constexpr size_t INLINE_MAX_NODES = 8; // taille du corps `return <expr>` inlinable
+
+    // `redefined` : globales définies aussi hors de ce Program (autres
+    // fichiers d'un projet, qui partagent les globales) ; jamais candidates
+    explicit Optimizer(ast::Program& p, const std::unordered_set<std::string_view>* r = nullptr)
+        : program(p), arena(*p.arena), redefined(r) {}
+
+    // Exécute les passes du niveau demandé ; une entrée par passe
+    std::vector<PassStats> run(int level) {
+        std::vector<PassStats> stats;
+        if (level <= 0) return stats;
+        if (level == 1) {
+            stats.push_back(measure("fold", [this] { return fold_program(); }));
+            stats.push_back(measure("dce", [this] { return dce_program(); }));
+        } else {
+            stats.push_back(measure("dce", [this] { return dce_program(); }));
+            stats.push_back(measure("inline", [this] { return inline_program(); }));
+            stats.push_back(measure("fold", [this] { return fold_program(); }));
+        }
+        return stats;
+    }
+
+private:
+    ast::Program& program;
+    ast::AstArena& arena;
+    const std::unordered_set<std::string_view>* redefined;
+
+    template <typename Pass>
+    PassStats measure(const char* name, Pass pass) {
+        PassStats s{name, count_nodes(program), 0, 0, 0};
+        auto start = std::chrono::steady_clock::now();
+        s.rewrites = pass();
+        s.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        s.nodes_after = count_nodes(program);
+        return s;
+    }
+
+    template <typename T, typename... Args>
+    T* make(ast::SourceLocation at, Args&&... args) {
+        T* node = arena.make<T>(std::forward<Args>(args)...);
+        node->location = at;
+        return node;
+    }
+
+    // Applique `f` à chaque emplacement d'expression d'une instruction,
+    // fonctions imbriquées comprises
+    template <typename F>
+    static void for_each_expression_slot(ast::Statement* stmt, F& f) {
+        switch (stmt->kind) {
+            case ast::NodeKind::ExpressionStatement:
+                f(static_cast<ast::ExpressionStatement*>(stmt)->expression);
+                break;
+            case ast::NodeKind::VariableDeclaration: {
+                auto* decl = static_cast<ast::VariableDeclaration*>(stmt);
+                if (decl->value) f(decl->value);
+                break;
+            }
+            case ast::NodeKind::BlockStatement:
+                for (ast::Statement* inner : static_cast<ast::BlockStatement*>(stmt)->statements) {
+                    for_each_expression_slot(inner, f);
+                }
+                break;
+            case ast::NodeKind::FunctionDeclaration: {
+                auto* decl = static_cast<ast::FunctionDeclaration*>(stmt);
+                if (decl->body) for_each_expression_slot(decl->body, f);
+                break;
+            }
+            case ast::NodeKind::ReturnStatement: {
+                auto* ret = static_cast<ast::ReturnStatement*>(stmt);
+                if (ret->value) f(ret->value);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // ----- fold : opérations sur littéraux -----
+
+    size_t fold_program() {
+        size_t folds = 0;
+        auto visit = [&](ast::Expression*& slot) { slot = fold(slot, folds); };
+        for (ast::Statement* stmt : program.statements) for_each_expression_slot(stmt, visit);
+        return folds;
+    }
+
+    ast::Expression* fold(ast::Expression* expr, size_t& folds) {
+        if (auto* call = ast::node_cast<ast::CallExpression>(expr)) {
+            call->callee = fold(call->callee, folds);
+            for (ast::Expression*& arg : call->arguments) arg = fold(arg, folds);
+            return call;
+        }
+        if (auto* spawn = ast::node_cast<ast::SpawnExpression>(expr)) {
+            fold(spawn->call, folds);
+            return spawn;
+        }
+        if (auto* wait = ast::node_cast<ast::AwaitExpression>(expr)) {
+            wait->value = fold(wait->value, folds);
+            return wait;
+        }
+        auto* bin = ast::node_cast<ast::BinaryExpression>(expr);
+        if (!bin) return expr;
+
+        bin->left = fold(bin->left, folds);
+        bin->right = fold(bin->right, folds);
+        ast::Expression* folded = fold_binary(bin);
+        if (folded != bin) ++folds;
+        return folded;
+    }
+
+    // Mêmes calculs que la VM : arithmétique IEEE sur double (division par
+    // zéro comprise) et concaténation avec le rendu de runtime::to_string.
+    // Les comparaisons ne sont pas pliées : l'AST n'a pas de littéral booléen.
+    ast::Expression* fold_binary(ast::BinaryExpression* bin) {
+        auto* ln = ast::node_cast<ast::NumberLiteral>(bin->left);
+        auto* rn = ast::node_cast<ast::NumberLiteral>(bin->right);
+        if (ln && rn) {
+            double a = ln->value, b = rn->value;
+            switch (bin->op) {
+                case lexer::TokenType::PLUS:  return make<ast::NumberLiteral>(bin->location, a + b);
+                case lexer::TokenType::MINUS: return make<ast::NumberLiteral>(bin->location, a - b);
+                case lexer::TokenType::STAR:  return make<ast::NumberLiteral>(bin->location, a * b);
+                case lexer::TokenType::SLASH: return make<ast::NumberLiteral>(bin->location, a / b);
+                default:                      return bin;
+            }
+        }
+
+        auto* ls = ast::node_cast<ast::StringLiteral>(bin->left);
+        auto* rs = ast::node_cast<ast::StringLiteral>(bin->right);
+        if (bin->op != lexer::TokenType::PLUS || !(ls || rs) || !(ls || ln) || !(rs || rn)) return bin;
+        if (!program.symbols || program.symbols->frozen()) return bin;
+
+        std::string text = ls ? std::string(ls->value.text) : runtime::to_string(runtime::Value::number(ln->value));
+        text += rs ? std::string(rs->value.text) : runtime::to_string(runtime::Value::number(rn->value));
+        return make<ast::StringLiteral>(bin->location, program.symbols->symbol(text));
+    }
+
+    // ----- dce : instructions après un return -----
+
+    size_t dce_program() {
+        size_t cuts = 0;
+        for (ast::Statement* stmt : program.statements) dce(stmt, cuts);
+        return cuts;
+    }
+
+    void dce(ast::Statement* stmt, size_t& cuts) {
+        if (auto* decl = ast::node_cast<ast::FunctionDeclaration>(stmt)) {
+            if (decl->body) dce(decl->body, cuts);
+            return;
+        }
+        auto* block = ast::node_cast<ast::BlockStatement>(stmt);
+        if (!block) return;
+
+        uint32_t keep = 0;
+        for (ast::Statement* inner : block->statements) {
+            dce(inner, cuts);
+            ++keep;
+            if (inner->kind == ast::NodeKind::ReturnStatement) break;
+        }
+        if (keep < block->statements.size()) {
+            block->statements = ast::ArenaArray<ast::Statement*>(block->statements.begin(), keep);
+            ++cuts;
+        }
+    }
+
+    // ----- inline : fi f(p...) { return <expr> } -----
+    //
+    // Candidates : fonctions de premier niveau déclarées une seule fois
+    // (aucune autre définition de la globale, ni ici ni dans `redefined`)
+    // dont le corps se réduit à `return <expr>`, <expr> ne contenant que
+    // des paramètres, des littéraux et des opérations binaires, en au plus
+    // INLINE_MAX_NODES nœuds. Les appels d'une candidate sont remplacés
+    // dans les instructions qui la suivent : un appel antérieur échouerait
+    // à l'exécution et doit continuer à échouer. Le corps d'une candidate est
+    // lui-même traité avant d'être examiné, ce qui inline les appels aux
+    // candidates précédentes ; une fonction récursive garde un appel et
+    // n'est donc jamais candidate.
+    //
+    // Un appel n'est remplacé que si son arité est exacte, que ses
+    // arguments sont des littéraux ou des identifiants (dupliqués sans
+    // effet de bord) et qu'un paramètre inutilisé ne reçoit qu'un littéral
+    // (un identifiant pourrait lever « Undefined variable »). Le nom appelé
+    // ne doit pas être masqué par une locale. L'appel d'un `spawn` reste un
+    // appel (seuls ses arguments sont traités).
+
+    struct Candidate {
+        const ast::FunctionDeclaration* decl;
+        const ast::Expression* body;
+        std::vector<uint32_t> uses; // occurrences de chaque paramètre
+    };
+
+    std::unordered_map<common::SymbolId, Candidate, common::SymbolIdHash> candidates;
+    std::vector<common::SymbolId> shadowed; // noms locaux des fonctions en cours
+
+    size_t inline_program() {
+        candidates.clear();
+        shadowed.clear();
+
+        std::unordered_map<common::SymbolId, int, common::SymbolIdHash> definitions;
+        for (const ast::Statement* stmt : program.statements) {
+            if (auto* var = ast::node_cast<ast::VariableDeclaration>(stmt)) ++definitions[var->name.id];
+            if (auto* fn = ast::node_cast<ast::FunctionDeclaration>(stmt)) ++definitions[fn->name.id];
+        }
+
+        size_t inlined = 0;
+        for (ast::Statement* stmt : program.statements) {
+            inline_statement(stmt, inlined);
+            auto* fn = ast::node_cast<ast::FunctionDeclaration>(stmt);
+            if (fn && definitions[fn->name.id] == 1 && !(redefined && redefined->count(fn->name.text))) consider(fn);
+        }
+        return inlined;
+    }
+
+    void consider(const ast::FunctionDeclaration* fn) {
+        if (!fn->body || fn->body->statements.size() != 1) return;
+        auto* ret = ast::node_cast<ast::ReturnStatement>(fn->body->statements[0]);
+        if (!ret || !ret->value || count_nodes(ret->value) > INLINE_MAX_NODES) return;
+
+        Candidate candidate{fn, ret->value, std::vector<uint32_t>(fn->parameters.size(), 0)};
+        if (!inlinable_body(fn, ret->value, candidate.uses)) return;
+        candidates[fn->name.id] = std::move(candidate);
+    }
+
+    static int parameter_index(const ast::FunctionDeclaration* fn, common::SymbolId name) {
+        // Le dernier paramètre homonyme l'emporte, comme pour les slots
+        for (size_t i = fn->parameters.size(); i-- > 0;) {
+            if (fn->parameters[i].id == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    static bool inlinable_body(const ast::FunctionDeclaration* fn, const ast::Expression* expr,
+                               std::vector<uint32_t>& uses) {
+        switch (expr->kind) {
+            case ast::NodeKind::NumberLiteral:
+            case ast::NodeKind::StringLiteral:
+                return true;
+            case ast::NodeKind::Identifier: {
+                int index = parameter_index(fn, static_cast<const ast::Identifier*>(expr)->name.id);
+                if (index < 0) return false;
+                ++uses[index];
+                return true;
+            }
+            case ast::NodeKind::BinaryExpression: {
+                auto* bin = static_cast<const ast::BinaryExpression*>(expr);
+                return inlinable_body(fn, bin->left, uses) && inlinable_body(fn, bin->right, uses);
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool is_shadowed(common::SymbolId name) const {
+        for (common::SymbolId local : shadowed) {
+            if (local == name) return true;
+        }
+        return false;
+    }
+
+    void inline_statement(ast::Statement* stmt, size_t& inlined) {
+        auto* fn = ast::node_cast<ast::FunctionDeclaration>(stmt);
+        if (!fn) {
+            auto visit = [&](ast::Expression*& slot) { slot = inline_expression(slot, inlined); };
+            for_each_expression_slot(stmt, visit);
+            return;
+        }
+        if (!fn->body) return;
+
+        // Paramètres et déclarations du corps masquent les globales
+        size_t mark = shadowed.size();
+        for (common::Symbol param : fn->parameters) shadowed.push_back(param.id);
+        for (const ast::Statement* inner : fn->body->statements) {
+            if (auto* var = ast::node_cast<ast::VariableDeclaration>(inner)) shadowed.push_back(var->name.id);
+            if (auto* nested = ast::node_cast<ast::FunctionDeclaration>(inner)) shadowed.push_back(nested->name.id);
+        }
+        for (ast::Statement* inner : fn->body->statements) inline_statement(inner, inlined);
+        shadowed.resize(mark);
+    }
+
+    ast::Expression* inline_expression(ast::Expression* expr, size_t& inlined) {
+        if (auto* bin = ast::node_cast<ast::BinaryExpression>(expr)) {
+            bin->left = inline_expression(bin->left, inlined);
+            bin->right = inline_expression(bin->right, inlined);
+            return bin;
+        }
+        if (auto* spawn = ast::node_cast<ast::SpawnExpression>(expr)) {
+            for (ast::Expression*& arg : spawn->call->arguments) arg = inline_expression(arg, inlined);
+            return spawn;
+        }
+        if (auto* wait = ast::node_cast<ast::AwaitExpression>(expr)) {
+            wait->value = inline_expression(wait->value, inlined);
+            return wait;
+        }
+        auto* call = ast::node_cast<ast::CallExpression>(expr);
+        if (!call) return expr;
+
+        for (ast::Expression*& arg : call->arguments) arg = inline_expression(arg, inlined);
+
+        auto* callee = ast::node_cast<ast::Identifier>(call->callee);
+        if (!callee || is_shadowed(callee->name.id)) return call;
+        auto it = candidates.find(callee->name.id);
+        if (it == candidates.end()) return call;
+
+        const Candidate& candidate = it->second;
+        if (call->arguments.size() != candidate.decl->parameters.size()) return call;
+        for (size_t i = 0; i < call->arguments.size(); ++i) {
+            const ast::Expression* arg = call->arguments[i];
+            bool literal = arg->kind == ast::NodeKind::NumberLiteral || arg->kind == ast::NodeKind::StringLiteral;
+            if (!literal && (arg->kind != ast::NodeKind::Identifier || candidate.uses[i] == 0)) return call;
+        }
+
+        ++inlined;
+        return substitute(candidate, candidate.body, call);
+    }
+
+    // Copie du corps, paramètres remplacés par une copie de l'argument ;
+    // les nœuds prennent la position de l'appel
+    ast::Expression* substitute(const Candidate& candidate, const ast::Expression* expr, const ast::CallExpression* call) {
+        switch (expr->kind) {
+            case ast::NodeKind::NumberLiteral:
+                return make<ast::NumberLiteral>(call->location, static_cast<const ast::NumberLiteral*>(expr)->value);
+            case ast::NodeKind::StringLiteral:
+                return make<ast::StringLiteral>(call->location, static_cast<const ast::StringLiteral*>(expr)->value);
+            case ast::NodeKind::Identifier: {
+                int index = parameter_index(candidate.decl, static_cast<const ast::Identifier*>(expr)->name.id);
+                const ast::Expression* arg = call->arguments[index];
+                if (auto* ident = ast::node_cast<ast::Identifier>(arg)) {
+                    return make<ast::Identifier>(arg->location, ident->name);
+                }
+                return substitute(candidate, arg, call);
+            }
+            case ast::NodeKind::BinaryExpression: {
+                auto* bin = static_cast<const ast::BinaryExpression*>(expr);
+                return make<ast::BinaryExpression>(call->location, bin->op, substitute(candidate, bin->left, call),
+                                                   substitute(candidate, bin->right, call));
+            }
+            default:
+                return nullptr; // exclu par inlinable_body
+        }
+    }
+};
+
+inline std::vector<PassStats> optimize(ast::Program& program, int level,
+                                       const std::unordered_set<std::string_view>* redefined = nullptr) {
+    return Optimizer(program, redefined).run(level);
+}
+
+} // namespace optimizer
+} // namespace initlang
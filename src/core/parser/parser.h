@@ -2,32 +2,164 @@
 #pragma once
 #include "../lexer/lexer.h"
 #include "../ast/ast.h"
+#include "../ast/flat_ast.h"
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <utility>
 #include <stdexcept>
 
 namespace initlang {
 namespace parser {
 
-class Parser {
+// Précedence des opérateurs
+enum Precedence {
+    LOWEST,
+    EQUALS,      // ==
+    LESSGREATER, // > or <
+    SUM,         // +
+    PRODUCT,     // *
+    PREFIX,      // -X, !X, spawn X, await X
+    CALL         // myFunction(X)
+};
+
+// Table dense indexée par TokenType, construite à la compilation
+inline constexpr std::array<Precedence, lexer::TOKEN_TYPE_COUNT> precedence_table = [] {
+    std::array<Precedence, lexer::TOKEN_TYPE_COUNT> table{};
+    auto set = [&table](lexer::TokenType type, Precedence p) {
+        table[static_cast<size_t>(type)] = p;
+    };
+    set(lexer::TokenType::EQ, EQUALS);
+    set(lexer::TokenType::NEQ, EQUALS);
+    set(lexer::TokenType::LT, LESSGREATER);
+    set(lexer::TokenType::GT, LESSGREATER);
+    set(lexer::TokenType::LTE, LESSGREATER);
+    set(lexer::TokenType::GTE, LESSGREATER);
+    set(lexer::TokenType::PLUS, SUM);
+    set(lexer::TokenType::MINUS, SUM);
+    set(lexer::TokenType::SLASH, PRODUCT);
+    set(lexer::TokenType::STAR, PRODUCT);
+    set(lexer::TokenType::LPAREN, CALL);
+    return table;
+}();
+
+// Constructeur de l'arbre à pointeurs (ast.h) dans une AstArena. Les listes
+// sont accumulées sur des piles de travail réutilisées puis copiées dans
+// l'arène : pas d'allocation par liste en régime établi.
+class TreeBuilder {
+public:
+    using Expr = ast::Expression*;
+    using Stmt = ast::Statement*;
+    using Block = ast::BlockStatement*;
+
+    static constexpr std::nullptr_t null() { return nullptr; }
+
+    TreeBuilder(ast::AstArena& a, ast::Program& p) : arena(a), program(p) {}
+
+    Expr number(ast::SourceLocation at, double value) { return make<ast::NumberLiteral>(at, value); }
+    Expr string_literal(ast::SourceLocation at, common::Symbol value) { return make<ast::StringLiteral>(at, value); }
+    Expr identifier(ast::SourceLocation at, common::Symbol name) { return make<ast::Identifier>(at, name); }
+
+    Expr binary(ast::SourceLocation at, lexer::TokenType op, Expr left, Expr right) {
+        return make<ast::BinaryExpression>(at, op, left, right);
+    }
+
+    size_t mark_expressions() const { return expression_stack.size(); }
+    void push_expression(Expr e) { expression_stack.push_back(e); }
+
+    Expr call(ast::SourceLocation at, Expr callee, size_t mark) {
+        return make<ast::CallExpression>(at, callee, pop_list(expression_stack, mark));
+    }
+
+    bool is_call(Expr e) const { return e && e->kind == ast::NodeKind::CallExpression; }
+    Expr spawn_expression(ast::SourceLocation at, Expr call) {
+        return make<ast::SpawnExpression>(at, static_cast<ast::CallExpression*>(call));
+    }
+    Expr await_expression(ast::SourceLocation at, Expr value) { return make<ast::AwaitExpression>(at, value); }
+
+    Stmt expression_statement(ast::SourceLocation at, Expr e) { return make<ast::ExpressionStatement>(at, e); }
+
+    // Le nom est le dernier empilé depuis `names_mark`
+    Stmt variable(ast::SourceLocation at, size_t names_mark, Expr value, bool is_const = false) {
+        common::Symbol name = name_stack[names_mark];
+        name_stack.resize(names_mark);
+        return make<ast::VariableDeclaration>(at, name, value, is_const);
+    }
+
+    size_t mark_statements() const { return statement_stack.size(); }
+    void push_statement(Stmt s) { statement_stack.push_back(s); }
+
+    Block block(ast::SourceLocation at, size_t mark) {
+        return make<ast::BlockStatement>(at, pop_list(statement_stack, mark));
+    }
+
+    size_t mark_names() const { return name_stack.size(); }
+    void push_name(common::Symbol name) { name_stack.push_back(name); }
+
+    // Pile de noms depuis `names_mark` : nom de la fonction puis paramètres
+    Stmt function(ast::SourceLocation at, size_t names_mark, Block body, bool is_async = false) {
+        common::Symbol name = name_stack[names_mark];
+        auto params = pop_list(name_stack, names_mark + 1);
+        name_stack.pop_back();
+        return make<ast::FunctionDeclaration>(at, name, params, body, is_async);
+    }
+
+    Stmt return_statement(ast::SourceLocation at, Expr value) { return make<ast::ReturnStatement>(at, value); }
+
+    void add_to_program(Stmt s) { program.statements.push_back(s); }
+
+private:
+    ast::AstArena& arena;
+    ast::Program& program;
+    std::vector<ast::Expression*> expression_stack;
+    std::vector<ast::Statement*> statement_stack;
+    std::vector<common::Symbol> name_stack;
+
+    template <typename T, typename... Args>
+    T* make(ast::SourceLocation at, Args&&... args) {
+        T* node = arena.make<T>(std::forward<Args>(args)...);
+        node->location = at;
+        return node;
+    }
+
+    template <typename T>
+    ast::ArenaArray<T> pop_list(std::vector<T>& stack, size_t mark) {
+        auto list = arena.copy_array(stack.data() + mark, stack.size() - mark);
+        stack.resize(mark);
+        return list;
+    }
+};
+
+// Grammaire INITLANG, indépendante de la forme d'AST produite : le Builder
+// (TreeBuilder ou ast::FlatBuilder) fabrique les nœuds.
+template <typename Builder>
+class BasicParser {
 private:
+    using Expr = typename Builder::Expr;
+    using Stmt = typename Builder::Stmt;
+    using Block = typename Builder::Block;
+
     lexer::Lexer& lexer;
-    lexer::Token current_token;
-    lexer::Token peek_token;
-    
+    lexer::Token& current_token;
+    lexer::Token& peek_token;
+    common::Interner& symbols;
+    Builder& build;
+
     void next_token() {
         current_token = peek_token;
         peek_token = lexer.next_token();
     }
-    
+
     bool current_token_is(lexer::TokenType type) {
         return current_token.type == type;
     }
-    
+
     bool peek_token_is(lexer::TokenType type) {
         return peek_token.type == type;
     }
-    
+
     bool expect_peek(lexer::TokenType type) {
         if (peek_token_is(type)) {
             next_token();
@@ -35,217 +167,208 @@ private:
         }
         return false;
     }
-    
+
+    ast::SourceLocation here() const {
+        return ast::SourceLocation{current_token.line, current_token.column};
+    }
+
+    // Symbole du token courant : déjà interné par le Lexer s'il partage
+    // notre Interner, sinon haché ici.
+    common::Symbol current_symbol() {
+        if (current_token.symbol.valid() && lexer.interner() == &symbols) {
+            return symbols.symbol(current_token.symbol);
+        }
+        return symbols.symbol(current_token.value);
+    }
+
     void error(const std::string& msg) {
-        throw std::runtime_error(msg + " at line " + 
-                                std::to_string(current_token.line) + ":" + 
+        throw std::runtime_error(msg + " at line " +
+                                std::to_string(current_token.line) + ":" +
                                 std::to_string(current_token.column));
     }
 
 public:
-    Parser(lexer::Lexer& l) : lexer(l) {
-        next_token();
-        next_token();
-    }
-    
-    std::unique_ptr<ast::Program> parse_program() {
-        auto program = std::make_unique<ast::Program>();
-        
+    BasicParser(lexer::Lexer& l, lexer::Token& current, lexer::Token& peek,
+                common::Interner& interner, Builder& b)
+        : lexer(l), current_token(current), peek_token(peek), symbols(interner), build(b) {}
+
+    void parse_program() {
         while (!current_token_is(lexer::TokenType::EOF_TOKEN)) {
             auto stmt = parse_statement();
-            if (stmt) {
-                program->statements.push_back(std::move(stmt));
+            if (stmt != Builder::null()) {
+                build.add_to_program(stmt);
             }
             next_token();
         }
-        
-        return program;
     }
-    
+
 private:
-    std::unique_ptr<ast::Statement> parse_statement() {
+    Stmt parse_statement() {
         switch (current_token.type) {
             case lexer::TokenType::LET:
                 return parse_let_statement();
             case lexer::TokenType::FI:
                 return parse_function_statement();
+            case lexer::TokenType::ASYNC:
+                return parse_async_function_statement();
             case lexer::TokenType::RETURN:
                 return parse_return_statement();
             default:
                 return parse_expression_statement();
         }
     }
-    
-    std::unique_ptr<ast::VariableDeclaration> parse_let_statement() {
+
+    Stmt parse_let_statement() {
         // let x ==> 5
+        ast::SourceLocation at = here();
         next_token(); // skip 'let'
-        
+
         if (!current_token_is(lexer::TokenType::IDENTIFIER)) {
             error("Expected identifier after 'let'");
-            return nullptr;
+            return Builder::null();
         }
-        
-        std::string name = current_token.value;
-        next_token(); // skip identifier
-        
+
+        // Interné tout de suite : en mode flux, la vue ne survit pas à la valeur
+        size_t names_mark = build.mark_names();
+        build.push_name(current_symbol());
+
         if (!expect_peek(lexer::TokenType::ARROW)) {
             error("Expected '==>' after variable name");
-            return nullptr;
+            return Builder::null();
         }
-        
+
         next_token(); // skip '==>'
         auto value = parse_expression(LOWEST);
-        
-        return std::make_unique<ast::VariableDeclaration>(name, std::move(value));
+
+        return build.variable(at, names_mark, value);
+    }
+
+    Stmt parse_async_function_statement() {
+        // async fi fetch(x) { return await spawn load(x) }
+        ast::SourceLocation at = here();
+        if (!expect_peek(lexer::TokenType::FI)) {
+            error("Expected 'fi' after 'async'");
+            return Builder::null();
+        }
+        return parse_function_statement(at, true);
     }
-    
-    std::unique_ptr<ast::FunctionDeclaration> parse_function_statement() {
+
+    Stmt parse_function_statement() { return parse_function_statement(here(), false); }
+
+    Stmt parse_function_statement(ast::SourceLocation at, bool is_async) {
         // fi add(a, b) { return a + b }
         next_token(); // skip 'fi'
-        
+
         if (!current_token_is(lexer::TokenType::IDENTIFIER)) {
             error("Expected function name after 'fi'");
-            return nullptr;
+            return Builder::null();
         }
-        
-        std::string name = current_token.value;
-        next_token(); // skip function name
-        
+
+        // Nom puis paramètres sur la pile de noms du Builder
+        size_t names_mark = build.mark_names();
+        build.push_name(current_symbol());
+
         if (!expect_peek(lexer::TokenType::LPAREN)) {
             error("Expected '(' after function name");
-            return nullptr;
+            return Builder::null();
         }
-        
-        auto params = parse_function_parameters();
-        
+
+        parse_function_parameters();
+
         if (!expect_peek(lexer::TokenType::LBRACE)) {
             error("Expected '{' after function parameters");
-            return nullptr;
+            return Builder::null();
         }
-        
+
         auto body = parse_block_statement();
-        
-        return std::make_unique<ast::FunctionDeclaration>(name, std::move(params), std::move(body));
+
+        return build.function(at, names_mark, body, is_async);
     }
-    
-    std::vector<std::string> parse_function_parameters() {
-        std::vector<std::string> parameters;
-        
+
+    void parse_function_parameters() {
         if (peek_token_is(lexer::TokenType::RPAREN)) {
             next_token();
-            return parameters;
+            return;
         }
-        
+
         next_token(); // skip '(' or ','
-        
+
         if (current_token_is(lexer::TokenType::IDENTIFIER)) {
-            parameters.push_back(current_token.value);
+            build.push_name(current_symbol());
         } else {
             error("Expected parameter name");
-            return parameters;
         }
-        
+
         while (peek_token_is(lexer::TokenType::COMMA)) {
             next_token(); // skip identifier
             next_token(); // skip ','
-            
+
             if (current_token_is(lexer::TokenType::IDENTIFIER)) {
-                parameters.push_back(current_token.value);
+                build.push_name(current_symbol());
             } else {
                 error("Expected parameter name after ','");
                 break;
             }
         }
-        
+
         if (!expect_peek(lexer::TokenType::RPAREN)) {
             error("Expected ')' after parameters");
         }
-        
-        return parameters;
     }
-    
-    std::unique_ptr<ast::BlockStatement> parse_block_statement() {
-        auto block = std::make_unique<ast::BlockStatement>();
+
+    Block parse_block_statement() {
+        size_t mark = build.mark_statements();
+        ast::SourceLocation at = here();
         next_token(); // skip '{'
-        
-        while (!current_token_is(lexer::TokenType::RBRACE) && 
+
+        while (!current_token_is(lexer::TokenType::RBRACE) &&
                !current_token_is(lexer::TokenType::EOF_TOKEN)) {
             auto stmt = parse_statement();
-            if (stmt) {
-                block->statements.push_back(std::move(stmt));
+            if (stmt != Builder::null()) {
+                build.push_statement(stmt);
             }
             next_token();
         }
-        
-        return block;
+
+        return build.block(at, mark);
     }
-    
-    std::unique_ptr<ast::ReturnStatement> parse_return_statement() {
+
+    Stmt parse_return_statement() {
+        ast::SourceLocation at = here();
         next_token(); // skip 'return'
         auto value = parse_expression(LOWEST);
-        return std::make_unique<ast::ReturnStatement>(std::move(value));
+        return build.return_statement(at, value);
     }
-    
-    std::unique_ptr<ast::ExpressionStatement> parse_expression_statement() {
+
+    Stmt parse_expression_statement() {
+        ast::SourceLocation at = here();
         auto expr = parse_expression(LOWEST);
-        return std::make_unique<ast::ExpressionStatement>(std::move(expr));
-    }
-    
-    // Précedence des opérateurs
-    enum Precedence {
-        LOWEST,
-        EQUALS,      // ==
-        LESSGREATER, // > or <
-        SUM,         // +
-        PRODUCT,     // *
-        PREFIX,      // -X or !X
-        CALL         // myFunction(X)
-    };
-    
-    std::unordered_map<lexer::TokenType, Precedence> precedences = {
-        {lexer::TokenType::EQ, EQUALS},
-        {lexer::TokenType::NEQ, EQUALS},
-        {lexer::TokenType::LT, LESSGREATER},
-        {lexer::TokenType::GT, LESSGREATER},
-        {lexer::TokenType::LTE, LESSGREATER},
-        {lexer::TokenType::GTE, LESSGREATER},
-        {lexer::TokenType::PLUS, SUM},
-        {lexer::TokenType::MINUS, SUM},
-        {lexer::TokenType::SLASH, PRODUCT},
-        {lexer::TokenType::STAR, PRODUCT},
-        {lexer::TokenType::LPAREN, CALL},
-    };
-    
-    Precedence current_precedence() {
-        auto it = precedences.find(current_token.type);
-        if (it != precedences.end()) {
-            return it->second;
-        }
-        return LOWEST;
+        return build.expression_statement(at, expr);
     }
-    
-    Precedence peek_precedence() {
-        auto it = precedences.find(peek_token.type);
-        if (it != precedences.end()) {
-            return it->second;
-        }
-        return LOWEST;
+
+    Precedence current_precedence() const {
+        return precedence_table[static_cast<size_t>(current_token.type)];
+    }
+
+    Precedence peek_precedence() const {
+        return precedence_table[static_cast<size_t>(peek_token.type)];
     }
-    
-    std::unique_ptr<ast::Expression> parse_expression(Precedence precedence) {
+
+    Expr parse_expression(Precedence precedence) {
         auto left = parse_prefix();
-        if (!left) return nullptr;
-        
-        while (!peek_token_is(lexer::TokenType::SEMICOLON) && 
+        if (left == Builder::null()) return Builder::null();
+
+        while (!peek_token_is(lexer::TokenType::SEMICOLON) &&
                precedence < peek_precedence()) {
-            left = parse_infix(std::move(left));
-            if (!left) return nullptr;
+            next_token(); // avancer sur l'opérateur infixe
+            left = parse_infix(left);
+            if (left == Builder::null()) return Builder::null();
         }
-        
+
         return left;
     }
-    
-    std::unique_ptr<ast::Expression> parse_prefix() {
+
+    Expr parse_prefix() {
         switch (current_token.type) {
             case lexer::TokenType::IDENTIFIER:
                 return parse_identifier();
@@ -254,19 +377,24 @@ private:
             case lexer::TokenType::STRING:
                 return parse_string_literal();
             case lexer::TokenType::INIT_GER:
-                return parse_init_ger();
+            case lexer::TokenType::INIT_LOG:
+                return parse_builtin();
             case lexer::TokenType::LPAREN:
                 return parse_grouped_expression();
             case lexer::TokenType::MINUS:
             case lexer::TokenType::NOT:
                 return parse_prefix_expression();
+            case lexer::TokenType::SPAWN:
+                return parse_spawn_expression();
+            case lexer::TokenType::AWAIT:
+                return parse_await_expression();
             default:
-                error("No prefix parse function for " + current_token.value);
-                return nullptr;
+                error("No prefix parse function for " + std::string(current_token.value));
+                return Builder::null();
         }
     }
-    
-    std::unique_ptr<ast::Expression> parse_infix(std::unique_ptr<ast::Expression> left) {
+
+    Expr parse_infix(Expr left) {
         switch (current_token.type) {
             case lexer::TokenType::PLUS:
             case lexer::TokenType::MINUS:
@@ -278,125 +406,189 @@ private:
             case lexer::TokenType::GT:
             case lexer::TokenType::LTE:
             case lexer::TokenType::GTE:
-                return parse_binary_expression(std::move(left));
+                return parse_binary_expression(left);
             case lexer::TokenType::LPAREN:
-                return parse_call_expression(std::move(left));
+                return parse_call_expression(left);
             default:
                 return left;
         }
     }
-    
-    std::unique_ptr<ast::Identifier> parse_identifier() {
-        return std::make_unique<ast::Identifier>(current_token.value);
+
+    Expr parse_identifier() {
+        return build.identifier(here(), current_symbol());
     }
-    
-    std::unique_ptr<ast::NumberLiteral> parse_number_literal() {
+
+    Expr parse_number_literal() {
         try {
-            double value = std::stod(current_token.value);
-            return std::make_unique<ast::NumberLiteral>(value);
+            double value = std::stod(std::string(current_token.value));
+            return build.number(here(), value);
         } catch (...) {
-            error("Could not parse number: " + current_token.value);
-            return nullptr;
+            error("Could not parse number: " + std::string(current_token.value));
+            return Builder::null();
         }
     }
-    
-    std::unique_ptr<ast::StringLiteral> parse_string_literal() {
-        return std::make_unique<ast::StringLiteral>(current_token.value);
+
+    Expr parse_string_literal() {
+        return build.string_literal(here(), current_symbol());
     }
-    
-    std::unique_ptr<ast::Expression> parse_init_ger() {
-        // init.ger(expression)
-        next_token(); // skip 'init.ger'
-        
-        if (!expect_peek(lexer::TokenType::LPAREN)) {
-            error("Expected '(' after init.ger");
-            return nullptr;
-        }
-        
-        next_token(); // skip '('
-        auto arg = parse_expression(LOWEST);
-        
-        if (!expect_peek(lexer::TokenType::RPAREN)) {
-            error("Expected ')' after init.ger argument");
-            return nullptr;
+
+    Expr parse_builtin() {
+        // init.ger(...) / init.log(...) : l'appel est analysé comme un
+        // CallExpression ordinaire dont l'appelé porte le nom réservé ; le
+        // compilateur le reconnaît à son SymbolId.
+        if (!peek_token_is(lexer::TokenType::LPAREN)) {
+            error("Expected '(' after " + std::string(current_token.value));
+            return Builder::null();
         }
-        
-        // Pour l'instant, on retourne simplement l'argument
-        // Plus tard, ce sera un CallExpression spécial
-        return arg;
+        return build.identifier(here(), symbols.symbol(current_token.value));
     }
-    
-    std::unique_ptr<ast::Expression> parse_grouped_expression() {
+
+    Expr parse_grouped_expression() {
         next_token(); // skip '('
         auto expr = parse_expression(LOWEST);
-        
+
         if (!expect_peek(lexer::TokenType::RPAREN)) {
             error("Expected ')' after expression");
-            return nullptr;
+            return Builder::null();
         }
-        
+
         return expr;
     }
-    
-    std::unique_ptr<ast::Expression> parse_prefix_expression() {
+
+    Expr parse_prefix_expression() {
         auto op = current_token.type;
+        ast::SourceLocation at = here();
         next_token(); // skip operator
         auto right = parse_expression(PREFIX);
-        
-        if (!right) return nullptr;
-        
+
+        if (right == Builder::null()) return Builder::null();
+
         // Pour l'instant, on gère seulement la négation
         if (op == lexer::TokenType::MINUS) {
             // Créer une expression binaire: 0 - right
-            auto zero = std::make_unique<ast::NumberLiteral>(0);
-            return std::make_unique<ast::BinaryExpression>(
-                lexer::TokenType::MINUS, std::move(zero), std::move(right));
+            auto zero = build.number(at, 0);
+            return build.binary(at, lexer::TokenType::MINUS, zero, right);
         }
-        
+
         return right;
     }
-    
-    std::unique_ptr<ast::BinaryExpression> parse_binary_expression(std::unique_ptr<ast::Expression> left) {
+
+    Expr parse_spawn_expression() {
+        // spawn f(x) : l'opérande, de précédence PREFIX, doit être un appel
+        ast::SourceLocation at = here();
+        next_token(); // skip 'spawn'
+        auto call = parse_expression(PREFIX);
+        if (call == Builder::null()) return Builder::null();
+        if (!build.is_call(call)) {
+            error("Expected call after 'spawn'");
+            return Builder::null();
+        }
+        return build.spawn_expression(at, call);
+    }
+
+    Expr parse_await_expression() {
+        ast::SourceLocation at = here();
+        next_token(); // skip 'await'
+        auto value = parse_expression(PREFIX);
+        if (value == Builder::null()) return Builder::null();
+        return build.await_expression(at, value);
+    }
+
+    Expr parse_binary_expression(Expr left) {
         auto op = current_token.type;
         auto precedence = current_precedence();
-        
+        ast::SourceLocation at = here();
+
         next_token(); // skip operator
         auto right = parse_expression(precedence);
-        
-        if (!right) return nullptr;
-        
-        return std::make_unique<ast::BinaryExpression>(op, std::move(left), std::move(right));
-    }
-    
-    std::unique_ptr<ast::CallExpression> parse_call_expression(std::unique_ptr<ast::Expression> function) {
-        auto call_expr = std::make_unique<ast::CallExpression>();
-        call_expr->callee = std::move(function);
-        call_expr->arguments = parse_call_arguments();
-        return call_expr;
-    }
-    
-    std::vector<std::unique_ptr<ast::Expression>> parse_call_arguments() {
-        std::vector<std::unique_ptr<ast::Expression>> args;
-        
+
+        if (right == Builder::null()) return Builder::null();
+
+        return build.binary(at, op, left, right);
+    }
+
+    Expr parse_call_expression(Expr function) {
+        size_t mark = build.mark_expressions();
+        ast::SourceLocation at = here();
+        parse_call_arguments();
+        return build.call(at, function, mark);
+    }
+
+    void parse_call_arguments() {
         if (peek_token_is(lexer::TokenType::RPAREN)) {
             next_token();
-            return args;
+            return;
         }
-        
+
         next_token(); // skip '(' or ','
-        args.push_back(parse_expression(LOWEST));
-        
+        build.push_expression(parse_expression(LOWEST));
+
         while (peek_token_is(lexer::TokenType::COMMA)) {
             next_token(); // skip expression
             next_token(); // skip ','
-            args.push_back(parse_expression(LOWEST));
+            build.push_expression(parse_expression(LOWEST));
         }
-        
+
         if (!expect_peek(lexer::TokenType::RPAREN)) {
             error("Expected ')' after arguments");
         }
-        
-        return args;
+    }
+};
+
+// Point d'entrée : lit le flux de tokens d'un Lexer et produit l'AST sous
+// forme d'arbre (parse_program) ou sous forme plate (parse_flat_program).
+//
+// Identifiants et chaînes sont internés dans `symbols`, partagé avec l'AST
+// produit (Program::symbols, FlatAst::symbols) puis avec le compilateur. Si
+// le Lexer n'a pas encore d'Interner, il reçoit celui du Parser.
+class Parser {
+private:
+    lexer::Lexer& lexer;
+    std::shared_ptr<common::Interner> symbols;
+    lexer::Token current_token;
+    lexer::Token peek_token;
+
+    void next_token() {
+        current_token = peek_token;
+        peek_token = lexer.next_token();
+    }
+
+public:
+    Parser(lexer::Lexer& l, std::shared_ptr<common::Interner> interner = nullptr)
+        : lexer(l), symbols(interner ? std::move(interner) : std::make_shared<common::Interner>()) {
+        if (!lexer.interner()) lexer.set_interner(symbols.get());
+        next_token();
+        next_token();
+    }
+
+    // Le Program possède sa propre arène
+    std::unique_ptr<ast::Program> parse_program() {
+        auto owned = std::make_unique<ast::AstArena>();
+        auto program = parse_program(*owned);
+        program->owned_arena = std::move(owned);
+        return program;
+    }
+
+    // Les nœuds sont alloués dans `arena`, qui doit survivre au Program
+    std::unique_ptr<ast::Program> parse_program(ast::AstArena& arena) {
+        auto program = std::make_unique<ast::Program>();
+        program->arena = &arena;
+        program->symbols = symbols;
+
+        TreeBuilder builder(arena, *program);
+        BasicParser<TreeBuilder>(lexer, current_token, peek_token, *symbols, builder).parse_program();
+        return program;
+    }
+
+    const std::shared_ptr<common::Interner>& interner() const { return symbols; }
+
+    // Émet directement la forme plate (ast::FlatAst)
+    ast::FlatAst parse_flat_program() {
+        ast::FlatAst tree;
+        tree.symbols = symbols;
+        ast::FlatBuilder builder(tree);
+        BasicParser<ast::FlatBuilder>(lexer, current_token, peek_token, *symbols, builder).parse_program();
+        return tree;
     }
 };
 
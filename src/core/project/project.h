@@ -0,0 +1,246 @@
+// src/core/project/project.h
+#pragma once
+#include "parser.h"
+#include "optimizer.h"
+#include "resolver.h"
+#include "compiler.h"
+#include "peephole.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace initlang {
+namespace project {
+
+// Compilation d'un projet multi-fichiers sur un pool de threads fixe.
+//
+// Chaque fichier passe par Lexer -> Parser -> optimiseur -> compilateur
+// avec son propre Interner (le « shard » de symboles du fichier) et sa
+// propre arène d'AST. Le Heap n'étant pas partagé entre threads, la
+// compilation se fait en quatre phases :
+//   1. parallèle : analyse ; puis, séquentiellement, décompte des
+//      définitions de premier niveau (let, fi) de tous les fichiers ; puis
+//      en parallèle optimisation de l'AST et résolution, chaque fichier
+//      rendant la liste de ses globales (Resolver::global_names). Les
+//      globales étant partagées, une fonction définie plusieurs fois dans
+//      le projet n'est inlinée dans aucun fichier ;
+//   2. séquentielle : numérotation des globales dans le Heap principal,
+//      fichier par fichier dans l'ordre donné ;
+//   3. parallèle : chaque worker compile dans un Heap privé, amorcé avec
+//      tous les noms de globales dans l'ordre des identifiants, ce qui lui
+//      donne exactement la numérotation du Heap principal ;
+//   4. séquentielle : recopie des fonctions dans le Heap principal, dans
+//      l'ordre des fichiers (chaînes ré-internées).
+// La numérotation ne dépend que de l'ordre des fichiers : le résultat est
+// identique octet pour octet quel que soit le nombre de threads.
+
+struct Options {
+    size_t threads = 0; // 0 : std::thread::hardware_concurrency()
+    int level = 0;      // niveau -O (optimiseur d'AST, puis peephole si > 0)
+};
+
+struct Stats {
+    size_t files = 0;
+    size_t threads = 0;
+    size_t globals = 0; // globales numérotées par le projet
+    double parse_seconds = 0;
+    double link_seconds = 0;
+    double compile_seconds = 0;
+    double merge_seconds = 0;
+};
+
+struct Result {
+    std::vector<runtime::ObjFunction*> scripts; // un par fichier, à exécuter dans l'ordre
+    Stats stats;
+};
+
+// Exécute task(worker, i) pour i dans [0, count) sur `threads` threads
+// (worker dans [0, threads), le thread appelant étant le worker 0). Les
+// indices sont distribués à la demande ; task ne doit pas lever.
+template <typename Task>
+void parallel_for(size_t count, size_t threads, Task&& task) {
+    std::atomic<size_t> next{0};
+    auto worker = [&](size_t t) {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) task(t, i);
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& thread : pool) thread.join();
+}
+
+class ProjectCompiler {
+public:
+    ProjectCompiler(runtime::Heap& h, Options o = {}) : heap(h), options(o) {}
+
+    // Compile `paths` ; en cas d'erreur, lève celle du premier fichier fautif
+    // (dans l'ordre de `paths`), préfixée de son chemin.
+    Result compile(const std::vector<std::string>& paths) {
+        using Clock = std::chrono::steady_clock;
+        Result result;
+        const size_t count = paths.size();
+        size_t threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        if (threads > count) threads = count > 0 ? count : 1;
+        result.stats.files = count;
+        result.stats.threads = threads;
+
+        std::vector<Unit> units(count);
+        for (size_t i = 0; i < count; ++i) units[i].path = &paths[i];
+
+        // Phase 1
+        auto start = Clock::now();
+        parallel_for(count, threads, [&](size_t, size_t i) { parse(units[i]); });
+        rethrow_first(units);
+        std::unordered_map<std::string_view, int> definitions;
+        for (const Unit& unit : units) {
+            for (const ast::Statement* stmt : unit.program->statements) {
+                if (auto* var = ast::node_cast<ast::VariableDeclaration>(stmt)) ++definitions[var->name.text];
+                if (auto* fn = ast::node_cast<ast::FunctionDeclaration>(stmt)) ++definitions[fn->name.text];
+            }
+        }
+        std::unordered_set<std::string_view> redefined;
+        for (const auto& [name, n] : definitions) {
+            if (n > 1) redefined.insert(name);
+        }
+        parallel_for(count, threads, [&](size_t, size_t i) { analyze(units[i], redefined); });
+        rethrow_first(units);
+        result.stats.parse_seconds = seconds_since(start);
+
+        // Phase 2
+        start = Clock::now();
+        size_t before = heap.global_count();
+        for (const Unit& unit : units) {
+            for (const std::string& name : unit.globals) heap.global_id(heap.intern(name));
+        }
+        result.stats.globals = heap.global_count() - before;
+        std::vector<std::string_view> names(heap.global_count());
+        for (uint32_t id = 0; id < names.size(); ++id) names[id] = heap.global_name(id)->view();
+        result.stats.link_seconds = seconds_since(start);
+
+        // Phase 3 : un Heap privé par worker, qui ne voit que ses fichiers
+        start = Clock::now();
+        std::vector<std::unique_ptr<runtime::Heap>> heaps(threads);
+        parallel_for(count, threads, [&](size_t t, size_t i) {
+            if (!heaps[t]) {
+                heaps[t] = std::make_unique<runtime::Heap>();
+                for (std::string_view name : names) heaps[t]->global_id(heaps[t]->intern(name));
+            }
+            generate(units[i], *heaps[t], names.size());
+        });
+        rethrow_first(units);
+        result.stats.compile_seconds = seconds_since(start);
+
+        // Phase 4
+        start = Clock::now();
+        std::unordered_map<const runtime::ObjFunction*, runtime::ObjFunction*> copies;
+        for (Unit& unit : units) result.scripts.push_back(import(unit.script, copies));
+        result.stats.merge_seconds = seconds_since(start);
+        return result;
+    }
+
+private:
+    runtime::Heap& heap;
+    Options options;
+
+    struct Unit {
+        const std::string* path = nullptr;
+        std::unique_ptr<lexer::Lexer> source;
+        std::unique_ptr<parser::Parser> parser; // garde l'Interner du fichier
+        std::unique_ptr<ast::Program> program;
+        std::vector<std::string> globals;
+        runtime::ObjFunction* script = nullptr; // dans un Heap privé
+        std::exception_ptr error;
+    };
+
+    static double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static void rethrow_first(const std::vector<Unit>& units) {
+        for (const Unit& unit : units) {
+            if (!unit.error) continue;
+            try {
+                std::rethrow_exception(unit.error);
+            } catch (const std::exception& e) {
+                throw std::runtime_error(*unit.path + ": " + e.what());
+            }
+        }
+    }
+
+    static void parse(Unit& unit) {
+        try {
+            unit.source = std::make_unique<lexer::Lexer>(lexer::SourceBuffer::map_file(*unit.path));
+            unit.parser = std::make_unique<parser::Parser>(*unit.source);
+            unit.program = unit.parser->parse_program();
+        } catch (...) {
+            unit.error = std::current_exception();
+        }
+    }
+
+    void analyze(Unit& unit, const std::unordered_set<std::string_view>& redefined) const {
+        try {
+            optimizer::optimize(*unit.program, options.level, &redefined);
+            compiler::Resolver resolver(*unit.program);
+            resolver.resolve();
+            for (const common::Symbol& name : resolver.global_names()) unit.globals.emplace_back(name.text);
+        } catch (...) {
+            unit.error = std::current_exception();
+        }
+    }
+
+    void generate(Unit& unit, runtime::Heap& local, size_t seeded) const {
+        if (unit.error) return;
+        try {
+            unit.script = compiler::Compiler(local).compile(*unit.program);
+            if (options.level > 0) compiler::optimize_bytecode(*unit.script);
+            if (local.global_count() != seeded) {
+                throw std::runtime_error("Compile error: global outside the project table");
+            }
+        } catch (...) {
+            unit.error = std::current_exception();
+        }
+        unit.program.reset();
+        unit.parser.reset();
+        unit.source.reset();
+    }
+
+    // Recopie profonde dans le Heap principal ; les fonctions partagées entre
+    // constantes ne sont recopiées qu'une fois.
+    runtime::ObjFunction* import(runtime::ObjFunction* function,
+                                 std::unordered_map<const runtime::ObjFunction*, runtime::ObjFunction*>& copies) {
+        auto it = copies.find(function);
+        if (it != copies.end()) return it->second;
+
+        runtime::ObjFunction* copy = heap.new_function();
+        copies.emplace(function, copy);
+        copy->arity = function->arity;
+        copy->name = function->name ? heap.intern(function->name->view()) : nullptr;
+        copy->chunk = std::move(function->chunk);
+        for (runtime::Value& constant : copy->chunk.constants) {
+            if (runtime::is_string(constant)) {
+                constant = runtime::Value::object(heap.intern(runtime::as_string(constant)->view()));
+            } else if (runtime::is_function(constant)) {
+                constant = runtime::Value::object(import(runtime::as_function(constant), copies));
+            }
+        }
+        return copy;
+    }
+};
+
+inline Result compile_project(runtime::Heap& heap, const std::vector<std::string>& paths, Options options = {}) {
+    return ProjectCompiler(heap, options).compile(paths);
+}
+
+} // namespace project
+} // namespace initlang
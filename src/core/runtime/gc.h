@@ -0,0 +1,100 @@
+// src/core/runtime/gc.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace initlang {
+namespace runtime {
+
+// Réglages du ramasse-miettes (Heap)
+struct GcOptions {
+    size_t nursery_bytes = 1 << 20;        // jeune génération, allouée au premier besoin
+    size_t major_threshold = 8 << 20;      // vieille génération avant la première collecte majeure
+    double growth = 2.0;                   // seuil suivant : octets vivants après collecte * growth
+    bool stress = false;                   // collecte complète à chaque allocation (tests)
+};
+
+// Bilan du ramasse-miettes depuis la création du Heap
+struct GcStats {
+    size_t minor_collections = 0;
+    size_t major_collections = 0;
+    double minor_pause_seconds = 0;   // cumul
+    double major_pause_seconds = 0;   // cumul, collecte mineure préalable comprise
+    double max_pause_seconds = 0;
+    uint64_t bytes_allocated = 0;     // objets collectables (nurserie et vieille génération)
+    uint64_t bytes_promoted = 0;      // survivants recopiés de la nurserie
+    uint64_t bytes_freed = 0;
+    size_t old_bytes = 0;             // vieille génération collectable, à l'instant
+    size_t max_old_bytes = 0;         // pic de old_bytes
+};
+
+// Drapeaux GC de l'en-tête Obj
+enum GcFlag : uint8_t {
+    GC_YOUNG = 1,      // dans la nurserie
+    GC_FORWARDED = 2,  // nurserie : promu, copie dans Obj::next
+    GC_MARKED = 4,     // collecte majeure en cours : atteint
+    GC_REMEMBERED = 8, // vieil objet inscrit dans l'ensemble mémorisé
+    GC_PERMANENT = 16, // alloué hors exécution : jamais collecté
+};
+
+// Jeune génération : allocation par incrément de pointeur dans une zone
+// fixe, vidée d'un coup après chaque collecte mineure. L'adresse de la zone
+// ne change pas : contains() est un simple test d'intervalle.
+class Nursery {
+public:
+    static constexpr size_t ALIGNMENT = 16;
+
+    explicit Nursery(size_t bytes) : capacity((bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1)) {}
+
+    Nursery(const Nursery&) = delete;
+    Nursery& operator=(const Nursery&) = delete;
+
+    static size_t align(size_t size) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    // nullptr si la place manque
+    void* allocate(size_t size) {
+        if (!base) {
+            base.reset(static_cast<unsigned char*>(::operator new(capacity, std::align_val_t(ALIGNMENT))));
+            top = base.get();
+        }
+        size = align(size);
+        if (size > capacity - static_cast<size_t>(top - base.get())) return nullptr;
+        void* memory = top;
+        top += size;
+        return memory;
+    }
+
+    bool contains(const void* p) const {
+        return base && static_cast<size_t>(static_cast<const unsigned char*>(p) - base.get()) < capacity;
+    }
+
+    size_t used() const { return base ? static_cast<size_t>(top - base.get()) : 0; }
+    size_t size() const { return capacity; }
+
+    // f(objet) pour chaque allocation, dans l'ordre ; size_of donne la
+    // taille demandée à allocate()
+    template <typename Object, typename SizeOf, typename F>
+    void for_each(SizeOf&& size_of, F&& f) {
+        for (unsigned char* p = base.get(); p && p < top;) {
+            auto* object = reinterpret_cast<Object*>(p);
+            p += align(size_of(object));
+            f(object);
+        }
+    }
+
+    void reset() { top = base.get(); }
+
+private:
+    struct Release {
+        void operator()(unsigned char* p) const { ::operator delete(p, std::align_val_t(ALIGNMENT)); }
+    };
+
+    size_t capacity;
+    std::unique_ptr<unsigned char, Release> base;
+    unsigned char* top = nullptr;
+};
+
+} // namespace runtime
+} // namespace initlang
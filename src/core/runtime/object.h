@@ -0,0 +1,778 @@
+// src/core/runtime/object.h
+#pragma once
+#include "value.h"
+#include "gc.h"
+#include "shape.h"
+#include "../compiler/bytecode.h"
+#include "../common/interner.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace initlang {
+namespace jit { class NativeFunction; }
+namespace runtime {
+
+enum class ObjType : uint8_t {
+    String,
+    Function,
+    List,
+    Struct,
+    Task
+};
+
+// En-tête commun des objets du tas. Les objets de la vieille génération
+// sont chaînés par `next` ; dans la nurserie, `next` reçoit l'adresse de la
+// copie promue (GC_FORWARDED).
+struct Obj {
+    ObjType type;
+    uint8_t gc = 0; // GcFlag
+    Obj* next = nullptr;
+
+    explicit Obj(ObjType t) : type(t) {}
+};
+
+// Chaîne immuable, caractères stockés juste après l'objet (une seule
+// allocation). Toujours terminée par '\0'.
+struct ObjString : Obj {
+    static constexpr uint32_t NO_GLOBAL = 0xFFFFFFFF;
+
+    uint32_t length;
+    uint32_t global_id = NO_GLOBAL; // identifiant de globale (Heap::global_id)
+    uint64_t hash;
+
+    ObjString(uint32_t len, uint64_t h) : Obj(ObjType::String), length(len), hash(h) {}
+
+    const char* chars() const { return reinterpret_cast<const char*>(this + 1); }
+    char* chars() { return reinterpret_cast<char*>(this + 1); }
+    std::string_view view() const { return std::string_view(chars(), length); }
+};
+
+// Fonction compilée : son propre Chunk, son arité et son nom (nullptr pour
+// le script de premier niveau).
+struct ObjFunction : Obj {
+    int arity = 0;
+    compiler::Chunk chunk;
+    ObjString* name = nullptr;
+    // Niveau JIT (jit/jit.h) : appels et tours de boucle comptés par
+    // l'interpréteur, code natif une fois la fonction chaude
+    uint32_t hotness = 0;
+    std::shared_ptr<jit::NativeFunction> native;
+
+    ObjFunction() : Obj(ObjType::Function) {}
+};
+
+// Liste construite par OP_BUILD_LIST
+struct ObjList : Obj {
+    std::vector<Value> items;
+
+    ObjList() : Obj(ObjType::List) {}
+};
+
+// Structure construite par OP_BUILD_STRUCT : sa forme (noms des champs,
+// partagés avec les structures de même disposition, shape.h) suivie de ses
+// valeurs, allouées avec l'objet, dans l'ordre des noms. Le nombre de
+// champs est fixé à la construction ; leurs valeurs peuvent changer
+// (OP_SET_FIELD).
+struct ObjStruct : Obj {
+    const Shape* shape;
+
+    explicit ObjStruct(const Shape* s) : Obj(ObjType::Struct), shape(s) {}
+
+    size_t size() const { return shape->size(); }
+    ObjString* name(size_t index) const { return shape->name(index); }
+    Value* values() { return reinterpret_cast<Value*>(this + 1); }
+    const Value* values() const { return reinterpret_cast<const Value*>(this + 1); }
+
+    // Valeur du champ `name` (interné), nullptr si absent
+    const Value* find(const ObjString* name) const {
+        int index = shape->index_of(name);
+        return index < 0 ? nullptr : values() + index;
+    }
+};
+static_assert(sizeof(ObjStruct) % alignof(Value) == 0, "ObjStruct values must follow the header aligned");
+
+// Tâche créée par OP_SPAWN : l'appel function(args...) exécuté par le
+// planificateur de la VM (vm/vm.h). `state` passe une seule fois de Pending
+// à Done (result) ou Failed (error), avec publication (release) ; la liste
+// des tâches qui l'attendent est protégée par `lock`.
+struct ObjTask : Obj {
+    enum State : uint8_t { Pending, Done, Failed };
+
+    ObjFunction* function;
+    std::vector<Value> args;     // libérés au démarrage
+    std::atomic<uint8_t> state{Pending};
+    std::atomic<bool> observed{false}; // résultat lu par un await
+    Value result = Value::null();
+    std::exception_ptr error;
+
+    std::mutex lock;
+    std::vector<ObjTask*> waiters; // tâches suspendues sur celle-ci
+    bool root_waiting = false;     // le script l'attend (réveil du planificateur)
+    void* fiber = nullptr;         // pile d'exécution tant que démarrée et non terminée
+
+    ObjTask(ObjFunction* f, const Value* first, size_t count)
+        : Obj(ObjType::Task), function(f), args(first, first + count) {}
+
+    bool pending() const { return state.load(std::memory_order_acquire) == Pending; }
+};
+
+inline bool is_obj_type(Value value, ObjType type) {
+    return value.is_object() && value.as_object()->type == type;
+}
+
+inline bool is_string(Value value) { return is_obj_type(value, ObjType::String); }
+inline bool is_function(Value value) { return is_obj_type(value, ObjType::Function); }
+inline bool is_list(Value value) { return is_obj_type(value, ObjType::List); }
+inline bool is_task(Value value) { return is_obj_type(value, ObjType::Task); }
+inline bool is_struct(Value value) { return is_obj_type(value, ObjType::Struct); }
+inline ObjString* as_string(Value value) { return static_cast<ObjString*>(value.as_object()); }
+inline ObjFunction* as_function(Value value) { return static_cast<ObjFunction*>(value.as_object()); }
+inline ObjList* as_list(Value value) { return static_cast<ObjList*>(value.as_object()); }
+inline ObjStruct* as_struct(Value value) { return static_cast<ObjStruct*>(value.as_object()); }
+inline ObjTask* as_task(Value value) { return static_cast<ObjTask*>(value.as_object()); }
+
+// Tas d'objets. Les chaînes sont internées : une seule ObjString par texte,
+// ce qui ramène l'égalité à une comparaison de pointeurs.
+//
+// Le Heap numérote aussi les globales : chaque nom de globale reçoit, à la
+// compilation (ou à l'édition de liens d'un cache), un identifiant dense
+// partagé par tout le code du Heap. La VM range les valeurs dans un
+// vecteur indexé par cet identifiant ; la table nom -> identifiant est le
+// champ ObjString::global_id, sans autre recherche.
+//
+// Ramasse-miettes générationnel et exact. Hors exécution (compilation,
+// chargement d'un cache, code hôte), les objets sont permanents : jamais
+// collectés, ils restent à leur adresse, que l'hôte peut garder. Pendant une
+// exécution (begin_execution/end_execution, appelés par la VM), les chaînes,
+// listes et structures naissent dans la nurserie (gc.h). Une collecte
+// mineure recopie ses survivants dans la vieille génération et met à jour
+// toutes les références ; la vieille génération est collectée par marquage
+// et balayage quand elle a doublé (GcOptions::growth). La nurserie est vidée
+// à la fin de chaque exécution : hors exécution, aucun objet ne bouge plus.
+//
+// Racines : celles que déclarent les sources inscrites (add_roots : piles,
+// trames et globales de chaque VM), les objets permanents (constantes des
+// Chunk), les noms des formes de structures et l'ensemble mémorisé. Les
+// opcodes d'écriture de variables ne touchent que des racines (pile,
+// globales), balayées à chaque collecte ; un vieil objet qui reçoit une
+// valeur après sa construction (OP_SET_FIELD, code hôte) passe par
+// write_barrier().
+// Une source de racines doit faire passer chaque valeur par trace() ; une
+// valeur qui n'y passe pas (variable C++ locale) n'est plus valide après
+// une allocation.
+//
+// Pendant l'exécution de tâches sur plusieurs threads, la VM passe le Heap
+// en mode partagé, nurserie vide : allocations et internement se font alors
+// sous un verrou, directement dans la vieille génération, et plus rien ne
+// bouge. Les threads qui exécutent du code sont des mutateurs
+// (attach_mutator/detach_mutator) ; une allocation qui trouve la vieille
+// génération au seuil demande une collecte majeure et arrête son thread
+// (point sûr : stack_top à jour). Le dernier mutateur à s'arrêter, ou à se
+// détacher, la fait, monde arrêté, puis réveille les autres. Les tâches en
+// cours, que seul le planificateur tient, sont alors des racines.
+// La numérotation des globales reste réservée à la compilation.
+class Heap {
+public:
+    using RootTracer = void (*)(void* owner, Heap& heap);
+
+private:
+    Obj* objects = nullptr;   // vieille génération collectable
+    Obj* permanent = nullptr; // objets alloués hors exécution
+    std::vector<Obj*> permanent_containers; // permanents à champs (racines des collectes majeures)
+    std::unordered_map<std::string_view, ObjString*> strings;
+    std::vector<ObjString*> global_names;
+    size_t allocated = 0;
+    bool shared = false;
+    std::mutex mutex;
+    // Mode partagé : mutateurs attachés, arrêtés au point sûr, et collecte
+    // demandée (faite quand tous sont arrêtés)
+    size_t mutators = 0;
+    size_t stopped = 0;
+    bool stop_requested = false;
+    std::condition_variable restart;
+
+    GcOptions options;
+    GcStats gc_totals;
+    Nursery nursery;
+    ShapeTable shapes;
+    size_t shapes_traced = 0; // formes créées avant la dernière collecte mineure : noms déjà vieux
+    size_t executions = 0; // exécutions en cours (begin_execution)
+    size_t next_major;
+    std::vector<std::pair<void*, RootTracer>> root_sources;
+    std::vector<Obj*> remembered;
+    std::vector<Obj*> gray; // objets promus ou marqués, champs à parcourir
+    enum class Phase : uint8_t { Idle, Minor, Major } phase = Phase::Idle;
+
+    std::unique_lock<std::mutex> guard() {
+        return shared ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+
+    static GcOptions& default_options() {
+        static GcOptions defaults;
+        return defaults;
+    }
+
+    bool young_allowed() const { return executions > 0 && !shared; }
+
+    static size_t object_size(const Obj* object) {
+        switch (object->type) {
+            case ObjType::String:
+                return sizeof(ObjString) + static_cast<const ObjString*>(object)->length + 1;
+            case ObjType::Function:
+                return sizeof(ObjFunction);
+            case ObjType::List:
+                return sizeof(ObjList);
+            case ObjType::Struct:
+                return sizeof(ObjStruct) + static_cast<const ObjStruct*>(object)->size() * sizeof(Value);
+            case ObjType::Task:
+                return sizeof(ObjTask);
+        }
+        return sizeof(Obj);
+    }
+
+    // Mémoire d'un objet de `size` octets : nurserie si possible, sinon
+    // vieille génération (chaînage fait par track). `lock` : celui de guard()
+    void* allocate(size_t size, bool& young, std::unique_lock<std::mutex>& lock) {
+        young = false;
+        if (shared) safepoint(lock);
+        if (young_allowed()) {
+            if (options.stress) collect(true);
+            void* memory = nursery.allocate(size);
+            if (!memory && size <= nursery.size() / 4) {
+                collect(false);
+                memory = nursery.allocate(size);
+            }
+            gc_totals.bytes_allocated += size;
+            if (memory) {
+                young = true;
+                return memory;
+            }
+        } else if (executions > 0) {
+            gc_totals.bytes_allocated += size;
+        }
+        return ::operator new(size);
+    }
+
+    template <typename T>
+    T* track(T* object, size_t size, bool young) {
+        allocated += size;
+        if (young) {
+            object->gc = GC_YOUNG;
+            return object;
+        }
+        if (executions == 0) {
+            object->gc = GC_PERMANENT;
+            object->next = permanent;
+            permanent = object;
+            if (object->type != ObjType::String) permanent_containers.push_back(object);
+            return object;
+        }
+        object->next = objects;
+        objects = object;
+        gc_totals.old_bytes += size;
+        gc_totals.max_old_bytes = std::max(gc_totals.max_old_bytes, gc_totals.old_bytes);
+        // Conteneur né vieux (trop grand, tâche) : ses champs, remplis
+        // ensuite sans barrière, peuvent désigner la nurserie
+        if (young_allowed() && object->type != ObjType::String) {
+            object->gc |= GC_REMEMBERED;
+            remembered.push_back(object);
+        }
+        return object;
+    }
+
+    template <typename T>
+    T* make(std::unique_lock<std::mutex>& lock) {
+        bool young;
+        void* memory = allocate(sizeof(T), young, lock);
+        return track(new (memory) T(), sizeof(T), young);
+    }
+
+    // Libère un objet de la vieille génération (ou permanent)
+    static void destroy(Obj* object) {
+        destroy_in_place(object);
+        ::operator delete(static_cast<void*>(object));
+    }
+
+    static void destroy_in_place(Obj* object) {
+        switch (object->type) {
+            case ObjType::String:
+                static_cast<ObjString*>(object)->~ObjString();
+                break;
+            case ObjType::Function:
+                static_cast<ObjFunction*>(object)->~ObjFunction();
+                break;
+            case ObjType::List:
+                static_cast<ObjList*>(object)->~ObjList();
+                break;
+            case ObjType::Struct:
+                static_cast<ObjStruct*>(object)->~ObjStruct();
+                break;
+            case ObjType::Task:
+                static_cast<ObjTask*>(object)->~ObjTask();
+                break;
+        }
+    }
+
+    static void release_list(Obj* list) {
+        while (list) {
+            Obj* next = list->next;
+            destroy(list);
+            list = next;
+        }
+    }
+
+    // ----- Collecte -----
+
+    // Collecte mineure : copie d'un survivant de la nurserie (une fois)
+    Obj* promote(Obj* object) {
+        if (object->gc & GC_FORWARDED) return object->next;
+        size_t size = object_size(object);
+        void* memory = ::operator new(size);
+        Obj* copy = nullptr;
+        switch (object->type) {
+            case ObjType::String: {
+                auto* string = static_cast<ObjString*>(object);
+                auto* moved = new (memory) ObjString(string->length, string->hash);
+                moved->global_id = string->global_id;
+                std::memcpy(moved->chars(), string->chars(), string->length + 1);
+                copy = moved;
+                break;
+            }
+            case ObjType::List: {
+                auto* moved = new (memory) ObjList();
+                moved->items = std::move(static_cast<ObjList*>(object)->items);
+                copy = moved;
+                break;
+            }
+            case ObjType::Struct: {
+                auto* from = static_cast<ObjStruct*>(object);
+                auto* moved = new (memory) ObjStruct(from->shape);
+                std::uninitialized_copy_n(from->values(), from->size(), moved->values());
+                copy = moved;
+                break;
+            }
+            case ObjType::Function:
+            case ObjType::Task:
+                // Jamais dans la nurserie (compilation, mode partagé)
+                ::operator delete(memory);
+                return object;
+        }
+        copy->next = objects;
+        objects = copy;
+        gc_totals.old_bytes += size;
+        gc_totals.max_old_bytes = std::max(gc_totals.max_old_bytes, gc_totals.old_bytes);
+        gc_totals.bytes_promoted += size;
+        object->gc |= GC_FORWARDED;
+        object->next = copy;
+        if (copy->type != ObjType::String) gray.push_back(copy);
+        return copy;
+    }
+
+    Obj* visit(Obj* object) {
+        if (!object) return object;
+        if (phase == Phase::Minor) return (object->gc & GC_YOUNG) ? promote(object) : object;
+        if (!(object->gc & (GC_MARKED | GC_PERMANENT))) {
+            object->gc |= GC_MARKED;
+            if (object->type != ObjType::String) gray.push_back(object);
+        }
+        return object;
+    }
+
+    void trace_fields(Obj* object) {
+        switch (object->type) {
+            case ObjType::String:
+                break;
+            case ObjType::Function: {
+                auto* function = static_cast<ObjFunction*>(object);
+                for (Value& constant : function->chunk.constants) trace(constant);
+                if (function->name) function->name = static_cast<ObjString*>(visit(function->name));
+                break;
+            }
+            case ObjType::List:
+                for (Value& item : static_cast<ObjList*>(object)->items) trace(item);
+                break;
+            case ObjType::Struct: {
+                auto* fields = static_cast<ObjStruct*>(object);
+                for (size_t i = 0; i < fields->size(); ++i) trace(fields->values()[i]);
+                break;
+            }
+            case ObjType::Task: {
+                auto* task = static_cast<ObjTask*>(object);
+                task->function = static_cast<ObjFunction*>(visit(task->function));
+                for (Value& arg : task->args) trace(arg);
+                trace(task->result);
+                break;
+            }
+        }
+    }
+
+    void trace_roots() {
+        for (const auto& source : root_sources) source.second(source.first, *this);
+        // Les formes ne meurent pas : leurs noms sont des racines
+        shapes.for_each_name(phase == Phase::Minor ? shapes_traced : 0,
+                             [this](ObjString*& name) { name = static_cast<ObjString*>(visit(name)); });
+        shapes_traced = shapes.size();
+        for (Obj* object : remembered) {
+            object->gc &= static_cast<uint8_t>(~GC_REMEMBERED);
+            trace_fields(object);
+        }
+        remembered.clear();
+        while (!gray.empty()) {
+            Obj* object = gray.back();
+            gray.pop_back();
+            trace_fields(object);
+        }
+    }
+
+    void collect_minor() {
+        if (nursery.used() == 0 && remembered.empty()) return;
+        auto start = std::chrono::steady_clock::now();
+        phase = Phase::Minor;
+        trace_roots();
+        // Chaînes internées recopiées ou mortes, puis destructeurs
+        nursery.for_each<Obj>(object_size, [this](Obj* object) {
+            if (object->type == ObjType::String) {
+                auto* string = static_cast<ObjString*>(object);
+                strings.erase(string->view());
+                if (object->gc & GC_FORWARDED) {
+                    auto* moved = static_cast<ObjString*>(object->next);
+                    strings.emplace(moved->view(), moved);
+                }
+            }
+            if (!(object->gc & GC_FORWARDED)) gc_totals.bytes_freed += object_size(object);
+            destroy_in_place(object);
+        });
+        nursery.reset();
+        phase = Phase::Idle;
+        ++gc_totals.minor_collections;
+        record_pause(start, gc_totals.minor_pause_seconds);
+    }
+
+    void collect_major() {
+        auto start = std::chrono::steady_clock::now();
+        phase = Phase::Major;
+        for (Obj* object : permanent_containers) trace_fields(object);
+        if (shared) {
+            // Tâche en file ou démarrée : tenue par le planificateur seul
+            for (Obj* object = objects; object; object = object->next) {
+                if (object->type == ObjType::Task && static_cast<ObjTask*>(object)->pending()) visit(object);
+            }
+        }
+        trace_roots();
+        Obj** link = &objects;
+        while (Obj* object = *link) {
+            if (object->gc & GC_MARKED) {
+                object->gc &= static_cast<uint8_t>(~GC_MARKED);
+                link = &object->next;
+                continue;
+            }
+            *link = object->next;
+            size_t size = object_size(object);
+            if (object->type == ObjType::String) strings.erase(static_cast<ObjString*>(object)->view());
+            gc_totals.old_bytes -= size;
+            gc_totals.bytes_freed += size;
+            destroy(object);
+        }
+        phase = Phase::Idle;
+        next_major = std::max(options.major_threshold, static_cast<size_t>(gc_totals.old_bytes * options.growth));
+        ++gc_totals.major_collections;
+        record_pause(start, gc_totals.major_pause_seconds);
+    }
+
+    // Mode partagé, avant une allocation : arrête le thread si une collecte
+    // est demandée (ou si celle-ci l'est, au seuil), jusqu'à ce qu'elle soit
+    // faite ; le dernier mutateur arrêté la fait
+    void safepoint(std::unique_lock<std::mutex>& lock) {
+        if (!stop_requested) {
+            if (!options.stress && gc_totals.old_bytes < next_major) return;
+            stop_requested = true;
+        }
+        ++stopped;
+        if (stopped == mutators) {
+            collect_stopped();
+        } else {
+            size_t seen = gc_totals.major_collections;
+            restart.wait(lock, [&] { return gc_totals.major_collections != seen; });
+        }
+        --stopped;
+    }
+
+    void collect_stopped() {
+        collect_major();
+        stop_requested = false;
+        restart.notify_all();
+    }
+
+    void record_pause(std::chrono::steady_clock::time_point start, double& total) {
+        double pause = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        total += pause;
+        gc_totals.max_pause_seconds = std::max(gc_totals.max_pause_seconds, pause);
+    }
+
+public:
+    explicit Heap(GcOptions gc = default_options())
+        : options(gc), nursery(gc.nursery_bytes), next_major(gc.major_threshold) {}
+    Heap(const Heap&) = delete;
+    Heap& operator=(const Heap&) = delete;
+
+    ~Heap() {
+        nursery.for_each<Obj>(object_size, [](Obj* object) { destroy_in_place(object); });
+        release_list(objects);
+        release_list(permanent);
+    }
+
+    // Réglages des Heap construits ensuite sans argument (tests : stress)
+    static void set_default_gc_options(GcOptions gc) { default_options() = gc; }
+
+    // Mode partagé ; à ne changer que sans autre thread actif. La nurserie
+    // est d'abord vidée : aucun objet ne bouge pendant le mode partagé. Le
+    // thread appelant en est le premier mutateur.
+    void set_shared(bool enabled) {
+        if (enabled) collect(false);
+        shared = enabled;
+        mutators = enabled ? 1 : 0;
+    }
+
+    // Mode partagé : le thread appelant commence (attach) ou cesse (detach)
+    // d'exécuter du code. Entre les deux, ses valeurs doivent être dans des
+    // racines à chaque allocation ; détaché, il ne touche plus aux objets et
+    // une collecte peut avoir lieu sans lui. attach attend la fin d'une
+    // collecte demandée.
+    void attach_mutator() {
+        auto lock = guard();
+        restart.wait(lock, [this] { return !stop_requested; });
+        ++mutators;
+    }
+
+    void detach_mutator() {
+        auto lock = guard();
+        --mutators;
+        if (stop_requested && stopped == mutators) collect_stopped();
+    }
+
+    // ----- Ramasse-miettes -----
+
+    // Sources de racines (une VM : pile, trames, globales)
+    void add_roots(void* owner, RootTracer tracer) { root_sources.emplace_back(owner, tracer); }
+    void remove_roots(void* owner) {
+        root_sources.erase(std::remove_if(root_sources.begin(), root_sources.end(),
+                                          [owner](const auto& source) { return source.first == owner; }),
+                           root_sources.end());
+    }
+
+    // Depuis une source de racines : `slot` mis à jour si l'objet a bougé
+    void trace(Value& slot) {
+        if (slot.is_object()) {
+            Obj* object = slot.as_object();
+            Obj* moved = visit(object);
+            if (moved != object) slot = Value::object(moved);
+        }
+    }
+
+    // À appeler après l'écriture de `value` dans un objet déjà construit
+    void write_barrier(Obj* holder, Value value) {
+        if (holder->gc & (GC_YOUNG | GC_REMEMBERED)) return;
+        if (!value.is_object() || !value.as_object() || !(value.as_object()->gc & GC_YOUNG)) return;
+        auto lock = guard();
+        holder->gc |= GC_REMEMBERED;
+        remembered.push_back(holder);
+    }
+
+    // Exécution (VM) : les allocations deviennent collectables. La fin de
+    // la dernière exécution vide la nurserie ; les valeurs à conserver
+    // doivent alors être dans une racine.
+    void begin_execution() { ++executions; }
+    void end_execution() {
+        if (executions == 1) collect(false);
+        --executions;
+    }
+
+    // Collecte mineure, suivie d'une majeure si `full` ou si la vieille
+    // génération a atteint son seuil. Sans effet en mode partagé (collectes
+    // aux points sûrs des allocations, voir safepoint).
+    void collect(bool full = false) {
+        if (shared || phase != Phase::Idle) return;
+        collect_minor();
+        if (full || gc_totals.old_bytes >= next_major) collect_major();
+    }
+
+    const GcStats& gc_stats() const { return gc_totals; }
+    const GcOptions& gc_options() const { return options; }
+    bool is_young(const Obj* object) const { return object->gc & GC_YOUNG; }
+
+    // ----- Allocation -----
+
+    ObjString* intern(std::string_view text) {
+        auto lock = guard();
+        auto it = strings.find(text);
+        if (it != strings.end()) return it->second;
+
+        // Une collecte peut déplacer le texte s'il vient de la nurserie
+        std::string copy;
+        if (nursery.contains(text.data())) text = copy.assign(text);
+        size_t size = sizeof(ObjString) + text.size() + 1;
+        bool young;
+        void* memory = allocate(size, young, lock);
+        auto* string = new (memory) ObjString(static_cast<uint32_t>(text.size()), common::Interner::hash_text(text));
+        std::memcpy(string->chars(), text.data(), text.size());
+        string->chars()[text.size()] = '\0';
+        strings.emplace(string->view(), string);
+        return track(string, size, young);
+    }
+
+    uint32_t global_id(ObjString* name) {
+        if (name->global_id == ObjString::NO_GLOBAL) {
+            name->global_id = static_cast<uint32_t>(global_names.size());
+            global_names.push_back(name);
+        }
+        return name->global_id;
+    }
+
+    size_t global_count() const { return global_names.size(); }
+    ObjString* global_name(uint32_t id) const { return global_names[id]; }
+
+    // Prépare l'internement d'un lot de chaînes (chargement d'un cache)
+    void reserve_strings(size_t count) { strings.reserve(strings.size() + count); }
+
+    ObjString* concat(const ObjString* a, const ObjString* b) {
+        std::string text;
+        text.reserve(a->length + b->length);
+        text.append(a->view()).append(b->view());
+        return intern(text);
+    }
+
+    ObjFunction* new_function() {
+        auto lock = guard();
+        bool young = false;
+        return track(new (::operator new(sizeof(ObjFunction))) ObjFunction(), sizeof(ObjFunction), young);
+    }
+
+    ObjList* new_list() {
+        auto lock = guard();
+        return make<ObjList>(lock);
+    }
+
+    // Formes des structures (shape.h)
+    const Shape* empty_shape() const { return shapes.empty(); }
+    const Shape* shape_with(const Shape* from, ObjString* field) {
+        auto lock = guard();
+        return shapes.with(from, field);
+    }
+    size_t shape_count() const { return shapes.size(); }
+
+    // Structure de forme `shape`, champs à null
+    ObjStruct* new_struct(const Shape* shape) {
+        auto lock = guard();
+        size_t size = sizeof(ObjStruct) + shape->size() * sizeof(Value);
+        bool young;
+        void* memory = allocate(size, young, lock);
+        auto* object = new (memory) ObjStruct(shape);
+        std::uninitialized_fill_n(object->values(), shape->size(), Value::null());
+        return track(object, size, young);
+    }
+
+    ObjTask* new_task(ObjFunction* function, const Value* args, size_t count) {
+        auto lock = guard();
+        if (shared) safepoint(lock);
+        if (executions > 0) gc_totals.bytes_allocated += sizeof(ObjTask);
+        auto* task = new (::operator new(sizeof(ObjTask))) ObjTask(function, args, count);
+        return track(task, sizeof(ObjTask), false);
+    }
+
+    size_t bytes_allocated() const { return allocated; }
+    size_t interned_strings() const { return strings.size(); }
+};
+
+// Rendu textuel d'une valeur, ajouté à `out` : les nombres sont convertis
+// directement dans la chaîne de destination, les listes et structures
+// rendues sans chaînes intermédiaires (init.log, disassembleur)
+inline void append_value(std::string& out, Value value) {
+    switch (value.type()) {
+        case ValueType::Null:
+            out += "null";
+            return;
+        case ValueType::Bool:
+            out += value.as_bool() ? "true" : "false";
+            return;
+        case ValueType::Number: {
+            char buffer[32];
+            double number = value.as_number();
+            // Entiers (cas courant) : conversion directe, sans snprintf
+            if (number > -1e15 && number < 1e15 && number == static_cast<double>(static_cast<int64_t>(number))) {
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(number));
+                out.append(buffer, result.ptr);
+                return;
+            }
+            int length = std::snprintf(buffer, sizeof(buffer), "%.14g", number);
+            out.append(buffer, static_cast<size_t>(length));
+            return;
+        }
+        case ValueType::Object:
+            break;
+    }
+    switch (value.as_object()->type) {
+        case ObjType::String:
+            out += as_string(value)->view();
+            return;
+        case ObjType::Function: {
+            ObjString* name = as_function(value)->name;
+            if (!name) {
+                out += "<script>";
+                return;
+            }
+            out += "<fi ";
+            out += name->view();
+            out += '>';
+            return;
+        }
+        case ObjType::List: {
+            out += '[';
+            const auto& items = as_list(value)->items;
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (i) out += ", ";
+                append_value(out, items[i]);
+            }
+            out += ']';
+            return;
+        }
+        case ObjType::Struct: {
+            out += '{';
+            const ObjStruct* object = as_struct(value);
+            for (size_t i = 0; i < object->size(); ++i) {
+                if (i) out += ", ";
+                out += object->name(i)->view();
+                out += ": ";
+                append_value(out, object->values()[i]);
+            }
+            out += '}';
+            return;
+        }
+        case ObjType::Task:
+            out += "<task>";
+            return;
+    }
+    out += '?';
+}
+
+inline std::string to_string(Value value) {
+    std::string out;
+    append_value(out, value);
+    return out;
+}
+
+} // namespace runtime
+} // namespace initlang
@@ -0,0 +1,87 @@
+// src/core/runtime/shape.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace initlang {
+namespace runtime {
+
+struct ObjString;
+
+// Forme (« classe cachée ») d'une structure : ses noms de champs, dans
+// l'ordre. Les formes sont partagées : deux structures construites avec les
+// mêmes noms dans le même ordre ont la même forme, et une instance se
+// réduit à un pointeur de forme suivi de ses valeurs (ObjStruct). Chaque
+// forme garde ses transitions, les formes obtenues en ajoutant un champ :
+// construire une structure, c'est suivre une transition par champ depuis
+// la forme vide.
+//
+// Une forme ne change plus une fois créée : son adresse identifie une
+// disposition des champs (clé des caches en ligne de OP_GET_FIELD et
+// OP_SET_FIELD).
+class Shape {
+public:
+    Shape() = default;
+    Shape(const Shape&) = delete;
+    Shape& operator=(const Shape&) = delete;
+
+    size_t size() const { return names.size(); }
+    ObjString* name(size_t index) const { return names[index]; }
+
+    // Indice du champ `field` (chaîne internée), -1 si absent
+    int index_of(const ObjString* field) const {
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == field) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+private:
+    friend class ShapeTable;
+
+    std::vector<ObjString*> names;
+    std::vector<Shape*> transitions; // clé : names.back() de la forme cible
+};
+
+// Toutes les formes d'un Heap, jamais libérées (une par disposition
+// rencontrée, pas par instance). Le Heap verrouille en mode partagé.
+class ShapeTable {
+public:
+    ShapeTable() { shapes.push_back(std::make_unique<Shape>()); }
+
+    const Shape* empty() const { return shapes.front().get(); }
+
+    // `from` plus le champ `field` à la fin ; `from` lui-même si le champ
+    // y est déjà
+    const Shape* with(const Shape* from, ObjString* field) {
+        if (from->index_of(field) >= 0) return from;
+        Shape& source = const_cast<Shape&>(*from);
+        for (Shape* next : source.transitions) {
+            if (next->names.back() == field) return next;
+        }
+        auto shape = std::make_unique<Shape>();
+        shape->names = from->names;
+        shape->names.push_back(field);
+        source.transitions.push_back(shape.get());
+        shapes.push_back(std::move(shape));
+        return shapes.back().get();
+    }
+
+    size_t size() const { return shapes.size(); }
+
+    // Ramasse-miettes : f(ObjString*&) pour chaque nom des formes [first, size())
+    template <typename F>
+    void for_each_name(size_t first, F&& f) {
+        for (size_t i = first; i < shapes.size(); ++i) {
+            for (ObjString*& name : shapes[i]->names) f(name);
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Shape>> shapes;
+};
+
+} // namespace runtime
+} // namespace initlang
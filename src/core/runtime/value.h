@@ -0,0 +1,152 @@
+// src/core/runtime/value.h
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace initlang {
+namespace runtime {
+
+struct Obj;
+
+enum class ValueType : uint8_t {
+    Null,
+    Bool,
+    Number,
+    Object
+};
+
+// Le NaN-boxing suppose des pointeurs 64 bits dont seuls 48 sont utilisés
+#if !defined(INITLANG_TAGGED_VALUES) && UINTPTR_MAX != 0xFFFFFFFFFFFFFFFFu
+#define INITLANG_TAGGED_VALUES
+#endif
+
+#ifndef INITLANG_TAGGED_VALUES
+
+// Valeur INITLANG sur 8 octets, par « NaN-boxing » :
+//  - un double ordinaire est stocké tel quel ;
+//  - les autres valeurs vivent dans la charge utile d'un NaN silencieux
+//    (bits QNAN tous à 1) : null/false/true dans les bits de poids faible,
+//    un pointeur d'objet (48 bits) avec en plus le bit de signe.
+// Les NaN produits par l'arithmétique (0x7ff8... / 0xfff8...) n'ont pas tous
+// les bits QNAN et restent donc des nombres.
+struct Value {
+    static constexpr uint64_t SIGN_BIT = 0x8000000000000000ull;
+    static constexpr uint64_t QNAN = 0x7ffc000000000000ull;
+    static constexpr uint64_t TAG_NULL = 1;
+    static constexpr uint64_t TAG_FALSE = 2;
+    static constexpr uint64_t TAG_TRUE = 3;
+    static constexpr uint64_t NULL_BITS = QNAN | TAG_NULL;
+    static constexpr uint64_t FALSE_BITS = QNAN | TAG_FALSE;
+    static constexpr uint64_t TRUE_BITS = QNAN | TAG_TRUE;
+
+    uint64_t bits;
+
+    static Value from_bits(uint64_t b) { Value v; v.bits = b; return v; }
+    static Value null() { return from_bits(NULL_BITS); }
+    static Value boolean(bool b) { return from_bits(b ? TRUE_BITS : FALSE_BITS); }
+    static Value number(double d) { Value v; std::memcpy(&v.bits, &d, sizeof(d)); return v; }
+    static Value object(Obj* o) { return from_bits(SIGN_BIT | QNAN | reinterpret_cast<uintptr_t>(o)); }
+
+    bool is_null() const { return bits == NULL_BITS; }
+    bool is_bool() const { return (bits | 1) == TRUE_BITS; }
+    bool is_number() const { return (bits & QNAN) != QNAN; }
+    bool is_object() const { return (bits & (SIGN_BIT | QNAN)) == (SIGN_BIT | QNAN); }
+
+    bool as_bool() const { return bits == TRUE_BITS; }
+    double as_number() const { double d; std::memcpy(&d, &bits, sizeof(d)); return d; }
+    Obj* as_object() const { return reinterpret_cast<Obj*>(static_cast<uintptr_t>(bits & ~(SIGN_BIT | QNAN))); }
+
+    ValueType type() const {
+        if (is_number()) return ValueType::Number;
+        if (is_object()) return ValueType::Object;
+        return bits == NULL_BITS ? ValueType::Null : ValueType::Bool;
+    }
+
+    // null et false sont faux, tout le reste est vrai
+    bool is_falsey() const { return bits == NULL_BITS || bits == FALSE_BITS; }
+};
+
+inline constexpr const char* VALUE_REPRESENTATION = "nan-boxing";
+
+// Test de type des opcodes arithmétiques : un seul branchement pour deux
+// opérandes. Un non-nombre a tous les bits QNAN ; le ET des deux ne les a
+// tous que si les deux opérandes en sont.
+inline bool both_numbers(Value a, Value b) {
+    return ((a.bits & Value::QNAN) != Value::QNAN) & ((b.bits & Value::QNAN) != Value::QNAN);
+}
+
+// Égalité INITLANG : nombres par valeur (NaN != NaN, 0 == -0), le reste
+// par identité des bits (les chaînes sont internées par le Heap).
+inline bool values_equal(Value a, Value b) {
+    if (both_numbers(a, b)) return a.as_number() == b.as_number();
+    return a.bits == b.bits;
+}
+
+// Identité bit à bit, pour dédupliquer les constantes (distingue 0 et -0)
+inline bool values_identical(Value a, Value b) { return a.bits == b.bits; }
+
+#else
+
+// Repli portable (INITLANG_TAGGED_VALUES) : union étiquetée de 16 octets.
+struct Value {
+    ValueType tag;
+    union {
+        bool boolean;
+        double number;
+        Obj* object;
+    } as;
+
+    static Value null() { Value v; v.tag = ValueType::Null; v.as.number = 0; return v; }
+    static Value boolean(bool b) { Value v; v.tag = ValueType::Bool; v.as.number = 0; v.as.boolean = b; return v; }
+    static Value number(double d) { Value v; v.tag = ValueType::Number; v.as.number = d; return v; }
+    static Value object(Obj* o) { Value v; v.tag = ValueType::Object; v.as.object = o; return v; }
+
+    bool is_null() const { return tag == ValueType::Null; }
+    bool is_bool() const { return tag == ValueType::Bool; }
+    bool is_number() const { return tag == ValueType::Number; }
+    bool is_object() const { return tag == ValueType::Object; }
+
+    bool as_bool() const { return as.boolean; }
+    double as_number() const { return as.number; }
+    Obj* as_object() const { return as.object; }
+
+    ValueType type() const { return tag; }
+
+    // null et false sont faux, tout le reste est vrai
+    bool is_falsey() const { return tag == ValueType::Null || (tag == ValueType::Bool && !as.boolean); }
+};
+
+inline constexpr const char* VALUE_REPRESENTATION = "tagged-union";
+
+inline bool both_numbers(Value a, Value b) {
+    return (a.tag == ValueType::Number) & (b.tag == ValueType::Number);
+}
+
+// Égalité INITLANG : nombres par valeur, objets par identité (les chaînes
+// sont internées par le Heap, donc deux chaînes égales sont le même objet).
+inline bool values_equal(Value a, Value b) {
+    if (a.tag != b.tag) return false;
+    switch (a.tag) {
+        case ValueType::Null:   return true;
+        case ValueType::Bool:   return a.as.boolean == b.as.boolean;
+        case ValueType::Number: return a.as.number == b.as.number;
+        case ValueType::Object: return a.as.object == b.as.object;
+    }
+    return false;
+}
+
+// Identité bit à bit, pour dédupliquer les constantes (distingue 0 et -0)
+inline bool values_identical(Value a, Value b) {
+    if (a.tag != b.tag) return false;
+    if (a.tag == ValueType::Number) return std::memcmp(&a.as.number, &b.as.number, sizeof(double)) == 0;
+    return values_equal(a, b);
+}
+
+#endif
+
+// Piles et pools de constantes se copient par memcpy
+static_assert(std::is_trivially_copyable_v<Value>, "Value must stay trivially copyable");
+
+} // namespace runtime
+} // namespace initlang
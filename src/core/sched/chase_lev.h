@@ -0,0 +1,118 @@
+// src/core/sched/chase_lev.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace initlang {
+namespace sched {
+
+// Deque de vol de travail de Chase et Lev, dans la version pour modèles
+// mémoire faibles de Lê, Pop, Cohen et Zappa Nardelli (PPoPP 2013). Le
+// propriétaire empile et dépile par le bas (LIFO, localité), les voleurs
+// prennent par le haut (FIFO, les tâches les plus anciennes, donc les plus
+// grosses d'un arbre de tâches). Seul le conflit sur le dernier élément
+// passe par un compare-and-swap.
+//
+// Les barrières de l'article sont portées par les accès eux-mêmes (release
+// sur bottom dans push, seq_cst autour de la lecture croisée top/bottom) :
+// même coût sur x86-64, et les outils de détection de courses les
+// comprennent. Les tableaux remplacés par une croissance restent vivants
+// jusqu'à la destruction : un voleur peut encore y lire.
+//
+// T : type pointeur ; nullptr signale une deque vide (ou un vol perdu).
+template <typename T>
+class ChaseLevDeque {
+public:
+    static constexpr size_t INITIAL_CAPACITY = 64; // puissance de deux
+
+    ChaseLevDeque() {
+        arrays.push_back(std::make_unique<Array>(INITIAL_CAPACITY));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // Propriétaire seulement
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(a->mask)) a = grow(a, t, b);
+        a->put(b, item);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Propriétaire seulement
+    T pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed); // vide
+            return nullptr;
+        }
+        T item = a->get(b);
+        if (t == b) {
+            // Dernier élément : disputé avec les voleurs
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // N'importe quel thread
+    T steal() {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) return nullptr;
+        Array* a = array.load(std::memory_order_acquire);
+        T item = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr; // perdu contre un autre voleur ou le propriétaire
+        }
+        return item;
+    }
+
+    // Approximatif hors du thread propriétaire
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    size_t capacity() const { return array.load(std::memory_order_relaxed)->mask + 1; }
+
+private:
+    struct Array {
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(size_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t i) const { return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T item) { slots[static_cast<size_t>(i) & mask].store(item, std::memory_order_relaxed); }
+    };
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<Array*> array{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays; // tous les tableaux alloués (propriétaire)
+
+    Array* grow(Array* old, int64_t t, int64_t b) {
+        arrays.push_back(std::make_unique<Array>(2 * (old->mask + 1)));
+        Array* bigger = arrays.back().get();
+        for (int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+};
+
+} // namespace sched
+} // namespace initlang
@@ -0,0 +1,204 @@
+// src/core/sched/scheduler.h
+#pragma once
+#include "chase_lev.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace initlang {
+namespace sched {
+
+// Planificateur M:N à vol de travail : `workers` files ChaseLevDeque, une
+// par worker. Le worker 0 est le thread qui possède le Scheduler : il ne
+// traite des travaux que lorsqu'il le demande (run_one, help_until, drain) ;
+// les workers 1..n-1 sont des threads qui bouclent sur leur file puis volent
+// les autres, en commençant par une victime tirée au hasard.
+//
+// Un travail est un pointeur opaque confié au Handler sur le worker qui l'a
+// obtenu ; le Handler ne doit pas lever et peut pousser d'autres travaux
+// (toujours dans la file de son worker).
+//
+// Un worker sans travail cède le processeur quelques tours puis s'endort sur
+// une variable de condition, réveillé par push(). signal() réveille aussi
+// les dormeurs : événement extérieur aux files (fin d'une tâche attendue),
+// dont help_until tient compte. Le passage de pending() à 0 est signalé de
+// même.
+class Scheduler {
+public:
+    using Handler = void (*)(void* context, void* job, size_t worker);
+
+    // Tours de vol infructueux avant de s'endormir
+    static constexpr int SPIN_ROUNDS = 16;
+
+    Scheduler(size_t workers, Handler h, void* ctx) : handler(h), context(ctx) {
+        if (workers == 0) workers = 1;
+        queues.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) queues.push_back(std::make_unique<Queue>(i));
+        threads.reserve(workers - 1);
+        for (size_t i = 1; i < workers; ++i) threads.emplace_back([this, i] { loop(i); });
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    ~Scheduler() { stop(); }
+
+    size_t workers() const { return queues.size(); }
+
+    // Travaux poussés et pas encore terminés (en file ou en cours)
+    size_t pending() const { return static_cast<size_t>(in_flight.load(std::memory_order_seq_cst)); }
+
+    // Depuis le thread du worker `worker` (0 : le propriétaire)
+    void push(size_t worker, void* job) {
+        in_flight.fetch_add(1, std::memory_order_seq_cst);
+        queued.fetch_add(1, std::memory_order_seq_cst);
+        queues[worker]->deque.push(job);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_one();
+        }
+    }
+
+    // Traite un travail (le sien, sinon volé) ; false si aucun n'a été trouvé
+    bool run_one(size_t worker) {
+        void* job = take(worker);
+        if (!job) return false;
+        handler(context, job, worker);
+        if (in_flight.fetch_sub(1, std::memory_order_seq_cst) == 1) signal();
+        return true;
+    }
+
+    // Compteur d'événements, à lire avant de vérifier une condition puis
+    // de s'endormir avec park()
+    uint64_t epoch() const { return events.load(std::memory_order_seq_cst); }
+
+    void signal() {
+        events.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_all();
+        }
+    }
+
+    // Attend un travail en file, un signal postérieur à `seen` ou l'arrêt
+    void park(uint64_t seen) {
+        std::unique_lock<std::mutex> lock(mutex);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        wake.wait(lock, [&] {
+            return queued.load(std::memory_order_seq_cst) > 0 || stopping.load(std::memory_order_seq_cst) ||
+                   events.load(std::memory_order_seq_cst) != seen;
+        });
+        sleepers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    // Worker 0 : traite des travaux jusqu'à done() ou jusqu'à ce qu'il n'y
+    // en ait plus aucun en cours ; renvoie done()
+    template <typename Done>
+    bool help_until(Done&& done) {
+        while (!done()) {
+            if (run_one(0)) continue;
+            uint64_t seen = epoch();
+            if (done()) return true;
+            if (pending() == 0) return done();
+            park(seen);
+        }
+        return true;
+    }
+
+    // Worker 0 : traite des travaux jusqu'à ce que plus aucun ne soit en cours
+    void drain() {
+        help_until([this] { return pending() == 0; });
+    }
+
+    // Arrête et joint les threads ; les travaux encore en file y restent
+    // (take_remaining)
+    void stop() {
+        if (stopping.exchange(true)) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_all();
+        }
+        for (std::thread& thread : threads) thread.join();
+        threads.clear();
+    }
+
+    // Après stop() : retire un travail resté en file, nullptr s'il n'y en a plus
+    void* take_remaining() {
+        for (auto& queue : queues) {
+            if (void* job = queue->deque.steal()) {
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                in_flight.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    struct Queue {
+        ChaseLevDeque<void*> deque;
+        uint64_t seed; // générateur xorshift du choix des victimes
+
+        explicit Queue(size_t index) : seed(0x9E3779B97F4A7C15ull * (index + 1)) {}
+    };
+
+    Handler handler;
+    void* context;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    std::atomic<int64_t> in_flight{0};
+    std::atomic<int64_t> queued{0};
+    std::atomic<uint64_t> events{0};
+    std::atomic<int> sleepers{0};
+    std::atomic<bool> stopping{false};
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    void* take(size_t worker) {
+        void* job = queues[worker]->deque.pop();
+        if (!job) job = steal(worker);
+        if (job) queued.fetch_sub(1, std::memory_order_seq_cst);
+        return job;
+    }
+
+    void* steal(size_t worker) {
+        const size_t count = queues.size();
+        if (count == 1) return nullptr;
+        uint64_t& seed = queues[worker]->seed;
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t start = static_cast<size_t>(seed % count);
+        for (size_t i = 0; i < count; ++i) {
+            size_t victim = (start + i) % count;
+            if (victim == worker) continue;
+            if (void* job = queues[victim]->deque.steal()) return job;
+        }
+        return nullptr;
+    }
+
+    void loop(size_t worker) {
+        int idle = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (run_one(worker)) {
+                idle = 0;
+                continue;
+            }
+            if (++idle < SPIN_ROUNDS) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle = 0;
+            park(epoch());
+        }
+    }
+};
+
+} // namespace sched
+} // namespace initlang
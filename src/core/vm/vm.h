@@ -0,0 +1,1536 @@
+// src/core/vm/vm.h
+#pragma once
+#include "../compiler/bytecode.h"
+#include "../jit/jit.h"
+#include "../runtime/object.h"
+#include "../sched/scheduler.h"
+#include "../logging/logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Dispatch « direct-threaded » par goto calculé (extension GCC/Clang)
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(INITLANG_NO_COMPUTED_GOTO)
+#define INITLANG_COMPUTED_GOTO 1
+#else
+#define INITLANG_COMPUTED_GOTO 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define INITLANG_COLD __attribute__((cold, noinline))
+#define INITLANG_LIKELY(x) __builtin_expect(!!(x), 1)
+#define INITLANG_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define INITLANG_COLD
+#define INITLANG_LIKELY(x) (x)
+#define INITLANG_UNLIKELY(x) (x)
+#endif
+
+namespace initlang {
+namespace vm {
+
+using compiler::OpCode;
+using runtime::Value;
+
+enum class Dispatch {
+    Switch,   // boucle + switch, portable
+    Threaded  // goto calculé : un saut indirect par opcode
+};
+
+// Fréquences d'exécution des opcodes et des paires d'opcodes consécutifs
+// (précédent, courant), relevées en dispatch switch quand un profil est
+// attaché à la VM. Sert à choisir les superinstructions du peephole.
+struct OpcodeProfile {
+    uint64_t counts[compiler::OPCODE_COUNT] = {};
+    uint64_t pairs[compiler::OPCODE_COUNT][compiler::OPCODE_COUNT] = {};
+    int last = -1; // opcode précédent, -1 en début d'exécution
+
+    void record(uint8_t op) {
+        ++counts[op];
+        if (last >= 0) ++pairs[last][op];
+        last = op;
+    }
+};
+
+// Bilan des tâches depuis la création de la VM
+struct TaskStats {
+    size_t spawned = 0;     // tâches créées par OP_SPAWN
+    size_t suspended = 0;   // suspensions sur un await
+    size_t workers = 0;     // workers de la dernière exécution avec tâches
+};
+
+// Bilan du quickening depuis la création de la VM
+struct QuickeningStats {
+    size_t specialized = 0;   // sites réécrits en forme spécialisée
+    size_t deoptimized = 0;   // sites revenus à la forme générique
+    size_t field_misses = 0;  // caches en ligne de structure (re)remplis
+};
+
+// Machine à pile. La pile de valeurs et la pile d'appels sont allouées une
+// fois pour toutes, à la profondeur choisie à la construction : un appel
+// n'alloue rien, ses arguments restent en place sur la pile de valeurs et
+// deviennent les premiers slots de la trame. OP_TAIL_CALL (`return f(x)`)
+// réutilise la trame de l'appelant, d'où une récursion terminale en pile
+// constante. La boucle d'exécution garde ip et le sommet de pile dans des
+// variables locales et ne les écrit dans la trame qu'aux appels et sur
+// erreur. Les erreurs passent par des fonctions froides hors ligne qui
+// lèvent std::runtime_error avec la pile d'appels.
+//
+// Quickening : un opcode arithmétique ou de comparaison générique exécuté
+// QUICKEN_THRESHOLD fois est réécrit sur place, dans Chunk::code, en sa
+// forme spécialisée pour les types vus (OP_ADD -> OP_ADD_NUM_NUM...). La
+// forme spécialisée garde son cas par un test de type ; s'il échoue, le
+// site reprend la forme générique et n'est plus spécialisé (polymorphe).
+// Un code emprunté à un cache .initc est recopié à la première réécriture.
+//
+// Caches en ligne : OP_GET_FIELD et OP_SET_FIELD gardent, par site, la
+// dernière forme de structure vue et l'indice du champ dans cette forme ;
+// tant que la forme est la même, l'accès est une comparaison de pointeurs
+// et un accès indexé. Un échec refait la recherche par nom et remplace
+// l'entrée (cache monomorphe). OP_BUILD_STRUCT garde la forme produite,
+// ce qui évite de suivre les transitions. Les caches ne sont remplis
+// qu'avec le quickening (jamais en mode tâches).
+//
+// JIT (jit/jit.h) : une fonction dont les appels et les tours de boucle
+// atteignent le seuil du JIT est traduite en x86-64. Ses appels suivants
+// exécutent le code natif, et une activation interprétée en cours y entre
+// au tour de boucle suivant. Le code natif partage la pile de valeurs, les
+// trames et les chemins lents de l'interpréteur ; une fonction qui contient
+// un opcode non traduit reste interprétée. Un appel passé par le code
+// natif consomme aussi de la pile C : le JIT n'est actif que jusqu'à
+// JIT_MAX_FRAMES trames.
+//
+// Tâches : `spawn f(x)` crée une ObjTask confiée au planificateur à vol de
+// travail (sched/scheduler.h), `await t` en rend le résultat. Une tâche
+// s'exécute sur une fibre : une pile de valeurs et une pile de trames
+// propres (TASK_MAX_FRAMES trames), que la VM du worker qui la prend
+// échange avec les siennes. Comme la boucle d'exécution garde tout son état
+// dans ces piles, un await sur une tâche en cours suspend la fibre en
+// revenant simplement de run() : ip reste sur OP_AWAIT, la tâche s'inscrit
+// parmi celles qui attendent l'autre et sera reprise, par n'importe quel
+// worker, quand celle-ci se terminera. Aucun thread ne bloque. Le script,
+// lui, n'est pas une tâche : son await fait travailler le thread appelant
+// (worker 0) jusqu'à ce que la tâche attendue soit terminée.
+//
+// Une exécution dont le code atteignable contient OP_SPAWN passe en mode
+// tâches : Heap partagé, ni quickening ni JIT (le code est ramené à ses
+// formes génériques et n'est plus réécrit). Chaque thread est mutateur du
+// Heap tant qu'il exécute du code, et s'en détache pour attendre ; les VM
+// des workers et les piles des fibres suspendues sont des racines, de sorte
+// que la vieille génération est collectée, monde arrêté, comme hors tâches
+// (runtime/object.h). interpret() attend la fin de
+// toutes les tâches ; un cycle d'await est signalé comme « Deadlock » et
+// l'erreur d'une tâche que personne n'a attendue est relevée à la fin.
+class VM {
+public:
+    static constexpr size_t DEFAULT_MAX_FRAMES = 1024;
+    // Fenêtre maximale d'une trame (slots et temporaires) : le compilateur
+    // et le chargeur de cache bornent Chunk::max_stack à cette valeur et
+    // interpret() refuse une fonction qui la dépasse. Chaque appel vérifie
+    // qu'elle tient encore dans la pile, sinon « Stack overflow ».
+    static constexpr size_t SLOTS_PER_FRAME = compiler::MAX_FRAME_SLOTS;
+    // Slots réservés par trame en moyenne pour dimensionner la pile : une
+    // trame réelle en utilise bien moins que SLOTS_PER_FRAME. Des trames plus
+    // larges épuisent la pile avant max_frames() appels, ce que la
+    // vérification de l'appel signale comme un débordement.
+    static constexpr size_t AVERAGE_SLOTS = 64;
+    // Trames affichées aux deux bouts d'une pile d'appels trop longue
+    static constexpr size_t TRACE_INNER = 12;
+    static constexpr size_t TRACE_OUTER = 4;
+
+    static constexpr uint8_t QUICKEN_THRESHOLD = 8;
+    static constexpr uint8_t POLYMORPHIC = 0xFF; // compteur d'un site qui ne sera plus spécialisé
+
+    static constexpr uint32_t DEFAULT_JIT_THRESHOLD = 1000;
+    static constexpr size_t JIT_MAX_FRAMES = 4096;
+
+    // Profondeur d'appel d'une tâche (au plus max_frames())
+    static constexpr size_t TASK_MAX_FRAMES = 256;
+
+    // `max_frames` : profondeur d'appel au-delà de laquelle l'exécution
+    // échoue sur « Stack overflow »
+    explicit VM(runtime::Heap& h, size_t max_frames = DEFAULT_MAX_FRAMES)
+        : heap(h),
+          frame_limit(max_frames > 0 ? max_frames : 1),
+          stack_slots(frame_limit * AVERAGE_SLOTS + SLOTS_PER_FRAME),
+          stack(new Value[stack_slots]),
+          frames(new CallFrame[frame_limit]),
+          jit_threshold(default_threshold()) {
+        heap.add_roots(this, &VM::trace_roots);
+    }
+
+    ~VM() { heap.remove_roots(this); }
+
+    VM(const VM&) = delete;
+    VM& operator=(const VM&) = delete;
+
+    static constexpr bool threaded_available() { return INITLANG_COMPUTED_GOTO != 0; }
+    static constexpr bool jit_available() { return INITLANG_JIT != 0; }
+
+    // Seuil de traduction native (appels + tours de boucle d'une fonction),
+    // 0 : JIT désactivé. Le défaut vaut pour les VM créées ensuite : les
+    // tests le changent pour passer tout le programme sous chaque niveau.
+    void set_jit_threshold(uint32_t threshold) { jit_threshold = threshold; }
+    static void set_default_jit_threshold(uint32_t threshold) { default_threshold() = threshold; }
+    // JIT effectivement utilisé par interpret()
+    bool jit_enabled() const {
+        return jit_available() && jit_threshold > 0 && !profile && frame_limit <= JIT_MAX_FRAMES;
+    }
+    const jit::Stats& jit_stats() const { return jitted; }
+
+    size_t max_frames() const { return frame_limit; }
+
+    void set_dispatch(Dispatch d) { mode = d; }
+    Dispatch dispatch() const { return threaded_available() ? mode : Dispatch::Switch; }
+
+    // Profil des opcodes exécutés (nullptr : aucun). Force le dispatch switch
+    // et l'interpréteur tant qu'il est attaché.
+    void set_profile(OpcodeProfile* p) { profile = p; }
+
+    // Quickening et caches en ligne actifs (par défaut) ; sans effet sur
+    // les sites déjà réécrits ou remplis
+    void set_quickening(bool enabled) { quickening = enabled; }
+    const QuickeningStats& quickening_stats() const { return quickened; }
+
+    // Sortie de init.log : écriture directe sur `out` (stdout par défaut),
+    // ou, si un Logger est attaché, formatage dans l'anneau du thread et
+    // vidage asynchrone (logging/logger.h). `level` : niveau des lignes de
+    // init.log, comparé au seuil du Logger.
+    void set_log_output(std::FILE* out) { log_output = out; }
+    void set_logger(logging::Logger* l) { logger = l; }
+    void set_log_level(logging::Level level) { log_level = level; }
+
+    // Workers du planificateur de tâches, thread appelant compris ;
+    // 0 (défaut) : std::thread::hardware_concurrency()
+    void set_workers(size_t count) { worker_count = count; }
+    const TaskStats& task_stats() const { return task_totals; }
+
+    // Exécute le script et renvoie sa valeur de retour. Les globales sont
+    // conservées d'un appel à l'autre.
+    Value interpret(runtime::ObjFunction* script) {
+        // Édition de liens : une case par globale connue du Heap
+        if (globals.size() < heap.global_count()) globals.resize(heap.global_count(), UNDEFINED);
+        global_slots = globals.data();
+        jit_context = jit::Context{this, globals.data()};
+        std::vector<runtime::ObjFunction*> functions = reachable_functions(script);
+        check_frame_windows(functions);
+        bool concurrent = prepare_tasks(functions);
+        hot = jit_enabled() && !concurrent ? jit_threshold : 0;
+
+        stack_top = stack.get();
+        frame_count = 0;
+        *stack_top++ = Value::object(script);
+        frames[frame_count++] = CallFrame{script, script->chunk.code.data(), stack.get()};
+
+        // Allocations collectables jusqu'à la fin ; le résultat reste sur la
+        // pile (racine) pendant que la nurserie est vidée
+        heap.begin_execution();
+        Value result;
+        try {
+            result = concurrent ? run_with_tasks() : start();
+        } catch (...) {
+            stack_top = stack.get();
+            frame_count = 0;
+            heap.end_execution();
+            throw;
+        }
+        stack_top = stack.get();
+        *stack_top++ = result;
+        heap.end_execution();
+        result = *--stack_top;
+        return result;
+    }
+
+    // Lecture d'une globale (tests, hôte) ; null si absente
+    Value global(std::string_view name) {
+        uint32_t id = heap.intern(name)->global_id;
+        if (id >= globals.size() || runtime::values_identical(globals[id], UNDEFINED)) return Value::null();
+        return globals[id];
+    }
+
+private:
+    struct CallFrame {
+        runtime::ObjFunction* function;
+        const uint8_t* ip;
+        Value* slots;
+    };
+
+    runtime::Heap& heap;
+    size_t frame_limit;
+    size_t stack_slots;
+    std::unique_ptr<Value[]> stack;
+    std::unique_ptr<CallFrame[]> frames;
+    Value* stack_top = nullptr;
+    size_t frame_count = 0;
+    // Valeurs des globales, indexées par Heap::global_id ; UNDEFINED (objet
+    // nul, jamais produit par le programme) tant que non définie
+    static inline const Value UNDEFINED = Value::object(nullptr);
+    std::vector<Value> globals;
+    Dispatch mode = Dispatch::Threaded;
+    OpcodeProfile* profile = nullptr;
+    bool quickening = true;
+    QuickeningStats quickened;
+    std::FILE* log_output = stdout;
+    logging::Logger* logger = nullptr;
+    logging::Level log_level = logging::Level::Info;
+    uint32_t jit_threshold;
+    uint32_t hot = 0;  // seuil de l'exécution en cours, 0 sans JIT
+    jit::Context jit_context{this, nullptr};
+    std::exception_ptr jit_pending;  // erreur remontée par un helper au code natif
+    jit::Stats jitted;
+    Value* global_slots = nullptr; // globales lues par run() (celles de la VM racine)
+
+    // Tâches (VM racine : task_runtime ; VM de worker : tasks seul)
+    struct Fiber;
+    struct Tasks;
+    size_t worker_count = 0;
+    std::unique_ptr<Tasks> task_runtime;
+    Tasks* tasks = nullptr;
+    size_t worker = 0;                     // file du planificateur de ce thread
+    bool in_fiber = false;                 // VM de worker : await suspend la fibre
+    runtime::ObjTask* awaiting = nullptr;  // tâche attendue par la fibre suspendue
+    TaskStats task_totals;
+
+    static uint32_t& default_threshold() {
+        static uint32_t threshold = DEFAULT_JIT_THRESHOLD;
+        return threshold;
+    }
+
+    // Racines du ramasse-miettes : pile de valeurs jusqu'à stack_top
+    // (à jour avant chaque allocation) et globales
+    static void trace_roots(void* owner, runtime::Heap& heap) {
+        VM& vm = *static_cast<VM*>(owner);
+        for (Value* slot = vm.stack.get(); slot < vm.stack_top; ++slot) heap.trace(*slot);
+        for (Value& global : vm.globals) heap.trace(global);
+    }
+
+    // ----- Chemin froid -----
+
+    // `ip` pointe après l'instruction fautive
+    [[noreturn]] INITLANG_COLD void fail(const uint8_t* ip, const std::string& message) {
+        frames[frame_count - 1].ip = ip;
+
+        // Pile trop longue (débordement) : les trames les plus internes et
+        // les plus externes, dont le script
+        std::string trace = "Runtime error: " + message;
+        for (size_t i = frame_count; i-- > 0;) {
+            if (frame_count > TRACE_INNER + TRACE_OUTER && i + TRACE_INNER < frame_count && i >= TRACE_OUTER) {
+                trace += "\n  ... " + std::to_string(frame_count - TRACE_INNER - TRACE_OUTER) + " more frames";
+                i = TRACE_OUTER;
+                continue;
+            }
+            const CallFrame& frame = frames[i];
+            const compiler::Chunk& chunk = frame.function->chunk;
+            size_t offset = static_cast<size_t>(frame.ip - chunk.code.data()) - 1;
+            compiler::LinePosition at = chunk.position(offset);
+            trace += "\n  [line " + std::to_string(at.line);
+            if (at.column > 0) trace += ":" + std::to_string(at.column);
+            trace += "] in ";
+            trace += frame.function->name ? std::string(frame.function->name->view()) + "()" : "script";
+        }
+
+        stack_top = stack.get();
+        frame_count = 0;
+        throw std::runtime_error(trace);
+    }
+
+    [[noreturn]] INITLANG_COLD void operand_error(const uint8_t* ip, OpCode op) {
+        const char* what = op == OpCode::OP_ADD ? "Operands must be two numbers or a string"
+                         : op == OpCode::OP_NEGATE ? "Operand must be a number"
+                         : "Operands must be numbers";
+        fail(ip, what);
+    }
+
+    [[noreturn]] INITLANG_COLD void undefined_global(const uint8_t* ip, uint32_t id) {
+        fail(ip, "Undefined variable '" + std::string(heap.global_name(id)->view()) + "'");
+    }
+
+    [[noreturn]] INITLANG_COLD void call_error(const uint8_t* ip, Value callee, int argc) {
+        if (!runtime::is_function(callee)) {
+            fail(ip, "Can only call functions, got " + runtime::to_string(callee));
+        }
+        runtime::ObjFunction* function = runtime::as_function(callee);
+        if (function->arity != argc) {
+            fail(ip, "Expected " + std::to_string(function->arity) + " arguments but got " + std::to_string(argc));
+        }
+        fail(ip, "Stack overflow (" + std::to_string(frame_count) + " nested calls)");
+    }
+
+    // ----- Quickening -----
+
+    // Forme spécialisée de `op` pour les opérandes (a, b), OP_COUNT_ si aucune
+    static OpCode specialize(OpCode op, Value a, Value b) {
+        if (runtime::both_numbers(a, b)) {
+            switch (op) {
+                case OpCode::OP_ADD:      return OpCode::OP_ADD_NUM_NUM;
+                case OpCode::OP_SUBTRACT: return OpCode::OP_SUBTRACT_NUM;
+                case OpCode::OP_MULTIPLY: return OpCode::OP_MULTIPLY_NUM;
+                case OpCode::OP_DIVIDE:   return OpCode::OP_DIVIDE_NUM;
+                case OpCode::OP_GREATER:  return OpCode::OP_GREATER_NUM;
+                case OpCode::OP_LESS:     return OpCode::OP_LESS_NUM;
+                default:                  break;
+            }
+        }
+        if (op == OpCode::OP_ADD && runtime::is_string(a) && runtime::is_string(b)) return OpCode::OP_ADD_STR_STR;
+        return OpCode::OP_COUNT_;
+    }
+
+    // Recopie le code emprunté de `function`. Recale les trames appelantes
+    // de la fonction, et `ip` (celui de la trame courante `frame`, dont
+    // frame->ip n'est pas à jour) si c'est la sienne.
+    const uint8_t* own_code(runtime::ObjFunction* function, const CallFrame* frame, const uint8_t* ip) {
+        compiler::CodeBuffer& code = function->chunk.code;
+        if (!code.is_borrowed()) return ip;
+        const uint8_t* old_base = code.data();
+        code.make_owned();
+        const uint8_t* base = code.data();
+
+        for (size_t i = 0; i + 1 < frame_count; ++i) {
+            if (frames[i].function == function) frames[i].ip = base + (frames[i].ip - old_base);
+        }
+        return frame && frame->function == function ? base + (ip - old_base) : ip;
+    }
+
+    // Écrit `op` à `offset` dans le code de la trame courante ; renvoie ip,
+    // recalé si le code était emprunté
+    const uint8_t* rewrite(CallFrame* frame, const uint8_t* ip, size_t offset, OpCode op) {
+        ip = own_code(frame->function, frame, ip);
+        frame->function->chunk.code[offset] = static_cast<uint8_t>(op);
+        return ip;
+    }
+
+    // Exécution d'un opcode générique ; `ip` pointe après l'opcode
+    const uint8_t* quicken(CallFrame* frame, const uint8_t* ip, Value a, Value b) {
+        compiler::Chunk& chunk = frame->function->chunk;
+        size_t offset = static_cast<size_t>(ip - chunk.code.data()) - 1;
+        if (chunk.warmup.size() != chunk.code.size()) chunk.warmup.resize(chunk.code.size(), 0);
+
+        uint8_t& heat = chunk.warmup[offset];
+        if (heat == POLYMORPHIC || ++heat < QUICKEN_THRESHOLD) return ip;
+
+        OpCode special = specialize(static_cast<OpCode>(chunk.code.data()[offset]), a, b);
+        if (special == OpCode::OP_COUNT_) {
+            heat = POLYMORPHIC;
+            return ip;
+        }
+        ++quickened.specialized;
+        return rewrite(frame, ip, offset, special);
+    }
+
+    // Garde d'une forme spécialisée en échec : renvoie ip sur l'opcode,
+    // redevenu générique, pour le réexécuter
+    INITLANG_COLD const uint8_t* deoptimize(CallFrame* frame, const uint8_t* ip) {
+        compiler::Chunk& chunk = frame->function->chunk;
+        size_t offset = static_cast<size_t>(ip - chunk.code.data()) - 1;
+        chunk.warmup[offset] = POLYMORPHIC;
+        ++quickened.deoptimized;
+        ip = rewrite(frame, ip, offset, compiler::generic_opcode(static_cast<OpCode>(chunk.code.data()[offset])));
+        return ip - 1;
+    }
+
+    // ----- JIT -----
+
+    // Traduit `function`, devenue chaude. Son code doit rester en place
+    // pour les positions d'erreur du code natif : un code emprunté est
+    // d'abord recopié (`ip` de la trame `frame` recalé comme par rewrite).
+    INITLANG_COLD const uint8_t* tier_up(runtime::ObjFunction* function, const CallFrame* frame, const uint8_t* ip) {
+        ip = own_code(function, frame, ip);
+        static const jit::Helpers helpers{&jit_binary, &jit_undefined_global, &jit_call, &jit_log};
+        function->native = jit::compile(*function, helpers);
+        if (function->native) {
+            ++jitted.compiled;
+            jitted.code_bytes += function->native->code_size();
+        } else {
+            ++jitted.rejected;
+        }
+        return ip;
+    }
+
+    // Appel du code natif de `function`, dont la trame vient d'être empilée
+    void run_native(runtime::ObjFunction* function, Value* window) {
+        if (INITLANG_UNLIKELY(function->native->entry(&jit_context, window) != 0)) rethrow_pending();
+    }
+
+    [[noreturn]] INITLANG_COLD void rethrow_pending() {
+        std::exception_ptr error = std::move(jit_pending);
+        jit_pending = nullptr;
+        std::rethrow_exception(error);
+    }
+
+    // Interpréteur pour les trames au-dessus de `base`
+    Value execute(size_t base) {
+#if INITLANG_COMPUTED_GOTO
+        if (mode == Dispatch::Threaded) return run<true, false>(base);
+#endif
+        return run<false, false>(base);
+    }
+
+    // OP_CALL depuis le code natif : appelé en `window`, arguments au-dessus
+    void call_from_native(Value* window, int argc, const uint8_t* ip) {
+        Value callee = *window;
+        Value* sp = window + argc + 1;
+        if (INITLANG_UNLIKELY(!runtime::is_function(callee) || runtime::as_function(callee)->arity != argc ||
+                              frame_count == frame_limit || sp + SLOTS_PER_FRAME > stack.get() + stack_slots)) {
+            call_error(ip, callee, argc);
+        }
+        frames[frame_count - 1].ip = ip;
+
+        runtime::ObjFunction* function = runtime::as_function(callee);
+        if (!function->native && ++function->hotness == hot) tier_up(function, nullptr, nullptr);
+        frames[frame_count++] = CallFrame{function, function->chunk.code.data(), window};
+        if (function->native) {
+            run_native(function, window);
+            --frame_count;
+            return;
+        }
+        stack_top = sp;
+        *window = execute(frame_count - 1);
+    }
+
+    // Helpers du code natif : aucune exception ne doit les traverser
+    static int jit_binary(jit::Context* context, Value* operands, uint32_t op, const uint8_t* ip) {
+        VM& vm = *static_cast<VM*>(context->vm);
+        try {
+            if (static_cast<OpCode>(op) != OpCode::OP_ADD) vm.operand_error(ip, static_cast<OpCode>(op));
+            vm.stack_top = operands + 2;
+            operands[0] = vm.add_slow(ip, operands[0], operands[1]);
+            return 0;
+        } catch (...) {
+            vm.jit_pending = std::current_exception();
+            return 1;
+        }
+    }
+
+    static int jit_undefined_global(jit::Context* context, uint32_t id, const uint8_t* ip) {
+        VM& vm = *static_cast<VM*>(context->vm);
+        try {
+            vm.undefined_global(ip, id);
+        } catch (...) {
+            vm.jit_pending = std::current_exception();
+        }
+        return 1;
+    }
+
+    static int jit_call(jit::Context* context, Value* window, uint32_t argc, const uint8_t* ip) {
+        VM& vm = *static_cast<VM*>(context->vm);
+        try {
+            vm.call_from_native(window, static_cast<int>(argc), ip);
+            return 0;
+        } catch (...) {
+            vm.jit_pending = std::current_exception();
+            return 1;
+        }
+    }
+
+    static int jit_log(jit::Context* context, Value* args, uint32_t argc) {
+        VM& vm = *static_cast<VM*>(context->vm);
+        try {
+            vm.log(args, argc);
+            args[0] = Value::null();
+            return 0;
+        } catch (...) {
+            vm.jit_pending = std::current_exception();
+            return 1;
+        }
+    }
+
+    // ----- Tâches -----
+
+    // Piles d'une tâche démarrée ; échangées avec celles de la VM du worker
+    // le temps de l'exécuter (enter/leave)
+    struct Fiber {
+        std::unique_ptr<Value[]> stack;
+        std::unique_ptr<CallFrame[]> frames;
+        Value* stack_top = nullptr;       // nullptr : piles dans une VM (enter)
+        size_t frame_count = 0;
+        runtime::ObjTask* task = nullptr; // nullptr : libre
+    };
+
+    void enter(Fiber& fiber) {
+        std::swap(stack, fiber.stack);
+        std::swap(frames, fiber.frames);
+        stack_top = fiber.stack_top;
+        frame_count = fiber.frame_count;
+        fiber.stack_top = nullptr;
+    }
+
+    void leave(Fiber& fiber) {
+        fiber.stack_top = stack_top;
+        fiber.frame_count = frame_count;
+        std::swap(stack, fiber.stack);
+        std::swap(frames, fiber.frames);
+        stack_top = stack.get();
+    }
+
+    // État partagé d'une exécution avec tâches : une VM par worker, les
+    // fibres et le planificateur (dernier membre : ses threads sont joints
+    // avant que le reste ne soit détruit)
+    struct Tasks {
+        VM& root;
+        std::vector<std::unique_ptr<VM>> vms;
+        std::vector<std::vector<Fiber*>> free_fibers; // par worker, sans verrou
+        std::mutex fibers_lock;
+        std::vector<std::unique_ptr<Fiber>> fibers;   // toutes les fibres créées
+        std::atomic<size_t> live{0};                  // créées et pas encore terminées
+        std::atomic<size_t> spawned{0};
+        std::atomic<size_t> suspended{0};
+        std::mutex failures_lock;
+        std::vector<runtime::ObjTask*> failures;
+        sched::Scheduler scheduler;
+
+        Tasks(VM& vm, size_t workers) : root(vm), free_fibers(workers), scheduler(workers, &run_job, this) {
+            vm.heap.add_roots(this, &Tasks::trace_roots);
+            size_t depth = std::min(vm.frame_limit, TASK_MAX_FRAMES);
+            for (size_t i = 0; i < workers; ++i) {
+                auto task_vm = std::make_unique<VM>(vm.heap, depth);
+                task_vm->mode = vm.mode;
+                task_vm->log_output = vm.log_output;
+                task_vm->logger = vm.logger;
+                task_vm->log_level = vm.log_level;
+                task_vm->quickening = false;
+                task_vm->jit_threshold = 0;
+                task_vm->global_slots = vm.global_slots;
+                task_vm->tasks = this;
+                task_vm->worker = i;
+                task_vm->in_fiber = true;
+                vms.push_back(std::move(task_vm));
+            }
+        }
+
+        ~Tasks() { root.heap.remove_roots(this); }
+
+        static void run_job(void* context, void* job, size_t worker) {
+            Tasks& tasks = *static_cast<Tasks*>(context);
+            tasks.root.heap.attach_mutator();
+            tasks.execute(static_cast<runtime::ObjTask*>(job), worker);
+            tasks.root.heap.detach_mutator();
+        }
+
+        // Racines, monde arrêté : piles des fibres suspendues (celle d'une
+        // fibre en cours est dans la VM de son worker) et tâches échouées ;
+        // les tâches en cours le sont pour le Heap
+        static void trace_roots(void* owner, runtime::Heap& heap) {
+            Tasks& tasks = *static_cast<Tasks*>(owner);
+            for (const auto& fiber : tasks.fibers) {
+                if (!fiber->task || !fiber->stack_top) continue;
+                for (Value* slot = fiber->stack.get(); slot < fiber->stack_top; ++slot) heap.trace(*slot);
+            }
+            for (runtime::ObjTask* task : tasks.failures) {
+                Value value = Value::object(task);
+                heap.trace(value);
+            }
+        }
+
+        Fiber* acquire(size_t worker) {
+            std::vector<Fiber*>& pool = free_fibers[worker];
+            if (!pool.empty()) {
+                Fiber* fiber = pool.back();
+                pool.pop_back();
+                return fiber;
+            }
+            const VM& vm = *vms[worker];
+            auto fiber = std::make_unique<Fiber>();
+            fiber->stack.reset(new Value[vm.stack_slots]);
+            fiber->frames.reset(new CallFrame[vm.frame_limit]);
+            std::lock_guard<std::mutex> lock(fibers_lock);
+            fibers.push_back(std::move(fiber));
+            return fibers.back().get();
+        }
+
+        // Démarre ou reprend `task` sur le worker `worker`
+        void execute(runtime::ObjTask* task, size_t worker) {
+            VM& vm = *vms[worker];
+            Fiber* fiber = static_cast<Fiber*>(task->fiber);
+            if (!fiber) {
+                fiber = acquire(worker);
+                fiber->task = task;
+                Value* window = fiber->stack.get();
+                window[0] = Value::object(task->function);
+                std::copy(task->args.begin(), task->args.end(), window + 1);
+                fiber->stack_top = window + 1 + task->args.size();
+                fiber->frames[0] = CallFrame{task->function, task->function->chunk.code.data(), window};
+                fiber->frame_count = 1;
+                std::vector<Value>().swap(task->args);
+            }
+
+            Value result = Value::null();
+            std::exception_ptr error;
+            vm.enter(*fiber);
+            try {
+                result = vm.execute(0);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            vm.leave(*fiber);
+
+            if (!error && vm.awaiting) {
+                runtime::ObjTask* target = vm.awaiting;
+                vm.awaiting = nullptr;
+                task->fiber = fiber;
+                suspended.fetch_add(1, std::memory_order_relaxed);
+                std::unique_lock<std::mutex> lock(target->lock);
+                if (target->pending()) {
+                    target->waiters.push_back(task);
+                    return;
+                }
+                lock.unlock();
+                scheduler.push(worker, task); // terminée entre-temps : reprise tout de suite
+                return;
+            }
+
+            task->fiber = nullptr;
+            fiber->task = nullptr;
+            free_fibers[worker].push_back(fiber);
+            finish(task, result, error, worker);
+        }
+
+        void finish(runtime::ObjTask* task, Value result, std::exception_ptr error, size_t worker) {
+            std::vector<runtime::ObjTask*> waiters;
+            bool wake_root;
+            {
+                std::lock_guard<std::mutex> lock(task->lock);
+                if (error) {
+                    task->error = error;
+                    task->state.store(runtime::ObjTask::Failed, std::memory_order_release);
+                } else {
+                    task->result = result;
+                    task->state.store(runtime::ObjTask::Done, std::memory_order_release);
+                }
+                waiters.swap(task->waiters);
+                wake_root = task->root_waiting;
+            }
+            if (error) {
+                std::lock_guard<std::mutex> lock(failures_lock);
+                failures.push_back(task);
+            }
+            for (runtime::ObjTask* waiter : waiters) scheduler.push(worker, waiter);
+            live.fetch_sub(1, std::memory_order_relaxed);
+            if (wake_root) scheduler.signal();
+        }
+
+        // Script : attend `task` en traitant des travaux ; false si plus rien
+        // ne peut la faire progresser. Sa pile (stack_top à jour) reste une
+        // racine pendant qu'il est détaché.
+        bool wait(runtime::ObjTask* task) {
+            root.heap.detach_mutator();
+            bool done = scheduler.help_until([task] {
+                std::lock_guard<std::mutex> lock(task->lock);
+                if (!task->pending()) return true;
+                task->root_waiting = true;
+                return false;
+            });
+            root.heap.attach_mutator();
+            return done;
+        }
+
+        // Après l'arrêt des threads : erreur de fin d'exécution éventuelle
+        std::exception_ptr outcome() {
+            size_t stuck = live.load();
+            if (stuck > 0) {
+                return std::make_exception_ptr(std::runtime_error(
+                    "Runtime error: Deadlock: " + std::to_string(stuck) + (stuck == 1 ? " task" : " tasks") +
+                    " never completed"));
+            }
+            for (runtime::ObjTask* task : failures) {
+                if (!task->observed.load()) return task->error;
+            }
+            return nullptr;
+        }
+
+        // Après l'arrêt des threads : les tâches en file ou suspendues
+        // échouent sur « Task cancelled »
+        void cancel_remaining() {
+            std::exception_ptr cancelled = std::make_exception_ptr(std::runtime_error("Runtime error: Task cancelled"));
+            auto cancel = [&](runtime::ObjTask* task) {
+                task->fiber = nullptr;
+                task->waiters.clear();
+                task->error = cancelled;
+                task->observed.store(true);
+                task->state.store(runtime::ObjTask::Failed, std::memory_order_release);
+            };
+            while (void* job = scheduler.take_remaining()) {
+                auto* task = static_cast<runtime::ObjTask*>(job);
+                if (task->pending()) cancel(task);
+            }
+            for (const auto& fiber : fibers) {
+                if (fiber->task && fiber->task->pending()) cancel(fiber->task);
+            }
+        }
+    };
+
+    // Fonctions atteignables depuis le script et les globales
+    std::vector<runtime::ObjFunction*> reachable_functions(runtime::ObjFunction* script) {
+        std::vector<runtime::ObjFunction*> functions;
+        std::unordered_set<const runtime::Obj*> seen;
+        std::vector<Value> pending(globals.begin(), globals.end());
+        pending.push_back(Value::object(script));
+        while (!pending.empty()) {
+            Value value = pending.back();
+            pending.pop_back();
+            if (!value.is_object() || !value.as_object() || !seen.insert(value.as_object()).second) continue;
+            switch (value.as_object()->type) {
+                case runtime::ObjType::Function: {
+                    runtime::ObjFunction* function = runtime::as_function(value);
+                    functions.push_back(function);
+                    pending.insert(pending.end(), function->chunk.constants.begin(), function->chunk.constants.end());
+                    break;
+                }
+                case runtime::ObjType::List: {
+                    const auto& items = runtime::as_list(value)->items;
+                    pending.insert(pending.end(), items.begin(), items.end());
+                    break;
+                }
+                case runtime::ObjType::Struct: {
+                    const runtime::ObjStruct* object = runtime::as_struct(value);
+                    pending.insert(pending.end(), object->values(), object->values() + object->size());
+                    break;
+                }
+                case runtime::ObjType::Task:
+                    pending.push_back(Value::object(runtime::as_task(value)->function));
+                    pending.push_back(runtime::as_task(value)->result);
+                    break;
+                case runtime::ObjType::String:
+                    break;
+            }
+        }
+        return functions;
+    }
+
+    // Chaque appel ne garantit que SLOTS_PER_FRAME slots à la trame : une
+    // fonction dont la hauteur de pile (Chunk::max_stack) dépasse cette
+    // fenêtre n'est pas exécutée
+    void check_frame_windows(const std::vector<runtime::ObjFunction*>& functions) {
+        for (const runtime::ObjFunction* function : functions) {
+            if (function->chunk.max_stack > SLOTS_PER_FRAME) {
+                throw std::runtime_error(
+                    "Runtime error: " +
+                    (function->name ? "function '" + std::string(function->name->view()) + "'" : std::string("script")) +
+                    " needs " + std::to_string(function->chunk.max_stack) + " stack slots (limit " +
+                    std::to_string(SLOTS_PER_FRAME) + ")");
+            }
+        }
+    }
+
+    // Mode tâches : vrai si le code de `functions` contient OP_SPAWN ; ce
+    // code est alors ramené aux formes génériques, qu'aucun thread ne
+    // réécrira pendant l'exécution
+    bool prepare_tasks(const std::vector<runtime::ObjFunction*>& functions) {
+        auto spawns = [](const runtime::ObjFunction* function) {
+            const compiler::CodeBuffer& code = function->chunk.code;
+            for (size_t offset = 0; offset < code.size(); offset += compiler::instruction_size(OpCode(code[offset]))) {
+                if (code[offset] == static_cast<uint8_t>(OpCode::OP_SPAWN)) return true;
+            }
+            return false;
+        };
+        if (std::none_of(functions.begin(), functions.end(), spawns)) return false;
+
+        for (runtime::ObjFunction* function : functions) {
+            compiler::Chunk& chunk = function->chunk;
+            const compiler::CodeBuffer& view = chunk.code; // lecture sans recopie
+            for (size_t offset = 0; offset < view.size(); offset += compiler::instruction_size(OpCode(view[offset]))) {
+                OpCode op = static_cast<OpCode>(view[offset]);
+                if (compiler::generic_opcode(op) != op) chunk.code[offset] = static_cast<uint8_t>(compiler::generic_opcode(op));
+            }
+        }
+        return true;
+    }
+
+    Value start() {
+        if (profile) {
+            profile->last = -1;
+            return run<false, true>(0);
+        }
+        return execute(0);
+    }
+
+    // Script exécuté avec le planificateur, puis attente de toutes les tâches
+    Value run_with_tasks() {
+        bool saved_quickening = quickening;
+        quickening = false;
+        heap.set_shared(true);
+        size_t count = worker_count ? worker_count : std::thread::hardware_concurrency();
+        task_runtime = std::make_unique<Tasks>(*this, count ? count : 1);
+        tasks = task_runtime.get();
+
+        Value result = Value::null();
+        std::exception_ptr error;
+        try {
+            result = start();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // Le script ne touche plus aux objets : son résultat attend sur la
+        // pile, et les workers arrêtés sur une collecte ne dépendent plus de lui
+        *stack_top++ = result;
+        heap.detach_mutator();
+        if (!error) tasks->scheduler.drain();
+        tasks->scheduler.stop();
+        if (!error) error = tasks->outcome();
+        tasks->cancel_remaining();
+
+        task_totals.spawned += tasks->spawned.load();
+        task_totals.suspended += tasks->suspended.load();
+        task_totals.workers = tasks->vms.size();
+        tasks = nullptr;
+        task_runtime.reset();
+        heap.set_shared(false);
+        quickening = saved_quickening;
+        result = *--stack_top;
+
+        if (error) std::rethrow_exception(error);
+        return result;
+    }
+
+    // OP_SPAWN : appelé et arité déjà vérifiés
+    Value spawn(const uint8_t* ip, runtime::ObjFunction* function, const Value* args, int argc) {
+        if (INITLANG_UNLIKELY(!tasks)) fail(ip, "Cannot spawn outside of a task run");
+        runtime::ObjTask* task = heap.new_task(function, args, static_cast<size_t>(argc));
+        tasks->live.fetch_add(1, std::memory_order_relaxed);
+        tasks->spawned.fetch_add(1, std::memory_order_relaxed);
+        tasks->scheduler.push(worker, task);
+        return Value::object(task);
+    }
+
+    // OP_AWAIT hors fibre (ou tâche déjà terminée) : résultat de `task`
+    Value await_task(const uint8_t* ip, runtime::ObjTask* task) {
+        if (task->pending() && (!tasks || !tasks->wait(task))) {
+            fail(ip, "Deadlock: awaited task can never complete");
+        }
+        task->observed.store(true, std::memory_order_relaxed);
+        if (task->state.load(std::memory_order_acquire) == runtime::ObjTask::Failed) task_failed(ip, task);
+        return task->result;
+    }
+
+    // Erreur de la tâche attendue, suivie de la pile du point d'attente
+    [[noreturn]] INITLANG_COLD void task_failed(const uint8_t* ip, runtime::ObjTask* task) {
+        std::string message;
+        try {
+            std::rethrow_exception(task->error);
+        } catch (const std::exception& e) {
+            message = e.what();
+        } catch (...) {
+            message = "unknown error";
+        }
+        const std::string prefix = "Runtime error: ";
+        if (message.compare(0, prefix.size(), prefix) == 0) message.erase(0, prefix.size());
+        fail(ip, message);
+    }
+
+    // ----- Chemin tiède : hors de la boucle mais non exceptionnel -----
+
+    Value add_slow(const uint8_t* ip, Value a, Value b) {
+        if (runtime::is_string(a) && runtime::is_string(b)) {
+            return Value::object(heap.concat(runtime::as_string(a), runtime::as_string(b)));
+        }
+        if (runtime::is_string(a) || runtime::is_string(b)) {
+            return Value::object(heap.intern(runtime::to_string(a) + runtime::to_string(b)));
+        }
+        operand_error(ip, OpCode::OP_ADD);
+    }
+
+    Value build_list(Value* items, size_t count) {
+        runtime::ObjList* list = heap.new_list();
+        list->items.assign(items, items + count);
+        return Value::object(list);
+    }
+
+    // Forme connue du site si les noms sont les mêmes, dans le même ordre ;
+    // un nom répété garde un seul champ, de la dernière valeur
+    Value build_struct(CallFrame* frame, const uint8_t* ip, Value* pairs, size_t count) {
+        const compiler::FieldCache* cache = site_cache(frame, ip);
+        const runtime::Shape* shape = cache ? cache->shape : nullptr;
+        bool same = shape && shape->size() == count;
+        for (size_t i = 0; same && i < count; ++i) {
+            same = pairs[2 * i].is_object() && pairs[2 * i].as_object() == shape->name(i);
+        }
+        if (!same) {
+            shape = heap.empty_shape();
+            for (size_t i = 0; i < count; ++i) {
+                Value name = pairs[2 * i];
+                if (!runtime::is_string(name)) fail(ip, "Struct field names must be strings");
+                shape = heap.shape_with(shape, runtime::as_string(name));
+            }
+            fill_cache(frame, ip, shape, 0);
+        }
+
+        runtime::ObjStruct* object = heap.new_struct(shape); // peut déplacer les paires (collecte)
+        Value* values = object->values();
+        for (size_t i = 0; i < count; ++i) {
+            size_t index = shape->size() == count ? i
+                         : static_cast<size_t>(shape->index_of(runtime::as_string(pairs[2 * i])));
+            values[index] = pairs[2 * i + 1];
+        }
+        return Value::object(object);
+    }
+
+    // ----- Caches en ligne -----
+
+    // Cache du site courant (`ip` après son opérande d'un octet), nullptr
+    // tant qu'aucun cache n'a été alloué pour la fonction
+    static compiler::FieldCache* site_cache(CallFrame* frame, const uint8_t* ip) {
+        compiler::Chunk& chunk = frame->function->chunk;
+        size_t offset = static_cast<size_t>(ip - chunk.code.data()) - 2;
+        return offset < chunk.field_caches.size() ? &chunk.field_caches[offset] : nullptr;
+    }
+
+    void fill_cache(CallFrame* frame, const uint8_t* ip, const runtime::Shape* shape, uint32_t index) {
+        if (!quickening) return;
+        compiler::Chunk& chunk = frame->function->chunk;
+        if (chunk.field_caches.size() != chunk.code.size()) chunk.field_caches.resize(chunk.code.size());
+        chunk.field_caches[static_cast<size_t>(ip - chunk.code.data()) - 2] = compiler::FieldCache{shape, index};
+        ++quickened.field_misses;
+    }
+
+    // Chemin lent de OP_GET_FIELD / OP_SET_FIELD : case du champ `name` de
+    // `target`, cache du site rempli
+    Value* field_slot(CallFrame* frame, const uint8_t* ip, Value target, Value name) {
+        if (INITLANG_UNLIKELY(!runtime::is_struct(target))) {
+            fail(ip, "Only structs have fields, got " + runtime::to_string(target));
+        }
+        runtime::ObjStruct* object = runtime::as_struct(target);
+        int index = object->shape->index_of(runtime::as_string(name));
+        if (INITLANG_UNLIKELY(index < 0)) {
+            fail(ip, "Undefined field '" + std::string(runtime::as_string(name)->view()) + "'");
+        }
+        fill_cache(frame, ip, object->shape, static_cast<uint32_t>(index));
+        return object->values() + index;
+    }
+
+    void log(Value* args, size_t count) {
+        if (logger) {
+            if (!logger->enabled(log_level)) return;
+            std::string& line = logger->begin();
+            if (logger->format() == logging::Format::KeyValue) {
+                format_fields(line, args, count);
+            } else {
+                format_line(line, args, count);
+            }
+            logger->commit();
+            return;
+        }
+        std::string line;
+        format_line(line, args, count);
+        std::fwrite(line.data(), 1, line.size(), log_output);
+    }
+
+    static void format_line(std::string& line, const Value* args, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (i) line += ' ';
+            runtime::append_value(line, args[i]);
+        }
+        line += '\n';
+    }
+
+    // Format::KeyValue : « level=info », puis les champs des structures
+    // (nom=valeur) et les autres arguments sous argN=valeur
+    void format_fields(std::string& line, const Value* args, size_t count) const {
+        line += "level=";
+        line += logging::level_name(log_level);
+        for (size_t i = 0; i < count; ++i) {
+            if (runtime::is_struct(args[i])) {
+                const runtime::ObjStruct* object = runtime::as_struct(args[i]);
+                for (size_t f = 0; f < object->size(); ++f) {
+                    line += ' ';
+                    line += object->name(f)->view();
+                    line += '=';
+                    append_field(line, object->values()[f]);
+                }
+                continue;
+            }
+            line += " arg";
+            line += std::to_string(i);
+            line += '=';
+            append_field(line, args[i]);
+        }
+        line += '\n';
+    }
+
+    // Nombres, booléens et null tels quels ; le reste entre guillemets
+    static void append_field(std::string& line, Value value) {
+        if (!value.is_object()) {
+            runtime::append_value(line, value);
+            return;
+        }
+        size_t start = line.size();
+        line += '"';
+        runtime::append_value(line, value);
+        for (size_t i = start + 1; i < line.size(); ++i) {
+            char c = line[i];
+            if (c == '"' || c == '\\' || c == '\n') {
+                line.replace(i, 1, c == '\n' ? "\\n" : std::string{'\\', c});
+                ++i;
+            }
+        }
+        line += '"';
+    }
+
+    // ----- Boucle d'exécution -----
+
+    // Exécute jusqu'au retour de la trame base (0 : le script)
+    template <bool THREADED, bool PROFILE>
+    Value run(size_t base) {
+        CallFrame* frame = &frames[frame_count - 1];
+        const uint8_t* ip = frame->ip;
+        Value* sp = stack_top;
+        Value* slots = frame->slots;
+        const Value* constants = frame->function->chunk.constants.data();
+        Value* globals_base = global_slots; // taille fixe pendant l'exécution
+        const uint32_t jit_after = PROFILE ? 0 : hot;
+
+#if INITLANG_COMPUTED_GOTO
+        // Même ordre que l'enum OpCode. Le bytecode est supposé valide (produit
+        // par le Compiler ou vérifié au chargement) : pas de test de borne.
+        static void* const labels[] = {
+            &&L_OP_CONSTANT, &&L_OP_NULL, &&L_OP_TRUE, &&L_OP_FALSE,
+            &&L_OP_DEFINE_GLOBAL, &&L_OP_GET_GLOBAL, &&L_OP_SET_GLOBAL,
+            &&L_OP_GET_LOCAL, &&L_OP_SET_LOCAL,
+            &&L_OP_ADD, &&L_OP_SUBTRACT, &&L_OP_MULTIPLY, &&L_OP_DIVIDE,
+            &&L_OP_NEGATE, &&L_OP_NOT,
+            &&L_OP_EQUAL, &&L_OP_NOT_EQUAL, &&L_OP_GREATER, &&L_OP_LESS, &&L_OP_GREATER_EQUAL, &&L_OP_LESS_EQUAL,
+            &&L_OP_JUMP, &&L_OP_JUMP_IF_FALSE, &&L_OP_LOOP,
+            &&L_OP_CALL, &&L_OP_TAIL_CALL, &&L_OP_RETURN,
+            &&L_OP_BUILD_LIST, &&L_OP_BUILD_STRUCT, &&L_OP_GET_FIELD, &&L_OP_SET_FIELD,
+            &&L_OP_INIT_GER, &&L_OP_INIT_LOG,
+            &&L_OP_SPAWN, &&L_OP_AWAIT,
+            &&L_OP_POP,
+            &&L_OP_CONSTANT_LONG, &&L_OP_DEFINE_GLOBAL_LONG, &&L_OP_GET_GLOBAL_LONG, &&L_OP_SET_GLOBAL_LONG,
+            &&L_OP_ADD_CONSTANT, &&L_OP_SUBTRACT_CONSTANT, &&L_OP_JUMP_IF_NOT_LESS, &&L_OP_SET_LOCAL_POP,
+            &&L_OP_RETURN_LOCAL,
+            &&L_OP_ADD_NUM_NUM, &&L_OP_ADD_STR_STR, &&L_OP_SUBTRACT_NUM, &&L_OP_MULTIPLY_NUM, &&L_OP_DIVIDE_NUM,
+            &&L_OP_GREATER_NUM, &&L_OP_LESS_NUM,
+        };
+        static_assert(sizeof(labels) / sizeof(labels[0]) == compiler::OPCODE_COUNT,
+                      "dispatch table out of sync with OpCode");
+#define INITLANG_JUMP_NEXT() goto *labels[*ip++]
+#else
+#define INITLANG_JUMP_NEXT() goto dispatch_switch
+#endif
+
+#define DISPATCH()                                      \
+    do {                                                \
+        if constexpr (THREADED) INITLANG_JUMP_NEXT();   \
+        else goto dispatch_switch;                      \
+    } while (0)
+#if INITLANG_COMPUTED_GOTO
+#define OPCODE(op) case OpCode::op: L_##op:
+#else
+#define OPCODE(op) case OpCode::op:
+#endif
+#define READ_BYTE() (*ip++)
+#define READ_SHORT() (ip += 2, static_cast<uint16_t>(ip[-2] | (ip[-1] << 8)))
+#define READ_LONG() (ip += 3, static_cast<uint32_t>(ip[-3] | (ip[-2] << 8) | (ip[-1] << 16)))
+#define QUICKEN(a, b)                                                       \
+    do {                                                                    \
+        if (quickening) ip = quicken(frame, ip, a, b);                      \
+    } while (0)
+#define BINARY_NUMBER(op_code, result)                                      \
+    do {                                                                    \
+        Value b = sp[-1];                                                   \
+        Value a = sp[-2];                                                   \
+        QUICKEN(a, b);                                                      \
+        if (INITLANG_UNLIKELY(!runtime::both_numbers(a, b))) {              \
+            operand_error(ip, OpCode::op_code);                             \
+        }                                                                   \
+        double x = a.as_number();                                           \
+        double y = b.as_number();                                           \
+        sp[-2] = result;                                                    \
+        --sp;                                                               \
+        DISPATCH();                                                         \
+    } while (0)
+// Forme spécialisée sur deux nombres ; sinon retour à la forme générique
+#define BINARY_NUMBER_GUARDED(result)                                       \
+    do {                                                                    \
+        Value b = sp[-1];                                                   \
+        Value a = sp[-2];                                                   \
+        if (INITLANG_UNLIKELY(!runtime::both_numbers(a, b))) {              \
+            ip = deoptimize(frame, ip);                                     \
+            DISPATCH();                                                     \
+        }                                                                   \
+        double x = a.as_number();                                           \
+        double y = b.as_number();                                           \
+        sp[-2] = result;                                                    \
+        --sp;                                                               \
+        DISPATCH();                                                         \
+    } while (0)
+// Dépile la trame courante ; fin de run() au retour de la trame `base`
+#define RETURN_VALUE(value)                                                 \
+    do {                                                                    \
+        Value result = (value);                                             \
+        if (--frame_count == base) {                                        \
+            stack_top = slots;                                              \
+            return result;                                                  \
+        }                                                                   \
+        sp = slots;                                                         \
+        *sp++ = result;                                                     \
+                                                                            \
+        frame = &frames[frame_count - 1];                                   \
+        ip = frame->ip;                                                     \
+        slots = frame->slots;                                               \
+        constants = frame->function->chunk.constants.data();                \
+        DISPATCH();                                                         \
+    } while (0)
+
+        DISPATCH();
+
+#if INITLANG_COMPUTED_GOTO
+    dispatch_switch: __attribute__((unused)); // non utilisé en mode THREADED
+#else
+    dispatch_switch:
+#endif
+        if constexpr (PROFILE) profile->record(*ip);
+        switch (static_cast<OpCode>(*ip++)) {
+            OPCODE(OP_CONSTANT) {
+                *sp++ = constants[READ_BYTE()];
+                DISPATCH();
+            }
+            OPCODE(OP_CONSTANT_LONG) {
+                *sp++ = constants[READ_LONG()];
+                DISPATCH();
+            }
+            OPCODE(OP_NULL) { *sp++ = Value::null(); DISPATCH(); }
+            OPCODE(OP_TRUE) { *sp++ = Value::boolean(true); DISPATCH(); }
+            OPCODE(OP_FALSE) { *sp++ = Value::boolean(false); DISPATCH(); }
+            OPCODE(OP_POP) { --sp; DISPATCH(); }
+
+            OPCODE(OP_DEFINE_GLOBAL) {
+                globals_base[READ_BYTE()] = *--sp;
+                DISPATCH();
+            }
+            OPCODE(OP_DEFINE_GLOBAL_LONG) {
+                globals_base[READ_LONG()] = *--sp;
+                DISPATCH();
+            }
+            OPCODE(OP_GET_GLOBAL) {
+                uint32_t id = READ_BYTE();
+                Value value = globals_base[id];
+                if (INITLANG_UNLIKELY(runtime::values_identical(value, UNDEFINED))) undefined_global(ip, id);
+                *sp++ = value;
+                DISPATCH();
+            }
+            OPCODE(OP_GET_GLOBAL_LONG) {
+                uint32_t id = READ_LONG();
+                Value value = globals_base[id];
+                if (INITLANG_UNLIKELY(runtime::values_identical(value, UNDEFINED))) undefined_global(ip, id);
+                *sp++ = value;
+                DISPATCH();
+            }
+            OPCODE(OP_SET_GLOBAL) {
+                uint32_t id = READ_BYTE();
+                if (INITLANG_UNLIKELY(runtime::values_identical(globals_base[id], UNDEFINED))) undefined_global(ip, id);
+                globals_base[id] = sp[-1];
+                DISPATCH();
+            }
+            OPCODE(OP_SET_GLOBAL_LONG) {
+                uint32_t id = READ_LONG();
+                if (INITLANG_UNLIKELY(runtime::values_identical(globals_base[id], UNDEFINED))) undefined_global(ip, id);
+                globals_base[id] = sp[-1];
+                DISPATCH();
+            }
+            OPCODE(OP_GET_LOCAL) {
+                *sp++ = slots[READ_BYTE()];
+                DISPATCH();
+            }
+            OPCODE(OP_SET_LOCAL) {
+                slots[READ_BYTE()] = sp[-1];
+                DISPATCH();
+            }
+
+            OPCODE(OP_ADD) {
+                Value b = sp[-1];
+                Value a = sp[-2];
+                QUICKEN(a, b);
+                if (INITLANG_LIKELY(runtime::both_numbers(a, b))) {
+                    sp[-2] = Value::number(a.as_number() + b.as_number());
+                } else {
+                    stack_top = sp; // racines du ramasse-miettes
+                    sp[-2] = add_slow(ip, a, b);
+                }
+                --sp;
+                DISPATCH();
+            }
+            OPCODE(OP_SUBTRACT) BINARY_NUMBER(OP_SUBTRACT, Value::number(x - y));
+            OPCODE(OP_MULTIPLY) BINARY_NUMBER(OP_MULTIPLY, Value::number(x * y));
+            OPCODE(OP_DIVIDE) BINARY_NUMBER(OP_DIVIDE, Value::number(x / y));
+            OPCODE(OP_GREATER) BINARY_NUMBER(OP_GREATER, Value::boolean(x > y));
+            OPCODE(OP_LESS) BINARY_NUMBER(OP_LESS, Value::boolean(x < y));
+            OPCODE(OP_GREATER_EQUAL) BINARY_NUMBER(OP_GREATER_EQUAL, Value::boolean(x >= y));
+            OPCODE(OP_LESS_EQUAL) BINARY_NUMBER(OP_LESS_EQUAL, Value::boolean(x <= y));
+            OPCODE(OP_NEGATE) {
+                if (INITLANG_UNLIKELY(!sp[-1].is_number())) operand_error(ip, OpCode::OP_NEGATE);
+                sp[-1] = Value::number(-sp[-1].as_number());
+                DISPATCH();
+            }
+            OPCODE(OP_NOT) {
+                sp[-1] = Value::boolean(sp[-1].is_falsey());
+                DISPATCH();
+            }
+            OPCODE(OP_EQUAL) {
+                sp[-2] = Value::boolean(runtime::values_equal(sp[-2], sp[-1]));
+                --sp;
+                DISPATCH();
+            }
+            OPCODE(OP_NOT_EQUAL) {
+                sp[-2] = Value::boolean(!runtime::values_equal(sp[-2], sp[-1]));
+                --sp;
+                DISPATCH();
+            }
+
+            OPCODE(OP_JUMP) {
+                uint16_t offset = READ_SHORT();
+                ip += offset;
+                DISPATCH();
+            }
+            OPCODE(OP_JUMP_IF_FALSE) {
+                uint16_t offset = READ_SHORT();
+                if ((*--sp).is_falsey()) ip += offset;
+                DISPATCH();
+            }
+            OPCODE(OP_LOOP) {
+                uint16_t offset = READ_SHORT();
+                ip -= offset;
+                if (jit_after) {
+                    // Fonction chaude : la suite de l'activation passe au
+                    // code natif, à partir du début de la boucle
+                    runtime::ObjFunction* function = frame->function;
+                    if (!function->native && ++function->hotness == jit_after) ip = tier_up(function, frame, ip);
+                    const void* head = function->native ? function->native->loop_head(ip - function->chunk.code.data()) : nullptr;
+                    if (head) {
+                        frame->ip = ip;
+                        if (INITLANG_UNLIKELY(function->native->resume(&jit_context, slots, sp, head) != 0)) {
+                            rethrow_pending();
+                        }
+                        RETURN_VALUE(slots[0]);
+                    }
+                }
+                DISPATCH();
+            }
+
+            OPCODE(OP_CALL) {
+                int argc = READ_BYTE();
+                Value callee = sp[-1 - argc];
+                if (INITLANG_UNLIKELY(!runtime::is_function(callee) ||
+                                      runtime::as_function(callee)->arity != argc ||
+                                      frame_count == frame_limit ||
+                                      sp + SLOTS_PER_FRAME > stack.get() + stack_slots)) {
+                    call_error(ip, callee, argc);
+                }
+                frame->ip = ip;
+
+                runtime::ObjFunction* function = runtime::as_function(callee);
+                if (jit_after) {
+                    if (!function->native && ++function->hotness == jit_after) {
+                        ip = frame->ip = tier_up(function, frame, ip);
+                    }
+                    if (function->native) {
+                        Value* window = sp - argc - 1;
+                        frames[frame_count++] = CallFrame{function, function->chunk.code.data(), window};
+                        run_native(function, window);
+                        --frame_count;
+                        sp = window + 1;
+                        // Un appel a pu recopier le code de cette trame (tier_up)
+                        ip = frame->ip;
+                        DISPATCH();
+                    }
+                }
+                frame = &frames[frame_count++];
+                frame->function = function;
+                frame->slots = slots = sp - argc - 1;
+                ip = function->chunk.code.data();
+                constants = function->chunk.constants.data();
+                DISPATCH();
+            }
+            OPCODE(OP_TAIL_CALL) {
+                // L'appelé et ses arguments remplacent la fenêtre de
+                // l'appelant, qui n'a plus rien à exécuter
+                int argc = READ_BYTE();
+                Value* callee_slot = sp - 1 - argc;
+                Value callee = *callee_slot;
+                if (INITLANG_UNLIKELY(!runtime::is_function(callee) ||
+                                      runtime::as_function(callee)->arity != argc)) {
+                    call_error(ip, callee, argc);
+                }
+                for (int i = 0; i <= argc; ++i) slots[i] = callee_slot[i];
+                sp = slots + argc + 1;
+
+                runtime::ObjFunction* function = runtime::as_function(callee);
+                frame->function = function;
+                ip = function->chunk.code.data();
+                constants = function->chunk.constants.data();
+                DISPATCH();
+            }
+            OPCODE(OP_RETURN) RETURN_VALUE(*--sp);
+
+            OPCODE(OP_BUILD_LIST) {
+                size_t count = READ_BYTE();
+                stack_top = sp; // éléments gardés (et mis à jour) par une collecte
+                sp -= count;
+                *sp = build_list(sp, count);
+                ++sp;
+                DISPATCH();
+            }
+            OPCODE(OP_BUILD_STRUCT) {
+                size_t count = READ_BYTE();
+                stack_top = sp;
+                sp -= 2 * count;
+                *sp = build_struct(frame, ip, sp, count);
+                ++sp;
+                DISPATCH();
+            }
+            OPCODE(OP_GET_FIELD) {
+                Value name = constants[READ_BYTE()];
+                Value target = sp[-1];
+                const compiler::FieldCache* cache = site_cache(frame, ip);
+                if (INITLANG_LIKELY(cache && runtime::is_struct(target) &&
+                                    runtime::as_struct(target)->shape == cache->shape)) {
+                    sp[-1] = runtime::as_struct(target)->values()[cache->index];
+                } else {
+                    sp[-1] = *field_slot(frame, ip, target, name);
+                }
+                DISPATCH();
+            }
+            OPCODE(OP_SET_FIELD) {
+                Value name = constants[READ_BYTE()];
+                Value target = sp[-2];
+                Value value = sp[-1];
+                const compiler::FieldCache* cache = site_cache(frame, ip);
+                if (INITLANG_LIKELY(cache && runtime::is_struct(target) &&
+                                    runtime::as_struct(target)->shape == cache->shape)) {
+                    runtime::as_struct(target)->values()[cache->index] = value;
+                } else {
+                    *field_slot(frame, ip, target, name) = value;
+                }
+                heap.write_barrier(target.as_object(), value);
+                sp[-2] = value;
+                --sp;
+                DISPATCH();
+            }
+
+            OPCODE(OP_INIT_GER) {
+                // Rend son premier argument (null sans argument)
+                size_t argc = READ_BYTE();
+                sp -= argc;
+                *sp = argc ? sp[0] : Value::null();
+                ++sp;
+                DISPATCH();
+            }
+            OPCODE(OP_INIT_LOG) {
+                size_t argc = READ_BYTE();
+                sp -= argc;
+                log(sp, argc);
+                *sp++ = Value::null();
+                DISPATCH();
+            }
+
+            OPCODE(OP_SPAWN) {
+                int argc = READ_BYTE();
+                Value* window = sp - argc - 1;
+                Value callee = *window;
+                if (INITLANG_UNLIKELY(!runtime::is_function(callee) ||
+                                      runtime::as_function(callee)->arity != argc)) {
+                    call_error(ip, callee, argc);
+                }
+                stack_top = sp; // arguments gardés par une collecte
+                *window = spawn(ip, runtime::as_function(callee), window + 1, argc);
+                sp = window + 1;
+                DISPATCH();
+            }
+            OPCODE(OP_AWAIT) {
+                if (runtime::is_task(sp[-1])) {
+                    runtime::ObjTask* task = runtime::as_task(sp[-1]);
+                    if (in_fiber && task->pending()) {
+                        // Suspension : la fibre reprendra sur ce même OP_AWAIT
+                        frame->ip = ip - 1;
+                        stack_top = sp;
+                        awaiting = task;
+                        return Value::null();
+                    }
+                    stack_top = sp; // le script attend détaché : sa pile reste une racine
+                    sp[-1] = await_task(ip, task);
+                }
+                DISPATCH();
+            }
+
+            // Superinstructions (compiler/peephole.h) : une erreur est
+            // signalée avec l'opcode de la composante fautive
+            OPCODE(OP_ADD_CONSTANT) {
+                Value a = sp[-1];
+                Value b = constants[READ_BYTE()];
+                if (INITLANG_LIKELY(runtime::both_numbers(a, b))) {
+                    sp[-1] = Value::number(a.as_number() + b.as_number());
+                } else {
+                    stack_top = sp;
+                    sp[-1] = add_slow(ip, a, b);
+                }
+                DISPATCH();
+            }
+            OPCODE(OP_SUBTRACT_CONSTANT) {
+                Value a = sp[-1];
+                Value b = constants[READ_BYTE()];
+                if (INITLANG_UNLIKELY(!runtime::both_numbers(a, b))) operand_error(ip, OpCode::OP_SUBTRACT);
+                sp[-1] = Value::number(a.as_number() - b.as_number());
+                DISPATCH();
+            }
+            OPCODE(OP_JUMP_IF_NOT_LESS) {
+                uint16_t offset = READ_SHORT();
+                Value b = sp[-1];
+                Value a = sp[-2];
+                if (INITLANG_UNLIKELY(!runtime::both_numbers(a, b))) operand_error(ip, OpCode::OP_LESS);
+                sp -= 2;
+                if (!(a.as_number() < b.as_number())) ip += offset;
+                DISPATCH();
+            }
+            OPCODE(OP_SET_LOCAL_POP) {
+                slots[READ_BYTE()] = *--sp;
+                DISPATCH();
+            }
+            OPCODE(OP_RETURN_LOCAL) RETURN_VALUE(slots[READ_BYTE()]);
+
+            // Formes spécialisées (quickening)
+            OPCODE(OP_ADD_NUM_NUM) BINARY_NUMBER_GUARDED(Value::number(x + y));
+            OPCODE(OP_ADD_STR_STR) {
+                Value b = sp[-1];
+                Value a = sp[-2];
+                if (INITLANG_UNLIKELY(!runtime::is_string(a) || !runtime::is_string(b))) {
+                    ip = deoptimize(frame, ip);
+                    DISPATCH();
+                }
+                stack_top = sp;
+                sp[-2] = Value::object(heap.concat(runtime::as_string(a), runtime::as_string(b)));
+                --sp;
+                DISPATCH();
+            }
+            OPCODE(OP_SUBTRACT_NUM) BINARY_NUMBER_GUARDED(Value::number(x - y));
+            OPCODE(OP_MULTIPLY_NUM) BINARY_NUMBER_GUARDED(Value::number(x * y));
+            OPCODE(OP_DIVIDE_NUM) BINARY_NUMBER_GUARDED(Value::number(x / y));
+            OPCODE(OP_GREATER_NUM) BINARY_NUMBER_GUARDED(Value::boolean(x > y));
+            OPCODE(OP_LESS_NUM) BINARY_NUMBER_GUARDED(Value::boolean(x < y));
+
+            case OpCode::OP_COUNT_:
+                break;
+        }
+        fail(ip, "Unknown opcode " + std::to_string(ip[-1]));
+
+#undef INITLANG_JUMP_NEXT
+#undef DISPATCH
+#undef OPCODE
+#undef READ_BYTE
+#undef READ_SHORT
+#undef READ_LONG
+#undef QUICKEN
+#undef BINARY_NUMBER
+#undef BINARY_NUMBER_GUARDED
+#undef RETURN_VALUE
+    }
+};
+
+} // namespace vm
+} // namespace initlang
@@ -0,0 +1,227 @@
+// src/frontend/cli/main.cpp
+// initlang_main : exécute un script INITLANG.
+//   initlang_main [--disassemble] [--dispatch=switch|threaded] [--no-cache]
+//                 [-O0|-O1|-O2] [--pass-stats] [--max-frames=N] [--jit=N]
+//                 [--threads=N] [--workers=N] [--log-level=L]
+//                 [--log-format=plain|kv] [--log-overflow=block|drop] script.init...
+//
+// Le bytecode compilé est mis en cache à côté du script (script.initc) ;
+// tant que la source et le niveau -O ne changent pas, les lancements
+// suivants sautent lexer, parser, optimiseur et compilateur.
+// À partir de -O1, le bytecode passe aussi par le peephole. --pass-stats
+// affiche sur stderr le bilan de chaque passe d'optimisation, puis celui
+// du quickening, du JIT, des tâches, du journal et du ramasse-miettes à la
+// fin de l'exécution.
+// --max-frames fixe la profondeur d'appel maximale
+// (vm::VM::DEFAULT_MAX_FRAMES par défaut),
+// --jit le seuil de traduction native (0 : interpréteur seul).
+//
+// Plusieurs scripts forment un projet : compilés en parallèle sur
+// --threads threads (project/project.h, sans cache), puis exécutés dans
+// l'ordre de la ligne de commande sur la même VM.
+//
+// --workers fixe le nombre de workers du planificateur de tâches
+// (spawn/await), thread principal compris ; par défaut un par cœur.
+//
+// init.log passe par le journal asynchrone (logging/logger.h) : lignes
+// formatées dans un anneau par thread, écrites sur stdout par lots.
+// --log-level fixe le seuil (debug, info, warn, error, off ; init.log
+// écrit en info), --log-format le rendu, --log-overflow le comportement
+// quand un anneau est plein (attendre ou perdre la ligne).
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "bytecode_cache.h"
+#include "disassembler.h"
+#include "peephole.h"
+#include "vm.h"
+#include "project.h"
+#include "logger.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+using namespace initlang;
+
+static int usage() {
+    std::fprintf(stderr, "usage: initlang_main [--disassemble] [--dispatch=switch|threaded] [--no-cache]\n"
+                         "                     [-O0|-O1|-O2] [--pass-stats] [--max-frames=N] [--jit=N]\n"
+                         "                     [--threads=N] [--workers=N] [--log-level=L]\n"
+                         "                     [--log-format=plain|kv] [--log-overflow=block|drop] script.init...\n");
+    return 64;
+}
+
+int main(int argc, char** argv) {
+    bool disassemble = false;
+    bool use_cache = true;
+    bool pass_stats = false;
+    int level = 0;
+    size_t max_frames = vm::VM::DEFAULT_MAX_FRAMES;
+    uint32_t jit_threshold = vm::VM::DEFAULT_JIT_THRESHOLD;
+    size_t threads = 0;
+    size_t workers = 0;
+    logging::Options log_options;
+    vm::Dispatch dispatch = vm::Dispatch::Threaded;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--disassemble") == 0) {
+            disassemble = true;
+        } else if (std::strcmp(argv[i], "--dispatch=switch") == 0) {
+            dispatch = vm::Dispatch::Switch;
+        } else if (std::strcmp(argv[i], "--dispatch=threaded") == 0) {
+            dispatch = vm::Dispatch::Threaded;
+        } else if (std::strcmp(argv[i], "--no-cache") == 0) {
+            use_cache = false;
+        } else if (std::strncmp(argv[i], "--max-frames=", 13) == 0) {
+            char* end = nullptr;
+            unsigned long long frames = std::strtoull(argv[i] + 13, &end, 10);
+            if (end == argv[i] + 13 || *end != '\0' || frames == 0) return usage();
+            max_frames = static_cast<size_t>(frames);
+        } else if (std::strncmp(argv[i], "--jit=", 6) == 0) {
+            char* end = nullptr;
+            unsigned long threshold = std::strtoul(argv[i] + 6, &end, 10);
+            if (end == argv[i] + 6 || *end != '\0' || threshold > UINT32_MAX) return usage();
+            jit_threshold = static_cast<uint32_t>(threshold);
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            char* end = nullptr;
+            unsigned long count = std::strtoul(argv[i] + 10, &end, 10);
+            if (end == argv[i] + 10 || *end != '\0' || count == 0) return usage();
+            threads = static_cast<size_t>(count);
+        } else if (std::strncmp(argv[i], "--workers=", 10) == 0) {
+            char* end = nullptr;
+            unsigned long count = std::strtoul(argv[i] + 10, &end, 10);
+            if (end == argv[i] + 10 || *end != '\0' || count == 0) return usage();
+            workers = static_cast<size_t>(count);
+        } else if (std::strncmp(argv[i], "--log-level=", 12) == 0) {
+            if (!logging::parse_level(argv[i] + 12, log_options.level)) return usage();
+        } else if (std::strcmp(argv[i], "--log-format=plain") == 0) {
+            log_options.format = logging::Format::Plain;
+        } else if (std::strcmp(argv[i], "--log-format=kv") == 0) {
+            log_options.format = logging::Format::KeyValue;
+        } else if (std::strcmp(argv[i], "--log-overflow=block") == 0) {
+            log_options.overflow = logging::Overflow::Block;
+        } else if (std::strcmp(argv[i], "--log-overflow=drop") == 0) {
+            log_options.overflow = logging::Overflow::Drop;
+        } else if (std::strcmp(argv[i], "--pass-stats") == 0) {
+            pass_stats = true;
+        } else if (argv[i][0] == '-' && argv[i][1] == 'O' && argv[i][2] >= '0' &&
+                   argv[i][2] <= '0' + optimizer::Optimizer::MAX_LEVEL && argv[i][3] == '\0') {
+            level = argv[i][2] - '0';
+        } else if (argv[i][0] == '-') {
+            return usage();
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) return usage();
+
+    runtime::Heap heap;
+    std::vector<runtime::ObjFunction*> scripts;
+    if (paths.size() > 1) {
+        try {
+            project::Result result = project::compile_project(heap, paths, project::Options{threads, level});
+            scripts = std::move(result.scripts);
+            if (pass_stats) {
+                const project::Stats& s = result.stats;
+                std::fprintf(stderr, "%-8s %8zu files on %zu threads, %zu globals, %.3f ms parse, %.3f ms compile\n",
+                             "project", s.files, s.threads, s.globals, s.parse_seconds * 1e3,
+                             (s.link_seconds + s.compile_seconds + s.merge_seconds) * 1e3);
+            }
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s\n", e.what()); // déjà préfixé du chemin fautif
+            return 65;
+        }
+    } else {
+        const char* path = paths[0].c_str();
+        runtime::ObjFunction* script = nullptr;
+        try {
+            lexer::SourceBuffer text = lexer::SourceBuffer::map_file(path);
+            std::string cache_path = compiler::cache_path_for(path);
+
+            if (use_cache) {
+                try {
+                    script = compiler::load_cache_file(heap, cache_path, text.view(), level);
+                } catch (const std::exception&) {
+                    script = nullptr; // cache corrompu : recompilé et réécrit
+                }
+            }
+
+            if (!script) {
+                std::string_view view = text.view();
+                lexer::Lexer source(std::move(text));
+                auto program = parser::Parser(source).parse_program();
+                for (const optimizer::PassStats& s : optimizer::optimize(*program, level)) {
+                    if (!pass_stats) continue;
+                    std::fprintf(stderr, "%-8s %8zu -> %8zu nodes (%lld removed), %zu rewrites, %.3f ms\n", s.name,
+                                 s.nodes_before, s.nodes_after, s.nodes_removed(), s.rewrites, s.seconds * 1e3);
+                }
+                script = compiler::Compiler(heap).compile(*program);
+                if (level > 0) {
+                    compiler::PeepholeStats s = compiler::optimize_bytecode(*script);
+                    if (pass_stats) {
+                        std::fprintf(stderr, "%-8s %8zu -> %8zu bytes, %zu jumps threaded, %zu dead, %zu fused\n",
+                                     "peephole", s.bytes_before, s.bytes_after, s.threaded_jumps, s.dead_instructions,
+                                     s.fused);
+                    }
+                }
+
+                if (use_cache) {
+                    // Le buffer appartient désormais au Lexer, toujours vivant
+                    try { compiler::write_cache_file(cache_path, heap, *script, view, level); } catch (const std::exception&) {}
+                }
+            }
+            scripts.push_back(script);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: %s\n", path, e.what());
+            return 65;
+        }
+    }
+
+    if (disassemble) {
+        for (runtime::ObjFunction* compiled : scripts) std::fputs(compiler::disassemble(*compiled, &heap).c_str(), stdout);
+        return 0;
+    }
+
+    std::fflush(stdout);
+    logging::Logger logger(log_options); // vidé à la destruction, après la VM
+    vm::VM machine(heap, max_frames);
+    machine.set_dispatch(dispatch);
+    machine.set_jit_threshold(jit_threshold);
+    machine.set_workers(workers);
+    machine.set_logger(&logger);
+    try {
+        for (runtime::ObjFunction* compiled : scripts) machine.interpret(compiled);
+    } catch (const std::exception& e) {
+        logger.flush();
+        std::fprintf(stderr, "%s\n", e.what());
+        return 70;
+    }
+    if (pass_stats) {
+        logger.flush();
+        logging::Stats log = logger.stats();
+        std::fprintf(stderr, "%-8s %8zu sites specialized, %zu deoptimized, %zu field cache misses\n", "quicken",
+                     machine.quickening_stats().specialized, machine.quickening_stats().deoptimized,
+                     machine.quickening_stats().field_misses);
+        std::fprintf(stderr, "%-8s %8zu functions compiled (%zu bytes), %zu left to the interpreter\n", "jit",
+                     machine.jit_stats().compiled, machine.jit_stats().code_bytes, machine.jit_stats().rejected);
+        std::fprintf(stderr, "%-8s %8zu spawned on %zu workers, %zu suspensions\n", "tasks",
+                     machine.task_stats().spawned, machine.task_stats().workers, machine.task_stats().suspended);
+        std::fprintf(stderr, "%-8s %8llu lines in %llu writes (%llu bytes), %llu dropped, %llu blocked\n", "log",
+                     static_cast<unsigned long long>(log.records), static_cast<unsigned long long>(log.writes),
+                     static_cast<unsigned long long>(log.bytes), static_cast<unsigned long long>(log.dropped),
+                     static_cast<unsigned long long>(log.blocked));
+        const runtime::GcStats& gc = heap.gc_stats();
+        std::fprintf(stderr,
+                     "%-8s %8zu minor, %zu major, %.3f ms max pause, %llu bytes allocated, %llu promoted, "
+                     "%zu old at peak\n",
+                     "gc", gc.minor_collections, gc.major_collections, gc.max_pause_seconds * 1e3,
+                     static_cast<unsigned long long>(gc.bytes_allocated),
+                     static_cast<unsigned long long>(gc.bytes_promoted), gc.max_old_bytes);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// tests/bench_cache.cpp
+// Démarrage à froid : du fichier sur disque à la fonction du script prête à
+// exécuter, depuis la source (lexer + parser + compilateur) puis depuis le
+// cache .initc (projection + hash de la source + chargement).
+#include "parser.h"
+#include "compiler.h"
+#include "bytecode_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace initlang;
+
+static std::string generate_program(int functions) {
+    std::string source;
+    source += "let v0 ==> 1\n";
+    for (int i = 1; i <= functions; ++i) {
+        std::string n = std::to_string(i);
+        std::string prev = "v" + std::to_string(i - 1);
+        source += "fi f" + n + "(a, b, c) {\n"
+                  "    let t ==> a * " + n + " + b / (c - 2)\n"
+                  "    init.log(t, \"f" + n + "\")\n"
+                  "    return t - g(a, b) * -c\n"
+                  "}\n";
+        source += "let v" + n + " ==> f" + n + "(" + prev + ", \"s" + n + "\", 3.5) + 3 * (4 - " + prev + ")\n";
+    }
+    return source;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Load>
+static double best_of(int passes, Load load) {
+    double best = 1e9;
+    for (int pass = 0; pass < passes; ++pass) {
+        runtime::Heap heap;
+        auto start = std::chrono::steady_clock::now();
+        runtime::ObjFunction* script = load(heap);
+        best = std::min(best, seconds_since(start));
+        if (!script) {
+            std::fprintf(stderr, "bench_cache: load failed\n");
+            return -1;
+        }
+    }
+    return best;
+}
+
+int main() {
+    const int sizes[] = {100, 5000, 50000};
+    std::string dir = "/tmp/initlang_bench_cache_" + std::to_string(::getpid());
+    std::string path = dir + ".init";
+    std::string cache = compiler::cache_path_for(path);
+
+    std::printf("%-10s %10s %10s %12s %12s %8s\n", "functions", "source", "cache", "from source", "from cache",
+                "speedup");
+    for (int functions : sizes) {
+        std::string text = generate_program(functions);
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) return 1;
+        std::fwrite(text.data(), 1, text.size(), out);
+        std::fclose(out);
+
+        // Remplit le cache comme le ferait un premier lancement
+        {
+            runtime::Heap heap;
+            lexer::Lexer lex = lexer::Lexer::from_file(path);
+            auto program = parser::Parser(lex).parse_program();
+            compiler::write_cache_file(cache, heap, *compiler::Compiler(heap).compile(*program), text);
+        }
+
+        double from_source = best_of(5, [&](runtime::Heap& heap) {
+            lexer::Lexer lex = lexer::Lexer::from_file(path);
+            auto program = parser::Parser(lex).parse_program();
+            return compiler::Compiler(heap).compile(*program);
+        });
+        double from_cache = best_of(5, [&](runtime::Heap& heap) {
+            lexer::SourceBuffer source = lexer::SourceBuffer::map_file(path);
+            return compiler::load_cache_file(heap, cache, source.view());
+        });
+
+        std::FILE* image = std::fopen(cache.c_str(), "rb");
+        std::fseek(image, 0, SEEK_END);
+        long cache_size = std::ftell(image);
+        std::fclose(image);
+
+        std::printf("%-10d %8.1f K %8.1f K %9.3f ms %9.3f ms %7.1fx\n", functions, text.size() / 1024.0,
+                    cache_size / 1024.0, from_source * 1e3, from_cache * 1e3, from_source / from_cache);
+    }
+
+    std::remove(path.c_str());
+    std::remove(cache.c_str());
+    return 0;
+}
@@ -0,0 +1,111 @@
+// tests/bench_compiler.cpp
+// Compilation AST -> bytecode d'un gros programme généré : octets de
+// bytecode émis par seconde (parse exclu), puis coût mémoire des tables de
+// lignes face à l'ancien vector<int> (un int par octet de code). Enfin,
+// bilan des passes de l'optimiseur à chaque niveau -O.
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace initlang;
+
+static std::string generate_program(int functions) {
+    std::string source;
+    source += "let v0 ==> 1\n";
+    for (int i = 1; i <= functions; ++i) {
+        std::string n = std::to_string(i);
+        std::string prev = "v" + std::to_string(i - 1);
+        source += "fi f" + n + "(a, b, c) {\n"
+                  "    let t ==> a * " + n + " + b / (c - 2)\n"
+                  "    init.log(t, \"f" + n + "\")\n"
+                  "    return t - g(a, b) * -c\n"
+                  "}\n";
+        source += "let v" + n + " ==> f" + n + "(" + prev + ", \"s" + n + "\", 3.5) + 3 * (4 - " + prev + ")\n";
+    }
+    return source;
+}
+
+// Petites fonctions appelées avec des littéraux : matière à inliner et plier
+static std::string generate_helpers(int functions) {
+    std::string source;
+    source += "let w0 ==> 1\n";
+    for (int i = 1; i <= functions; ++i) {
+        std::string n = std::to_string(i);
+        source += "fi scale" + n + "(x) {\n    return x * " + n + " + 2 * 8\n    init.log(x)\n}\n";
+        source += "let w" + n + " ==> scale" + n + "(w" + std::to_string(i - 1) + ") - scale" + n + "(3)\n";
+    }
+    return source;
+}
+
+struct LineMemory {
+    size_t chunks = 0;
+    size_t code = 0;
+    size_t table = 0;
+};
+
+static void measure_lines(const runtime::ObjFunction& function, LineMemory& total) {
+    ++total.chunks;
+    total.code += function.chunk.code.size();
+    total.table += function.chunk.lines.memory_bytes();
+    for (runtime::Value constant : function.chunk.constants) {
+        if (runtime::is_function(constant)) measure_lines(*runtime::as_function(constant), total);
+    }
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    std::string source = generate_program(50000);
+    lexer::Lexer lex(source);
+    auto program = parser::Parser(lex).parse_program();
+
+    const int passes = 5;
+    size_t bytes = 0;
+    size_t constants = 0;
+    double best = 1e9;
+    LineMemory lines;
+    for (int pass = 0; pass < passes; ++pass) {
+        runtime::Heap heap;
+        compiler::Compiler compiler(heap);
+
+        auto start = std::chrono::steady_clock::now();
+        runtime::ObjFunction* script = compiler.compile(*program);
+        double elapsed = seconds_since(start);
+
+        best = std::min(best, elapsed);
+        bytes = compiler.bytes_emitted();
+        constants = script->chunk.constants.size();
+        if (pass == passes - 1) measure_lines(*script, lines);
+    }
+
+    std::printf("compile: %zu nodes -> %zu bytes of bytecode (%zu script constants)\n",
+                program->arena->nodes(), bytes, constants);
+    std::printf("compile: %.3f s, %.1f MB/s of bytecode, %.1f Mnodes/s\n",
+                best, bytes / best / 1e6, program->arena->nodes() / best / 1e6);
+    std::printf("lines: %zu chunks, %.1f bytes/chunk as vector<int>, %.1f bytes/chunk as line table (%.1fx smaller)\n",
+                lines.chunks, double(lines.code * sizeof(int)) / lines.chunks, double(lines.table) / lines.chunks,
+                double(lines.code * sizeof(int)) / lines.table);
+
+    std::string helpers = generate_helpers(20000);
+    for (int level = 0; level <= optimizer::Optimizer::MAX_LEVEL; ++level) {
+        lexer::Lexer helpers_lex(helpers);
+        auto optimized = parser::Parser(helpers_lex).parse_program();
+        auto stats = optimizer::optimize(*optimized, level);
+        runtime::Heap heap;
+        compiler::Compiler compiler(heap);
+        compiler.compile(*optimized);
+        std::printf("-O%d: %zu nodes -> %zu bytes of bytecode\n", level, optimizer::count_nodes(*optimized),
+                    compiler.bytes_emitted());
+        for (const optimizer::PassStats& pass : stats) {
+            std::printf("  %-7s %8zu -> %8zu nodes (%lld removed), %zu rewrites, %.3f ms\n", pass.name,
+                        pass.nodes_before, pass.nodes_after, pass.nodes_removed(), pass.rewrites, pass.seconds * 1e3);
+        }
+    }
+    return 0;
+}
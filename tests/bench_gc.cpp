@@ -0,0 +1,90 @@
+// tests/bench_gc.cpp
+// Ramasse-miettes générationnel sous plusieurs tailles de nurserie : un
+// script appelle `calls` fois (premier argument, 200000 par défaut) une
+// fonction qui construit {n: n, s: ["v" + n]} par OP_BUILD_LIST et
+// OP_BUILD_STRUCT et laisse deux chaînes mortes ; un résultat sur cent est
+// gardé dans une globale. Temps total, collectes, pauses (moyenne et
+// maximum), octets alloués, promus et libérés.
+#include "parser.h"
+#include "compiler.h"
+#include "vm.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace initlang;
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static std::string generate(int calls) {
+    std::string source =
+        "fi mk(n) { return n }\n"
+        "fi churn(n) { let a ==> \"a\" + n\n let b ==> a + \"b\"\n return mk(n) }\n";
+    for (int i = 0; i < calls; ++i) {
+        std::string call = "churn(" + std::to_string(i) + ")\n";
+        source += i % 100 ? call : "let k" + std::to_string(i) + " ==> " + call;
+    }
+    return source;
+}
+
+// Corps de mk, que le langage ne sait pas écrire : {n: n, s: ["v" + n]}
+static void build_mk(runtime::Heap& heap, runtime::ObjFunction* script) {
+    using compiler::OpCode;
+    using runtime::Value;
+    for (Value constant : script->chunk.constants) {
+        if (!runtime::is_function(constant) || runtime::as_function(constant)->name != heap.intern("mk")) continue;
+        compiler::Chunk& chunk = runtime::as_function(constant)->chunk;
+        chunk = compiler::Chunk();
+        auto constant_byte = [&](const char* text) {
+            return static_cast<uint8_t>(chunk.add_constant(Value::object(heap.intern(text))));
+        };
+        const uint8_t body[] = {
+            uint8_t(OpCode::OP_CONSTANT), constant_byte("n"), uint8_t(OpCode::OP_GET_LOCAL), 1,
+            uint8_t(OpCode::OP_CONSTANT), constant_byte("s"), uint8_t(OpCode::OP_CONSTANT), constant_byte("v"),
+            uint8_t(OpCode::OP_GET_LOCAL), 1, uint8_t(OpCode::OP_ADD),
+            uint8_t(OpCode::OP_BUILD_LIST), 1, uint8_t(OpCode::OP_BUILD_STRUCT), 2,
+            uint8_t(OpCode::OP_RETURN),
+        };
+        for (uint8_t byte : body) chunk.write(byte, 1);
+    }
+}
+
+int main(int argc, char** argv) {
+    int calls = argc > 1 ? std::atoi(argv[1]) : 200000;
+    if (calls < 1) calls = 1;
+    std::string source = generate(calls);
+
+    std::printf("%d calls, %d kept\n", calls, (calls + 99) / 100);
+    std::printf("%-10s %10s %8s %8s %10s %10s %12s %12s %12s\n", "nursery", "ms", "minor", "major", "avg us",
+                "max us", "alloc KB", "promoted KB", "freed KB");
+    for (size_t nursery : {size_t{64} << 10, size_t{256} << 10, size_t{1} << 20, size_t{4} << 20}) {
+        runtime::GcOptions options;
+        options.nursery_bytes = nursery;
+        runtime::Heap heap(options);
+        lexer::Lexer lexer(source);
+        auto program = parser::Parser(lexer).parse_program();
+        runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+        build_mk(heap, script);
+
+        vm::VM machine(heap);
+        auto start = Clock::now();
+        machine.interpret(script);
+        double elapsed = seconds_since(start);
+
+        const runtime::GcStats& s = heap.gc_stats();
+        size_t collections = s.minor_collections + s.major_collections;
+        double average = collections ? (s.minor_pause_seconds + s.major_pause_seconds) / collections : 0;
+        std::printf("%-10zu %10.2f %8zu %8zu %10.1f %10.1f %12llu %12llu %12llu\n", nursery >> 10, elapsed * 1e3,
+                    s.minor_collections, s.major_collections, average * 1e6, s.max_pause_seconds * 1e6,
+                    static_cast<unsigned long long>(s.bytes_allocated >> 10),
+                    static_cast<unsigned long long>(s.bytes_promoted >> 10),
+                    static_cast<unsigned long long>(s.bytes_freed >> 10));
+    }
+    return 0;
+}
@@ -0,0 +1,256 @@
+// tests/bench_lexer.cpp
+// Mesure du débit du Lexer (tokens/s) et du nombre d'allocations par token.
+#include "lexer.h"
+#include "parallel_lexer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace initlang;
+
+static std::string generate_line(int i) {
+    return "let variable_name_" + std::to_string(i) + " ==> compute_value(" +
+           std::to_string(i) + ", \"some string literal\") + 3.25 * other_identifier\n";
+}
+
+static std::string generate_source(int lines) {
+    std::string source;
+    for (int i = 0; i < lines; ++i) {
+        source += generate_line(i);
+    }
+    return source;
+}
+
+static void bench_tokenize(const std::string& source) {
+    size_t allocations_before = allocation_count;
+    auto start = std::chrono::steady_clock::now();
+
+    lexer::Lexer lex(source);
+    auto tokens = lex.tokenize();
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    size_t allocations = allocation_count - allocations_before;
+
+    std::printf("tokenize: %zu bytes, %zu tokens, %.3f s, %.2f Mtokens/s, %.4f allocations/token\n",
+                source.size(), tokens.size(), seconds,
+                tokens.size() / seconds / 1e6,
+                double(allocations) / tokens.size());
+}
+
+// Débit (octets/s) du Lexer complet pour chaque jeu de noyaux de balayage
+static void bench_kernels(const std::string& source) {
+    const lexer::simd::ScanKernels* candidates[] = {
+        &lexer::simd::scalar_kernels(),
+#ifdef INITLANG_SIMD_X86
+        &lexer::simd::sse2_kernels(),
+        lexer::simd::cpu_has_avx2() ? &lexer::simd::avx2_kernels() : nullptr,
+#endif
+    };
+
+    for (const auto* kernels : candidates) {
+        if (!kernels) continue;
+        lexer::simd::force_kernels(*kernels);
+
+        double best = 1e9;
+        size_t count = 0;
+        for (int run = 0; run < 5; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            lexer::Lexer lex(source);
+            count = 0;
+            while (lex.next_token().type != lexer::TokenType::EOF_TOKEN) ++count;
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        std::printf("  %-7s %zu tokens, %.1f MB/s\n", kernels->name, count, source.size() / best / 1e6);
+    }
+    lexer::simd::force_kernels(lexer::simd::best_kernels());
+}
+
+// Reconnaissance des mots-clés sur du code riche en identifiants :
+// table de hachage parfait constexpr vs l'ancienne std::unordered_map.
+static void bench_keywords() {
+    std::string source;
+    const char* words[] = {"let", "value", "fi", "compute", "return", "init.log", "spawn",
+                           "counter", "await", "x", "async", "result_total", "const", "init.ger"};
+    for (int i = 0; i < 400000; ++i) {
+        source += words[i % 14];
+        source += ' ';
+    }
+
+    lexer::Lexer lex(source);
+    std::vector<std::string_view> lexemes;
+    for (const auto& token : lex.tokenize()) {
+        if (!token.value.empty()) lexemes.push_back(token.value);
+    }
+
+    const std::unordered_map<std::string_view, lexer::TokenType> map = {
+        {"let", lexer::TokenType::LET}, {"fi", lexer::TokenType::FI},
+        {"const", lexer::TokenType::CONST}, {"return", lexer::TokenType::RETURN},
+        {"async", lexer::TokenType::ASYNC}, {"spawn", lexer::TokenType::SPAWN},
+        {"await", lexer::TokenType::AWAIT}
+    };
+    auto map_lookup = [&map](std::string_view text) {
+        if (text == "init.ger") return lexer::TokenType::INIT_GER;
+        if (text == "init.log") return lexer::TokenType::INIT_LOG;
+        auto it = map.find(text);
+        return it != map.end() ? it->second : lexer::TokenType::IDENTIFIER;
+    };
+
+    auto time_lookup = [&lexemes](const char* label, auto lookup) {
+        size_t keyword_count = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int rep = 0; rep < 10; ++rep) {
+            for (auto text : lexemes) {
+                keyword_count += lookup(text) != lexer::TokenType::IDENTIFIER;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / (10.0 * lexemes.size());
+        std::printf("  %-14s %.2f ns/identifier (%zu keywords)\n", label, ns, keyword_count);
+    };
+
+    std::printf("keywords: %zu identifiers\n", lexemes.size());
+    time_lookup("unordered_map", map_lookup);
+    time_lookup("perfect hash", [](std::string_view text) { return lexer::lookup_keyword(text); });
+}
+
+// Débit du ParallelLexer de 1 à N threads (N = hardware_concurrency),
+// pré-balayage compris, comparé au Lexer séquentiel
+static void bench_parallel(const std::string& source) {
+    auto best_of = [](auto run) {
+        double best = 1e9;
+        for (int pass = 0; pass < 5; ++pass) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+
+    size_t count = 0;
+    double serial = best_of([&] {
+        lexer::Lexer lex(source);
+        count = lex.tokenize().size();
+    });
+    double split = best_of([&] { lexer::ParallelLexer::split(source, 64); });
+    std::printf("parallel: %.1f MB, %zu tokens, serial %.1f MB/s, pre-scan %.1f MB/s\n", source.size() / 1e6, count,
+                source.size() / serial / 1e6, source.size() / split / 1e6);
+
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+        size_t segments = 0;
+        double seconds = best_of([&] {
+            lexer::ParallelLexer lex(source, threads);
+            lex.tokenize();
+            segments = lex.segments().size();
+        });
+        std::printf("  %2zu threads  %2zu segments  %8.1f MB/s  %.2fx\n", threads, segments,
+                    source.size() / seconds / 1e6, serial / seconds);
+    }
+}
+
+static long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Lexe sans conserver les tokens, pour mesurer la mémoire des modes fichier/flux
+template <typename MakeLexer>
+static void bench_input_mode(const char* label, size_t bytes, MakeLexer make_lexer) {
+    auto start = std::chrono::steady_clock::now();
+
+    auto lex = make_lexer();
+    size_t count = 0;
+    while (lex->next_token().type != lexer::TokenType::EOF_TOKEN) {
+        ++count;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::printf("%-9s %zu tokens, %.1f MB/s, peak RSS %ld kB\n",
+                label, count, bytes / seconds / 1e6, peak_rss_kb());
+}
+
+// Usage : bench_lexer [tokenize|keywords|scan|parallel|streaming|mmap]
+// Lancer un seul mode par processus pour que le pic RSS soit significatif.
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "all";
+    const char* path = "bench_lexer_input.init";
+
+    if (mode == "all" || mode == "tokenize") {
+        bench_tokenize(generate_source(100000));
+    }
+    if (mode == "all" || mode == "keywords") {
+        bench_keywords();
+    }
+    if (mode == "all" || mode == "scan") {
+        std::printf("scan: generated code\n");
+        bench_kernels(generate_source(100000));
+
+        // Code « minifié » à longs identifiants, et code très indenté
+        std::string minified, indented;
+        for (int i = 0; i < 100000; ++i) {
+            minified += "let generated_identifier_" + std::to_string(i) +
+                        "_with_a_long_suffix==>another_generated_identifier_name_" +
+                        std::to_string(i) + "+12345678901234;";
+            indented += "\n                                " "x" + std::to_string(i) +
+                        "\n                                " "\"a string literal body of reasonable size\"";
+        }
+        std::printf("scan: minified, long identifiers\n");
+        bench_kernels(minified);
+        std::printf("scan: deeply indented\n");
+        bench_kernels(indented);
+    }
+    if (mode == "all" || mode == "parallel") {
+        bench_parallel(generate_source(300000));
+    }
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (int i = 0; i < 100000; ++i) {
+            out << generate_line(i);
+        }
+    }
+    size_t bytes = 0;
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        bytes = static_cast<size_t>(in.tellg());
+    }
+
+    if (mode == "all" || mode == "streaming") {
+        int fd = ::open(path, O_RDONLY);
+        bench_input_mode("streaming", bytes, [&] {
+            return std::make_unique<lexer::Lexer>(lexer::fd_reader(fd));
+        });
+        ::close(fd);
+    }
+    if (mode == "all" || mode == "mmap") {
+        bench_input_mode("mmap", bytes, [&] {
+            return std::make_unique<lexer::Lexer>(lexer::SourceBuffer::map_file(path));
+        });
+    }
+
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,174 @@
+// tests/bench_log.cpp
+// Journal asynchrone (logging::Logger) face aux écritures directes, sur un
+// fichier temporaire, avec 1 à N threads, N = hardware_concurrency (ou le
+// premier argument) :
+//   - write : un appel write(2) par ligne ;
+//   - stdio : fwrite puis fflush par ligne (stdout en mode ligne) ;
+//   - logger : formatage dans l'anneau du thread, writev par lots.
+// Débit en lignes par seconde et latence par appel (p50, p99, p99.9, max),
+// puis init.log exécuté par la VM avec et sans Logger.
+#include "parser.h"
+#include "compiler.h"
+#include "logger.h"
+#include "vm.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace initlang;
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+enum class Method { Write, Stdio, Logger };
+
+static const char* method_name(Method method) {
+    switch (method) {
+        case Method::Write: return "write";
+        case Method::Stdio: return "stdio";
+        case Method::Logger: return "logger";
+    }
+    return "?";
+}
+
+// Ligne type : un libellé et deux nombres, formatés sur place
+static void format(std::string& line, int thread, int i) {
+    char digits[24];
+    line += "event thread=";
+    line.append(digits, std::to_chars(digits, digits + sizeof(digits), thread).ptr);
+    line += " seq=";
+    line.append(digits, std::to_chars(digits, digits + sizeof(digits), i).ptr);
+    line += " status=ok\n";
+}
+
+struct Result {
+    double seconds = 0;
+    std::vector<double> latencies; // secondes, tous threads confondus
+};
+
+static Result measure(Method method, size_t threads, int calls, const std::string& path) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    std::FILE* file = method == Method::Stdio ? ::fdopen(::dup(fd), "w") : nullptr;
+    std::vector<std::vector<double>> latencies(threads, std::vector<double>(static_cast<size_t>(calls)));
+    Result result;
+    {
+        logging::Options options;
+        options.fd = fd;
+        logging::Logger logger(options);
+        auto body = [&](size_t t) {
+            std::string line;
+            for (int i = 0; i < calls; ++i) {
+                auto start = Clock::now();
+                switch (method) {
+                    case Method::Write:
+                        line.clear();
+                        format(line, static_cast<int>(t), i);
+                        if (::write(fd, line.data(), line.size()) < 0) std::abort();
+                        break;
+                    case Method::Stdio:
+                        line.clear();
+                        format(line, static_cast<int>(t), i);
+                        std::fwrite(line.data(), 1, line.size(), file);
+                        std::fflush(file);
+                        break;
+                    case Method::Logger:
+                        format(logger.begin(), static_cast<int>(t), i);
+                        logger.commit();
+                        break;
+                }
+                latencies[t][static_cast<size_t>(i)] = seconds_since(start);
+            }
+        };
+        auto start = Clock::now();
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < threads; ++t) pool.emplace_back(body, t);
+        body(0);
+        for (std::thread& thread : pool) thread.join();
+        if (method == Method::Logger) logger.flush(); // le débit compte l'écriture effective
+        result.seconds = seconds_since(start);
+    }
+    if (file) std::fclose(file);
+    ::close(fd);
+    for (const auto& samples : latencies) result.latencies.insert(result.latencies.end(), samples.begin(), samples.end());
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+}
+
+// Script : burst() fait 100 init.log, appelée `bursts` fois
+static std::string generate(int bursts) {
+    std::string source = "fi burst(n) {\n";
+    for (int i = 0; i < 100; ++i) source += "    init.log(\"event\", n, " + std::to_string(i) + ", n * 0.5)\n";
+    source += "    return n\n}\n";
+    for (int i = 0; i < bursts; ++i) source += "burst(" + std::to_string(i) + ")\n";
+    return source;
+}
+
+int main(int argc, char** argv) {
+    size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    if (max_threads == 0) max_threads = 1;
+    const int calls = 200000;
+    std::string path = (std::filesystem::temp_directory_path() / "initlang_bench_log.txt").string();
+
+    std::printf("%d lines per thread, 1 to %zu threads, latencies in ns\n", calls, max_threads);
+    std::printf("%-8s %-8s %10s %14s %8s %8s %8s %10s\n", "threads", "method", "ms", "lines/s", "p50", "p99",
+                "p99.9", "max");
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+        for (Method method : {Method::Write, Method::Stdio, Method::Logger}) {
+            Result r = measure(method, threads, calls, path);
+            double lines = static_cast<double>(calls) * static_cast<double>(threads);
+            std::printf("%-8zu %-8s %10.2f %14.0f %8.0f %8.0f %8.0f %10.0f\n", threads, method_name(method),
+                        r.seconds * 1e3, lines / r.seconds, percentile(r.latencies, 0.5) * 1e9,
+                        percentile(r.latencies, 0.99) * 1e9, percentile(r.latencies, 0.999) * 1e9,
+                        r.latencies.back() * 1e9);
+        }
+    }
+
+    // init.log depuis la VM : FILE* en mode ligne, puis Logger
+    const int bursts = 2000;
+    std::string source = generate(bursts);
+    runtime::Heap heap;
+    lexer::Lexer lexer(source);
+    auto program = parser::Parser(lexer).parse_program();
+    runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+    const double lines = 100.0 * bursts;
+    std::printf("vm: %.0f init.log calls\n", lines);
+    for (bool async : {false, true}) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        std::FILE* file = ::fdopen(::dup(fd), "w");
+        std::setvbuf(file, nullptr, _IOLBF, BUFSIZ);
+        double elapsed;
+        {
+            logging::Options options;
+            options.fd = fd;
+            logging::Logger logger(options);
+            vm::VM machine(heap);
+            machine.set_log_output(file);
+            if (async) machine.set_logger(&logger);
+            auto start = Clock::now();
+            machine.interpret(script);
+            logger.flush();
+            std::fflush(file);
+            elapsed = seconds_since(start);
+        }
+        std::fclose(file);
+        ::close(fd);
+        std::printf("%-8s %10.2f ms %14.0f calls/s\n", async ? "logger" : "stdio", elapsed * 1e3, lines / elapsed);
+    }
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// tests/bench_parser.cpp
+// Parse d'un gros programme généré : temps de parse, nombre de nœuds et
+// temps de destruction de l'AST.
+#include "parser.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace initlang;
+
+static std::string generate_program(int functions) {
+    std::string source;
+    source += "let v0 ==> 1\n";
+    for (int i = 1; i <= functions; ++i) {
+        std::string n = std::to_string(i);
+        std::string prev = "v" + std::to_string(i - 1);
+        source += "fi f" + n + "(a, b, c) {\n"
+                  "    let t ==> a * " + n + " + b / (c - 2)\n"
+                  "    h(t, \"f" + n + "\")\n"
+                  "    return t - g(a, b) * -c\n"
+                  "}\n";
+        source += "let v" + n + " ==> f" + n + "(" + prev + ", \"s" + n + "\", 3.5) + 3 * (4 - " + prev + ")\n";
+    }
+    return source;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Parcours récursif de l'arbre à pointeurs, aiguillé par NodeKind
+static size_t count_identifiers(const ast::ASTNode* node) {
+    if (!node) return 0;
+    switch (node->kind) {
+        case ast::NodeKind::Identifier:
+            return 1;
+        case ast::NodeKind::BinaryExpression: {
+            auto* bin = static_cast<const ast::BinaryExpression*>(node);
+            return count_identifiers(bin->left) + count_identifiers(bin->right);
+        }
+        case ast::NodeKind::CallExpression: {
+            auto* call = static_cast<const ast::CallExpression*>(node);
+            size_t n = count_identifiers(call->callee);
+            for (auto* arg : call->arguments) n += count_identifiers(arg);
+            return n;
+        }
+        case ast::NodeKind::ExpressionStatement:
+            return count_identifiers(static_cast<const ast::ExpressionStatement*>(node)->expression);
+        case ast::NodeKind::VariableDeclaration:
+            return count_identifiers(static_cast<const ast::VariableDeclaration*>(node)->value);
+        case ast::NodeKind::BlockStatement: {
+            size_t n = 0;
+            for (auto* stmt : static_cast<const ast::BlockStatement*>(node)->statements) n += count_identifiers(stmt);
+            return n;
+        }
+        case ast::NodeKind::FunctionDeclaration:
+            return count_identifiers(static_cast<const ast::FunctionDeclaration*>(node)->body);
+        case ast::NodeKind::ReturnStatement:
+            return count_identifiers(static_cast<const ast::ReturnStatement*>(node)->value);
+        default:
+            return 0;
+    }
+}
+
+// Parcours complets de l'AST : arbre à pointeurs vs forme plate
+static void bench_walks(const std::string& source) {
+    lexer::Lexer tree_lexer(source);
+    auto program = parser::Parser(tree_lexer).parse_program();
+
+    lexer::Lexer flat_lexer(source);
+    auto start = std::chrono::steady_clock::now();
+    ast::FlatAst flat = parser::Parser(flat_lexer).parse_flat_program();
+    double flat_parse_time = seconds_since(start);
+
+    const int passes = 10;
+    size_t found = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i) {
+        for (auto* stmt : program->statements) found += count_identifiers(stmt);
+    }
+    double tree_walk = seconds_since(start) / passes;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i) {
+        ast::walk(flat, [&](ast::NodeId id) { found += flat.kind(id) == ast::NodeKind::Identifier; });
+    }
+    double flat_walk = seconds_since(start) / passes;
+
+    // Passe insensible à l'ordre : balayage linéaire du tableau de types
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i) {
+        for (ast::NodeKind kind : flat.kinds) found += kind == ast::NodeKind::Identifier;
+    }
+    double flat_scan = seconds_since(start) / passes;
+
+    std::printf("flat: parse %.3f s, %zu nodes (%zu identifiers counted)\n", flat_parse_time, flat.size(), found / (3 * passes));
+    std::printf("walk: tree %.2f ms, flat preorder %.2f ms, flat linear scan %.2f ms\n",
+                tree_walk * 1e3, flat_walk * 1e3, flat_scan * 1e3);
+}
+
+int main() {
+    std::string source = generate_program(50000);
+    lexer::Lexer lex(source);
+    parser::Parser parser(lex);
+
+    auto start = std::chrono::steady_clock::now();
+    auto program = parser.parse_program();
+    double parse_time = seconds_since(start);
+
+    size_t nodes = program->arena->nodes();
+    size_t arena_bytes = program->arena->bytes_reserved();
+
+    start = std::chrono::steady_clock::now();
+    program.reset();
+    double teardown_time = seconds_since(start);
+
+    std::printf("parse: %zu bytes, %zu nodes, %.3f s (%.1f Mnodes/s), arena %.1f MB\n",
+                source.size(), nodes, parse_time, nodes / parse_time / 1e6, arena_bytes / 1e6);
+    std::printf("teardown: %.3f ms\n", teardown_time * 1e3);
+
+    bench_walks(source);
+    return 0;
+}
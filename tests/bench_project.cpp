@@ -0,0 +1,93 @@
+// tests/bench_project.cpp
+// Compilation d'un projet de fichiers générés (project::compile_project)
+// avec 1 à N threads, N = hardware_concurrency (ou le premier argument) :
+// temps par phase, accélération face à un thread, et vérification que le
+// bytecode produit est identique pour chaque nombre de threads.
+#include "project.h"
+#include "disassembler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace initlang;
+
+// Un module : quelques fonctions, des globales propres et des appels vers
+// le module précédent
+static std::string generate_module(int index, int functions) {
+    std::string m = std::to_string(index);
+    std::string source = "let base" + m + " ==> " + m + "\n";
+    for (int i = 0; i < functions; ++i) {
+        std::string f = "m" + m + "_f" + std::to_string(i);
+        source += "fi " + f + "(a, b) {\n"
+                  "    let t ==> a * " + std::to_string(i + 1) + " + b / 2\n"
+                  "    init.log(\"" + f + "\", t)\n"
+                  "    return t - base" + m + "\n"
+                  "}\n";
+        source += "let v" + m + "_" + std::to_string(i) + " ==> " + f + "(base" + m + ", " + std::to_string(i) + ")\n";
+    }
+    if (index > 0) source += "let link" + m + " ==> m" + std::to_string(index - 1) + "_f0(1, 2)\n";
+    return source;
+}
+
+static std::string listing(const runtime::Heap& heap, const project::Result& result) {
+    std::string text;
+    for (const runtime::ObjFunction* script : result.scripts) text += compiler::disassemble(*script, &heap);
+    return text;
+}
+
+int main(int argc, char** argv) {
+    const int files = 300;
+    const int functions = 40;
+    size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    if (max_threads == 0) max_threads = 1;
+
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "initlang_bench_project";
+    fs::create_directories(dir);
+    std::vector<std::string> paths;
+    size_t bytes = 0;
+    for (int i = 0; i < files; ++i) {
+        std::string source = generate_module(i, functions);
+        bytes += source.size();
+        paths.push_back((dir / ("m" + std::to_string(i) + ".init")).string());
+        std::ofstream(paths.back()) << source;
+    }
+    std::printf("%d files, %.1f MB, 1 to %zu threads\n", files, bytes / 1e6, max_threads);
+    std::printf("%-8s %10s %10s %10s %10s %10s %8s\n", "threads", "parse ms", "link ms", "compile ms", "merge ms",
+                "total ms", "speedup");
+
+    const int passes = 3;
+    std::string reference;
+    double single = 0;
+    bool identical = true;
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+        project::Stats best;
+        double best_total = 1e9;
+        for (int pass = 0; pass < passes; ++pass) {
+            runtime::Heap heap;
+            project::Result result = project::compile_project(heap, paths, project::Options{threads, 1});
+            const project::Stats& s = result.stats;
+            double total = s.parse_seconds + s.link_seconds + s.compile_seconds + s.merge_seconds;
+            if (total < best_total) {
+                best_total = total;
+                best = s;
+            }
+            if (pass > 0) continue;
+            std::string text = listing(heap, result);
+            if (threads == 1) reference = text;
+            else if (text != reference) identical = false;
+        }
+        if (threads == 1) single = best_total;
+        std::printf("%-8zu %10.2f %10.2f %10.2f %10.2f %10.2f %7.2fx\n", threads, best.parse_seconds * 1e3,
+                    best.link_seconds * 1e3, best.compile_seconds * 1e3, best.merge_seconds * 1e3, best_total * 1e3,
+                    single / best_total);
+    }
+    fs::remove_all(dir);
+
+    std::printf("output %s across thread counts\n", identical ? "identical" : "DIFFERS");
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+// tests/bench_shapes.cpp
+// Structures à formes partagées (runtime/shape.h) :
+//   - mémoire par instance selon le nombre de champs, face à la disposition
+//     précédente (vecteur de paires nom/valeur alloué à part) ;
+//   - OP_GET_FIELD en ns/op sur une structure de 16 champs, pour le premier,
+//     le huitième et le dernier champ, avec et sans caches en ligne (sans :
+//     recherche par nom à chaque accès) ; coût d'une boucle témoin où
+//     l'accès est remplacé par une constante déduit ;
+//   - construction par OP_BUILD_STRUCT de n structures de 8 champs, lecture
+//     et écriture d'un champ de chacune (ns par structure).
+// Itérations : premier argument (10000000 par défaut), meilleur de trois
+// passes. Programmes assemblés à la main : le langage n'a pas de syntaxe
+// pour les champs.
+#include "vm.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace initlang;
+using compiler::OpCode;
+using runtime::Value;
+
+using Clock = std::chrono::steady_clock;
+
+// Assembleur minimal sur le Chunk d'une fonction
+class Assembler {
+public:
+    explicit Assembler(runtime::Heap& h) : heap(h), function(h.new_function()) {}
+
+    Assembler& op(OpCode code) { chunk().write(code, 1); return *this; }
+    Assembler& op(OpCode code, uint8_t operand) { op(code); chunk().write(operand, 1); return *this; }
+
+    uint8_t constant_index(Value value) { return static_cast<uint8_t>(chunk().add_constant(value)); }
+    Assembler& constant(Value value) { return op(OpCode::OP_CONSTANT, constant_index(value)); }
+    Assembler& number(double value) { return constant(Value::number(value)); }
+    Assembler& field(OpCode code, const std::string& name) {
+        return op(code, constant_index(Value::object(heap.intern(name))));
+    }
+
+    size_t here() const { return function->chunk.code.size(); }
+
+    size_t jump(OpCode code) {
+        op(code);
+        chunk().write(0, 1);
+        chunk().write(0, 1);
+        return here() - 2;
+    }
+
+    void patch(size_t operand) {
+        size_t offset = here() - operand - 2;
+        chunk().code[operand] = static_cast<uint8_t>(offset & 0xFF);
+        chunk().code[operand + 1] = static_cast<uint8_t>(offset >> 8);
+    }
+
+    void loop(size_t start) {
+        op(OpCode::OP_LOOP);
+        size_t offset = here() + 2 - start;
+        chunk().write(static_cast<uint8_t>(offset & 0xFF), 1);
+        chunk().write(static_cast<uint8_t>(offset >> 8), 1);
+    }
+
+    runtime::ObjFunction* done() { return function; }
+
+private:
+    runtime::Heap& heap;
+    runtime::ObjFunction* function;
+
+    compiler::Chunk& chunk() { return function->chunk; }
+};
+
+static std::string field_name(int i) { return "f" + std::to_string(i); }
+
+// Slots du script : 1 = structure de `fields` champs (fi = i), 2 = i, 3 = acc.
+// for (i = 0; i < n; i = i + 1) { body } ; renvoie acc
+template <typename Body>
+static runtime::ObjFunction* loop_program(runtime::Heap& heap, int fields, double n, Body body) {
+    Assembler a(heap);
+    for (int i = 0; i < fields; ++i) {
+        a.constant(Value::object(heap.intern(field_name(i)))).number(i);
+    }
+    a.op(OpCode::OP_BUILD_STRUCT, static_cast<uint8_t>(fields));
+    a.number(0).number(0);
+    size_t start = a.here();
+    a.op(OpCode::OP_GET_LOCAL, 2).number(n).op(OpCode::OP_LESS);
+    size_t exit = a.jump(OpCode::OP_JUMP_IF_FALSE);
+    body(a);
+    a.op(OpCode::OP_GET_LOCAL, 2).number(1).op(OpCode::OP_ADD).op(OpCode::OP_SET_LOCAL, 2).op(OpCode::OP_POP);
+    a.loop(start);
+    a.patch(exit);
+    a.op(OpCode::OP_GET_LOCAL, 3).op(OpCode::OP_RETURN);
+    return a.done();
+}
+
+// Meilleur de trois passes, caches en ligne vidés avant chacune
+static double run(runtime::Heap& heap, runtime::ObjFunction* script, bool caches, Value& result) {
+    double best = 0;
+    for (int pass = 0; pass < 3; ++pass) {
+        script->chunk.field_caches.clear();
+        vm::VM machine(heap);
+        machine.set_jit_threshold(0);
+        machine.set_quickening(caches);
+        auto start = Clock::now();
+        result = machine.interpret(script);
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (pass == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    double n = argc > 1 ? std::atof(argv[1]) : 1e7;
+    if (n < 1) n = 1;
+
+    // Disposition précédente : en-tête, vecteur, puis bloc de paires séparé
+    // (plus l'en-tête de malloc, 16 octets avec la glibc)
+    struct VectorStruct : runtime::Obj {
+        std::vector<std::pair<runtime::ObjString*, Value>> fields;
+    };
+    std::printf("bytes per instance (Value: %zu bytes)\n", sizeof(Value));
+    std::printf("%-8s %12s %14s\n", "fields", "shape", "vector<pair>");
+    for (size_t fields : {1, 2, 4, 8, 16}) {
+        size_t shaped = sizeof(runtime::ObjStruct) + fields * sizeof(Value);
+        size_t vectored = sizeof(VectorStruct) + fields * sizeof(std::pair<runtime::ObjString*, Value>) + 16;
+        std::printf("%-8zu %12zu %14zu\n", fields, shaped, vectored);
+    }
+
+    runtime::Heap heap;
+    Value result;
+    std::printf("OP_GET_FIELD on a 16-field struct, %.0f iterations, ns/op\n", n);
+    std::printf("%-8s %12s %12s\n", "field", "cached", "uncached");
+    runtime::ObjFunction* baseline = loop_program(heap, 16, n, [](Assembler& a) {
+        a.op(OpCode::OP_GET_LOCAL, 3).number(1).op(OpCode::OP_ADD).op(OpCode::OP_SET_LOCAL, 3).op(OpCode::OP_POP);
+    });
+    bool consistent = true;
+    for (int field : {0, 7, 15}) {
+        runtime::ObjFunction* reads = loop_program(heap, 16, n, [&](Assembler& a) {
+            a.op(OpCode::OP_GET_LOCAL, 3).op(OpCode::OP_GET_LOCAL, 1).field(OpCode::OP_GET_FIELD, field_name(field));
+            a.op(OpCode::OP_ADD).op(OpCode::OP_SET_LOCAL, 3).op(OpCode::OP_POP);
+        });
+        double ns[2];
+        for (bool caches : {true, false}) {
+            double base = run(heap, baseline, caches, result);
+            double elapsed = run(heap, reads, caches, result);
+            consistent = consistent && result.as_number() == field * n;
+            ns[caches ? 0 : 1] = (elapsed - base) / n * 1e9;
+        }
+        std::printf("%-8s %12.2f %12.2f\n", field_name(field).c_str(), ns[0], ns[1]);
+    }
+
+    // s = {f0: i, ..., f7: i} ; s.f0 = s.f7 + 1 ; acc = acc + s.f0
+    runtime::ObjFunction* builds = loop_program(heap, 1, n, [&](Assembler& a) {
+        for (int i = 0; i < 8; ++i) a.constant(Value::object(heap.intern(field_name(i)))).op(OpCode::OP_GET_LOCAL, 2);
+        a.op(OpCode::OP_BUILD_STRUCT, 8).op(OpCode::OP_SET_LOCAL, 1).op(OpCode::OP_POP);
+        a.op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_GET_LOCAL, 1).field(OpCode::OP_GET_FIELD, "f7").number(1);
+        a.op(OpCode::OP_ADD).field(OpCode::OP_SET_FIELD, "f0").op(OpCode::OP_POP);
+        a.op(OpCode::OP_GET_LOCAL, 3).op(OpCode::OP_GET_LOCAL, 1).field(OpCode::OP_GET_FIELD, "f0");
+        a.op(OpCode::OP_ADD).op(OpCode::OP_SET_LOCAL, 3).op(OpCode::OP_POP);
+    });
+    std::printf("build 8-field struct + set + 2 gets, ns/struct\n");
+    for (bool caches : {true, false}) {
+        double elapsed = run(heap, builds, caches, result);
+        consistent = consistent && result.as_number() == n * (n - 1) / 2 + n;
+        std::printf("%-10s %10.2f\n", caches ? "cached" : "uncached", elapsed / n * 1e9);
+    }
+    std::printf("%zu shapes, %zu minor collections\n", heap.shape_count(), heap.gc_stats().minor_collections);
+    std::printf("results %s\n", consistent ? "consistent" : "WRONG");
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// tests/bench_tasks.cpp
+// Planificateur de tâches avec 1 à N workers, N = hardware_concurrency (ou
+// le premier argument) :
+//   - sched::Scheduler seul : un arbre binaire de travaux vides ;
+//   - VM : un arbre de tâches INITLANG (chaque niveau lance ses deux
+//     enfants par spawn puis les attend), 2^(profondeur+1) - 1 tâches,
+//     profondeur = second argument (19 par défaut,
+//     soit 1 048 575 tâches).
+// Débit en tâches par seconde, accélération face à un worker, et
+// vérification que le résultat ne dépend pas du nombre de workers.
+#include "parser.h"
+#include "compiler.h"
+#include "scheduler.h"
+#include "vm.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace initlang;
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Travail : profondeur restante + 1 (nullptr est réservé au planificateur)
+struct Tree {
+    sched::Scheduler* scheduler = nullptr;
+    std::atomic<uint64_t> jobs{0};
+
+    static void run(void* context, void* job, size_t worker) {
+        Tree& tree = *static_cast<Tree*>(context);
+        uintptr_t depth = reinterpret_cast<uintptr_t>(job) - 1;
+        tree.jobs.fetch_add(1, std::memory_order_relaxed);
+        if (depth == 0) return;
+        tree.scheduler->push(worker, reinterpret_cast<void*>(depth));
+        tree.scheduler->push(worker, reinterpret_cast<void*>(depth));
+    }
+};
+
+static std::string generate(int depth) {
+    std::string source = "async fi l0(x) { return x }\n";
+    for (int level = 1; level <= depth; ++level) {
+        std::string child = "l" + std::to_string(level - 1);
+        source += "async fi l" + std::to_string(level) + "(x) {\n"
+                  "    let a ==> spawn " + child + "(x)\n"
+                  "    let b ==> spawn " + child + "(x + 1)\n"
+                  "    return await a + await b\n"
+                  "}\n";
+    }
+    source += "let total ==> await spawn l" + std::to_string(depth) + "(0)\n";
+    return source;
+}
+
+int main(int argc, char** argv) {
+    size_t max_workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    if (max_workers == 0) max_workers = 1;
+    int depth = argc > 2 ? std::atoi(argv[2]) : 19;
+    if (depth < 1) depth = 1;
+    const uint64_t expected_jobs = (uint64_t{2} << depth) - 1;
+
+    std::printf("scheduler: %llu empty jobs, 1 to %zu workers\n", static_cast<unsigned long long>(expected_jobs),
+                max_workers);
+    std::printf("%-8s %10s %14s %8s\n", "workers", "ms", "jobs/s", "speedup");
+    bool consistent = true;
+    double single = 0;
+    for (size_t workers = 1; workers <= max_workers; ++workers) {
+        Tree tree;
+        sched::Scheduler scheduler(workers, &Tree::run, &tree);
+        tree.scheduler = &scheduler;
+        auto start = Clock::now();
+        scheduler.push(0, reinterpret_cast<void*>(static_cast<uintptr_t>(depth) + 1));
+        scheduler.drain();
+        double elapsed = seconds_since(start);
+        if (tree.jobs.load() != expected_jobs) consistent = false;
+        if (workers == 1) single = elapsed;
+        std::printf("%-8zu %10.2f %14.0f %7.2fx\n", workers, elapsed * 1e3, expected_jobs / elapsed, single / elapsed);
+    }
+
+    std::string source = generate(depth);
+    const uint64_t tasks = expected_jobs;
+    std::printf("vm: %llu tasks (depth %d), 1 to %zu workers\n", static_cast<unsigned long long>(tasks), depth,
+                max_workers);
+    std::printf("%-8s %10s %14s %12s %8s\n", "workers", "ms", "tasks/s", "suspensions", "speedup");
+    double reference = -1;
+    for (size_t workers = 1; workers <= max_workers; ++workers) {
+        runtime::Heap heap; // un Heap par passe : les tâches n'y sont pas collectées
+        lexer::Lexer lexer(source);
+        auto program = parser::Parser(lexer).parse_program();
+        runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+
+        vm::VM machine(heap);
+        machine.set_workers(workers);
+        auto start = Clock::now();
+        machine.interpret(script);
+        double elapsed = seconds_since(start);
+
+        double total = machine.global("total").as_number();
+        if (reference < 0) reference = total;
+        if (total != reference || machine.task_stats().spawned != tasks) consistent = false;
+        if (workers == 1) single = elapsed;
+        std::printf("%-8zu %10.2f %14.0f %12zu %7.2fx\n", workers, elapsed * 1e3, tasks / elapsed,
+                    machine.task_stats().suspended, single / elapsed);
+    }
+
+    std::printf("results %s across worker counts\n", consistent ? "identical" : "DIFFER");
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+// tests/bench_vm.cpp
+// Boucle d'exécution : fib récursif, boucle nue, construction de chaînes et
+// appels, en dispatch switch puis goto calculé. Le langage n'a pas encore
+// de conditionnelle : les programmes sont assemblés à la main. Compilé
+// deux fois (bench_vm, bench_vm_tagged) pour comparer les représentations
+// de Value. Les colonnes suivantes reprennent le goto calculé (switch à
+// défaut) avec quickening, après la passe peephole (superinstructions),
+// puis les deux ; les premières colonnes sont mesurées sans quickening. La
+// dernière ajoute le JIT (seuil par défaut) : interpréteur seul ailleurs.
+//
+// bench_vm --profile : fréquences des paires d'opcodes exécutées sur les
+// mêmes cas, corpus du choix des superinstructions (compiler/peephole.h).
+#include "vm.h"
+#include "disassembler.h"
+#include "peephole.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace initlang;
+using compiler::OpCode;
+using runtime::Value;
+
+// Assembleur minimal sur le Chunk d'une fonction
+class Assembler {
+public:
+    Assembler(runtime::Heap& h, const char* name, int arity) : heap(h), function(h.new_function()) {
+        function->arity = arity;
+        if (name) function->name = heap.intern(name);
+    }
+
+    Assembler& op(OpCode code) { chunk().write(code, 1); return *this; }
+    Assembler& op(OpCode code, uint8_t operand) { op(code); chunk().write(operand, 1); return *this; }
+
+    Assembler& constant(Value value) {
+        return op(OpCode::OP_CONSTANT, static_cast<uint8_t>(chunk().add_constant(value)));
+    }
+    Assembler& number(double value) { return constant(Value::number(value)); }
+    Assembler& string(const char* text) { return constant(Value::object(heap.intern(text))); }
+
+    Assembler& global(OpCode code, const char* name) {
+        return op(code, static_cast<uint8_t>(heap.global_id(heap.intern(name))));
+    }
+
+    size_t here() const { return function->chunk.code.size(); }
+
+    // Saut avant : renvoie la position de l'opérande à corriger
+    size_t jump(OpCode code) {
+        op(code);
+        chunk().write(0, 1);
+        chunk().write(0, 1);
+        return here() - 2;
+    }
+
+    void patch(size_t operand) {
+        size_t offset = here() - operand - 2;
+        chunk().code[operand] = static_cast<uint8_t>(offset & 0xFF);
+        chunk().code[operand + 1] = static_cast<uint8_t>(offset >> 8);
+    }
+
+    void loop(size_t start) {
+        op(OpCode::OP_LOOP);
+        size_t offset = here() + 2 - start;
+        chunk().write(static_cast<uint8_t>(offset & 0xFF), 1);
+        chunk().write(static_cast<uint8_t>(offset >> 8), 1);
+    }
+
+    runtime::ObjFunction* done() { return function; }
+
+private:
+    runtime::Heap& heap;
+    runtime::ObjFunction* function;
+
+    compiler::Chunk& chunk() { return function->chunk; }
+};
+
+// for (i = 0; i < n; i = i + 1) { body }, i dans le slot 1 du script
+template <typename Body>
+static runtime::ObjFunction* counted_loop(runtime::Heap& heap, double n, Body body) {
+    Assembler a(heap, nullptr, 0);
+    a.number(0);
+    size_t start = a.here();
+    a.op(OpCode::OP_GET_LOCAL, 1).number(n).op(OpCode::OP_LESS);
+    size_t exit = a.jump(OpCode::OP_JUMP_IF_FALSE);
+    body(a);
+    a.op(OpCode::OP_GET_LOCAL, 1).number(1).op(OpCode::OP_ADD).op(OpCode::OP_SET_LOCAL, 1).op(OpCode::OP_POP);
+    a.loop(start);
+    a.patch(exit);
+    a.op(OpCode::OP_NULL).op(OpCode::OP_RETURN);
+    return a.done();
+}
+
+static runtime::ObjFunction* fib_program(runtime::Heap& heap, double n) {
+    // fi fib(n) { if n < 2 { return n } return fib(n - 1) + fib(n - 2) }
+    Assembler fib(heap, "fib", 1);
+    fib.op(OpCode::OP_GET_LOCAL, 1).number(2).op(OpCode::OP_LESS);
+    size_t recurse = fib.jump(OpCode::OP_JUMP_IF_FALSE);
+    fib.op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_RETURN);
+    fib.patch(recurse);
+    fib.global(OpCode::OP_GET_GLOBAL, "fib").op(OpCode::OP_GET_LOCAL, 1).number(1)
+       .op(OpCode::OP_SUBTRACT).op(OpCode::OP_CALL, 1);
+    fib.global(OpCode::OP_GET_GLOBAL, "fib").op(OpCode::OP_GET_LOCAL, 1).number(2)
+       .op(OpCode::OP_SUBTRACT).op(OpCode::OP_CALL, 1);
+    fib.op(OpCode::OP_ADD).op(OpCode::OP_RETURN);
+
+    Assembler script(heap, nullptr, 0);
+    script.constant(Value::object(fib.done())).global(OpCode::OP_DEFINE_GLOBAL, "fib");
+    script.global(OpCode::OP_GET_GLOBAL, "fib").number(n).op(OpCode::OP_CALL, 1).op(OpCode::OP_RETURN);
+    return script.done();
+}
+
+// fi ack(m, n) {
+//   if m == 0 { return n + 1 }
+//   if n == 0 { return ack(m - 1, 1) }
+//   return ack(m - 1, ack(m, n - 1))
+// }
+// Les deux `return ack(...)` en `call` : OP_TAIL_CALL, ou OP_CALL + OP_RETURN
+static runtime::ObjFunction* ackermann_program(runtime::Heap& heap, double m, double n, OpCode call) {
+    Assembler ack(heap, "ack", 2);
+    auto tail = [&](uint8_t argc) {
+        ack.op(call, argc);
+        if (call == OpCode::OP_CALL) ack.op(OpCode::OP_RETURN);
+    };
+    ack.op(OpCode::OP_GET_LOCAL, 1).number(0).op(OpCode::OP_EQUAL);
+    size_t m_positive = ack.jump(OpCode::OP_JUMP_IF_FALSE);
+    ack.op(OpCode::OP_GET_LOCAL, 2).number(1).op(OpCode::OP_ADD).op(OpCode::OP_RETURN);
+    ack.patch(m_positive);
+    ack.op(OpCode::OP_GET_LOCAL, 2).number(0).op(OpCode::OP_EQUAL);
+    size_t n_positive = ack.jump(OpCode::OP_JUMP_IF_FALSE);
+    ack.global(OpCode::OP_GET_GLOBAL, "ack").op(OpCode::OP_GET_LOCAL, 1).number(1).op(OpCode::OP_SUBTRACT).number(1);
+    tail(2);
+    ack.patch(n_positive);
+    ack.global(OpCode::OP_GET_GLOBAL, "ack").op(OpCode::OP_GET_LOCAL, 1).number(1).op(OpCode::OP_SUBTRACT);
+    ack.global(OpCode::OP_GET_GLOBAL, "ack").op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_GET_LOCAL, 2).number(1)
+       .op(OpCode::OP_SUBTRACT).op(OpCode::OP_CALL, 2);
+    tail(2);
+
+    Assembler script(heap, nullptr, 0);
+    script.constant(Value::object(ack.done())).global(OpCode::OP_DEFINE_GLOBAL, "ack");
+    script.global(OpCode::OP_GET_GLOBAL, "ack").number(m).number(n).op(OpCode::OP_CALL, 2).op(OpCode::OP_RETURN);
+    return script.done();
+}
+
+// Appels d'une fonction identité `id`, définie par run_case
+static runtime::ObjFunction* calls_program(runtime::Heap& heap, double n) {
+    return counted_loop(heap, n, [](Assembler& a) {
+        a.global(OpCode::OP_GET_GLOBAL, "id").op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_CALL, 1).op(OpCode::OP_POP);
+    });
+}
+
+// c = a + b ; a = c - a, cinq accès globaux par itération
+static runtime::ObjFunction* globals_program(runtime::Heap& heap, double n) {
+    return counted_loop(heap, n, [](Assembler& a) {
+        a.global(OpCode::OP_GET_GLOBAL, "a").global(OpCode::OP_GET_GLOBAL, "b").op(OpCode::OP_ADD)
+         .global(OpCode::OP_SET_GLOBAL, "c").global(OpCode::OP_GET_GLOBAL, "a").op(OpCode::OP_SUBTRACT)
+         .global(OpCode::OP_SET_GLOBAL, "a").op(OpCode::OP_POP);
+    });
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Case {
+    const char* name;
+    double ops; // unité de mesure : itération ou appel
+    runtime::ObjFunction* (*build)(runtime::Heap&);
+};
+
+struct Config {
+    vm::Dispatch dispatch;
+    bool peephole;
+    bool quicken;
+    uint32_t jit = 0; // seuil du JIT, 0 : interpréteur seul
+    vm::OpcodeProfile* profile = nullptr;
+};
+
+static double run_case(const Case& c, const Config& config) {
+    double best = 1e9;
+    for (int pass = 0; pass < (config.profile ? 1 : 3); ++pass) {
+        runtime::Heap heap;
+        runtime::ObjFunction* script = c.build(heap);
+        vm::VM machine(heap, vm::VM::JIT_MAX_FRAMES); // ack(3, 7) : 1023 appels imbriqués
+        machine.set_dispatch(config.dispatch);
+        machine.set_quickening(config.quicken);
+        machine.set_jit_threshold(config.jit);
+
+        // fi id(x) { return x }  let a ==> 1  let b ==> 2  let c ==> 0
+        Assembler id(heap, "id", 1);
+        id.op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_RETURN);
+        Assembler define(heap, nullptr, 0);
+        define.constant(Value::object(id.done())).global(OpCode::OP_DEFINE_GLOBAL, "id");
+        define.number(1).global(OpCode::OP_DEFINE_GLOBAL, "a").number(2).global(OpCode::OP_DEFINE_GLOBAL, "b");
+        define.number(0).global(OpCode::OP_DEFINE_GLOBAL, "c").op(OpCode::OP_NULL).op(OpCode::OP_RETURN);
+        machine.interpret(define.done());
+        if (config.peephole) {
+            compiler::optimize_bytecode(*script);
+            compiler::optimize_bytecode(*id.done());
+        }
+
+        machine.set_profile(config.profile);
+        auto start = std::chrono::steady_clock::now();
+        machine.interpret(script);
+        best = std::min(best, seconds_since(start));
+    }
+    return best;
+}
+
+// Paires consécutives, en part moyenne des instructions de chaque cas (un
+// cas long ne domine pas le classement). Une paire qui commence par un
+// transfert de contrôle n'est pas adjacente dans le code : exclue.
+static void print_profile(const Case* cases, size_t count) {
+    const size_t n = compiler::OPCODE_COUNT;
+    std::vector<double> share(n * n, 0.0);
+    for (size_t i = 0; i < count; ++i) {
+        auto profile = std::make_unique<vm::OpcodeProfile>();
+        run_case(cases[i], Config{vm::Dispatch::Switch, false, false, 0, profile.get()});
+        uint64_t total = 0;
+        for (size_t op = 0; op < n; ++op) total += profile->counts[op];
+        for (size_t a = 0; a < n; ++a) {
+            for (size_t b = 0; b < n; ++b) share[a * n + b] += double(profile->pairs[a][b]) / total / count;
+        }
+    }
+
+    std::vector<size_t> order;
+    for (size_t pair = 0; pair < n * n; ++pair) {
+        OpCode first = static_cast<OpCode>(pair / n);
+        bool transfer = first == OpCode::OP_JUMP || first == OpCode::OP_JUMP_IF_FALSE || first == OpCode::OP_LOOP ||
+                        first == OpCode::OP_CALL || first == OpCode::OP_TAIL_CALL || first == OpCode::OP_RETURN;
+        if (share[pair] > 0 && !transfer) order.push_back(pair);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return share[a] > share[b]; });
+
+    std::printf("%-22s %-22s %8s\n", "first", "second", "share");
+    for (size_t i = 0; i < order.size() && i < 20; ++i) {
+        std::printf("%-22s %-22s %7.2f%%\n", compiler::opcode_name(static_cast<OpCode>(order[i] / n)),
+                    compiler::opcode_name(static_cast<OpCode>(order[i] % n)), share[order[i]] * 100);
+    }
+}
+
+int main(int argc, char** argv) {
+    const Case cases[] = {
+        {"fib(27)", 635621, [](runtime::Heap& h) { return fib_program(h, 27); }},
+        {"ack(3,7)", 693964, [](runtime::Heap& h) { return ackermann_program(h, 3, 7, OpCode::OP_TAIL_CALL); }},
+        {"ack/call", 693964, [](runtime::Heap& h) { return ackermann_program(h, 3, 7, OpCode::OP_CALL); }},
+        {"loop", 20e6, [](runtime::Heap& h) { return counted_loop(h, 20e6, [](Assembler&) {}); }},
+        {"strings", 500e3, [](runtime::Heap& h) {
+             return counted_loop(h, 500e3, [](Assembler& a) {
+                 a.string("item").op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_ADD).op(OpCode::OP_POP);
+             });
+         }},
+        {"calls", 5e6, [](runtime::Heap& h) { return calls_program(h, 5e6); }},
+        {"globals", 10e6, [](runtime::Heap& h) { return globals_program(h, 10e6); }},
+    };
+
+    if (argc > 1 && std::strcmp(argv[1], "--profile") == 0) {
+        print_profile(cases, sizeof(cases) / sizeof(cases[0]));
+        return 0;
+    }
+
+    std::printf("Value: %s, %zu bytes\n", runtime::VALUE_REPRESENTATION, sizeof(Value));
+    vm::Dispatch best = vm::VM::threaded_available() ? vm::Dispatch::Threaded : vm::Dispatch::Switch;
+    std::printf("%-10s %12s %12s %12s %12s %12s %12s\n", "case", "switch", "threaded", "quickened", "peephole",
+                "both", vm::VM::jit_available() ? "jit" : "(no jit)");
+    for (const Case& c : cases) {
+        auto ns = [&](vm::Dispatch dispatch, bool peephole, bool quicken, uint32_t jit = 0) {
+            return run_case(c, Config{dispatch, peephole, quicken, jit}) / c.ops * 1e9;
+        };
+        double switched = ns(vm::Dispatch::Switch, false, false);
+        double threaded = vm::VM::threaded_available() ? ns(vm::Dispatch::Threaded, false, false) : 0;
+        double quickened = ns(best, false, true);
+        double fused = ns(best, true, false);
+        double both = ns(best, true, true);
+        double jitted = vm::VM::jit_available() ? ns(best, true, true, vm::VM::DEFAULT_JIT_THRESHOLD) : 0;
+        std::printf("%-10s %9.2f ns %9.2f ns %9.2f ns %9.2f ns %9.2f ns %9.2f ns\n", c.name, switched, threaded,
+                    quickened, fused, both, jitted);
+    }
+    return 0;
+}
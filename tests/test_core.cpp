@@ -1,12 +1,2064 @@
-// tests/simple_test.cpp
+// tests/test_core.cpp
+#include "lexer.h"
+#include "parallel_lexer.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "compiler.h"
+#include "disassembler.h"
+#include "peephole.h"
+#include "bytecode_cache.h"
+#include "vm.h"
+#include "logger.h"
+#include "project.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
 
-// Test minimal pour vérifier la compilation
+using namespace initlang;
+
+static int failures = 0;
+static const char* tier = "interpreter"; // niveau d'exécution du passage en cours
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": [" << tier << "] CHECK(" #cond ") failed" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// L'ensemble des mots-clés est figé : tout ajout doit passer par ce test.
+static void test_keywords() {
+    const std::pair<const char*, lexer::TokenType> expected[] = {
+        {"let", lexer::TokenType::LET},
+        {"fi", lexer::TokenType::FI},
+        {"const", lexer::TokenType::CONST},
+        {"return", lexer::TokenType::RETURN},
+        {"async", lexer::TokenType::ASYNC},
+        {"spawn", lexer::TokenType::SPAWN},
+        {"await", lexer::TokenType::AWAIT},
+        {"init.ger", lexer::TokenType::INIT_GER},
+        {"init.log", lexer::TokenType::INIT_LOG},
+    };
+
+    CHECK(lexer::keyword_list.size() == sizeof(expected) / sizeof(expected[0]));
+    for (const auto& [text, type] : expected) {
+        CHECK(lexer::lookup_keyword(text) == type);
+
+        lexer::Lexer lex(text);
+        auto tokens = lex.tokenize();
+        CHECK(tokens.size() == 2 && tokens[0].type == type && tokens[0].value == text);
+    }
+
+    // Quasi-mots-clés : préfixes, suffixes, casse, mêmes (longueur, extrémités)
+    const char* identifiers[] = {
+        "le", "lets", "Let", "LET", "f", "fii", "constant", "returns", "asyncs",
+        "awaits", "spawned", "init", "init.", "init.gerr", "init.lg", "init_ger",
+        "aait", "asynt", "ft", "lat", "await2", "x",
+    };
+    for (const char* text : identifiers) {
+        CHECK(lexer::lookup_keyword(text) == lexer::TokenType::IDENTIFIER);
+    }
+}
+
+static void test_lexer_positions() {
+    lexer::Lexer lex("let x ==> 5\n  fi f(a) { return \"s\\n\" }");
+    auto tokens = lex.tokenize();
+
+    CHECK(tokens[0].type == lexer::TokenType::LET && tokens[0].line == 1 && tokens[0].column == 1);
+    CHECK(tokens[2].type == lexer::TokenType::ARROW && tokens[2].column == 7);
+    CHECK(tokens[4].type == lexer::TokenType::FI && tokens[4].line == 2 && tokens[4].column == 3);
+    CHECK(tokens[11].type == lexer::TokenType::STRING && tokens[11].value == "s\n");
+    CHECK(tokens.back().type == lexer::TokenType::EOF_TOKEN);
+}
+
+// Lexer en flux : mêmes tokens que sur le source entier quel que soit la
+// taille des blocs (tokens, échappements et chaînes multi-lignes à cheval
+// sur deux blocs) ; current_token et peek_token du Parser restent valides
+// à travers les remplissages
+static void test_streaming_lexer() {
+    const std::string source =
+        "let s ==> \"esc \\\"q\\\" \\\\ tab\\tend\"\n"
+        "let m ==> 'multi\nline \"x\"\nstring'\n"
+        "fi add(a, b) { return a + b }\n"
+        "let e ==> \"a\\nb\" + 'c\\'d' + \"plain\" + 'x\\ty'\n"
+        "let long_identifier_name ==> add(12.5, 3) >= 4\n"
+        "init.log(s, m, e, long_identifier_name)\n";
+    auto describe = [](const lexer::Token& t) {
+        return std::to_string(static_cast<int>(t.type)) + ":" + std::string(t.value) + ":" + std::to_string(t.line) +
+               ":" + std::to_string(t.column);
+    };
+    auto string_reader = [](const std::string& text) -> lexer::ChunkReader {
+        return [&text, offset = size_t{0}](char* dst, size_t capacity) mutable {
+            size_t n = std::min(capacity, text.size() - offset);
+            std::memcpy(dst, text.data() + offset, n);
+            offset += n;
+            return n;
+        };
+    };
+    // Tokens lus comme le Parser : chaque token est vérifié une fois devenu
+    // current_token, après la lecture du suivant (peek_token)
+    auto streamed = [&](lexer::Lexer& lex) {
+        std::vector<std::string> out;
+        lexer::Token current = lex.next_token();
+        lexer::Token peek = lex.next_token();
+        for (;;) {
+            out.push_back(describe(current));
+            if (current.type == lexer::TokenType::EOF_TOKEN) break;
+            current = peek;
+            peek = lex.next_token();
+        }
+        return out;
+    };
+
+    // Hors Parser : chaînes décodées consécutives (current et peek décodés,
+    // hors du tampon court de std::string)
+    const std::string text = source + "\"first decoded\\tstring\" 'second decoded\\tstring' \"a\\nb\"\n";
+    lexer::Lexer whole(text);
+    std::vector<lexer::Token> whole_tokens = whole.tokenize();
+    std::vector<std::string> expected;
+    for (const lexer::Token& t : whole_tokens) expected.push_back(describe(t));
+    CHECK(whole_tokens[3].value == "esc \"q\" \\ tab\tend" && whole_tokens[7].line == 2);
+
+    int differences = 0;
+    for (size_t chunk = 1; chunk <= 40; ++chunk) {
+        lexer::Lexer lex(string_reader(text), chunk);
+        if (streamed(lex) != expected) ++differences;
+    }
+    CHECK(differences == 0);
+
+    // Parser sur un flux : même programme que sur le source entier
+    auto listing = [](lexer::Lexer& lex) {
+        auto program = parser::Parser(lex).parse_program();
+        runtime::Heap heap;
+        return compiler::disassemble(*compiler::Compiler(heap).compile(*program), &heap);
+    };
+    lexer::Lexer whole_again(source);
+    std::string reference = listing(whole_again);
+    for (size_t chunk : {1, 3, 16}) {
+        lexer::Lexer lex(string_reader(source), chunk);
+        CHECK(listing(lex) == reference);
+    }
+
+    // Fichier projeté, puis flux sur un tube
+    std::string path = (std::filesystem::temp_directory_path() / "initlang_test_stream.init").string();
+    std::ofstream(path) << text;
+    lexer::Lexer mapped = lexer::Lexer::from_file(path);
+    std::vector<std::string> from_file;
+    for (const lexer::Token& t : mapped.tokenize()) from_file.push_back(describe(t));
+    CHECK(from_file == expected);
+    std::filesystem::remove(path);
+
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    CHECK(::write(fds[1], text.data(), text.size()) == static_cast<ssize_t>(text.size()));
+    ::close(fds[1]);
+    lexer::Lexer piped(lexer::fd_reader(fds[0]), 7);
+    CHECK(streamed(piped) == expected);
+    ::close(fds[0]);
+
+    // tokenize() exige le source entier
+    lexer::Lexer stream(string_reader(source), 8);
+    bool refused = false;
+    try { stream.tokenize(); } catch (const std::logic_error&) { refused = true; }
+    CHECK(refused);
+}
+
+// Noyaux de balayage SSE2/AVX2 : même arrêt et mêmes sauts de ligne que le
+// noyau scalaire sur des séries qui chevauchent les blocs de 16 et 32
+// octets, puis mêmes tokens sous chaque jeu de noyaux
+static void test_simd_scan() {
+#ifdef INITLANG_SIMD_X86
+    namespace simd = lexer::simd;
+    std::vector<const simd::ScanKernels*> sets = {&simd::sse2_kernels()};
+    if (simd::cpu_has_avx2()) sets.push_back(&simd::avx2_kernels());
+    const simd::ScanKernels& scalar = simd::scalar_kernels();
+
+    // Un octet de chaque classe qui compte pour un noyau (dont un octet
+    // ≥ 0x80, négatif en char)
+    const char alphabet[] = {' ', '\t', '\n', '\r', '\v', 'a', 'Z', '_', '.', '0', '9', '"', '\'', '\\', '\0',
+                             '=', '@', '`', '{', '/', ':', '[', static_cast<char>(0x80), static_cast<char>(0xE9)};
+    uint32_t seed = 4242;
+    auto random = [&seed](uint32_t n) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % n;
+    };
+    auto same = [](const char* stop, const simd::NewlineInfo& nl, const char* ref_stop, const simd::NewlineInfo& ref) {
+        return stop == ref_stop && nl.count == ref.count && nl.last == ref.last;
+    };
+    int differences = 0;
+    for (int round = 0; round < 20000; ++round) {
+        // Séries d'un même octet, de longueurs autour de 16 et 32
+        std::string input(random(32), 'x'); // décalage d'alignement
+        size_t begin = input.size();
+        while (input.size() - begin < 100) {
+            input.append(random(4) == 0 ? 1 : random(70), alphabet[random(sizeof(alphabet))]);
+        }
+        input.resize(begin + random(100));
+        const char* p = input.data() + begin;
+        const char* end = input.data() + input.size();
+
+        for (const simd::ScanKernels* set : sets) {
+            simd::NewlineInfo a, b;
+            if (!same(set->whitespace(p, end, a), a, scalar.whitespace(p, end, b), b)) ++differences;
+            a = b = {};
+            if (!same(set->identifier(p, end, a), a, scalar.identifier(p, end, b), b)) ++differences;
+            a = b = {};
+            if (!same(set->digits(p, end, a), a, scalar.digits(p, end, b), b)) ++differences;
+            a = b = {};
+            if (!same(set->quotes(p, end, a), a, scalar.quotes(p, end, b), b)) ++differences;
+            for (char quote : {'"', '\''}) {
+                a = b = {};
+                if (!same(set->string_body(p, end, quote, a), a, scalar.string_body(p, end, quote, b), b)) {
+                    ++differences;
+                }
+            }
+        }
+    }
+    CHECK(differences == 0);
+
+    // Lexer complet : mêmes type, valeur, ligne et colonne sous chaque jeu
+    auto tokens = [](const std::string& source) {
+        std::string text;
+        try {
+            lexer::Lexer lex(source);
+            for (const lexer::Token& t : lex.tokenize()) {
+                text += std::to_string(static_cast<int>(t.type)) + ":" + std::string(t.value) + ":" +
+                        std::to_string(t.line) + ":" + std::to_string(t.column) + "\n";
+            }
+        } catch (const std::runtime_error& e) {
+            text += std::string("error: ") + e.what();
+        }
+        return text;
+    };
+    const std::string pieces[] = {
+        "let identifier_of_thirty_three_bytes ==> 1234567890123456789.5\n",
+        "                                 \t\t\r\n\n  ", "\"a string body longer than sixteen, \\\"escaped\\\"\"",
+        "'multi\nline\nstring spanning more than thirty-two bytes'", "x.y.z_1 ", "fi f(a, b) { return a + b }\n",
+        "\"\\\n\"", "@", "'\\",
+    };
+    differences = 0;
+    for (int round = 0; round < 300; ++round) {
+        std::string source;
+        for (int i = 1 + static_cast<int>(random(30)); i > 0; --i) source += pieces[random(random(40) ? 7 : 9)];
+        simd::force_kernels(scalar);
+        std::string expected = tokens(source);
+        for (const simd::ScanKernels* set : sets) {
+            simd::force_kernels(*set);
+            if (tokens(source) != expected) ++differences;
+        }
+    }
+    simd::force_kernels(simd::best_kernels());
+    CHECK(differences == 0);
+    CHECK(&simd::kernels() == &simd::best_kernels());
+#endif
+}
+
+// ParallelLexer : mêmes tokens (ou même erreur) que le Lexer séquentiel,
+// quel que soit le découpage. Sources aléatoires bâties de fragments qui
+// piègent le pré-balayage : guillemets de l'autre sorte, échappements,
+// chaînes sur plusieurs lignes, '\0', chaînes non terminées.
+static void test_parallel_lexer() {
+    auto outcome = [](auto& lex, common::Interner& symbols) {
+        lex.set_interner(&symbols);
+        std::string text;
+        try {
+            for (const lexer::Token& t : lex.tokenize()) {
+                text += std::to_string(static_cast<int>(t.type)) + ":" + std::string(t.value) + ":" +
+                        std::to_string(t.line) + ":" + std::to_string(t.column) + ":" +
+                        std::to_string(t.symbol.value) + "\n";
+            }
+        } catch (const std::runtime_error& e) {
+            text += std::string("error: ") + e.what();
+        }
+        return text;
+    };
+
+    const std::string clean[] = {
+        "let x ==> 12.5 * y\n", "fi f(a, b) { return a + b }\n", "init.log(\"a 'quoted' \\\"word\\\"\")\n",
+        "let s ==> 'multi\nline \" string'\n", "let e ==> \"esc\\\nnewline\\\\\"\n", "\n\n   \t",
+        "x.y <= 3 != !z; [1, 2]\n", "let t ==> \"\"\n", "a=>b==c\n",
+    };
+    const std::string broken[] = {"\"unterminated\n", "@\n", "\\\n", std::string("a\0b\n", 4), "'\\"};
+
+    uint32_t seed = 12345;
+    auto random = [&seed](uint32_t n) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % n;
+    };
+    int differences = 0;
+    for (int round = 0; round < 150; ++round) {
+        std::string source;
+        int pieces = 1 + static_cast<int>(random(40));
+        for (int i = 0; i < pieces; ++i) {
+            source += random(25) == 0 ? broken[random(5)] : clean[random(9)];
+        }
+
+        common::Interner serial_symbols;
+        lexer::Lexer serial(source);
+        std::string expected = outcome(serial, serial_symbols);
+        size_t threads = 2 + random(7);
+        common::Interner parallel_symbols;
+        lexer::ParallelLexer parallel(source, threads, 1);
+        if (outcome(parallel, parallel_symbols) != expected) ++differences;
+        if (source.size() > 200 && source.find('\0') == std::string::npos &&
+            expected.find("error") == std::string::npos) {
+            CHECK(parallel.segments().size() > 1);
+        }
+    }
+    CHECK(differences == 0);
+
+    // Frontières hors chaîne, en début de ligne, lignes de départ exactes
+    std::string source = "let a ==> \"x\ny\nz\"\nlet b ==> 1\nlet c ==> 2\nlet d ==> 3\n";
+    auto segments = lexer::ParallelLexer::split(source, 4);
+    CHECK(segments.size() > 1 && segments.back().end == source.size());
+    for (const auto& segment : segments) {
+        CHECK(segment.begin == 0 || source[segment.begin - 1] == '\n');
+        CHECK(segment.begin == 0 || segment.begin > source.find("z\""));
+        CHECK(segment.line == 1 + std::count(source.begin(), source.begin() + segment.begin, '\n'));
+    }
+}
+
+static void test_parser_precedence() {
+    lexer::Lexer lex("1 + 2 * 3 == 7");
+    parser::Parser p(lex);
+    auto program = p.parse_program();
+    CHECK(program->statements.size() == 1);
+
+    auto* stmt = dynamic_cast<ast::ExpressionStatement*>(program->statements[0]);
+    auto* eq = stmt ? dynamic_cast<ast::BinaryExpression*>(stmt->expression) : nullptr;
+    CHECK(eq && eq->op == lexer::TokenType::EQ);
+    auto* sum = eq ? dynamic_cast<ast::BinaryExpression*>(eq->left) : nullptr;
+    CHECK(sum && sum->op == lexer::TokenType::PLUS);
+    auto* product = sum ? dynamic_cast<ast::BinaryExpression*>(sum->right) : nullptr;
+    CHECK(product && product->op == lexer::TokenType::STAR);
+}
+
+// Rendu textuel préfixe d'un FlatAst, pour comparer deux arbres plats
+static std::string dump(const ast::FlatAst& tree, ast::NodeId id) {
+    std::string out = "(" + std::to_string(static_cast<int>(tree.kind(id)));
+    ast::visit(tree, id, [&](ast::NodeId, const auto& node) {
+        using View = std::decay_t<decltype(node)>;
+        if constexpr (std::is_same_v<View, ast::FlatAst::Number>) out += " " + std::to_string(node.value);
+        if constexpr (std::is_same_v<View, ast::FlatAst::Ident>) out += " " + std::string(node.name.text);
+        if constexpr (std::is_same_v<View, ast::FlatAst::String>) out += " '" + std::string(node.value.text) + "'";
+        if constexpr (std::is_same_v<View, ast::FlatAst::VarDecl>) out += " " + std::string(node.name.text);
+        if constexpr (std::is_same_v<View, ast::FlatAst::Binary>) out += " op" + std::to_string(static_cast<int>(node.op));
+        if constexpr (std::is_same_v<View, ast::FlatAst::Function>) {
+            out += " " + std::string(node.name.text);
+            for (uint32_t param : node.parameters) out += " " + std::string(tree.symbol(param).text);
+        }
+    });
+    ast::for_each_child(tree, id, [&](ast::NodeId child) { out += " " + dump(tree, child); });
+    return out + ")";
+}
+
+static std::string dump(const ast::FlatAst& tree) {
+    std::string out;
+    for (ast::NodeId stmt : tree.statements) out += dump(tree, stmt) + "\n";
+    return out;
+}
+
+// Le Parser émet directement la forme plate ; elle doit coïncider avec la
+// conversion de l'arbre.
+static void test_flat_ast() {
+    const char* source =
+        "let x ==> 1 + 2 * -3\n"
+        "fi add(a, b) { let t ==> a + b\n return f(t, g(a), \"s\") }\n"
+        "add(x, 4) == 5\n";
+
+    lexer::Lexer tree_lexer(source);
+    auto program = parser::Parser(tree_lexer).parse_program();
+    ast::FlatAst converted = ast::flatten(*program);
+
+    lexer::Lexer flat_lexer(source);
+    ast::FlatAst direct = parser::Parser(flat_lexer).parse_flat_program();
+
+    CHECK(direct.statements.size() == 3);
+    CHECK(direct.size() == converted.size());
+    CHECK(dump(direct) == dump(converted));
+
+    auto fn = direct.function(direct.statements[1]);
+    CHECK(fn.name.text == "add" && fn.parameters.size() == 2);
+    CHECK(direct.kind(fn.body) == ast::NodeKind::BlockStatement);
+    CHECK(direct.block(fn.body).statements.size() == 2);
+
+    size_t identifiers = 0;
+    ast::walk(direct, [&](ast::NodeId id) { identifiers += direct.kind(id) == ast::NodeKind::Identifier; });
+    CHECK(identifiers == 8);
+
+    const int first_lines[] = {1, 2, 4};
+    for (size_t i = 0; i < direct.statements.size(); ++i) {
+        ast::SourceLocation a = direct.location(direct.statements[i]);
+        ast::SourceLocation b = converted.location(converted.statements[i]);
+        CHECK(a.line == first_lines[i] && a.column == 1 && b.line == a.line && b.column == a.column);
+    }
+}
+
+// Un symbole par texte distinct, partagé par le Lexer, le Parser et l'AST
+static void test_interner() {
+    common::Interner interner;
+    common::SymbolId x = interner.intern("x");
+    CHECK(interner.intern("x") == x);
+    CHECK(interner.intern("y") != x);
+    CHECK(interner.name(x) == "x");
+    CHECK(interner.hash(x) == common::Interner::hash_text("x"));
+    CHECK(!interner.find("absent").valid());
+
+    // Les vues restent valides malgré les agrandissements de la table
+    std::string_view first = interner.name(x);
+    for (int i = 0; i < 100000; ++i) interner.intern("sym" + std::to_string(i));
+    CHECK(interner.size() == 100002);
+    CHECK(interner.name(x).data() == first.data());
+    CHECK(interner.find("sym99999").valid());
+
+    interner.freeze();
+    CHECK(interner.intern("x") == x);
+    bool thrown = false;
+    try { interner.intern("nouveau"); } catch (const std::logic_error&) { thrown = true; }
+    CHECK(thrown);
+
+    // Les tokens portent l'identifiant ; les mêmes noms donnent les mêmes ids
+    lexer::Lexer lexer("let total ==> total + \"total\"\nfi f(total) { return total }");
+    parser::Parser parser(lexer);
+    auto program = parser.parse_program();
+    auto* decl = ast::node_cast<ast::VariableDeclaration>(program->statements[0]);
+    auto* fn = ast::node_cast<ast::FunctionDeclaration>(program->statements[1]);
+    CHECK(decl && fn && program->symbols == parser.interner());
+    if (decl && fn) {
+        auto* sum = ast::node_cast<ast::BinaryExpression>(decl->value);
+        auto* use = sum ? ast::node_cast<ast::Identifier>(sum->left) : nullptr;
+        auto* text = sum ? ast::node_cast<ast::StringLiteral>(sum->right) : nullptr;
+        CHECK(use && use->name == decl->name);
+        CHECK(text && text->value == decl->name && text->value.text == "total");
+        CHECK(fn->parameters.size() == 1 && fn->parameters[0] == decl->name);
+        CHECK(program->symbols->find("total") == decl->name.id);
+    }
+}
+
+static std::vector<compiler::OpCode> opcodes(const compiler::Chunk& chunk) {
+    std::vector<compiler::OpCode> ops;
+    for (size_t offset = 0; offset < chunk.code.size();) {
+        auto op = static_cast<compiler::OpCode>(chunk.code[offset]);
+        ops.push_back(op);
+        offset += compiler::instruction_size(op);
+    }
+    return ops;
+}
+
+// Globales au premier niveau, locales dans les fonctions, builtins dédiés
+static void test_compiler() {
+    using compiler::OpCode;
+    const char* source =
+        "let x ==> 1 + 2 * 3\n"
+        "fi add(a, b) { let t ==> a + b\n return t }\n"
+        "init.log(add(x, 1) <= 7, \"ok\")\n";
+
+    lexer::Lexer lexer(source);
+    auto program = parser::Parser(lexer).parse_program();
+    runtime::Heap heap;
+    compiler::Compiler compiler(heap);
+    runtime::ObjFunction* script = compiler.compile(*program);
+
+    std::vector<OpCode> expected = {
+        OpCode::OP_CONSTANT, OpCode::OP_CONSTANT, OpCode::OP_CONSTANT, OpCode::OP_MULTIPLY, OpCode::OP_ADD,
+        OpCode::OP_DEFINE_GLOBAL,
+        OpCode::OP_CONSTANT, OpCode::OP_DEFINE_GLOBAL,
+        OpCode::OP_GET_GLOBAL, OpCode::OP_GET_GLOBAL, OpCode::OP_CONSTANT, OpCode::OP_CALL,
+        OpCode::OP_CONSTANT, OpCode::OP_LESS_EQUAL, OpCode::OP_CONSTANT, OpCode::OP_INIT_LOG, OpCode::OP_POP,
+        OpCode::OP_NULL, OpCode::OP_RETURN,
+    };
+    CHECK(opcodes(script->chunk) == expected);
+    CHECK(compiler.bytes_emitted() > script->chunk.code.size());
+
+    // La constante 1 est partagée entre `1 + 2 * 3` et `add(x, 1)` ; les
+    // noms de globales ne sont pas des constantes mais des identifiants
+    CHECK(script->chunk.constants.size() == 6);
+    CHECK(heap.global_count() == 2 && heap.global_name(0)->view() == "x" && heap.global_name(1)->view() == "add");
+
+    const runtime::ObjFunction* add = nullptr;
+    for (auto constant : script->chunk.constants) {
+        if (runtime::is_function(constant)) add = runtime::as_function(constant);
+    }
+    CHECK(add && add->arity == 2 && add->name->view() == "add");
+    if (add) {
+        std::vector<OpCode> body = {
+            OpCode::OP_GET_LOCAL, OpCode::OP_GET_LOCAL, OpCode::OP_ADD,
+            OpCode::OP_GET_LOCAL, OpCode::OP_RETURN, OpCode::OP_NULL, OpCode::OP_RETURN,
+        };
+        CHECK(opcodes(add->chunk) == body);
+        CHECK(add->chunk.code[1] == 1 && add->chunk.code[3] == 2 && add->chunk.code[6] == 3);
+        CHECK(add->chunk.max_stack == 5); // appelé, a, b, t, puis t relu
+    }
+    CHECK(script->chunk.max_stack == 4);
+
+    std::string listing = compiler::disassemble(*script, &heap);
+    CHECK(listing.find("== <script> ==") != std::string::npos);
+    CHECK(listing.find("== add ==") != std::string::npos);
+    CHECK(listing.find("OP_DEFINE_GLOBAL         0 'x'") != std::string::npos);
+    CHECK(listing.find("OP_GET_GLOBAL            1 'add'") != std::string::npos);
+
+    // Au-delà de 255 constantes, encodage sur 3 octets
+    std::string many;
+    for (int i = 0; i < 300; ++i) many += "let g" + std::to_string(i) + " ==> " + std::to_string(i) + "\n";
+    lexer::Lexer many_lexer(many);
+    auto many_program = parser::Parser(many_lexer).parse_program();
+    auto ops = opcodes(compiler.compile(*many_program)->chunk);
+    CHECK(ops.size() == 602);
+    CHECK(ops[0] == OpCode::OP_CONSTANT && ops[599] == OpCode::OP_DEFINE_GLOBAL_LONG);
+
+    bool thrown = false;
+    lexer::Lexer bad_lexer("return 1");
+    auto bad = parser::Parser(bad_lexer).parse_program();
+    try { compiler.compile(*bad); } catch (const std::runtime_error&) { thrown = true; }
+    CHECK(thrown);
+
+    // Arguments imbriqués : la hauteur de pile dépasserait la fenêtre d'une trame
+    std::string nested = "0";
+    for (int i = 0; i < 300; ++i) {
+        std::string call = "init.ger(";
+        for (int j = 0; j < 254; ++j) call += "0, ";
+        nested = call + nested + ")";
+    }
+    lexer::Lexer deep_lexer("init.log(" + nested + ")\n");
+    auto deep = parser::Parser(deep_lexer).parse_program();
+    std::string message;
+    try { compiler.compile(*deep); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("expression too deep") != std::string::npos);
+}
+
+// Résolution des noms : slots, captures, globales
+static void test_resolver() {
+    const char* source =
+        "let g ==> 1\n"
+        "fi outer(a, b) {\n"
+        "  let c ==> a\n"
+        "  let d ==> b + c\n"
+        "  fi middle() { fi inner() { return a + c + g } return inner }\n"
+        "  return middle\n"
+        "}\n";
+
+    lexer::Lexer lexer(source);
+    auto program = parser::Parser(lexer).parse_program();
+    compiler::Resolver(*program).resolve();
+
+    auto* g = static_cast<ast::VariableDeclaration*>(program->statements[0]);
+    auto* outer = static_cast<ast::FunctionDeclaration*>(program->statements[1]);
+    CHECK(g->resolved.binding == ast::Binding::Global && outer->resolved.binding == ast::Binding::Global);
+
+    // Slots : 0 appelé, 1-2 paramètres, puis c, d, middle
+    auto& body = outer->body->statements;
+    auto* c = static_cast<ast::VariableDeclaration*>(body[0]);
+    auto* d = static_cast<ast::VariableDeclaration*>(body[1]);
+    auto* middle = static_cast<ast::FunctionDeclaration*>(body[2]);
+    CHECK(c->resolved.binding == ast::Binding::Local && c->resolved.index == 3);
+    CHECK(d->resolved.binding == ast::Binding::Local && d->resolved.index == 4);
+    CHECK(middle->resolved.binding == ast::Binding::Local && middle->resolved.index == 5);
+    CHECK(outer->body->local_count == 3 && outer->slot_count == 6 && outer->upvalues.size() == 0);
+
+    auto* sum = static_cast<ast::BinaryExpression*>(d->value);
+    CHECK(static_cast<ast::Identifier*>(sum->left)->resolved.index == 2);
+    CHECK(static_cast<ast::Identifier*>(sum->right)->resolved.index == 3);
+
+    // inner capture a et c à travers middle
+    auto* inner = static_cast<ast::FunctionDeclaration*>(middle->body->statements[0]);
+    CHECK(middle->upvalues.size() == 2 && middle->upvalues[0].is_local && middle->upvalues[0].index == 1);
+    CHECK(middle->upvalues[1].is_local && middle->upvalues[1].index == 3);
+    CHECK(inner->upvalues.size() == 2 && !inner->upvalues[0].is_local && inner->upvalues[1].index == 1);
+    auto* ret = static_cast<ast::ReturnStatement*>(inner->body->statements[0]);
+    auto* plus = static_cast<ast::BinaryExpression*>(ret->value);
+    auto* a_plus_c = static_cast<ast::BinaryExpression*>(plus->left);
+    CHECK(static_cast<ast::Identifier*>(a_plus_c->left)->resolved.binding == ast::Binding::Upvalue);
+    CHECK(static_cast<ast::Identifier*>(a_plus_c->right)->resolved.index == 1);
+    CHECK(static_cast<ast::Identifier*>(plus->right)->resolved.binding == ast::Binding::Global);
+
+    // Le compilateur refuse les captures tant que les fermetures n'existent pas
+    runtime::Heap heap;
+    std::string message;
+    try { compiler::Compiler(heap).compile(*program); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("[line 5:") != std::string::npos && message.find("cannot capture local 'a'") != std::string::npos);
+
+    lexer::Lexer dup_lexer("fi f(x) { let x ==> 1 }");
+    auto dup = parser::Parser(dup_lexer).parse_program();
+    message.clear();
+    try { compiler::Resolver(*dup).resolve(); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("'x' is already declared") != std::string::npos);
+}
+
+// Passes de l'optimiseur : résultat de chaque passe, puis même exécution
+// qu'au niveau 0
+static void test_optimizer() {
+    const char* source =
+        "fi sq(x) { return x * x }\n"
+        "fi fact(n) { return n * fact(n - 1) }\n"
+        "fi early(a) {\n  return a + 1\n  init.log(a)\n}\n"
+        "let k ==> 2 * -3 + 1\n"
+        "let s ==> \"k=\" + (1 / 4)\n"
+        "let q ==> sq(k) + sq(\"x\" + 1, 2)\n"
+        "fi shadow(sq) { return sq(3) }\n"
+        "let r ==> sq(4) - early(k)\n";
+
+    lexer::Lexer lexer(source);
+    auto program = parser::Parser(lexer).parse_program();
+    size_t before = optimizer::count_nodes(*program);
+
+    auto fold = optimizer::optimize(*program, 1);
+    CHECK(fold.size() == 2 && std::string(fold[0].name) == "fold" && std::string(fold[1].name) == "dce");
+    CHECK(fold[0].nodes_before == before && fold[1].nodes_after == optimizer::count_nodes(*program));
+    CHECK(fold[1].rewrites == 1 && fold[1].nodes_removed() == 4);
+
+    auto* k = ast::node_cast<ast::NumberLiteral>(static_cast<ast::VariableDeclaration*>(program->statements[3])->value);
+    CHECK(k && k->value == -5);
+    auto* s = ast::node_cast<ast::StringLiteral>(static_cast<ast::VariableDeclaration*>(program->statements[4])->value);
+    CHECK(s && s->value.text == "k=0.25");
+    auto* early = static_cast<ast::FunctionDeclaration*>(program->statements[2]);
+    CHECK(early->body->statements.size() == 1);
+
+    auto stats = optimizer::optimize(*program, 2);
+    CHECK(stats.size() == 3 && std::string(stats[1].name) == "inline");
+    CHECK(stats[1].rewrites == 3); // sq(k), sq(4), early(k) ; pas fact, sq à deux arguments, ni shadow
+
+    auto* q = static_cast<ast::VariableDeclaration*>(program->statements[5]);
+    auto* q_sum = static_cast<ast::BinaryExpression*>(q->value);
+    CHECK(q_sum->left->kind == ast::NodeKind::BinaryExpression && q_sum->right->kind == ast::NodeKind::CallExpression);
+    auto* r = ast::node_cast<ast::BinaryExpression>(static_cast<ast::VariableDeclaration*>(program->statements[7])->value);
+    CHECK(r && ast::node_cast<ast::NumberLiteral>(r->left) && ast::node_cast<ast::NumberLiteral>(r->left)->value == 16);
+    auto* fact = static_cast<ast::FunctionDeclaration*>(program->statements[1]);
+    auto* fact_ret = static_cast<ast::ReturnStatement*>(fact->body->statements[0]);
+    CHECK(static_cast<ast::BinaryExpression*>(fact_ret->value)->right->kind == ast::NodeKind::CallExpression);
+    auto* shadow = static_cast<ast::FunctionDeclaration*>(program->statements[6]);
+    CHECK(static_cast<ast::ReturnStatement*>(shadow->body->statements[0])->value->kind == ast::NodeKind::CallExpression);
+
+    // Même résultat qu'au niveau 0, erreurs comprises
+    const char* checked =
+        "fi sq(x) { return x * x }\n"
+        "fi cube(x) { return sq(x) * x }\n"
+        "fi greet(name) { return \"hi \" + name }\n"
+        "let a ==> cube(3) + sq(2 - 5) / 2\n"
+        "let g ==> greet(\"n\" + a)\n";
+    for (int level = 0; level <= optimizer::Optimizer::MAX_LEVEL; ++level) {
+        lexer::Lexer level_lexer(checked);
+        auto level_program = parser::Parser(level_lexer).parse_program();
+        optimizer::optimize(*level_program, level);
+        runtime::Heap heap;
+        vm::VM machine(heap);
+        machine.interpret(compiler::Compiler(heap).compile(*level_program));
+        CHECK(machine.global("a").is_number() && machine.global("a").as_number() == 31.5);
+        CHECK(runtime::to_string(machine.global("g")) == "hi n31.5");
+
+        lexer::Lexer bad_lexer("fi sq(x) { return x * x }\nlet z ==> sq(\"s\")\n");
+        auto bad = parser::Parser(bad_lexer).parse_program();
+        optimizer::optimize(*bad, level);
+        std::string message;
+        try { machine.interpret(compiler::Compiler(heap).compile(*bad)); } catch (const std::runtime_error& e) { message = e.what(); }
+        CHECK(message.find("Operands must be numbers") != std::string::npos);
+    }
+}
+
+// Peephole : threading des sauts, code mort, superinstructions, positions
+static void test_peephole() {
+    using compiler::OpCode;
+    using runtime::Value;
+
+    // i = 0 ; tant que i < n : i = i + 1 ; rend i. Chaînes de sauts et code
+    // mort ajoutés à la main.
+    auto build = [](runtime::Heap& heap, Value limit) {
+        runtime::ObjFunction* script = heap.new_function();
+        compiler::Chunk& c = script->chunk;
+        auto jump = [&](OpCode op, size_t to) {
+            size_t next = c.code.size() + 3;
+            size_t distance = op == OpCode::OP_LOOP ? next - to : to - next;
+            c.write(op, 2);
+            c.write(static_cast<uint8_t>(distance & 0xFF), 2);
+            c.write(static_cast<uint8_t>(distance >> 8), 2);
+        };
+        c.write(OpCode::OP_CONSTANT, 1); c.write(static_cast<uint8_t>(c.add_constant(Value::number(0))), 1);
+        c.write(OpCode::OP_GET_LOCAL, 2); c.write(1, 2);                                      // 2
+        c.write(OpCode::OP_CONSTANT, 2); c.write(static_cast<uint8_t>(c.add_constant(limit)), 2);
+        c.write(OpCode::OP_LESS, 2, 5);
+        jump(OpCode::OP_JUMP_IF_FALSE, 25);                                                   // 7
+        c.write(OpCode::OP_GET_LOCAL, 3); c.write(1, 3);
+        c.write(OpCode::OP_CONSTANT, 3); c.write(static_cast<uint8_t>(c.add_constant(Value::number(1))), 3);
+        c.write(OpCode::OP_ADD, 3, 7);
+        c.write(OpCode::OP_SET_LOCAL, 3); c.write(1, 3);
+        c.write(OpCode::OP_POP, 3);
+        jump(OpCode::OP_JUMP, 22);                                                            // 18
+        c.write(OpCode::OP_NULL, 4);
+        jump(OpCode::OP_LOOP, 2);                                                             // 22
+        jump(OpCode::OP_JUMP, 29);                                                            // 25
+        c.write(OpCode::OP_NULL, 4);
+        c.write(OpCode::OP_GET_LOCAL, 5); c.write(1, 5);                                      // 29
+        c.write(OpCode::OP_RETURN, 5);
+        c.write(OpCode::OP_NULL, 6);
+        c.write(OpCode::OP_RETURN, 6);
+        return script;
+    };
+
+    runtime::Heap heap;
+    runtime::ObjFunction* loop = build(heap, Value::number(5));
+    compiler::PeepholeStats stats = compiler::optimize_bytecode(*loop);
+    CHECK(stats.bytes_before == 34 && stats.bytes_after == 20 && stats.bytes_after == loop->chunk.code.size());
+    CHECK(stats.threaded_jumps == 2 && stats.dead_instructions == 6 && stats.fused == 4);
+    CHECK((opcodes(loop->chunk) == std::vector<OpCode>{
+        OpCode::OP_CONSTANT, OpCode::OP_GET_LOCAL, OpCode::OP_CONSTANT, OpCode::OP_JUMP_IF_NOT_LESS,
+        OpCode::OP_GET_LOCAL, OpCode::OP_ADD_CONSTANT, OpCode::OP_SET_LOCAL_POP, OpCode::OP_LOOP,
+        OpCode::OP_RETURN_LOCAL}));
+    // Dernier octet d'une superinstruction : position de la composante fautive
+    CHECK(loop->chunk.position(6).line == 2 && loop->chunk.position(8).column == 5);
+    CHECK(loop->chunk.position(11).line == 3 && loop->chunk.position(12).column == 7);
+    CHECK(compiler::disassemble(loop->chunk, "loop").find("OP_LOOP                 16 -> 2") != std::string::npos);
+
+    for (vm::Dispatch dispatch : {vm::Dispatch::Switch, vm::Dispatch::Threaded}) {
+        vm::VM machine(heap);
+        machine.set_dispatch(dispatch);
+        Value result = machine.interpret(loop);
+        CHECK(result.is_number() && result.as_number() == 5);
+    }
+
+    vm::VM machine(heap);
+    std::string message;
+    runtime::ObjFunction* bad_loop = build(heap, Value::null());
+    compiler::optimize_bytecode(*bad_loop);
+    try { machine.interpret(bad_loop); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("Operands must be numbers") != std::string::npos && message.find("[line 2:5]") != std::string::npos);
+
+    // Code compilé : code mort final retiré, mêmes traces d'erreur
+    lexer::Lexer bad_lexer("fi f(a) { return a - \"x\" }\nf(1)\n");
+    auto bad = parser::Parser(bad_lexer).parse_program();
+    runtime::ObjFunction* script = compiler::Compiler(heap).compile(*bad);
+    stats = compiler::optimize_bytecode(*script);
+    CHECK(stats.fused == 1 && stats.dead_instructions == 2);
+    message.clear();
+    try { machine.interpret(script); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("[line 1:20] in f()") != std::string::npos);
+    CHECK(message.find("[line 2:2] in script") != std::string::npos);
+}
+
+// Quickening : spécialisation après échauffement, retour au générique sur
+// changement de type, code emprunté recopié sans perdre les trames en cours
+static void test_quickening() {
+    using compiler::OpCode;
+    using runtime::Value;
+
+    auto first_op = [](Value function, OpCode op) {
+        const compiler::Chunk& chunk = runtime::as_function(function)->chunk;
+        for (size_t offset = 0; offset < chunk.code.size(); offset += compiler::instruction_size(OpCode(chunk.code[offset]))) {
+            OpCode at = static_cast<OpCode>(chunk.code[offset]);
+            if (compiler::generic_opcode(at) == op) return at;
+        }
+        return OpCode::OP_COUNT_;
+    };
+
+    std::string source = "fi add(a, b) { return a + b }\nfi cat(a, b) { return a + b }\n";
+    for (int i = 0; i < 10; ++i) source += "let n" + std::to_string(i) + " ==> add(" + std::to_string(i) + ", 1)\n";
+    for (int i = 0; i < 10; ++i) source += "let c" + std::to_string(i) + " ==> cat(\"a\", n" + std::to_string(i) + " + \"\")\n";
+
+    runtime::Heap heap;
+    lexer::Lexer lexer(source);
+    auto program = parser::Parser(lexer).parse_program();
+    runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+
+    // Le quickening est propre à l'interpréteur
+    vm::VM machine(heap);
+    machine.set_jit_threshold(0);
+    machine.interpret(script);
+    CHECK(machine.global("n9").as_number() == 10);
+    CHECK(runtime::to_string(machine.global("c9")) == "a10");
+    // add, cat ; pas `n + ""` du script, exécuté une fois par site
+    CHECK(machine.quickening_stats().specialized == 2 && machine.quickening_stats().deoptimized == 0);
+    CHECK(first_op(machine.global("add"), OpCode::OP_ADD) == OpCode::OP_ADD_NUM_NUM);
+    CHECK(first_op(machine.global("cat"), OpCode::OP_ADD) == OpCode::OP_ADD_STR_STR);
+
+    // Changement de type : retour à OP_ADD, résultat correct, site polymorphe
+    lexer::Lexer strings_lexer("let s ==> add(\"a\", \"b\")\nlet t ==> add(1, 2)\n");
+    auto strings = parser::Parser(strings_lexer).parse_program();
+    machine.interpret(compiler::Compiler(heap).compile(*strings));
+    CHECK(runtime::to_string(machine.global("s")) == "ab" && machine.global("t").as_number() == 3);
+    CHECK(machine.quickening_stats().deoptimized == 1);
+    CHECK(first_op(machine.global("add"), OpCode::OP_ADD) == OpCode::OP_ADD);
+
+    // Sans quickening, le code reste générique
+    runtime::Heap plain_heap;
+    lexer::Lexer plain_lexer(source);
+    auto plain = parser::Parser(plain_lexer).parse_program();
+    vm::VM plain_machine(plain_heap);
+    plain_machine.set_jit_threshold(0);
+    plain_machine.set_quickening(false);
+    plain_machine.interpret(compiler::Compiler(plain_heap).compile(*plain));
+    CHECK(plain_machine.quickening_stats().specialized == 0);
+    CHECK(first_op(plain_machine.global("add"), OpCode::OP_ADD) == OpCode::OP_ADD);
+
+    // fi f(n) { if n < 1 { return n } return f(n - 1) + 1 }, code emprunté.
+    // À la libération, le buffer d'origine est rempli d'opcodes invalides :
+    // une trame restée dessus échouerait.
+    runtime::Heap borrowed_heap;
+    runtime::ObjFunction* f = borrowed_heap.new_function();
+    f->arity = 1;
+    f->name = borrowed_heap.intern("f");
+    uint8_t id = static_cast<uint8_t>(borrowed_heap.global_id(f->name));
+    compiler::Chunk& c = f->chunk;
+    uint8_t one = static_cast<uint8_t>(c.add_constant(Value::number(1)));
+    const uint8_t body[] = {
+        uint8_t(OpCode::OP_GET_LOCAL), 1, uint8_t(OpCode::OP_CONSTANT), one, uint8_t(OpCode::OP_LESS),
+        uint8_t(OpCode::OP_JUMP_IF_FALSE), 3, 0,
+        uint8_t(OpCode::OP_GET_LOCAL), 1, uint8_t(OpCode::OP_RETURN),
+        uint8_t(OpCode::OP_GET_GLOBAL), id, uint8_t(OpCode::OP_GET_LOCAL), 1, uint8_t(OpCode::OP_CONSTANT), one,
+        uint8_t(OpCode::OP_SUBTRACT), uint8_t(OpCode::OP_CALL), 1, uint8_t(OpCode::OP_CONSTANT), one,
+        uint8_t(OpCode::OP_ADD), uint8_t(OpCode::OP_RETURN),
+    };
+    for (uint8_t byte : body) c.write(byte, 1);
+    auto bytes = std::make_shared<std::vector<uint8_t>>(body, body + sizeof(body));
+    std::shared_ptr<const void> owner(bytes.get(), [bytes](const void*) { std::fill(bytes->begin(), bytes->end(), 0xFF); });
+    c.code.borrow(bytes->data(), bytes->size(), owner);
+    owner.reset();
+
+    runtime::ObjFunction* call = borrowed_heap.new_function();
+    compiler::Chunk& m = call->chunk;
+    uint8_t fn = static_cast<uint8_t>(m.add_constant(Value::object(f)));
+    uint8_t twenty = static_cast<uint8_t>(m.add_constant(Value::number(20)));
+    const uint8_t main_code[] = {
+        uint8_t(OpCode::OP_CONSTANT), fn, uint8_t(OpCode::OP_DEFINE_GLOBAL), id,
+        uint8_t(OpCode::OP_GET_GLOBAL), id, uint8_t(OpCode::OP_CONSTANT), twenty, uint8_t(OpCode::OP_CALL), 1,
+        uint8_t(OpCode::OP_RETURN),
+    };
+    for (uint8_t byte : main_code) m.write(byte, 1);
+
+    vm::VM borrowed_machine(borrowed_heap);
+    borrowed_machine.set_jit_threshold(0);
+    borrowed_machine.set_dispatch(vm::Dispatch::Switch);
+    Value result = Value::null();
+    try { result = borrowed_machine.interpret(call); } catch (const std::runtime_error&) {}
+    CHECK(result.is_number() && result.as_number() == 20);
+    CHECK(!f->chunk.code.is_borrowed() && bytes->front() == 0xFF);
+    CHECK(borrowed_machine.quickening_stats().specialized == 3); // OP_LESS, OP_SUBTRACT, OP_ADD
+}
+
+// Appels terminaux : trame réutilisée, récursion profonde en pile
+// constante ; débordement localisé sinon
+static void test_tail_calls() {
+    using compiler::OpCode;
+    using runtime::Value;
+
+    lexer::Lexer lexer(
+        "fi f(x) { return x }\n"
+        "fi g(x) { return f(x) }\n"
+        "fi h(x) { return f(x) + 1 }\n"
+        "fi k(x) { return init.ger(x) }\n"
+        "let r ==> g(1) + h(1) + k(1)\n");
+    auto program = parser::Parser(lexer).parse_program();
+    runtime::Heap heap;
+    runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+    auto chunk_of = [&](size_t constant) { return runtime::as_function(script->chunk.constants[constant])->chunk; };
+    auto has = [&](const compiler::Chunk& chunk, OpCode op) {
+        auto ops = opcodes(chunk);
+        return std::find(ops.begin(), ops.end(), op) != ops.end();
+    };
+    CHECK(has(chunk_of(1), OpCode::OP_TAIL_CALL) && !has(chunk_of(1), OpCode::OP_CALL));
+    CHECK(has(chunk_of(2), OpCode::OP_CALL) && !has(chunk_of(2), OpCode::OP_TAIL_CALL));
+    CHECK(has(chunk_of(3), OpCode::OP_INIT_GER) && !has(chunk_of(3), OpCode::OP_TAIL_CALL));
+    vm::VM machine(heap);
+    machine.interpret(script);
+    CHECK(machine.global("r").as_number() == 4);
+
+    // fi down(n) { if n < 1 { return n } return down(n - 1) }, en appel
+    // terminal ou non, lancé sur 100000 niveaux avec 64 trames
+    auto build = [](runtime::Heap& h, OpCode call) {
+        runtime::ObjFunction* down = h.new_function();
+        down->arity = 1;
+        down->name = h.intern("down");
+        uint8_t id = static_cast<uint8_t>(h.global_id(down->name));
+        uint8_t one = static_cast<uint8_t>(down->chunk.add_constant(Value::number(1)));
+        std::vector<uint8_t> body = {
+            uint8_t(OpCode::OP_GET_LOCAL), 1, uint8_t(OpCode::OP_CONSTANT), one, uint8_t(OpCode::OP_LESS),
+            uint8_t(OpCode::OP_JUMP_IF_FALSE), 3, 0,
+            uint8_t(OpCode::OP_GET_LOCAL), 1, uint8_t(OpCode::OP_RETURN),
+            uint8_t(OpCode::OP_GET_GLOBAL), id, uint8_t(OpCode::OP_GET_LOCAL), 1, uint8_t(OpCode::OP_CONSTANT), one,
+            uint8_t(OpCode::OP_SUBTRACT), uint8_t(call), 1,
+        };
+        if (call == OpCode::OP_CALL) body.push_back(uint8_t(OpCode::OP_RETURN));
+        for (uint8_t byte : body) down->chunk.write(byte, 2, 3);
+
+        runtime::ObjFunction* main = h.new_function();
+        compiler::Chunk& m = main->chunk;
+        uint8_t fn = static_cast<uint8_t>(m.add_constant(Value::object(down)));
+        uint8_t depth = static_cast<uint8_t>(m.add_constant(Value::number(100000)));
+        const uint8_t code[] = {
+            uint8_t(OpCode::OP_CONSTANT), fn, uint8_t(OpCode::OP_DEFINE_GLOBAL), id,
+            uint8_t(OpCode::OP_GET_GLOBAL), id, uint8_t(OpCode::OP_CONSTANT), depth, uint8_t(OpCode::OP_CALL), 1,
+            uint8_t(OpCode::OP_RETURN),
+        };
+        for (uint8_t byte : code) m.write(byte, 7, 1);
+        return main;
+    };
+
+    runtime::Heap deep_heap;
+    vm::VM deep(deep_heap, 64);
+    CHECK(deep.max_frames() == 64);
+    for (vm::Dispatch dispatch : {vm::Dispatch::Switch, vm::Dispatch::Threaded}) {
+        deep.set_dispatch(dispatch);
+        Value result = deep.interpret(build(deep_heap, OpCode::OP_TAIL_CALL));
+        CHECK(result.is_number() && result.as_number() == 0);
+    }
+
+    std::string message;
+    try { deep.interpret(build(deep_heap, OpCode::OP_CALL)); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("Stack overflow (64 nested calls)") != std::string::npos);
+    CHECK(message.find("[line 2:3] in down()") != std::string::npos);
+    CHECK(message.find("... 48 more frames") != std::string::npos);
+    CHECK(message.find("[line 7:1] in script") != std::string::npos);
+    CHECK(std::count(message.begin(), message.end(), '\n') == 12 + 1 + 4); // 16 trames et la ligne « ... »
+}
+
+// JIT : encodage, résultats identiques à l'interpréteur (valeurs, sorties,
+// erreurs et leurs positions), entrée en cours de boucle, repli sur les
+// fonctions non traduites
+static void test_jit() {
+    using compiler::OpCode;
+    using runtime::Value;
+
+    jit::Assembler as;
+    as.load(jit::RAX, jit::R12, -8);      // mov rax, [r12 - 8]
+    as.store(jit::RBX, 16, jit::RCX);     // mov [rbx + 16], rcx
+    as.movq(jit::XMM1, jit::R15);         // movq xmm1, r15
+    as.push(jit::R13);
+    as.ret();
+    CHECK((as.code() == std::vector<uint8_t>{0x49, 0x8B, 0x84, 0x24, 0xF8, 0xFF, 0xFF, 0xFF,
+                                             0x48, 0x89, 0x8B, 0x10, 0x00, 0x00, 0x00,
+                                             0x66, 0x49, 0x0F, 0x6E, 0xCF, 0x41, 0x55, 0xC3}));
+
+    // Assemblage à la main : le langage n'a ni boucle ni conditionnelle
+    struct Builder {
+        runtime::Heap& heap;
+        runtime::ObjFunction* function;
+        int line = 1;
+
+        Builder(runtime::Heap& h, const char* name, int arity) : heap(h), function(h.new_function()) {
+            function->arity = arity;
+            if (name) function->name = heap.intern(name);
+        }
+        Builder& op(OpCode code) { function->chunk.write(code, line); return *this; }
+        Builder& op(OpCode code, uint8_t operand) { op(code); function->chunk.write(operand, line); return *this; }
+        Builder& constant(Value value) {
+            return op(OpCode::OP_CONSTANT, static_cast<uint8_t>(function->chunk.add_constant(value)));
+        }
+        Builder& number(double value) { return constant(Value::number(value)); }
+        Builder& global(OpCode code, const char* name) {
+            return op(code, static_cast<uint8_t>(heap.global_id(heap.intern(name))));
+        }
+        size_t here() const { return function->chunk.code.size(); }
+        size_t jump(OpCode code) {
+            op(code);
+            function->chunk.write(0, line);
+            function->chunk.write(0, line);
+            return here() - 2;
+        }
+        void patch(size_t operand) {
+            size_t offset = here() - operand - 2;
+            function->chunk.code[operand] = static_cast<uint8_t>(offset & 0xFF);
+            function->chunk.code[operand + 1] = static_cast<uint8_t>(offset >> 8);
+        }
+        void loop(size_t start) {
+            op(OpCode::OP_LOOP);
+            size_t offset = here() + 2 - start;
+            function->chunk.write(static_cast<uint8_t>(offset & 0xFF), line);
+            function->chunk.write(static_cast<uint8_t>(offset >> 8), line);
+        }
+    };
+
+    // acc = start ; for (i = 0; i < n; i = i + 1) acc = acc + i * step ; rend acc
+    auto sum_loop = [](runtime::Heap& heap, Value start, double n, Value step) {
+        Builder script(heap, nullptr, 0);
+        script.number(0).constant(start);
+        size_t head = script.here();
+        script.line = 2;
+        script.op(OpCode::OP_GET_LOCAL, 1).number(n).op(OpCode::OP_LESS);
+        size_t exit = script.jump(OpCode::OP_JUMP_IF_FALSE);
+        script.line = 3;
+        script.op(OpCode::OP_GET_LOCAL, 2).op(OpCode::OP_GET_LOCAL, 1).constant(step).op(OpCode::OP_MULTIPLY)
+              .op(OpCode::OP_ADD).op(OpCode::OP_SET_LOCAL, 2).op(OpCode::OP_POP);
+        script.op(OpCode::OP_GET_LOCAL, 1).number(1).op(OpCode::OP_ADD).op(OpCode::OP_SET_LOCAL, 1).op(OpCode::OP_POP);
+        script.loop(head);
+        script.patch(exit);
+        script.op(OpCode::OP_GET_LOCAL, 2).op(OpCode::OP_RETURN);
+        return script.function;
+    };
+
+    // fi fib(n) { if n < 2 { return n } return fib(n - 1) + fib(n - 2) } ;
+    // puis tests de NaN, de négation et de vérité sur le résultat
+    auto fib = [](runtime::Heap& heap, double n) {
+        Builder f(heap, "fib", 1);
+        f.op(OpCode::OP_GET_LOCAL, 1).number(2).op(OpCode::OP_LESS);
+        size_t recurse = f.jump(OpCode::OP_JUMP_IF_FALSE);
+        f.op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_RETURN);
+        f.patch(recurse);
+        f.line = 2;
+        f.global(OpCode::OP_GET_GLOBAL, "fib").op(OpCode::OP_GET_LOCAL, 1).number(1)
+         .op(OpCode::OP_SUBTRACT).op(OpCode::OP_CALL, 1);
+        f.global(OpCode::OP_GET_GLOBAL, "fib").op(OpCode::OP_GET_LOCAL, 1).number(2)
+         .op(OpCode::OP_SUBTRACT).op(OpCode::OP_CALL, 1);
+        f.op(OpCode::OP_ADD).op(OpCode::OP_RETURN);
+
+        Builder script(heap, nullptr, 0);
+        volatile double zero = 0;
+        script.constant(Value::object(f.function)).global(OpCode::OP_DEFINE_GLOBAL, "fib");
+        script.global(OpCode::OP_GET_GLOBAL, "fib").number(n).op(OpCode::OP_CALL, 1);
+        script.op(OpCode::OP_GET_LOCAL, 1).number(zero / zero).op(OpCode::OP_LESS)
+              .op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_NOT_EQUAL)
+              .op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_NEGATE).op(OpCode::OP_NOT)
+              .op(OpCode::OP_NULL).op(OpCode::OP_NOT).op(OpCode::OP_GET_LOCAL, 1).number(1e9).op(OpCode::OP_GREATER)
+              .op(OpCode::OP_INIT_LOG, 5);
+        script.op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_RETURN);
+        return script.function;
+    };
+
+    struct Outcome {
+        std::string result;
+        std::string log;
+        std::string error;
+        jit::Stats stats;
+    };
+    auto run = [](auto build, uint32_t threshold, size_t max_frames) {
+        runtime::Heap heap;
+        runtime::ObjFunction* script = build(heap);
+        vm::VM machine(heap, max_frames);
+        machine.set_jit_threshold(threshold);
+        std::FILE* log = std::tmpfile();
+        machine.set_log_output(log);
+        Outcome out;
+        try {
+            Value value = machine.interpret(script);
+            out.result = runtime::to_string(value) + " r=" + runtime::to_string(machine.global("r"));
+        } catch (const std::runtime_error& e) { out.error = e.what(); }
+        std::rewind(log);
+        char chunk[256];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), log)) > 0) out.log.append(chunk, read);
+        std::fclose(log);
+        out.stats = machine.jit_stats();
+        return out;
+    };
+    auto source = [](const char* text) {
+        return [text](runtime::Heap& heap) {
+            lexer::Lexer lexer(text);
+            auto program = parser::Parser(lexer).parse_program();
+            return compiler::Compiler(heap).compile(*program);
+        };
+    };
+    auto peephole = [](auto build) {
+        return [build](runtime::Heap& heap) {
+            runtime::ObjFunction* script = build(heap);
+            compiler::optimize_bytecode(*script);
+            return script;
+        };
+    };
+
+    struct Case {
+        const char* name;
+        std::function<runtime::ObjFunction*(runtime::Heap&)> build;
+        size_t max_frames;
+        bool jitted;  // au moins une fonction traduite sous le JIT
+    };
+    const Case cases[] = {
+        {"source", source("fi add(a, b) { return a + b }\n"
+                          "fi mix(x) { let y ==> x * 3 - 1 / 4\n"
+                          " init.log(y, -y, y == 8.75, y >= 9, add(\"s\", y), add(\"a\", \"b\") == \"ab\")\n"
+                          " return add(y, add(x, 0.5)) }\n"
+                          "let r ==> mix(3) + mix(-0.5) + init.ger(2)\n"), vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"operand error", source("fi f(a) { return a - \"x\" }\nlet r ==> f(1)\n"), vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"undefined", source("fi f() { return missing }\nlet r ==> f()\n"), vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"arity", source("fi f(a) { return a }\nfi g() { return f(1, 2) + 0 }\nlet r ==> g()\n"),
+         vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"loop", [&](runtime::Heap& h) { return sum_loop(h, Value::number(0), 1000, Value::number(0.5)); },
+         vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"loop/peephole", peephole([&](runtime::Heap& h) { return sum_loop(h, Value::number(0), 1000, Value::number(0.5)); }),
+         vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"loop/strings", [&](runtime::Heap& h) {
+             return sum_loop(h, Value::object(h.intern("")), 20, Value::number(2));
+         }, vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"loop/error", [&](runtime::Heap& h) { return sum_loop(h, Value::number(0), 10, Value::null()); },
+         vm::VM::DEFAULT_MAX_FRAMES, false},
+        {"fib", [&](runtime::Heap& h) { return fib(h, 20); }, vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"fib/peephole", peephole([&](runtime::Heap& h) { return fib(h, 15); }), vm::VM::DEFAULT_MAX_FRAMES, true},
+        {"overflow", [&](runtime::Heap& h) { return fib(h, 100); }, 40, true},
+    };
+
+    for (const Case& c : cases) {
+        Outcome interpreted = run(c.build, 0, c.max_frames);
+        for (uint32_t threshold : {1u, 3u}) {
+            Outcome native = run(c.build, threshold, c.max_frames);
+            bool same = native.result == interpreted.result && native.log == interpreted.log &&
+                        native.error == interpreted.error;
+            if (!same) std::cerr << "test_jit: " << c.name << " differs between tiers" << std::endl;
+            CHECK(same);
+            CHECK(interpreted.stats.compiled == 0);
+            if (vm::VM::jit_available() && threshold == 1) CHECK(!c.jitted || native.stats.compiled > 0);
+        }
+    }
+    Outcome fib20 = run(cases[8].build, 0, vm::VM::DEFAULT_MAX_FRAMES);
+    CHECK(fib20.result == "6765 r=null" && fib20.log == "false false false true false\n");
+    Outcome overflow = run(cases[10].build, 0, 40);
+    CHECK(overflow.error.find("Stack overflow (40 nested calls)") != std::string::npos);
+    CHECK(overflow.error.find("[line 2] in fib()") != std::string::npos);
+
+    if (!vm::VM::jit_available()) return;
+
+    // Seuil atteint en cours d'exécution : fib passe au code natif au 50e
+    // appel, la boucle du script au 50e tour (reprise au début de la boucle)
+    Outcome warm = run(cases[8].build, 50, vm::VM::DEFAULT_MAX_FRAMES);
+    CHECK(warm.result == fib20.result && warm.stats.compiled == 1 && warm.stats.code_bytes > 0);
+    Outcome loop = run(cases[4].build, 50, vm::VM::DEFAULT_MAX_FRAMES);
+    CHECK(loop.result == "249750 r=null" && loop.stats.compiled == 1);
+
+    // Opcode non traduit (OP_BUILD_LIST) : la fonction reste interprétée
+    Outcome list = run([](runtime::Heap& heap) {
+        Builder pair(heap, "pair", 1);
+        pair.op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_GET_LOCAL, 1).op(OpCode::OP_BUILD_LIST, 2).op(OpCode::OP_RETURN);
+        Builder script(heap, nullptr, 0);
+        script.constant(Value::object(pair.function)).number(7).op(OpCode::OP_CALL, 1).op(OpCode::OP_RETURN);
+        return script.function;
+    }, 1, vm::VM::DEFAULT_MAX_FRAMES);
+    CHECK(list.result == "[7, 7] r=null" && list.stats.compiled == 0 && list.stats.rejected == 1);
+
+    // Profil attaché ou pile d'appels plus profonde que JIT_MAX_FRAMES :
+    // interpréteur seul
+    runtime::Heap heap;
+    vm::VM deep(heap, vm::VM::JIT_MAX_FRAMES + 1);
+    CHECK(!deep.jit_enabled());
+    vm::VM profiled(heap);
+    vm::OpcodeProfile profile;
+    profiled.set_profile(&profile);
+    CHECK(!profiled.jit_enabled());
+}
+
+// Positions source : AST, puis table des lignes du Chunk
+static void test_line_table() {
+    lexer::Lexer lexer("let a ==> 1\n  init.log(a +\n 2)\n");
+    auto program = parser::Parser(lexer).parse_program();
+    auto* call = static_cast<const ast::ExpressionStatement*>(program->statements[1])->expression;
+    auto* sum = static_cast<const ast::CallExpression*>(call)->arguments[0];
+    CHECK(program->statements[0]->location.line == 1 && program->statements[0]->location.column == 1);
+    CHECK(call->location.line == 2 && call->location.column == 11);
+    CHECK(sum->location.line == 2 && sum->location.column == 14);
+
+    auto flat = ast::flatten(*program);
+    CHECK(flat.location(flat.statements[1]).line == 2 && flat.location(flat.statements[1]).column == 3);
+
+    compiler::LineTable table;
+    for (size_t offset = 0; offset < 1000; ++offset) {
+        int line = static_cast<int>(offset / 3) % 50 + 1;
+        table.add(offset, line, static_cast<int>(offset % 3) == 0 ? 1 : 7);
+    }
+    CHECK(table.size() == 667);
+    bool exact = true;
+    for (size_t offset = 0; offset < 1000; ++offset) {
+        compiler::LinePosition at = table.lookup(offset);
+        exact = exact && at.line == static_cast<int>(offset / 3) % 50 + 1 && at.column == (offset % 3 == 0 ? 1 : 7);
+    }
+    CHECK(exact);
+    CHECK(table.memory_bytes() < 1000 * sizeof(int));
+
+    runtime::Heap heap;
+    runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+    const compiler::Chunk& chunk = script->chunk;
+    CHECK(chunk.position(0).line == 1);
+    // OP_ADD porte la position de l'opérateur, OP_INIT_LOG celle de l'appel
+    size_t add = 0;
+    while (chunk.code[add] != static_cast<uint8_t>(compiler::OpCode::OP_ADD)) ++add;
+    CHECK(chunk.position(add).line == 2 && chunk.position(add).column == 14);
+    CHECK(chunk.position(add + 1).line == 2 && chunk.position(add + 1).column == 11);
+}
+
+// Encodage des valeurs (NaN-boxing, ou union étiquetée en repli)
+static void test_value() {
+    using runtime::Value;
+    runtime::Heap heap;
+    runtime::ObjString* text = heap.intern("abc");
+
+    double samples[] = {0.0, -0.0, 1.5, -3e300, 1e-310, std::numeric_limits<double>::infinity(),
+                        -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+    for (double d : samples) {
+        Value v = Value::number(d);
+        CHECK(v.is_number() && !v.is_object() && !v.is_null() && !v.is_bool());
+        double back = v.as_number();
+        CHECK(std::memcmp(&d, &back, sizeof(d)) == 0);
+    }
+    // NaN produit par l'arithmétique : reste un nombre
+    volatile double zero = 0;
+    Value nan = Value::number(zero / zero);
+    CHECK(nan.is_number() && !runtime::values_equal(nan, nan));
+    CHECK(runtime::values_equal(Value::number(0.0), Value::number(-0.0)));
+    CHECK(!runtime::values_identical(Value::number(0.0), Value::number(-0.0)));
+
+    CHECK(Value::null().is_null() && Value::null().is_falsey() && !Value::null().is_bool());
+    CHECK(Value::boolean(true).is_bool() && Value::boolean(true).as_bool() && !Value::boolean(true).is_falsey());
+    CHECK(Value::boolean(false).is_bool() && !Value::boolean(false).as_bool() && Value::boolean(false).is_falsey());
+    CHECK(!Value::number(0).is_falsey());
+
+    Value object = Value::object(text);
+    CHECK(object.is_object() && !object.is_number() && object.as_object() == text);
+    CHECK(runtime::is_string(object) && runtime::values_equal(object, Value::object(heap.intern("abc"))));
+    CHECK(object.type() == runtime::ValueType::Object && Value::null().type() == runtime::ValueType::Null);
+
+    CHECK(runtime::both_numbers(Value::number(1), Value::number(2)));
+    CHECK(!runtime::both_numbers(Value::number(1), object) && !runtime::both_numbers(Value::null(), Value::number(2)));
+}
+
+// Exécution de bout en bout, dans les deux modes de dispatch
+static void test_vm() {
+    const char* source =
+        "fi add(a, b) { let t ==> a + b\n return t }\n"
+        "fi twice(x) { return add(x, x) }\n"
+        "let n ==> twice(add(1, 2)) * 10\n"
+        "let s ==> \"n=\" + n\n"
+        "let same ==> init.ger(s) == \"n=60\"\n"
+        "init.log(s, n >= 60, same)\n";
+
+    lexer::Lexer lexer(source);
+    auto program = parser::Parser(lexer).parse_program();
+    runtime::Heap heap;
+    runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+
+    for (vm::Dispatch dispatch : {vm::Dispatch::Switch, vm::Dispatch::Threaded}) {
+        std::FILE* log = std::tmpfile();
+        vm::VM machine(heap);
+        machine.set_dispatch(dispatch);
+        machine.set_log_output(log);
+        machine.interpret(script);
+
+        CHECK(machine.global("n").is_number() && machine.global("n").as_number() == 60);
+        CHECK(runtime::to_string(machine.global("s")) == "n=60");
+        CHECK(machine.global("same").is_bool() && machine.global("same").as_bool());
+
+        char line[64] = {};
+        std::rewind(log);
+        CHECK(std::fgets(line, sizeof(line), log) && std::string(line) == "n=60 true true\n");
+        std::fclose(log);
+    }
+
+    // <= et >= sont faux dès qu'un opérande est NaN, comme < et >
+    lexer::Lexer nan_lexer(
+        "fi le(a, b) { return a <= b }\nfi ge(a, b) { return a >= b }\nlet nan ==> 0 / 0\n"
+        "init.log(le(nan, 1), ge(nan, 1), le(1, nan), ge(1, nan), nan <= nan, nan < 1, nan > 1)\n"
+        "init.log(le(1, 1), ge(1, 1), le(2, 1), ge(1, 2), 1 <= 2, 2 >= 1)\n");
+    auto nan_program = parser::Parser(nan_lexer).parse_program();
+    runtime::ObjFunction* nan_script = compiler::Compiler(heap).compile(*nan_program);
+    for (vm::Dispatch dispatch : {vm::Dispatch::Switch, vm::Dispatch::Threaded}) {
+        std::FILE* log = std::tmpfile();
+        vm::VM machine(heap);
+        machine.set_dispatch(dispatch);
+        machine.set_log_output(log);
+        machine.interpret(nan_script);
+
+        char line[64] = {};
+        std::rewind(log);
+        CHECK(std::fgets(line, sizeof(line), log) && std::string(line) == "false false false false false false false\n");
+        CHECK(std::fgets(line, sizeof(line), log) && std::string(line) == "true true false false true true\n");
+        std::fclose(log);
+    }
+
+    // Erreur d'exécution : message et pile d'appels, VM réutilisable ensuite
+    lexer::Lexer bad_lexer("fi f(a) { return a - \"x\" }\nf(1)\n");
+    auto bad = parser::Parser(bad_lexer).parse_program();
+    vm::VM machine(heap);
+    std::FILE* sink = std::tmpfile();
+    machine.set_log_output(sink);
+    std::string message;
+    try { machine.interpret(compiler::Compiler(heap).compile(*bad)); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("Operands must be numbers") != std::string::npos);
+    CHECK(message.find("[line 1:20] in f()") != std::string::npos);
+    CHECK(message.find("[line 2:2] in script") != std::string::npos);
+    machine.interpret(script);
+    CHECK(runtime::to_string(machine.global("s")) == "n=60");
+
+    // Trames larges (près de SLOTS_PER_FRAME slots chacune) : la récursion
+    // s'arrête sur « Stack overflow », sans écrire hors de la pile
+    std::string wide = "fi f(n) { return init.ger(";
+    for (int i = 0; i < 250; ++i) wide += "0, ";
+    wide += "f(n - 1)) }\nf(1)\n";
+    lexer::Lexer wide_lexer(wide);
+    auto wide_program = parser::Parser(wide_lexer).parse_program();
+    message.clear();
+    try { machine.interpret(compiler::Compiler(heap).compile(*wide_program)); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("Stack overflow") != std::string::npos);
+
+    // Fonction dont la hauteur de pile dépasse la fenêtre d'une trame : refusée
+    runtime::ObjFunction* tall = heap.new_function();
+    tall->chunk.write(compiler::OpCode::OP_NULL, 1);
+    tall->chunk.write(compiler::OpCode::OP_RETURN, 1);
+    tall->chunk.max_stack = vm::VM::SLOTS_PER_FRAME + 1;
+    message.clear();
+    try { machine.interpret(tall); } catch (const std::runtime_error& e) { message = e.what(); }
+    CHECK(message.find("script needs 257 stack slots") != std::string::npos);
+    std::fclose(sink);
+}
+
+// Cache .initc : aller-retour, péremption, corruption
+static void test_bytecode_cache() {
+    const char* source =
+        "fi add(a, b) { return a + b }\n"
+        "fi twice(x) { fi inner(y) { return add(y, y) }\n return inner(x) }\n"
+        "let s ==> \"n=\" + twice(21)\n"
+        "let t ==> 0.5\n";
+
+    lexer::Lexer lexer(source);
+    auto program = parser::Parser(lexer).parse_program();
+    runtime::Heap heap;
+    runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+    std::string image = compiler::serialize_cache(heap, *script, source);
+    auto* bytes = reinterpret_cast<const uint8_t*>(image.data());
+
+    runtime::Heap other;
+    runtime::ObjFunction* loaded = compiler::load_cache(other, bytes, image.size(), source, nullptr);
+    CHECK(loaded && loaded->chunk.code.is_borrowed());
+    CHECK(loaded->chunk.code.data() > bytes && loaded->chunk.code.data() < bytes + image.size());
+    CHECK(compiler::disassemble(*loaded, &other) == compiler::disassemble(*script, &heap));
+
+    vm::VM machine(other);
+    machine.interpret(loaded);
+    CHECK(runtime::to_string(machine.global("s")) == "n=42");
+    CHECK(machine.global("t").as_number() == 0.5);
+
+    // Heap dont les identifiants de globales diffèrent : opérandes corrigés
+    // sur une copie du code
+    runtime::Heap shifted;
+    shifted.global_id(shifted.intern("s"));
+    runtime::ObjFunction* relinked = compiler::load_cache(shifted, bytes, image.size(), source, nullptr);
+    CHECK(relinked && !relinked->chunk.code.is_borrowed());
+    vm::VM shifted_machine(shifted);
+    shifted_machine.interpret(relinked);
+    CHECK(runtime::to_string(shifted_machine.global("s")) == "n=42");
+
+    // Source modifiée : cache périmé
+    CHECK(compiler::load_cache(other, bytes, image.size(), "let s ==> 1\n", nullptr) == nullptr);
+
+    // Octet altéré ou fichier tronqué : erreur
+    for (size_t at : {image.size() - 1, image.size() / 2, size_t(3)}) {
+        std::string bad = image;
+        bad[at] ^= 0x5A;
+        bool thrown = false;
+        try {
+            compiler::load_cache(other, reinterpret_cast<const uint8_t*>(bad.data()), bad.size(), source, nullptr);
+        } catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+    }
+    bool truncated = false;
+    try { compiler::load_cache(other, bytes, image.size() - 8, source, nullptr); } catch (const std::runtime_error&) { truncated = true; }
+    CHECK(truncated);
+
+    // Image altérée puis somme de contrôle recalculée : seules les
+    // vérifications du chargement peuvent la refuser
+    auto reload = [&](std::string bad) {
+        const size_t header = sizeof(compiler::CacheHeader);
+        uint64_t checksum = compiler::content_hash(bad.data() + header, bad.size() - header);
+        std::memcpy(&bad[offsetof(compiler::CacheHeader, payload_checksum)], &checksum, sizeof(checksum));
+        std::string message;
+        try {
+            compiler::load_cache(other, reinterpret_cast<const uint8_t*>(bad.data()), bad.size(), source, nullptr);
+        } catch (const std::runtime_error& e) { message = e.what(); }
+        return message;
+    };
+
+    // Constante nombre remplacée par un NaN aux bits d'un pointeur d'objet
+    const double half = 0.5;
+    const uint64_t forged = 0xFFFC000000000010ull;
+    std::string forged_image = image;
+    size_t number_at = forged_image.find(std::string(reinterpret_cast<const char*>(&half), sizeof(half)));
+    CHECK(number_at != std::string::npos);
+    std::memcpy(&forged_image[number_at], &forged, sizeof(forged));
+    CHECK(reload(forged_image).find("bad number constant") != std::string::npos);
+
+    // Code altéré : seul verify_code peut le refuser
+    using compiler::OpCode;
+    runtime::ObjFunction* hand = heap.new_function();
+    uint8_t field = static_cast<uint8_t>(hand->chunk.add_constant(runtime::Value::object(heap.intern("f"))));
+    uint8_t one = static_cast<uint8_t>(hand->chunk.add_constant(runtime::Value::number(1)));
+    const uint8_t code[] = {
+        uint8_t(OpCode::OP_JUMP), 2, 0, uint8_t(OpCode::OP_CONSTANT), one,  // saut vers 5
+        uint8_t(OpCode::OP_CONSTANT), one, uint8_t(OpCode::OP_GET_FIELD), field, uint8_t(OpCode::OP_RETURN),
+    };
+    for (uint8_t byte : code) hand->chunk.write(byte, 1);
+    std::string hand_image = compiler::serialize_cache(heap, *hand, source);
+    size_t at = hand_image.find(std::string(reinterpret_cast<const char*>(code), sizeof(code)));
+    CHECK(at != std::string::npos);
+    auto patched = [&](size_t index, uint8_t byte) {
+        std::string bad = hand_image;
+        bad[at + index] = static_cast<char>(byte);
+        return reload(bad);
+    };
+    CHECK(patched(0, uint8_t(OpCode::OP_JUMP)).empty());
+    CHECK(patched(1, 3).find("Cache error") != std::string::npos);  // opérande de OP_CONSTANT
+    CHECK(patched(1, 7).find("Cache error") != std::string::npos);  // fin du code
+    CHECK(patched(8, one).find("Cache error") != std::string::npos); // nom de champ non chaîne
+    CHECK(patched(6, 2).find("Cache error") != std::string::npos);   // constante hors table
+    // OP_ADD sur la seule fenêtre du script, slot au-delà de la pile
+    CHECK(patched(5, uint8_t(OpCode::OP_ADD)).find("stack underflow") != std::string::npos);
+    CHECK(patched(5, uint8_t(OpCode::OP_GET_LOCAL)).find("local slot out of range") != std::string::npos);
+
+    // Hauteur de pile : au plus la fenêtre d'une trame, reportée dans max_stack
+    auto pushes = [&](size_t count) {
+        runtime::ObjFunction* tall = heap.new_function();
+        for (size_t i = 0; i < count; ++i) tall->chunk.write(OpCode::OP_NULL, 1);
+        tall->chunk.write(OpCode::OP_RETURN, 1);
+        std::string tall_image = compiler::serialize_cache(heap, *tall, source);
+        std::string message;
+        runtime::ObjFunction* tall_loaded = nullptr;
+        try {
+            tall_loaded = compiler::load_cache(other, reinterpret_cast<const uint8_t*>(tall_image.data()),
+                                               tall_image.size(), source, nullptr);
+        } catch (const std::runtime_error& e) { message = e.what(); }
+        return tall_loaded ? std::to_string(tall_loaded->chunk.max_stack) : message;
+    };
+    CHECK(pushes(vm::VM::SLOTS_PER_FRAME - 1) == std::to_string(vm::VM::SLOTS_PER_FRAME));
+    CHECK(pushes(vm::VM::SLOTS_PER_FRAME).find("stack too deep") != std::string::npos);
+
+    // Écriture dans un buffer emprunté : copie préalable
+    loaded->chunk.code[0] = loaded->chunk.code[0];
+    CHECK(!loaded->chunk.code.is_borrowed());
+}
+
+// Projet multi-fichiers : sortie identique quel que soit le nombre de
+// threads, globales partagées entre fichiers, première erreur rapportée
+static void test_project() {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "initlang_test_project";
+    fs::create_directories(dir);
+    auto write = [&](const std::string& name, const std::string& text) {
+        std::ofstream(dir / name) << text;
+        return (dir / name).string();
+    };
+
+    // Plus de 256 globales au total : formes LONG des opérandes
+    std::string many;
+    for (int i = 0; i < 300; ++i) many += "let g" + std::to_string(i) + " ==> " + std::to_string(i) + "\n";
+    std::vector<std::string> paths = {
+        write("a.init", "fi add(a, b) { return a + b }\nlet label ==> \"sum=\"\n"),
+        write("b.init", many),
+        write("c.init", "fi twice(x) { fi inner(y) { return add(y, y) }\n return inner(x) }\n"
+                        "let total ==> twice(g299) + g1\n"),
+        write("d.init", "let s ==> label + total\nlet again ==> add(g0, 1)\n"),
+    };
+
+    std::vector<std::string> reference;
+    std::vector<std::string> reference_globals;
+    for (size_t threads : {1, 2, 4}) {
+        runtime::Heap heap;
+        project::Result result = project::compile_project(heap, paths, project::Options{threads, threads == 4 ? 1 : 0});
+        CHECK(result.scripts.size() == paths.size());
+        CHECK(result.stats.threads == threads && result.stats.globals == heap.global_count());
+
+        std::vector<std::string> listing;
+        for (runtime::ObjFunction* script : result.scripts) listing.push_back(compiler::disassemble(*script, &heap));
+        std::vector<std::string> globals;
+        for (uint32_t id = 0; id < heap.global_count(); ++id) globals.emplace_back(heap.global_name(id)->view());
+        if (threads == 1) {
+            reference = listing;
+            reference_globals = globals;
+            CHECK(globals.size() == 306 && globals[0] == "add" && globals[2] == "g0");
+        } else if (threads == 2) {
+            CHECK(listing == reference);
+            CHECK(globals == reference_globals);
+        } else {
+            CHECK(globals == reference_globals); // -O1 : code différent, numérotation identique
+        }
+
+        vm::VM machine(heap);
+        for (runtime::ObjFunction* script : result.scripts) machine.interpret(script);
+        CHECK(runtime::to_string(machine.global("s")) == "sum=599");
+        CHECK(machine.global("again").as_number() == 1);
+    }
+
+    // Fonction redéfinie par un fichier suivant : pas d'inline à -O2, les
+    // globales étant communes à tout le projet
+    std::vector<std::string> redefined = {
+        write("r1.init", "fi f(a) { return a }\nfi g(x) { return f(x) }\n"),
+        write("r2.init", "fi f(a) { return a * 2 }\nlet r ==> g(3)\n"),
+    };
+    for (int level : {0, 2}) {
+        runtime::Heap heap;
+        project::Result result = project::compile_project(heap, redefined, project::Options{2, level});
+        vm::VM machine(heap);
+        for (runtime::ObjFunction* script : result.scripts) machine.interpret(script);
+        CHECK(machine.global("r").as_number() == 6);
+    }
+
+    // Erreurs dans deux fichiers : celle du premier, préfixée de son chemin
+    std::vector<std::string> broken = {paths[0], write("e.init", "let ==> 1\n"), write("f.init", "fi (\n")};
+    for (size_t threads : {1, 3}) {
+        runtime::Heap heap;
+        std::string message;
+        try {
+            project::compile_project(heap, broken, project::Options{threads, 0});
+        } catch (const std::runtime_error& e) { message = e.what(); }
+        CHECK(message.rfind(broken[1] + ": Expected identifier after 'let'", 0) == 0);
+    }
+    fs::remove_all(dir);
+}
+
+// async/spawn/await : formes de l'AST, erreurs de compilation, puis
+// exécution sur 1, 2 et 4 workers (mêmes résultats)
+static void test_tasks() {
+    const char* source =
+        "async fi f(x) { let t ==> spawn g(x, 1)\n return await t + 1 }\n"
+        "fi g(a, b) { return a + b }\n"
+        "let r ==> await spawn f(2)\n";
+
+    lexer::Lexer tree_lexer(source);
+    auto program = parser::Parser(tree_lexer).parse_program();
+    auto* f = dynamic_cast<ast::FunctionDeclaration*>(program->statements[0]);
+    auto* g = dynamic_cast<ast::FunctionDeclaration*>(program->statements[1]);
+    CHECK(f && f->is_async && g && !g->is_async);
+    auto* t = f ? dynamic_cast<ast::VariableDeclaration*>(f->body->statements[0]) : nullptr;
+    auto* spawned = t ? dynamic_cast<ast::SpawnExpression*>(t->value) : nullptr;
+    CHECK(spawned && spawned->call->arguments.size() == 2);
+    auto* r = dynamic_cast<ast::VariableDeclaration*>(program->statements[2]);
+    auto* awaited = r ? dynamic_cast<ast::AwaitExpression*>(r->value) : nullptr;
+    CHECK(awaited && awaited->value->kind == ast::NodeKind::SpawnExpression);
+
+    lexer::Lexer flat_lexer(source);
+    ast::FlatAst direct = parser::Parser(flat_lexer).parse_flat_program();
+    CHECK(dump(direct) == dump(ast::flatten(*program)));
+    CHECK(direct.function(direct.statements[0]).is_async && !direct.function(direct.statements[1]).is_async);
+    CHECK(direct.function(direct.statements[0]).parameters.size() == 1);
+
+    runtime::Heap heap;
+    auto compile = [&](const char* text) {
+        lexer::Lexer lexer(text);
+        auto tree = parser::Parser(lexer).parse_program();
+        return compiler::Compiler(heap).compile(*tree);
+    };
+    auto compile_error = [&](const char* text) {
+        std::string message;
+        try { compile(text); } catch (const std::runtime_error& e) { message = e.what(); }
+        return message;
+    };
+    CHECK(compile_error("spawn 1 + 2\n").find("Expected call after 'spawn'") != std::string::npos);
+    CHECK(compile_error("fi f(x) { return await x }\n").find("'await' outside of an async function") !=
+          std::string::npos);
+    CHECK(compile_error("spawn init.log(1)\n").find("'init.log' cannot be spawned") != std::string::npos);
+    CHECK(compile_error("async f()\n").find("Expected 'fi' after 'async'") != std::string::npos);
+
+    runtime::ObjFunction* script = compile(source);
+    std::string listing = compiler::disassemble(*script, &heap);
+    CHECK(listing.find("OP_SPAWN") != std::string::npos && listing.find("OP_AWAIT") != std::string::npos);
+
+    // Arbre de tâches : 2^6 feuilles, chaque niveau attend ses deux enfants
+    std::string tree;
+    tree += "async fi l0(x) { return x }\n";
+    for (int level = 1; level <= 6; ++level) {
+        std::string child = "l" + std::to_string(level - 1);
+        tree += "async fi l" + std::to_string(level) + "(x) { let a ==> spawn " + child + "(x)\n let b ==> spawn " +
+                child + "(x + 1)\n return await a + await b }\n";
+    }
+    tree += "let root ==> spawn l6(0)\nlet total ==> await root\nlet plain ==> await 5\n"
+            "init.log(root, total)\n";
+    runtime::ObjFunction* fan_out = compile(tree.c_str());
+    for (size_t workers : {1, 2, 4}) {
+        std::FILE* log = std::tmpfile();
+        vm::VM machine(heap);
+        machine.set_workers(workers);
+        machine.set_log_output(log);
+        machine.interpret(fan_out);
+        CHECK(machine.global("total").as_number() == 192); // somme des 64 feuilles
+        CHECK(machine.global("plain").as_number() == 5);
+        CHECK(machine.task_stats().spawned == 127 && machine.task_stats().workers == workers);
+        char line[64] = {};
+        std::rewind(log);
+        CHECK(std::fgets(line, sizeof(line), log) && std::string(line) == "<task> 192\n");
+        std::fclose(log);
+
+        // Une VM reste utilisable après chaque exécution
+        machine.interpret(compile(source));
+        CHECK(machine.global("r").as_number() == 4);
+    }
+
+    // Erreur d'une tâche : relevée par son await, avec les deux piles
+    auto run_error = [&](const char* text, size_t workers) {
+        runtime::ObjFunction* compiled = compile(text);
+        vm::VM machine(heap);
+        machine.set_workers(workers);
+        std::string message;
+        try { machine.interpret(compiled); } catch (const std::runtime_error& e) { message = e.what(); }
+        return message;
+    };
+    for (size_t workers : {1, 3}) {
+        std::string message = run_error("fi bad(x) { return x - \"s\" }\nlet t ==> spawn bad(1)\nawait t\n", workers);
+        CHECK(message.find("Operands must be numbers") != std::string::npos);
+        CHECK(message.find("in bad()") != std::string::npos && message.find("[line 3:1] in script") != std::string::npos);
+
+        // Jamais attendue : relevée à la fin de l'exécution
+        message = run_error("fi bad(x) { return x - \"s\" }\nspawn bad(1)\nlet after ==> 1\n", workers);
+        CHECK(message.find("Operands must be numbers") != std::string::npos);
+
+        message = run_error("fi f(a, b) { return a }\nspawn f(1)\n", workers);
+        CHECK(message.find("Expected 2 arguments but got 1") != std::string::npos);
+    }
+
+    // Attente circulaire ; un seul worker : f ne démarre qu'une fois t définie
+    std::string message = run_error("async fi f() { return await t }\nlet t ==> spawn f()\nawait t\n", 1);
+    CHECK(message.find("Deadlock: awaited task can never complete") != std::string::npos);
+    message = run_error("async fi f() { return await t }\nlet t ==> spawn f()\n", 1);
+    CHECK(message.find("Deadlock: 1 task never completed") != std::string::npos);
+
+    // Vieille génération collectée pendant les tâches : chaque feuille laisse
+    // des chaînes intermédiaires mortes ; les résultats (terminés, tenus par
+    // les piles des fibres suspendues) survivent
+    std::string garbage = "async fi l0(x) { let s ==> \"p\" + x";
+    for (int i = 0; i < 150; ++i) garbage += " + \".\"";
+    garbage += "\n return s }\n";
+    for (int level = 1; level <= 6; ++level) {
+        std::string child = "l" + std::to_string(level - 1);
+        garbage += "async fi l" + std::to_string(level) + "(x) { let a ==> spawn " + child + "(x * 2)\n let b ==> spawn " +
+                   child + "(x * 2 + 1)\n return await a + await b }\n";
+    }
+    garbage += "let total ==> await spawn l6(0)\n";
+    std::string expected;
+    for (int leaf = 0; leaf < 64; ++leaf) expected += "p" + std::to_string(leaf) + std::string(150, '.');
+    for (size_t workers : {1, 4}) {
+        runtime::GcOptions small;
+        small.major_threshold = 64 << 10;
+        runtime::Heap collected(small);
+        lexer::Lexer lexer(garbage.c_str());
+        auto tree = parser::Parser(lexer).parse_program();
+        runtime::ObjFunction* compiled = compiler::Compiler(collected).compile(*tree);
+        vm::VM machine(collected);
+        machine.set_workers(workers);
+        machine.interpret(compiled);
+        runtime::Value total = machine.global("total");
+        CHECK(runtime::is_string(total) && runtime::as_string(total)->view() == expected);
+        // Plus d'1 Mo de chaînes en tout ; sans collecte pendant les tâches,
+        // la vieille génération les garderait toutes jusqu'à la fin
+        CHECK(collected.gc_stats().major_collections > 1);
+        CHECK(collected.gc_stats().max_old_bytes < (256u << 10));
+    }
+}
+
+// Journal asynchrone : anneaux par thread, débordement, niveaux, format
+// clé=valeur, puis init.log de la VM (tâches comprises) à travers lui
+static void test_logging() {
+    using runtime::Value;
+    auto contents = [](std::FILE* file) {
+        std::string text;
+        char chunk[4096];
+        std::rewind(file);
+        for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) text.append(chunk, n);
+        return text;
+    };
+    auto lines = [](const std::string& text) {
+        std::vector<std::string> out;
+        for (size_t start = 0, end; (end = text.find('\n', start)) != std::string::npos; start = end + 1) {
+            out.push_back(text.substr(start, end - start));
+        }
+        return out;
+    };
+
+    // 4 threads, anneaux de 256 octets : tout arrive, dans l'ordre de chaque thread
+    {
+        std::FILE* file = std::tmpfile();
+        logging::Stats stats;
+        {
+            logging::Options options;
+            options.fd = fileno(file);
+            options.ring_bytes = 256;
+            logging::Logger logger(options);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&logger, t] {
+                    for (int i = 0; i < 1000; ++i) logger.write(std::to_string(t) + " " + std::to_string(i) + "\n");
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            logger.write(std::string(1000, 'x') + "\n"); // plus grand que l'anneau
+            logger.flush();
+            stats = logger.stats();
+        }
+        std::vector<std::string> out = lines(contents(file));
+        CHECK(out.size() == 4001 && out.back() == std::string(1000, 'x'));
+        int next[4] = {0, 0, 0, 0};
+        bool ordered = true;
+        for (size_t i = 0; i + 1 < out.size(); ++i) {
+            int t = out[i][0] - '0';
+            ordered = ordered && t >= 0 && t < 4 && out[i] == std::to_string(t) + " " + std::to_string(next[t]++);
+        }
+        CHECK(ordered);
+        CHECK(stats.records == 4001 && stats.dropped == 0 && stats.errors == 0);
+        CHECK(stats.bytes == contents(file).size() && stats.writes > 0);
+        std::fclose(file);
+    }
+
+    // Overflow::Drop : ce qui ne tient pas est compté, le reste écrit à la destruction
+    {
+        std::FILE* file = std::tmpfile();
+        logging::Stats stats;
+        {
+            logging::Options options;
+            options.fd = fileno(file);
+            options.ring_bytes = 64;
+            options.overflow = logging::Overflow::Drop;
+            options.interval = std::chrono::hours(1);
+            logging::Logger logger(options);
+            for (int i = 0; i < 100; ++i) logger.write("line " + std::to_string(i % 10) + "\n");
+            stats = logger.stats();
+        }
+        CHECK(stats.records + stats.dropped == 100 && stats.records > 0);
+        CHECK(lines(contents(file)).size() == stats.records);
+        std::fclose(file);
+    }
+
+    // init.log à travers un Logger : même rendu que l'écriture directe
+    runtime::Heap heap;
+    auto compile = [&](const char* text) {
+        lexer::Lexer lexer(text);
+        auto tree = parser::Parser(lexer).parse_program();
+        return compiler::Compiler(heap).compile(*tree);
+    };
+    auto run = [&](runtime::ObjFunction* script, logging::Options options, logging::Level level) {
+        std::FILE* file = std::tmpfile();
+        options.fd = fileno(file);
+        {
+            logging::Logger logger(options);
+            vm::VM machine(heap);
+            machine.set_logger(&logger);
+            machine.set_log_level(level);
+            machine.set_workers(3);
+            machine.interpret(script);
+        }
+        std::string text = contents(file);
+        std::fclose(file);
+        return text;
+    };
+    runtime::ObjFunction* plain = compile("init.log(1.5, \"a\", 2 == 2)\ninit.log()\n");
+    CHECK(run(plain, {}, logging::Level::Info) == "1.5 a true\n\n");
+
+    // Niveaux : init.log en info sous un seuil warn, puis en error
+    logging::Options warn;
+    warn.level = logging::Level::Warn;
+    CHECK(run(plain, warn, logging::Level::Info).empty());
+    CHECK(run(plain, warn, logging::Level::Error) == "1.5 a true\n\n");
+    logging::Level level = logging::Level::Info;
+    CHECK(logging::parse_level("error", level) && level == logging::Level::Error);
+    CHECK(!logging::parse_level("verbose", level) && level == logging::Level::Error);
+
+    // Format clé=valeur : champs des structures, chaînes échappées
+    runtime::ObjStruct* record =
+        heap.new_struct(heap.shape_with(heap.shape_with(heap.empty_shape(), heap.intern("n")), heap.intern("s")));
+    record->values()[0] = Value::number(3);
+    record->values()[1] = Value::object(heap.intern("x \"y\"\n"));
+    runtime::ObjFunction* structured = heap.new_function();
+    compiler::Chunk& chunk = structured->chunk;
+    chunk.write(compiler::OpCode::OP_CONSTANT, 1);
+    chunk.write(static_cast<uint8_t>(chunk.add_constant(Value::object(record))), 1);
+    chunk.write(compiler::OpCode::OP_TRUE, 1);
+    chunk.write(compiler::OpCode::OP_INIT_LOG, 1);
+    chunk.write(2, 1);
+    chunk.write(compiler::OpCode::OP_RETURN, 1);
+    logging::Options kv;
+    kv.format = logging::Format::KeyValue;
+    CHECK(run(structured, kv, logging::Level::Warn) == "level=warn n=3 s=\"x \\\"y\\\"\\n\" arg1=true\n");
+
+    // Tâches : une ligne par feuille, écrite depuis le worker qui l'exécute.
+    // Ordre garanti par thread seulement : « total » peut précéder une feuille
+    // journalisée par un autre worker
+    std::string tree = "async fi l0(x) { init.log(\"leaf\", x)\n return x }\n";
+    for (int level = 1; level <= 4; ++level) {
+        std::string child = "l" + std::to_string(level - 1);
+        tree += "async fi l" + std::to_string(level) + "(x) { let a ==> spawn " + child + "(x)\n let b ==> spawn " +
+                child + "(x + 1)\n return await a + await b }\n";
+    }
+    tree += "init.log(\"total\", await spawn l4(0))\n";
+    std::vector<std::string> out = lines(run(compile(tree.c_str()), {}, logging::Level::Info));
+    CHECK(out.size() == 17 && std::count(out.begin(), out.end(), "total 32") == 1);
+    CHECK(std::count_if(out.begin(), out.end(), [](const std::string& l) { return l.rfind("leaf ", 0) == 0; }) == 16);
+}
+
+// Ramasse-miettes : nurserie de 4 Ko, structures et listes construites par
+// OP_BUILD_STRUCT / OP_BUILD_LIST, chaînes internées déplacées ou libérées
+static void test_gc() {
+    using compiler::OpCode;
+    using runtime::Value;
+
+    // mk(n) rend {n: n, s: ["v" + n]} (corps écrit à la main) ; churn(n)
+    // laisse deux chaînes mortes à chaque appel, son résultat est gardé
+    // dans une globale une fois sur dix
+    std::string source =
+        "fi mk(n) { return n }\n"
+        "fi churn(n) { let a ==> \"a\" + n\n let b ==> a + \"b\"\n return mk(n) }\n"
+        "let keep ==> churn(0)\n";
+    for (int i = 1; i < 3000; ++i) {
+        std::string call = "churn(" + std::to_string(i) + ")\n";
+        source += i % 10 ? call : "let k" + std::to_string(i) + " ==> " + call; // un sur dix survit
+    }
+    source += "let last ==> churn(3000)\n";
+
+    auto run = [&](runtime::GcOptions options, auto&& check) {
+        runtime::Heap heap(options);
+        lexer::Lexer lexer(source);
+        auto program = parser::Parser(lexer).parse_program();
+        runtime::ObjFunction* script = compiler::Compiler(heap).compile(*program);
+        for (Value constant : script->chunk.constants) {
+            if (!runtime::is_function(constant) || runtime::as_function(constant)->name != heap.intern("mk")) continue;
+            compiler::Chunk& chunk = runtime::as_function(constant)->chunk;
+            chunk = compiler::Chunk();
+            auto constant_byte = [&](Value value) { return static_cast<uint8_t>(chunk.add_constant(value)); };
+            const uint8_t body[] = {
+                uint8_t(OpCode::OP_CONSTANT), constant_byte(Value::object(heap.intern("n"))),
+                uint8_t(OpCode::OP_GET_LOCAL), 1,
+                uint8_t(OpCode::OP_CONSTANT), constant_byte(Value::object(heap.intern("s"))),
+                uint8_t(OpCode::OP_CONSTANT), constant_byte(Value::object(heap.intern("v"))),
+                uint8_t(OpCode::OP_GET_LOCAL), 1,
+                uint8_t(OpCode::OP_ADD),
+                uint8_t(OpCode::OP_BUILD_LIST), 1,
+                uint8_t(OpCode::OP_BUILD_STRUCT), 2,
+                uint8_t(OpCode::OP_RETURN),
+            };
+            for (uint8_t byte : body) chunk.write(byte, 1);
+        }
+        vm::VM machine(heap);
+        machine.interpret(script);
+        check(heap, machine);
+    };
+    auto field = [](runtime::Heap& heap, Value object, const char* name) {
+        const Value* value = runtime::as_struct(object)->find(heap.intern(name));
+        return value ? *value : Value::null();
+    };
+    auto holds = [&](runtime::Heap& heap, Value object, int n) {
+        if (!runtime::is_struct(object) || field(heap, object, "n").as_number() != n) return false;
+        Value list = field(heap, object, "s");
+        if (!runtime::is_list(list) || runtime::as_list(list)->items.size() != 1) return false;
+        Value text = runtime::as_list(list)->items[0];
+        std::string expected = "v" + std::to_string(n);
+        // Chaîne promue toujours internée : même objet pour le même texte
+        return runtime::to_string(text) == expected && runtime::as_string(text) == heap.intern(expected);
+    };
+
+    runtime::GcOptions small;
+    small.nursery_bytes = 4096;
+    small.major_threshold = 4096;
+    run(small, [&](runtime::Heap& heap, vm::VM& machine) {
+        const runtime::GcStats& stats = heap.gc_stats();
+        CHECK(holds(heap, machine.global("keep"), 0));
+        CHECK(holds(heap, machine.global("last"), 3000));
+        CHECK(holds(heap, machine.global("k1500"), 1500));
+        CHECK(!heap.is_young(machine.global("keep").as_object()) && !heap.is_young(machine.global("last").as_object()));
+        CHECK(stats.minor_collections > 10 && stats.major_collections > 0);
+        CHECK(stats.bytes_promoted > 0 && stats.bytes_freed > stats.bytes_promoted);
+        CHECK(stats.bytes_allocated >= stats.bytes_freed);
+        CHECK(stats.max_pause_seconds > 0 && stats.max_pause_seconds <= stats.minor_pause_seconds + stats.major_pause_seconds);
+        // Les chaînes mortes quittent la table d'internement
+        CHECK(heap.interned_strings() < 1000);
+
+        // Collecte complète à la demande : les globales restent
+        size_t majors = stats.major_collections;
+        heap.collect(true);
+        CHECK(stats.major_collections == majors + 1);
+        CHECK(holds(heap, machine.global("keep"), 0) && holds(heap, machine.global("last"), 3000));
+    });
+
+    // Collecte complète à chaque allocation : mêmes résultats
+    runtime::GcOptions stress = small;
+    stress.stress = true;
+    source.resize(source.find("churn(21)\n"));
+    source += "let last ==> churn(3000)\n";
+    run(stress, [&](runtime::Heap& heap, vm::VM& machine) {
+        CHECK(holds(heap, machine.global("keep"), 0) && holds(heap, machine.global("last"), 3000));
+        CHECK(heap.gc_stats().major_collections > 20);
+    });
+
+    // Hors exécution, les objets sont permanents : ni nurserie ni collecte
+    runtime::Heap heap(small);
+    runtime::ObjString* host = heap.intern("host");
+    runtime::ObjList* list = heap.new_list();
+    list->items.push_back(Value::object(host));
+    heap.collect(true);
+    CHECK(!heap.is_young(list) && heap.intern("host") == host && heap.gc_stats().bytes_freed == 0);
+
+    // Barrière d'écriture : vieil objet modifié pendant une exécution
+    heap.begin_execution();
+    runtime::ObjString* young = heap.intern("young");
+    CHECK(heap.is_young(young));
+    list->items.push_back(Value::object(young));
+    heap.write_barrier(list, list->items.back());
+    heap.collect(false);
+    Value moved = list->items.back();
+    CHECK(runtime::is_string(moved) && !heap.is_young(moved.as_object()) && runtime::to_string(moved) == "young");
+    CHECK(heap.intern("young") == runtime::as_string(moved));
+    heap.end_execution();
+}
+
+// Formes des structures et caches en ligne de OP_GET_FIELD / OP_SET_FIELD
+// (bytecode écrit à la main : le langage n'a pas encore de syntaxe)
+static void test_shapes() {
+    using compiler::OpCode;
+    using runtime::Value;
+    runtime::Heap heap;
+    auto str = [&](const char* text) { return Value::object(heap.intern(text)); };
+    auto global = [&](const char* name) { return static_cast<uint8_t>(heap.global_id(heap.intern(name))); };
+    auto function = [&](const char* name, int arity) {
+        runtime::ObjFunction* f = heap.new_function();
+        f->arity = arity;
+        f->name = name ? heap.intern(name) : nullptr;
+        return f;
+    };
+    auto k = [](runtime::ObjFunction* f, Value value) { return static_cast<uint8_t>(f->chunk.add_constant(value)); };
+    auto emit = [](runtime::ObjFunction* f, std::initializer_list<uint8_t> bytes) {
+        for (uint8_t byte : bytes) f->chunk.write(byte, 1);
+    };
+    auto op = [](OpCode code) { return static_cast<uint8_t>(code); };
+
+    // fi sum(s) { return s.x + s.y }
+    runtime::ObjFunction* sum = function("sum", 1);
+    emit(sum, {op(OpCode::OP_GET_LOCAL), 1, op(OpCode::OP_GET_FIELD), k(sum, str("x")), op(OpCode::OP_GET_LOCAL), 1,
+               op(OpCode::OP_GET_FIELD), k(sum, str("y")), op(OpCode::OP_ADD), op(OpCode::OP_RETURN)});
+    // fi setx(s, v) { return s.x = v }
+    runtime::ObjFunction* setx = function("setx", 2);
+    emit(setx, {op(OpCode::OP_GET_LOCAL), 1, op(OpCode::OP_GET_LOCAL), 2, op(OpCode::OP_SET_FIELD),
+                k(setx, str("x")), op(OpCode::OP_RETURN)});
+    // fi point(a, b) { return {x: a, y: b} }
+    runtime::ObjFunction* point = function("point", 2);
+    emit(point, {op(OpCode::OP_CONSTANT), k(point, str("x")), op(OpCode::OP_GET_LOCAL), 1, op(OpCode::OP_CONSTANT),
+                 k(point, str("y")), op(OpCode::OP_GET_LOCAL), 2, op(OpCode::OP_BUILD_STRUCT), 2,
+                 op(OpCode::OP_RETURN)});
+
+    // p = point(1, 2), q = point(3, 4), r = {y: 5, x: 6, x: 7}
+    // a = sum(p) + sum(q) + sum(r) + sum(p), setx(q, 10), c = sum(q)
+    runtime::ObjFunction* script = function(nullptr, 0);
+    auto call = [&](const char* callee, std::initializer_list<Value> args, const char* target) {
+        emit(script, {op(OpCode::OP_GET_GLOBAL), global(callee)});
+        for (Value arg : args) emit(script, {op(OpCode::OP_CONSTANT), k(script, arg)});
+        emit(script, {op(OpCode::OP_CALL), static_cast<uint8_t>(args.size())});
+        if (target) emit(script, {op(OpCode::OP_DEFINE_GLOBAL), global(target)});
+    };
+    auto sum_of = [&](const char* name) {
+        emit(script, {op(OpCode::OP_GET_GLOBAL), global("sum"), op(OpCode::OP_GET_GLOBAL), global(name),
+                      op(OpCode::OP_CALL), 1});
+    };
+    for (runtime::ObjFunction* f : {sum, setx, point}) {
+        emit(script, {op(OpCode::OP_CONSTANT), k(script, Value::object(f)), op(OpCode::OP_DEFINE_GLOBAL),
+                      static_cast<uint8_t>(heap.global_id(f->name))});
+    }
+    call("point", {Value::number(1), Value::number(2)}, "p");
+    call("point", {Value::number(3), Value::number(4)}, "q");
+    for (auto [name, value] : {std::pair<const char*, double>{"y", 5}, {"x", 6}, {"x", 7}}) {
+        emit(script, {op(OpCode::OP_CONSTANT), k(script, str(name)), op(OpCode::OP_CONSTANT),
+                      k(script, Value::number(value))});
+    }
+    emit(script, {op(OpCode::OP_BUILD_STRUCT), 3, op(OpCode::OP_DEFINE_GLOBAL), global("r")});
+    sum_of("p");
+    for (const char* name : {"q", "r", "p"}) {
+        sum_of(name);
+        emit(script, {op(OpCode::OP_ADD)});
+    }
+    emit(script, {op(OpCode::OP_DEFINE_GLOBAL), global("a")});
+    emit(script, {op(OpCode::OP_GET_GLOBAL), global("setx"), op(OpCode::OP_GET_GLOBAL), global("q"),
+                  op(OpCode::OP_CONSTANT), k(script, Value::number(10)), op(OpCode::OP_CALL), 2, op(OpCode::OP_POP)});
+    sum_of("q");
+    emit(script, {op(OpCode::OP_DEFINE_GLOBAL), global("c"), op(OpCode::OP_NULL), op(OpCode::OP_RETURN)});
+
+    const runtime::Shape* built = nullptr;
+    for (bool caches : {true, false}) {
+        for (runtime::ObjFunction* f : {sum, setx, point, script}) f->chunk.field_caches.clear();
+        vm::VM machine(heap);
+        machine.set_quickening(caches);
+        machine.interpret(script);
+
+        Value p = machine.global("p"), q = machine.global("q"), r = machine.global("r");
+        CHECK(runtime::is_struct(p) && runtime::as_struct(p)->shape == runtime::as_struct(q)->shape);
+        CHECK(runtime::to_string(r) == "{y: 5, x: 7}" && runtime::as_struct(r)->shape != runtime::as_struct(p)->shape);
+        CHECK(machine.global("a").as_number() == 25);
+        CHECK(machine.global("c").as_number() == 14 && runtime::to_string(q) == "{x: 10, y: 4}");
+        // point : 1 ; sum : p, r puis p à nouveau sur chacun des deux sites ;
+        // r : 1 (nom répété, jamais en cache) ; setx : 1
+        CHECK(machine.quickening_stats().field_misses == (caches ? 9u : 0u));
+        built = runtime::as_struct(p)->shape;
+    }
+    // Formes : vide, {x}, {x, y}, {y}, {y, x}
+    CHECK(heap.shape_count() == 5);
+    const runtime::Shape* xy = heap.shape_with(heap.shape_with(heap.empty_shape(), heap.intern("x")), heap.intern("y"));
+    CHECK(xy == built && heap.shape_count() == 5);
+    CHECK(xy->size() == 2 && xy->index_of(heap.intern("y")) == 1 && xy->index_of(heap.intern("z")) == -1);
+
+    // Instance : en-tête, forme et valeurs, rien d'autre
+    size_t before = heap.bytes_allocated();
+    runtime::ObjStruct* object = heap.new_struct(xy);
+    CHECK(heap.bytes_allocated() - before == sizeof(runtime::ObjStruct) + 2 * sizeof(Value));
+    CHECK(object->find(heap.intern("x"))->is_null() && !object->find(heap.intern("z")));
+
+    // Erreurs : champ absent, valeur sans champs
+    auto failure = [&](Value target, const char* field) {
+        runtime::ObjFunction* bad = function(nullptr, 0);
+        emit(bad, {op(OpCode::OP_CONSTANT), k(bad, target), op(OpCode::OP_GET_FIELD), k(bad, str(field)),
+                   op(OpCode::OP_RETURN)});
+        std::string message;
+        try { vm::VM(heap).interpret(bad); } catch (const std::runtime_error& e) { message = e.what(); }
+        return message;
+    };
+    CHECK(failure(Value::object(object), "z").find("Undefined field 'z'") != std::string::npos);
+    CHECK(failure(Value::number(1), "x").find("Only structs have fields, got 1") != std::string::npos);
+    CHECK(compiler::disassemble(*sum, &heap).find("OP_GET_FIELD") != std::string::npos);
+}
+
+static void run_all() {
+    test_keywords();
+    test_lexer_positions();
+    test_streaming_lexer();
+    test_simd_scan();
+    test_parallel_lexer();
+    test_parser_precedence();
+    test_flat_ast();
+    test_interner();
+    test_compiler();
+    test_resolver();
+    test_optimizer();
+    test_line_table();
+    test_value();
+    test_vm();
+    test_peephole();
+    test_quickening();
+    test_tail_calls();
+    test_jit();
+    test_bytecode_cache();
+    test_project();
+    test_tasks();
+    test_logging();
+    test_gc();
+    test_shapes();
+}
+
+// Tous les tests sous chaque niveau : interpréteur seul, JIT dès le premier
+// appel ou tour de boucle, puis ramasse-miettes en mode stress (mêmes attentes)
 int main() {
-    std::cout << "=== INITLANG CORE ENGINE ===" << std::endl;
-    std::cout << "Status: COMPILATION SUCCESSFUL" << std::endl;
-    std::cout << "Next: Implementing Lexer & Parser" << std::endl;
-    std::cout << "=== READY FOR DEVELOPMENT ===" << std::endl;
+    vm::VM::set_default_jit_threshold(0);
+    run_all();
+    if (vm::VM::jit_available()) {
+        tier = "jit";
+        vm::VM::set_default_jit_threshold(1);
+        run_all();
+    }
+
+    // Collecte complète à chaque allocation d'une exécution : les racines
+    // oubliées se voient tout de suite (objets libérés puis relus)
+    tier = "gc-stress";
+    runtime::GcOptions stress;
+    stress.stress = true;
+    runtime::Heap::set_default_gc_options(stress);
+    run_all();
+
+    if (failures) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "test_core: all checks passed" << std::endl;
     return 0;
 }